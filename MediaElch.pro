@@ -149,6 +149,7 @@ SOURCES += src/main.cpp \
     src/ui/concerts/ConcertInfoWidget.cpp \
     src/concerts/Concert.cpp \
     src/concerts/ConcertFileSearcher.cpp \
+    src/concerts/ConcertLoader.cpp \
     src/concerts/ConcertModel.cpp \
     src/concerts/ConcertProxyModel.cpp \
     src/data/Database.cpp \
@@ -159,6 +160,7 @@ SOURCES += src/main.cpp \
     src/movies/file_searcher/MovieDirectorySearcher.cpp \
     src/movies/MovieFilesOrganizer.cpp \
     src/movies/MovieImages.cpp \
+    src/movies/MovieMetadataCache.cpp \
     src/movies/MovieModel.cpp \
     src/movies/MovieProxyModel.cpp \
     src/data/Locale.cpp \
@@ -169,6 +171,7 @@ SOURCES += src/main.cpp \
     src/tv_shows/TvShow.cpp \
     src/tv_shows/TvShowEpisode.cpp \
     src/tv_shows/TvShowFileSearcher.cpp \
+    src/tv_shows/TvShowLoader.cpp \
     src/ui/export/CsvExportDialog.cpp \
     src/ui/imports/ImportActions.cpp \
     src/ui/imports/ImportDialog.cpp \
@@ -186,8 +189,12 @@ SOURCES += src/main.cpp \
     src/export/ExportTemplateLoader.cpp \
     src/export/MediaExport.cpp \
     src/export/SimpleEngine.cpp \
+    src/file/DirectoryFingerprint.cpp \
+    src/file/DirectorySnapshot.cpp \
+    src/file/DirectoryWalker.cpp \
     src/file/FileFilter.cpp \
     src/file/FilenameUtils.cpp \
+    src/file/LibraryWatcher.cpp \
     src/file/Path.cpp \
     src/data/Actor.cpp \
     src/globals/ComboDelegate.cpp \
@@ -198,6 +205,8 @@ SOURCES += src/main.cpp \
     src/globals/Helper.cpp \
     src/globals/ImageDialog.cpp \
     src/globals/ImagePreviewDialog.cpp \
+    src/globals/LibraryUpdater.cpp \
+    src/globals/LoaderThreadPool.cpp \
     src/globals/Manager.cpp \
     src/globals/MessageIds.cpp \
     src/globals/Math.cpp \
@@ -441,8 +450,10 @@ SOURCES += src/main.cpp \
     src/ui/media_centers/KodiSync.cpp \
     src/data/ImdbId.cpp \
     src/data/TmdbId.cpp \
+    src/data/TrigramIndex.cpp \
     src/tv_shows/TvDbId.cpp \
     src/tv_shows/TvMazeId.cpp \
+    src/tv_shows/EpisodeGuideRefresher.cpp \
     src/tv_shows/EpisodeNumber.cpp \
     src/tv_shows/SeasonNumber.cpp \
     src/tv_shows/SeasonOrder.cpp \
@@ -486,6 +497,7 @@ HEADERS  += Version.h \
     src/ui/concerts/ConcertInfoWidget.h \
     src/concerts/Concert.h \
     src/concerts/ConcertFileSearcher.h \
+    src/concerts/ConcertLoader.h \
     src/concerts/ConcertModel.h \
     src/concerts/ConcertProxyModel.h \
     src/ui/concerts/ConcertStreamDetailsWidget.h \
@@ -498,6 +510,7 @@ HEADERS  += Version.h \
     src/movies/file_searcher/MovieDirectorySearcher.h \
     src/movies/MovieFilesOrganizer.h \
     src/movies/MovieImages.h \
+    src/movies/MovieMetadataCache.h \
     src/movies/MovieModel.h \
     src/movies/MovieProxyModel.h \
     src/scrapers/image/ImageProvider.h \
@@ -515,6 +528,7 @@ HEADERS  += Version.h \
     src/tv_shows/TvShow.h \
     src/tv_shows/TvShowEpisode.h \
     src/tv_shows/TvShowFileSearcher.h \
+    src/tv_shows/TvShowLoader.h \
     src/imports/DownloadFileSearcher.h \
     src/imports/Extractor.h \
     src/imports/FileWorker.h \
@@ -532,8 +546,12 @@ HEADERS  += Version.h \
     src/export/ExportTemplateLoader.h \
     src/export/MediaExport.h \
     src/export/SimpleEngine.h \
+    src/file/DirectoryFingerprint.h \
+    src/file/DirectorySnapshot.h \
+    src/file/DirectoryWalker.h \
     src/file/FileFilter.h \
     src/file/FilenameUtils.h \
+    src/file/LibraryWatcher.h \
     src/file/Path.h \
     src/data/Actor.h \
     src/globals/ComboDelegate.h \
@@ -544,6 +562,8 @@ HEADERS  += Version.h \
     src/globals/Helper.h \
     src/globals/ImageDialog.h \
     src/globals/ImagePreviewDialog.h \
+    src/globals/LibraryUpdater.h \
+    src/globals/LoaderThreadPool.h \
     src/globals/LocaleStringCompare.h \
     src/globals/Manager.h \
     src/globals/MessageIds.h \
@@ -785,8 +805,10 @@ HEADERS  += Version.h \
     src/ui/media_centers/KodiSync.h \
     src/data/ImdbId.h \
     src/data/TmdbId.h \
+    src/data/TrigramIndex.h \
     src/tv_shows/TvDbId.h \
     src/tv_shows/TvMazeId.h \
+    src/tv_shows/EpisodeGuideRefresher.h \
     src/tv_shows/EpisodeNumber.h \
     src/tv_shows/SeasonNumber.h \
     src/tv_shows/SeasonOrder.h \
@@ -0,0 +1,85 @@
+#include "cli/database.h"
+
+#include "data/Database.h"
+#include "settings/Settings.h"
+
+#include <QFileInfo>
+#include <iostream>
+
+namespace mediaelch {
+namespace cli {
+
+enum class DatabaseCommand
+{
+    Compact,
+    Unknown
+};
+
+static DatabaseCommand databaseCommandFromString(QString str)
+{
+    if ("compact" == str) {
+        return DatabaseCommand::Compact;
+    }
+    return DatabaseCommand::Unknown;
+}
+
+/// \brief Size of the database file in MiB, including its write-ahead log.
+static double databaseSize(const QString& databaseFile)
+{
+    const qint64 bytes = QFileInfo(databaseFile).size() + QFileInfo(databaseFile + "-wal").size();
+    return static_cast<double>(bytes) / (1024. * 1024.);
+}
+
+static int compactDatabase(QCommandLineParser& parser, const QCommandLineOption& uncompressedOption)
+{
+    Database database;
+    if (parser.isSet(uncompressedOption)) {
+        database.setCompressContent(false);
+    }
+
+    const QString databaseFile = database.db().databaseName();
+    const double sizeBefore = databaseSize(databaseFile);
+    std::cout << "Compacting " << databaseFile.toStdString() << " ..." << std::endl;
+    database.compact();
+    const double sizeAfter = databaseSize(databaseFile);
+
+    std::cout << "Database size: " << sizeBefore << " MiB -> " << sizeAfter << " MiB" << std::endl;
+    return 0;
+}
+
+int database(QApplication& app, QCommandLineParser& parser)
+{
+    parser.clearPositionalArguments();
+    // re-add this command so that it appears when help is printed
+    parser.addPositionalArgument("database", "Maintain MediaElch's cache database.", "database [database_options]");
+    parser.addPositionalArgument("command",
+        "What to do. Can be:\n"
+        " - compact: Store all cached NFO files in the configured format (see\n"
+        "            <database><compressContent> in advancedsettings.xml)\n"
+        "            and shrink the database file.",
+        "<command>");
+
+    QCommandLineOption uncompressedOption(
+        "uncompressed", "Store cached NFO files uncompressed, regardless of advancedsettings.xml.");
+    parser.addOption(uncompressedOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QString command = args.size() < 2 ? QString() : args.at(1);
+
+    switch (databaseCommandFromString(command)) {
+    case DatabaseCommand::Compact: return compactDatabase(parser, uncompressedOption);
+    case DatabaseCommand::Unknown:
+        if (command.isEmpty()) {
+            std::cout << "Missing database <command>" << std::endl;
+        } else {
+            std::cout << "Unknown database <command>: " << command.toStdString() << std::endl;
+        }
+        return 1;
+    }
+
+    return 1;
+}
+
+} // namespace cli
+} // namespace mediaelch
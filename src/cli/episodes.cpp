@@ -0,0 +1,142 @@
+#include "cli/episodes.h"
+
+#include "globals/Manager.h"
+#include "scrapers/tv_show/tmdb/TmdbTv.h"
+#include "settings/Settings.h"
+#include "tv_shows/EpisodeGuideRefresher.h"
+#include "tv_shows/TvShow.h"
+
+#include <QEventLoop>
+#include <iostream>
+
+namespace mediaelch {
+namespace cli {
+
+enum class EpisodesCommand
+{
+    Refresh,
+    Unknown
+};
+
+static EpisodesCommand episodesCommandFromString(QString str)
+{
+    if ("refresh" == str) {
+        return EpisodesCommand::Refresh;
+    }
+    return EpisodesCommand::Unknown;
+}
+
+static QVector<TvShow*> loadTvShows()
+{
+    Manager::instance()->tvShowFileSearcher()->setTvShowDirectories(
+        Settings::instance()->directorySettings().tvShowDirectories());
+    // TV shows are loaded in a background thread.
+    QEventLoop loop;
+    QObject::connect(
+        Manager::instance()->tvShowFileSearcher(), &TvShowFileSearcher::tvShowsLoaded, &loop, &QEventLoop::quit);
+    Manager::instance()->tvShowFileSearcher()->reload(false);
+    loop.exec();
+    return Manager::instance()->tvShowModel()->tvShows();
+}
+
+static bool initializeTmdb(scraper::TmdbTv& tmdb)
+{
+    if (tmdb.isInitialized()) {
+        return true;
+    }
+    bool success = false;
+    QEventLoop loop;
+    QObject::connect(&tmdb, &scraper::TvScraper::initialized, &loop, [&loop, &success](bool wasSuccessful) {
+        success = wasSuccessful;
+        loop.quit();
+    });
+    tmdb.initialize();
+    loop.exec();
+    return success;
+}
+
+static int refreshEpisodeGuides(QCommandLineParser& parser,
+    const QCommandLineOption& forceOption,
+    const QCommandLineOption& allOption)
+{
+    auto* tmdb = dynamic_cast<scraper::TmdbTv*>(Manager::instance()->scrapers().tvScraper(scraper::TmdbTv::ID));
+    if (tmdb == nullptr) {
+        std::cerr << "TMDb TV scraper not available" << std::endl;
+        return 1;
+    }
+
+    // The global TvShowFilesWidget instance is set in its constructor...
+    // TODO: Don't implicitly expect that it is instantiated somewhere.
+    TvShowFilesWidget filesWidget;
+    QVector<TvShow*> shows;
+    for (TvShow* show : loadTvShows()) {
+        if (parser.isSet(allOption) || show->showMissingEpisodes()) {
+            shows.append(show);
+        }
+    }
+
+    if (!initializeTmdb(*tmdb)) {
+        std::cerr << "Could not connect to TMDb" << std::endl;
+        return 1;
+    }
+
+    EpisodeGuideRefresher::Config config;
+    config.maxAgeHours =
+        parser.isSet(forceOption) ? 0 : Settings::instance()->advanced()->episodeGuideRefreshInterval();
+    config.maxConcurrentRequests = Settings::instance()->advanced()->concurrentEpisodeGuideRequests();
+    EpisodeGuideRefresher refresher(tmdb, Manager::instance()->database(), config);
+
+    QEventLoop loop;
+    QObject::connect(&refresher, &EpisodeGuideRefresher::showRefreshed, [](TvShow* show) {
+        std::cout << "Refreshed: " << show->title().toStdString() << std::endl;
+    });
+    QObject::connect(&refresher, &EpisodeGuideRefresher::finished, &loop, &QEventLoop::quit);
+    refresher.refresh(shows);
+    loop.exec();
+
+    std::cout << "Episode guides refreshed: " << refresher.refreshedCount()
+              << ", skipped: " << refresher.skippedCount() << ", failed: " << refresher.failedCount() << std::endl;
+    return refresher.failedCount() > 0 ? 1 : 0;
+}
+
+int episodes(QApplication& app, QCommandLineParser& parser)
+{
+    parser.clearPositionalArguments();
+    // re-add this command so that it appears when help is printed
+    parser.addPositionalArgument(
+        "episodes", "Maintain the episode guides of TV shows.", "episodes [episodes_options]");
+    parser.addPositionalArgument("command",
+        "What to do. Can be:\n"
+        " - refresh: Load the episode guides (used for missing episodes) of all\n"
+        "            TV shows with a TMDb ID that show missing episodes from\n"
+        "            TMDb; use --all to include all other TV shows as well.\n"
+        "            Episode guides that are younger than\n"
+        "            <episodeGuides><refreshInterval> (see advancedsettings.xml)\n"
+        "            are skipped.",
+        "<command>");
+
+    QCommandLineOption forceOption("force", "Refresh all episode guides, regardless of their age.");
+    QCommandLineOption allOption("all", "Include TV shows that don't show missing episodes.");
+    parser.addOption(forceOption);
+    parser.addOption(allOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const QString command = args.size() < 2 ? QString() : args.at(1);
+
+    switch (episodesCommandFromString(command)) {
+    case EpisodesCommand::Refresh: return refreshEpisodeGuides(parser, forceOption, allOption);
+    case EpisodesCommand::Unknown:
+        if (command.isEmpty()) {
+            std::cout << "Missing episodes <command>" << std::endl;
+        } else {
+            std::cout << "Unknown episodes <command>: " << command.toStdString() << std::endl;
+        }
+        return 1;
+    }
+
+    return 1;
+}
+
+} // namespace cli
+} // namespace mediaelch
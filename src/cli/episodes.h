@@ -0,0 +1,14 @@
+#pragma once
+
+#include "cli/common.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+
+namespace mediaelch {
+namespace cli {
+
+int episodes(QApplication& app, QCommandLineParser& parser);
+
+} // namespace cli
+} // namespace mediaelch
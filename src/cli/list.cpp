@@ -11,6 +11,7 @@
 #include "music/Album.h"
 #include "settings/Settings.h"
 
+#include <QEventLoop>
 #include <iomanip>
 #include <iostream>
 
@@ -60,7 +61,11 @@ void listConcerts()
 {
     Manager::instance()->concertFileSearcher()->setConcertDirectories(
         Settings::instance()->directorySettings().concertDirectories());
+    QEventLoop loop;
+    QObject::connect(
+        Manager::instance()->concertFileSearcher(), &ConcertFileSearcher::concertsLoaded, &loop, &QEventLoop::quit);
     Manager::instance()->concertFileSearcher()->reload(false);
+    loop.exec();
     ConcertModel* concertModel = Manager::instance()->concertModel();
 
     TableLayout layout;
@@ -126,7 +131,12 @@ void listTvShows()
     // The global TvShowFilesWidget instance is set in its constructor...
     // TODO: Don't implicitly expect that it is instantiated somewhere.
     TvShowFilesWidget filesWidget;
+    // TV shows are loaded in a background thread.
+    QEventLoop loop;
+    QObject::connect(
+        Manager::instance()->tvShowFileSearcher(), &TvShowFileSearcher::tvShowsLoaded, &loop, &QEventLoop::quit);
     Manager::instance()->tvShowFileSearcher()->reload(false);
+    loop.exec();
     TvShowModel* tvShowModel = Manager::instance()->tvShowModel();
 
     TableLayout layout;
@@ -1,5 +1,7 @@
 #include "Version.h"
 #include "cli/common.h"
+#include "cli/database.h"
+#include "cli/episodes.h"
 #include "cli/info.h"
 #include "cli/list.h"
 #include "cli/reload.h"
@@ -29,6 +31,8 @@ enum class Command
     Sync,
     Settings,
     Info,
+    Database,
+    Episodes,
     Help,
     Version
 };
@@ -53,6 +57,12 @@ static Command commandFromString(const QString& command)
     if ("info" == command) {
         return Command::Info;
     }
+    if ("database" == command) {
+        return Command::Database;
+    }
+    if ("episodes" == command) {
+        return Command::Episodes;
+    }
     if ("settings" == command) {
         return Command::Settings;
     }
@@ -82,6 +92,8 @@ commands:
    sync        Sync MediaElch with Kodi. Uses parameters set in settings.
    settings    Get or set MediaElch's settings.
    info        Get various details about MediaElch.
+   database    Maintain MediaElch's cache database, e.g. `database compact`.
+   episodes    Maintain episode guides of TV shows, e.g. `episodes refresh`.
    help        Same as `--help`.
    version     Same as `--version`.
 )";
@@ -128,6 +140,8 @@ static int parseArguments(QApplication& app)
     case Command::Add: printUnsupported(command); return 1;
     case Command::Show: return mediaelch::cli::show(app, parser);
     case Command::Info: return mediaelch::cli::info(app, parser);
+    case Command::Database: return mediaelch::cli::database(app, parser);
+    case Command::Episodes: return mediaelch::cli::episodes(app, parser);
     case Command::Unknown:
         // do not process arguments so that we can show our custom help command
         if (command.isEmpty() && parser.isSet("help")) {
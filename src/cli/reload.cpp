@@ -3,6 +3,7 @@
 #include "globals/Manager.h"
 #include "movies/file_searcher/MovieFileSearcher.h"
 
+#include <QEventLoop>
 #include <iostream>
 
 namespace mediaelch {
@@ -23,7 +24,12 @@ void reloadTvShows()
     // The global TvShowFilesWidget instance is set in its constructor...
     // TODO: Don't implicitly expect that it is instantiated somewhere.
     TvShowFilesWidget filesWidget;
+    // TV shows are loaded in a background thread.
+    QEventLoop loop;
+    QObject::connect(
+        Manager::instance()->tvShowFileSearcher(), &TvShowFileSearcher::tvShowsLoaded, &loop, &QEventLoop::quit);
     Manager::instance()->tvShowFileSearcher()->reload(true);
+    loop.exec();
     std::cout << "Concerts reloaded." << std::endl;
 }
 
@@ -31,7 +37,12 @@ void reloadConcerts()
 {
     Manager::instance()->concertFileSearcher()->setConcertDirectories(
         Settings::instance()->directorySettings().concertDirectories());
+    // Concerts are loaded in a background thread.
+    QEventLoop loop;
+    QObject::connect(
+        Manager::instance()->concertFileSearcher(), &ConcertFileSearcher::concertsLoaded, &loop, &QEventLoop::quit);
     Manager::instance()->concertFileSearcher()->reload(true);
+    loop.exec();
     std::cout << "Concerts reloaded." << std::endl;
 }
 
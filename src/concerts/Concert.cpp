@@ -9,6 +9,7 @@
 #include <QApplication>
 #include <QDir>
 #include <QFileInfo>
+#include <atomic>
 
 using namespace std::chrono_literals;
 
@@ -28,7 +29,8 @@ Concert::Concert(const mediaelch::FileList& files, QObject* parent) :
     m_hasExtraFanarts{false}
 {
     moveToThread(QApplication::instance()->thread());
-    static int s_idCounter = 0;
+    // Concerts are also created by the ConcertLoader's thread.
+    static std::atomic_int s_idCounter{0};
     m_concert.concertId = ++s_idCounter;
     setFiles(files);
 }
@@ -1,14 +1,14 @@
 #include "ConcertFileSearcher.h"
 
-#include "globals/Helper.h"
+#include "concerts/ConcertLoader.h"
+#include "globals/LoaderThreadPool.h"
 #include "globals/Manager.h"
 #include "globals/MessageIds.h"
 #include "log/Log.h"
 
-#include <QApplication>
-#include <QRegularExpression>
-#include <QSqlQuery>
-#include <QSqlRecord>
+#include <QSet>
+#include <QThread>
+#include <algorithm>
 
 ConcertFileSearcher::ConcertFileSearcher(QObject* parent) :
     QObject(parent), m_progressMessageId{Constants::ConcertFileSearcherProgressMessageId}
@@ -37,150 +37,90 @@ void ConcertFileSearcher::setConcertDirectories(QVector<SettingsDir> directories
     }
 }
 
-/// Starts the scanning process
+/// Starts the scanning process in a background thread
 ///
 ///  1. Clear old concert entries if a reload is either forced here or in its settings
 ///  2. Reload all entries from disk if it's forced here or in its directory settings
-///  3. Load all entries from the database
+///  3. Load all other entries from the database
 void ConcertFileSearcher::reload(bool force)
 {
+    if (m_loader != nullptr) {
+        // Results of the running loader are outdated.
+        discardJob(m_loader, m_loaderStore);
+        m_loader = nullptr;
+        m_loaderStore = nullptr;
+    }
+    // The reload loads all concerts anyway.
+    discardUpdates();
     m_aborted = false;
 
     clearOldConcerts(force);
 
     emit searchStarted(tr("Searching for Concerts..."));
+    emit progress(0, 0, m_progressMessageId);
+
+    m_loaderStore = new mediaelch::ConcertLoaderStore(this);
+    m_loader = new mediaelch::ConcertLoader(m_directories, force, *m_loaderStore, nullptr);
+
+    connect(m_loader, &mediaelch::ConcertLoader::concertsLoaded, this, &ConcertFileSearcher::onConcertsLoaded);
+    connect(m_loader, &mediaelch::ConcertLoader::finished, this, &ConcertFileSearcher::onLoaderFinished);
+    connect(m_loader, &mediaelch::ConcertLoader::directoriesScanned, this, [this]() {
+        emit currentDir("");
+        emit searchStarted(tr("Loading Concerts..."));
+    });
+    connect(m_loader,
+        &mediaelch::ConcertLoader::progress,
+        this,
+        [this](mediaelch::ConcertLoader*, int processed, int total) {
+            emit progress(processed, total, m_progressMessageId);
+        });
+    connect(m_loader, &mediaelch::ConcertLoader::progressText, this, [this](mediaelch::ConcertLoader*, QString text) {
+        emit currentDir(text);
+    });
+    mediaelch::runInLoaderThread(m_loader);
+}
 
-    auto contents = loadContentsFromDiskIfRequired(force);
-    storeContentsInDatabase(contents);
-
-    emit currentDir("");
-    emit searchStarted(tr("Loading Concerts..."));
-
-    addConcertsToGui(loadConcertsFromDatabase());
-
-    qCDebug(generic) << "Searching for concerts done";
-    if (!m_aborted) {
-        emit concertsLoaded();
+void ConcertFileSearcher::onConcertsLoaded(mediaelch::ConcertLoader* job)
+{
+    if (job != m_loader || m_aborted) {
+        return;
+    }
+    const QVector<Concert*> concerts = m_loaderStore->takeAll(this);
+    for (Concert* concert : concerts) {
+        Manager::instance()->concertModel()->addConcert(concert);
     }
 }
 
-/**
- * \brief Scans the given path for concert files.
- * Results are in a list which contains a QStringList for every concert.
- * \param startPath Scanning started at this path
- * \param path Path to scan
- * \param contents List of contents
- * \param separateFolders Are concerts in separate folders
- * \param firstScan When this is true, subfolders are scanned, regardless of separateFolders
- */
-void ConcertFileSearcher::scanDir(QString startPath,
-    QString path,
-    QVector<QStringList>& contents,
-    bool separateFolders,
-    bool firstScan)
+void ConcertFileSearcher::onLoaderFinished(mediaelch::ConcertLoader* job)
 {
-    emit currentDir(path.mid(startPath.length()));
-
-    QDir dir(path);
-    const auto dirEntries = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& cDir : dirEntries) {
-        if (m_aborted) {
-            return;
-        }
-
-        if (Settings::instance()->advanced()->isFolderExcluded(cDir)) {
-            continue;
-        }
-
-        // Skip "Extras" folder
-        if (QString::compare(cDir, "Extras", Qt::CaseInsensitive) == 0
-            || QString::compare(cDir, ".actors", Qt::CaseInsensitive) == 0
-            || QString::compare(cDir, "extrafanarts", Qt::CaseInsensitive) == 0) {
-            continue;
-        }
-
-        // Handle DVD
-        if (helper::isDvd(path + QDir::separator() + cDir)) {
-            contents.append({QDir(path + "/" + cDir + "/VIDEO_TS/VIDEO_TS.IFO").path()});
-            continue;
-        }
-
-        // Handle BluRay
-        if (helper::isBluRay(path + QDir::separator() + cDir)) {
-            contents.append({QDir(path + "/" + cDir + "/BDMV/index.bdmv").path()});
-            continue;
-        }
-
-        // Don't scan subfolders when separate folders is checked
-        if (!separateFolders || firstScan) {
-            scanDir(startPath, path + "/" + cDir, contents, separateFolders);
-        }
+    if (job != m_loader) {
+        return;
     }
+    // Remaining concerts that were not published in a batch, if any.
+    onConcertsLoaded(job);
 
-    QStringList files;
-    const QStringList entries = getFiles(mediaelch::DirectoryPath(path));
-    for (const QString& file : entries) {
-        if (m_aborted) {
-            return;
-        }
+    job->deleteLater();
+    m_loaderStore->deleteLater();
+    m_loader = nullptr;
+    m_loaderStore = nullptr;
 
-        if (Settings::instance()->advanced()->isFileExcluded(file)) {
-            continue;
-        }
-
-        // Skip Trailers and Sample files
-        if (file.contains("-trailer", Qt::CaseInsensitive) || file.contains("-sample", Qt::CaseInsensitive)) {
-            continue;
-        }
-        files.append(file);
-    }
-    files.sort();
-
-    if (separateFolders) {
-        QStringList concertFiles;
-        for (const QString& file : files) {
-            concertFiles.append(QDir(path + "/" + file).path());
-        }
-        if (concertFiles.count() > 0) {
-            contents.append(concertFiles);
-        }
+    if (m_aborted) {
         return;
     }
 
-    QRegularExpression rx("((part|cd)[\\s_]*)(\\d+)");
-    rx.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
-    for (elch_size_t i = 0, n = files.size(); i < n; i++) {
-        if (m_aborted) {
-            return;
-        }
-
-        QStringList concertFiles;
-        QString file = files.at(i);
-        if (file.isEmpty()) {
-            continue;
-        }
+    qCDebug(generic) << "[ConcertFileSearcher] Searching for concerts done";
+    emit concertsLoaded();
+}
 
-        concertFiles << QDir(path + QDir::separator() + file).path();
-
-        QRegularExpressionMatch match = rx.match(file);
-        const elch_size_t pos = match.capturedStart();
-        if (pos != -1) {
-            QString left = file.left(pos) + match.captured(1);
-            QString right = file.mid(pos + match.captured(1).size() + match.captured(2).size());
-            for (int x = 0; x < n; x++) {
-                QString subFile = files.at(x);
-                if (subFile != file) {
-                    if (subFile.startsWith(left) && subFile.endsWith(right)) {
-                        concertFiles << QDir(path + QDir::separator() + subFile).path();
-                        files[x] = ""; // set an empty file name, this way we can skip this file in the main loop
-                    }
-                }
-            }
-        }
-        if (concertFiles.count() > 0) {
-            contents.append(concertFiles);
-        }
-    }
+void ConcertFileSearcher::discardJob(mediaelch::ConcertLoader* job, mediaelch::ConcertLoaderStore* store)
+{
+    disconnect(job, nullptr, this, nullptr);
+    // The loader still runs in its own thread. It must not be deleted before
+    // it has finished, because it still writes into its store.
+    connect(job, &mediaelch::ConcertLoader::finished, store, &mediaelch::ConcertLoaderStore::clear);
+    connect(job, &mediaelch::ConcertLoader::finished, store, &QObject::deleteLater);
+    connect(job, &mediaelch::ConcertLoader::finished, job, &QObject::deleteLater);
+    job->abort();
 }
 
 void ConcertFileSearcher::clearOldConcerts(bool forceClear)
@@ -199,108 +139,118 @@ void ConcertFileSearcher::clearOldConcerts(bool forceClear)
     }
 }
 
-QVector<QStringList> ConcertFileSearcher::loadContentsFromDiskIfRequired(bool forceReload)
+void ConcertFileSearcher::loadNewConcerts(const mediaelch::DirectoryPath& concertDir,
+    const QStringList& directories)
 {
-    QVector<QStringList> contents;
+    const auto dir = std::find_if(m_directories.cbegin(), m_directories.cend(), [&](const SettingsDir& d) {
+        return !d.disabled && mediaelch::DirectoryPath(d.path) == concertDir;
+    });
+    if (dir == m_directories.cend() || directories.isEmpty()) {
+        return;
+    }
+    if (m_loader != nullptr) {
+        // A complete reload is in progress which loads all concerts anyway.
+        qCDebug(generic) << "[ConcertFileSearcher] Ignoring changed directories while reloading:" << concertDir;
+        return;
+    }
 
-    for (const SettingsDir& dir : asConst(m_directories)) {
-        if (dir.disabled) {
-            continue;
-        }
-        const QString path = dir.path.path();
-        QVector<Concert*> concertsFromDb = database().concertsInDirectory(mediaelch::DirectoryPath(dir.path));
-        if (dir.autoReload || forceReload || concertsFromDb.isEmpty()) {
-            scanDir(path, path, contents, dir.separateFolders, true);
-        }
+    m_updateQueue.enqueue({*dir, directories});
+    if (m_updateJob == nullptr) {
+        startNextUpdate();
     }
-    return contents;
 }
 
-void ConcertFileSearcher::storeContentsInDatabase(const QVector<QStringList>& contents)
+void ConcertFileSearcher::startNextUpdate()
 {
-    // Setup concerts
-    database().transaction();
-    for (const QStringList& files : contents) {
-        if (m_aborted) {
-            return;
-        }
+    if (m_updateQueue.isEmpty()) {
+        return;
+    }
+    const DirectoryUpdate update = m_updateQueue.dequeue();
 
-        bool inSeparateFolder = false;
-        QString path;
-        // get directory
-        if (!files.isEmpty()) {
-            elch_size_t index = -1;
-            // Get a normalized path so that we can compare it to QPath().path().
-            // Otherwise we may still have a Windows-style path, e.g. "G:\Test"
-            // instead of "G:/Test". "files" should already be normalized, though.
-            const QString filePath = QDir(files.at(0)).path();
-            for (elch_size_t i = 0, n = m_directories.count(); i < n; ++i) {
-                if (filePath.startsWith(m_directories[i].path.path())) {
-                    if (index == -1) {
-                        index = i;
-                    } else if (m_directories[index].path.path().length() < m_directories[i].path.path().length()) {
-                        index = i;
-                    }
-                }
-            }
-            if (index != -1) {
-                inSeparateFolder = m_directories[index].separateFolders;
-                path = m_directories[index].path.path();
-            }
+    // Files of all concerts that are already loaded.  Files of the previous
+    // update are part of the model as well, see onUpdateJobFinished().
+    QSet<QString> knownFiles;
+    for (Concert* concert : Manager::instance()->concertModel()->concerts()) {
+        const QStringList files = concert->files().toStringList();
+        for (const QString& file : files) {
+            knownFiles.insert(file);
         }
-        Concert concert(files, this);
-        concert.setInSeparateFolder(inSeparateFolder);
-        concert.controller()->loadData(Manager::instance()->mediaCenterInterface());
-        emit currentDir(concert.title());
-        database().add(&concert, mediaelch::DirectoryPath(path));
     }
-    database().commit();
+
+    m_updateStore = new mediaelch::ConcertLoaderStore(this);
+    m_updateJob = new mediaelch::ConcertLoader({update.dir}, true, *m_updateStore, nullptr);
+    m_updateJob->setDirectoriesToScan(update.directories, knownFiles);
+
+    connect(m_updateJob, &mediaelch::ConcertLoader::finished, this, &ConcertFileSearcher::onUpdateJobFinished);
+    mediaelch::runInLoaderThread(m_updateJob, QThread::LowPriority);
 }
 
-void ConcertFileSearcher::setupDatabaseConcerts(const QVector<Concert*>& dbConcerts)
+void ConcertFileSearcher::onUpdateJobFinished(mediaelch::ConcertLoader* job)
 {
-    int concertCounter = 0;
-    for (Concert* concert : dbConcerts) {
-        if (m_aborted) {
-            break;
-        }
-        concert->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, false);
-        emit currentDir(concert->title());
-        emit progress(++concertCounter, qsizetype_to_int(dbConcerts.size()), m_progressMessageId);
+    if (job != m_updateJob) {
+        return;
     }
-}
+    job->deleteLater();
+    removeConcertsOfFiles(job->removedFiles());
 
-QVector<Concert*> ConcertFileSearcher::loadConcertsFromDatabase()
-{
-    QVector<Concert*> dbConcerts;
-    for (const SettingsDir& dir : asConst(m_directories)) {
-        if (m_aborted) {
-            break;
-        }
-        dbConcerts.append(database().concertsInDirectory(mediaelch::DirectoryPath(dir.path)));
+    const QVector<Concert*> concerts = m_updateStore->takeAll(this);
+    m_updateStore->deleteLater();
+    m_updateJob = nullptr;
+    m_updateStore = nullptr;
+
+    for (Concert* concert : concerts) {
+        Manager::instance()->concertModel()->addConcert(concert);
+        qCInfo(generic) << "[ConcertFileSearcher] Added new concert:" << concert->title();
     }
-    setupDatabaseConcerts(dbConcerts);
-    return dbConcerts;
+    startNextUpdate();
 }
 
-void ConcertFileSearcher::addConcertsToGui(const QVector<Concert*>& concerts)
+void ConcertFileSearcher::removeConcertsOfFiles(const QStringList& removedFiles)
 {
-    // add all entries from database including the previously stored ones
+    if (removedFiles.isEmpty()) {
+        return;
+    }
+    QSet<QString> removed;
+    for (const QString& file : removedFiles) {
+        removed.insert(file);
+    }
+
+    const QVector<Concert*> concerts = Manager::instance()->concertModel()->concerts();
     for (Concert* concert : concerts) {
-        Manager::instance()->concertModel()->addConcert(concert);
+        const QStringList files = concert->files().toStringList();
+        // Multi-part concerts are only removed if all of their files are gone.
+        const bool isRemoved = !files.isEmpty()
+                               && std::all_of(files.cbegin(), files.cend(), [&removed](const QString& file) {
+                                      return removed.contains(file);
+                                  });
+        if (isRemoved) {
+            qCInfo(generic) << "[ConcertFileSearcher] Removing concert whose files no longer exist:"
+                            << concert->title();
+            database().removeConcert(concert->databaseId());
+            Manager::instance()->concertModel()->removeConcert(concert);
+        }
     }
 }
 
-/// Get a list of files in a directory
-QStringList ConcertFileSearcher::getFiles(mediaelch::DirectoryPath path)
+void ConcertFileSearcher::discardUpdates()
 {
-    const auto& fileFilter = Settings::instance()->advanced()->concertFilters();
-    return fileFilter.files(path.dir());
+    m_updateQueue.clear();
+    if (m_updateJob != nullptr) {
+        discardJob(m_updateJob, m_updateStore);
+        m_updateJob = nullptr;
+        m_updateStore = nullptr;
+    }
 }
 
 void ConcertFileSearcher::abort()
 {
     m_aborted = true;
+    if (m_loader != nullptr) {
+        discardJob(m_loader, m_loaderStore);
+        m_loader = nullptr;
+        m_loaderStore = nullptr;
+    }
+    discardUpdates();
 }
 
 Database& ConcertFileSearcher::database()
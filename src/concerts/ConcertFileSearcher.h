@@ -3,10 +3,16 @@
 #include "data/Database.h"
 
 #include <QDir>
+#include <QQueue>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 
+namespace mediaelch {
+class ConcertLoader;
+class ConcertLoaderStore;
+} // namespace mediaelch
+
 class ConcertFileSearcher : public QObject
 {
     Q_OBJECT
@@ -15,8 +21,16 @@ public:
     void setConcertDirectories(QVector<SettingsDir> directories);
 
 public slots:
+    /// \brief   Reload all concerts in a background thread.
+    /// \details Concerts are added to the ConcertModel while they are loaded.
+    ///          concertsLoaded() is emitted once all concerts are loaded.
     void reload(bool force);
     void abort();
+    /// \brief   Load new concerts of the given directories that changed on disk.
+    /// \details Only the given directories are listed (not recursively) in a background
+    ///          thread.  Files that already belong to a concert are skipped.  Concerts
+    ///          whose files were removed are removed.  concertsLoaded() is not emitted.
+    void loadNewConcerts(const mediaelch::DirectoryPath& concertDir, const QStringList& directories);
 
 signals:
     void searchStarted(QString);
@@ -24,28 +38,42 @@ signals:
     void concertsLoaded();
     void currentDir(QString);
 
+private slots:
+    void onConcertsLoaded(mediaelch::ConcertLoader* job);
+    void onLoaderFinished(mediaelch::ConcertLoader* job);
+    void onUpdateJobFinished(mediaelch::ConcertLoader* job);
+
 private:
     QVector<SettingsDir> m_directories;
     int m_progressMessageId;
     bool m_aborted = false;
 
+    /// \brief Currently running loader of reload(), if any.
+    mediaelch::ConcertLoader* m_loader = nullptr;
+    mediaelch::ConcertLoaderStore* m_loaderStore = nullptr;
+
+    /// \brief Changed directories that are scanned for new concerts, see loadNewConcerts().
+    struct DirectoryUpdate
+    {
+        SettingsDir dir;
+        QStringList directories;
+    };
+    /// \brief Updates run one after another, so that each one knows the concerts of
+    ///        all previous ones.
+    QQueue<DirectoryUpdate> m_updateQueue;
+    mediaelch::ConcertLoader* m_updateJob = nullptr;
+    mediaelch::ConcertLoaderStore* m_updateStore = nullptr;
+
 private:
     Database& database();
 
     void clearOldConcerts(bool forceClear);
-
-    QVector<QStringList> loadContentsFromDiskIfRequired(bool forceReload);
-    QVector<Concert*> loadConcertsFromDatabase();
-
-    void storeContentsInDatabase(const QVector<QStringList>& contents);
-    void setupDatabaseConcerts(const QVector<Concert*>& concerts);
-    void addConcertsToGui(const QVector<Concert*>& concerts);
-
-    void scanDir(QString startPath,
-        QString path,
-        QVector<QStringList>& contents,
-        bool separateFolders = false,
-        bool firstScan = false);
-
-    QStringList getFiles(mediaelch::DirectoryPath path);
+    /// \brief Start the next queued update of changed directories, if any.
+    void startNextUpdate();
+    /// \brief Remove concerts whose files no longer exist from the model and the database.
+    void removeConcertsOfFiles(const QStringList& removedFiles);
+    /// \brief Abort the queued and running updates.
+    void discardUpdates();
+    /// \brief Abort the given loader and delete it and its store once it has finished.
+    void discardJob(mediaelch::ConcertLoader* job, mediaelch::ConcertLoaderStore* store);
 };
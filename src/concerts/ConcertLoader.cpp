@@ -0,0 +1,447 @@
+#include "concerts/ConcertLoader.h"
+
+#include "concerts/Concert.h"
+#include "data/Database.h"
+#include "file/DirectoryWalker.h"
+#include "file/LibraryWatcher.h"
+#include "globals/Helper.h"
+#include "globals/Manager.h"
+#include "log/Log.h"
+#include "settings/Settings.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+/// \brief Loaded concerts are published as soon as this many concerts are available...
+constexpr int CONCERT_BATCH_SIZE = 20;
+/// \brief ...or after this many milliseconds, whichever comes first.
+constexpr qint64 CONCERT_BATCH_INTERVAL_MS = 200;
+
+bool isDvdDirectoryName(const QString& name)
+{
+    return QString::compare(name, "VIDEO_TS", Qt::CaseInsensitive) == 0
+           || QString::compare(name, "VIDEO TS", Qt::CaseInsensitive) == 0;
+}
+
+bool isBluRayDirectoryName(const QString& name)
+{
+    return QString::compare(name, "BDMV", Qt::CaseInsensitive) == 0;
+}
+
+} // namespace
+
+namespace mediaelch {
+
+void ConcertLoaderStore::addConcerts(const QVector<Concert*>& concerts)
+{
+    // Note: Concerts move themselves to the GUI thread on construction, see Concert::Concert().
+    QMutexLocker locker(&m_lock);
+    m_concerts.append(concerts);
+}
+
+QVector<Concert*> ConcertLoaderStore::takeAll(QObject* parent)
+{
+    QMutexLocker locker(&m_lock);
+    QVector<Concert*> concerts = std::move(m_concerts);
+    m_concerts = {};
+    locker.unlock();
+
+    for (Concert* concert : asConst(concerts)) {
+        concert->setParent(parent);
+    }
+    return concerts;
+}
+
+void ConcertLoaderStore::clear()
+{
+    QMutexLocker locker(&m_lock);
+    qDeleteAll(m_concerts);
+    m_concerts.clear();
+}
+
+ConcertLoader::ConcertLoader(QVector<SettingsDir> directories,
+    bool forceReload,
+    ConcertLoaderStore& store,
+    QObject* parent) :
+    QObject(parent), m_directories{std::move(directories)}, m_forceReload{forceReload}, m_store{&store}
+{
+}
+
+ConcertLoader::~ConcertLoader()
+{
+    qDeleteAll(m_concerts);
+    m_concerts.clear();
+}
+
+void ConcertLoader::start()
+{
+    qCInfo(generic) << "[ConcertLoader] Loading concerts, reload from disk:" << m_forceReload;
+
+    // Database connections must be used by the thread that created them.
+    std::unique_ptr<Database> db(Database::newConnection(nullptr));
+    m_db = db.get();
+
+    emit progress(this, 0, 0);
+    emit progressText(this, "");
+
+    QVector<Concert*> dbConcerts;
+    const QVector<QStringList> contents =
+        m_directoriesToScan.isEmpty() ? readConcertContents(dbConcerts) : readChangedConcertContents();
+    if (!m_directoriesToScan.isEmpty() && !isAborted()) {
+        m_removedFiles = LibraryWatcher::removedFiles(m_knownFiles, m_directoriesToScan);
+    }
+    if (isAborted()) {
+        qDeleteAll(dbConcerts);
+        m_db = nullptr;
+        emit finished(this);
+        return;
+    }
+
+    emit progressText(this, "");
+    emit directoriesScanned(this);
+
+    m_processed = 0;
+    m_total = qsizetype_to_int(contents.size() + dbConcerts.size());
+    emit progress(this, m_processed, m_total);
+
+    m_batchTimer.start();
+    setupConcerts(contents);
+    setupConcertsFromDatabase(dbConcerts);
+
+    publishConcerts();
+    m_db = nullptr;
+
+    qCDebug(generic) << "[ConcertLoader] Loading concerts done";
+    emit progressText(this, "");
+    emit finished(this);
+}
+
+void ConcertLoader::abort()
+{
+    m_aborted.store(true);
+}
+
+void ConcertLoader::scanDirectory(const SettingsDir& dir,
+    QVector<QStringList>& contents,
+    const std::function<bool()>& isAborted,
+    const std::function<void(const QString&)>& onDirectory)
+{
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
+    const QString startPath = dir.path.path();
+    const QString rootPath = QDir::cleanPath(startPath);
+
+    // Directories that contain a DVD or BluRay structure and the disc's main file.
+    // They are found while their parent is listed, i.e. without listing each directory again.
+    QHash<QString, QString> discs;
+    // Disc directories and all directories inside them.  Their files belong to the disc.
+    QSet<QString> discDirectories;
+
+    const auto shouldEnter = [&](const QFileInfo& subDir) {
+        if (isAborted()) {
+            return false;
+        }
+
+        const QString cDir = subDir.fileName();
+        // Handle DVD
+        if (isDvdDirectoryName(cDir)) {
+            const QString ifo = subDir.filePath() + "/VIDEO_TS.IFO";
+            if (QFileInfo::exists(ifo)) {
+                discs.insert(QDir::cleanPath(subDir.path()), ifo);
+            }
+            return false;
+        }
+        // Handle BluRay
+        if (isBluRayDirectoryName(cDir)) {
+            const QString index = subDir.filePath() + "/index.bdmv";
+            if (QFileInfo::exists(index)) {
+                discs.insert(QDir::cleanPath(subDir.path()), index);
+            }
+            return false;
+        }
+
+        if (advanced->isFolderExcluded(cDir)) {
+            return false;
+        }
+
+        // Skip "Extras" folder
+        if (QString::compare(cDir, "Extras", Qt::CaseInsensitive) == 0
+            || QString::compare(cDir, ".actors", Qt::CaseInsensitive) == 0
+            || QString::compare(cDir, "extrafanarts", Qt::CaseInsensitive) == 0) {
+            return false;
+        }
+
+        // Don't scan subfolders when separate folders is checked
+        if (!dir.separateFolders || QDir::cleanPath(subDir.path()) == rootPath) {
+            return true;
+        }
+        // ...but discs in those subfolders are concerts as well.
+        if (helper::isDvd(subDir.filePath())) {
+            contents.append({QDir(subDir.filePath() + "/VIDEO_TS/VIDEO_TS.IFO").path()});
+        } else if (helper::isBluRay(subDir.filePath())) {
+            contents.append({QDir(subDir.filePath() + "/BDMV/index.bdmv").path()});
+        }
+        return false;
+    };
+
+    DirectoryWalker walker(advanced->concertFilters(), shouldEnter);
+    walker.setIncludeSystemFiles(true);
+    walker.walk(startPath, [&](const QFileInfo& current, const QFileInfoList& entries) {
+        if (isAborted()) {
+            return false;
+        }
+        const QString path = current.filePath();
+        onDirectory(path.mid(startPath.length()));
+
+        const QString cleanPath = QDir::cleanPath(path);
+        if (discDirectories.contains(QDir::cleanPath(current.path()))) {
+            discDirectories.insert(cleanPath);
+            return true;
+        }
+        const auto disc = discs.constFind(cleanPath);
+        if (disc != discs.constEnd()) {
+            contents.append({QDir(disc.value()).path()});
+            discDirectories.insert(cleanPath);
+            return true;
+        }
+
+        QStringList files;
+        for (const QFileInfo& entry : entries) {
+            const QString file = entry.fileName();
+            if (advanced->isFileExcluded(file)) {
+                continue;
+            }
+            // Skip Trailers and Sample files
+            if (file.contains("-trailer", Qt::CaseInsensitive) || file.contains("-sample", Qt::CaseInsensitive)) {
+                continue;
+            }
+            files.append(file);
+        }
+        addConcertFiles(path, files, contents, dir.separateFolders);
+        return !isAborted();
+    });
+}
+
+void ConcertLoader::addConcertFiles(const QString& path,
+    QStringList files,
+    QVector<QStringList>& contents,
+    bool separateFolders)
+{
+    files.sort();
+
+    if (separateFolders) {
+        QStringList concertFiles;
+        for (const QString& file : asConst(files)) {
+            concertFiles.append(QDir(path + "/" + file).path());
+        }
+        if (concertFiles.count() > 0) {
+            contents.append(concertFiles);
+        }
+        return;
+    }
+
+    static const QRegularExpression rx("((?:part|cd)[\\s_]*)(\\d+)", QRegularExpression::CaseInsensitiveOption);
+    // Index in contents for each multi-part file name without its part number.
+    QHash<QString, elch_size_t> multiPartConcerts;
+    for (const QString& file : asConst(files)) {
+        const QString filePath = QDir(path + "/" + file).path();
+
+        const QRegularExpressionMatch match = rx.match(file);
+        if (match.hasMatch()) {
+            const QString name = file.left(match.capturedEnd(1)) + '/' + file.mid(match.capturedEnd(2));
+            const auto concert = multiPartConcerts.constFind(name);
+            if (concert != multiPartConcerts.constEnd()) {
+                contents[concert.value()].append(filePath);
+                continue;
+            }
+            multiPartConcerts.insert(name, contents.size());
+        }
+        contents.append({filePath});
+    }
+}
+
+QVector<QStringList> ConcertLoader::readConcertContents(QVector<Concert*>& dbConcerts)
+{
+    QVector<QStringList> contents;
+    for (const SettingsDir& dir : asConst(m_directories)) {
+        if (isAborted()) {
+            break;
+        }
+        if (dir.disabled) {
+            continue;
+        }
+        // If there are no concerts in the database for the directory, reload
+        // all concerts regardless of forceReload.
+        if (!dir.autoReload && !m_forceReload) {
+            // Concerts are handed over to the GUI thread by the store, i.e. they must not have a parent.
+            const QVector<Concert*> concerts = m_db->concertsInDirectory(DirectoryPath(dir.path), nullptr);
+            if (!concerts.isEmpty()) {
+                dbConcerts.append(concerts);
+                continue;
+            }
+        }
+        scanDirectory(
+            dir,
+            contents,
+            [this]() { return isAborted(); },
+            [this](const QString& directory) { emit progressText(this, directory); });
+    }
+    return contents;
+}
+
+QVector<QStringList> ConcertLoader::readChangedConcertContents()
+{
+    QVector<QStringList> contents;
+    if (m_directories.size() != 1) {
+        qCWarning(generic) << "[ConcertLoader] Changed directories require exactly one concert directory";
+        return contents;
+    }
+
+    const SettingsDir& dir = m_directories.first();
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
+    const QString rootPath = QDir::cleanPath(dir.path.path());
+
+    QVector<QStringList> changedContents;
+    for (const QString& directory : asConst(m_directoriesToScan)) {
+        if (isAborted()) {
+            break;
+        }
+        const QString relativePath = directory.mid(rootPath.length() + 1);
+        const QStringList relativeDirs = relativePath.split('/', ElchSplitBehavior::SkipEmptyParts);
+        // Same as scanDirectory(): With separate folders, only direct subfolders contain concerts.
+        if (dir.separateFolders && relativeDirs.size() > 1) {
+            continue;
+        }
+        // Contents of DVDs and BluRays are handled by their parent directory.
+        const bool isDiscStructure = std::any_of(relativeDirs.cbegin(), relativeDirs.cend(), [](const QString& d) {
+            return isDvdDirectoryName(d) || isBluRayDirectoryName(d);
+        });
+        if (isDiscStructure) {
+            continue;
+        }
+        emit progressText(this, directory.mid(rootPath.length()));
+        if (helper::isDvd(directory)) {
+            changedContents.append({QDir(directory + "/VIDEO_TS/VIDEO_TS.IFO").path()});
+            continue;
+        }
+        if (helper::isBluRay(directory)) {
+            changedContents.append({QDir(directory + "/BDMV/index.bdmv").path()});
+            continue;
+        }
+
+        QStringList files;
+        const QStringList entries =
+            QDir(directory).entryList(advanced->concertFilters().filters(), QDir::Files | QDir::System);
+        for (const QString& file : entries) {
+            if (advanced->isFileExcluded(file) || file.contains("-trailer", Qt::CaseInsensitive)
+                || file.contains("-sample", Qt::CaseInsensitive)) {
+                continue;
+            }
+            files.append(file);
+        }
+        addConcertFiles(directory, files, changedContents, dir.separateFolders);
+    }
+
+    for (const QStringList& files : asConst(changedContents)) {
+        const bool isKnown = std::any_of(files.cbegin(), files.cend(), [this](const QString& file) {
+            return m_knownFiles.contains(QFileInfo(file).absoluteFilePath());
+        });
+        if (!isKnown) {
+            contents.append(files);
+        }
+    }
+    return contents;
+}
+
+void ConcertLoader::setupConcerts(const QVector<QStringList>& contents)
+{
+    m_db->transaction();
+    for (const QStringList& files : contents) {
+        if (isAborted()) {
+            break;
+        }
+
+        // Get a normalized path so that we can compare it to QPath().path().
+        // Otherwise we may still have a Windows-style path, e.g. "G:\Test"
+        // instead of "G:/Test". "files" should already be normalized, though.
+        const SettingsDir* dir = files.isEmpty() ? nullptr : concertDirectory(QDir(files.first()).path());
+
+        auto* concert = new Concert(files, nullptr);
+        concert->setInSeparateFolder(dir != nullptr && dir->separateFolders);
+        concert->controller()->loadData(Manager::instance()->mediaCenterInterface());
+        m_db->add(concert, DirectoryPath(dir != nullptr ? dir->path.path() : QString()));
+
+        ++m_processed;
+        emit progressText(this, concert->title());
+        emit progress(this, m_processed, m_total);
+
+        m_concerts.append(concert);
+        if (m_concerts.size() >= CONCERT_BATCH_SIZE || m_batchTimer.elapsed() >= CONCERT_BATCH_INTERVAL_MS) {
+            // Concerts are only published once they are stored.
+            m_db->commit();
+            publishConcerts();
+            m_db->transaction();
+        }
+    }
+    m_db->commit();
+    publishConcerts();
+}
+
+void ConcertLoader::setupConcertsFromDatabase(QVector<Concert*>& dbConcerts)
+{
+    for (elch_size_t i = 0; i < dbConcerts.size(); ++i) {
+        if (isAborted()) {
+            // Concerts that were not published yet are not used anymore.
+            qDeleteAll(dbConcerts.mid(i));
+            return;
+        }
+
+        Concert* concert = dbConcerts.at(i);
+        concert->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, false);
+
+        ++m_processed;
+        emit progressText(this, concert->title());
+        emit progress(this, m_processed, m_total);
+        addConcert(concert);
+    }
+}
+
+const SettingsDir* ConcertLoader::concertDirectory(const QString& filePath) const
+{
+    const SettingsDir* result = nullptr;
+    for (const SettingsDir& dir : m_directories) {
+        if (filePath.startsWith(dir.path.path())
+            && (result == nullptr || result->path.path().length() < dir.path.path().length())) {
+            result = &dir;
+        }
+    }
+    return result;
+}
+
+void ConcertLoader::addConcert(Concert* concert)
+{
+    m_concerts.append(concert);
+    if (m_concerts.size() >= CONCERT_BATCH_SIZE || m_batchTimer.elapsed() >= CONCERT_BATCH_INTERVAL_MS) {
+        publishConcerts();
+    }
+}
+
+void ConcertLoader::publishConcerts()
+{
+    m_batchTimer.restart();
+    if (m_concerts.isEmpty() || isAborted()) {
+        return;
+    }
+    m_store->addConcerts(m_concerts);
+    m_concerts.clear();
+    emit concertsLoaded(this);
+}
+
+} // namespace mediaelch
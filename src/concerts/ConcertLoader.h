@@ -0,0 +1,146 @@
+#pragma once
+
+#include "globals/Globals.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+class Concert;
+class Database;
+
+namespace mediaelch {
+
+/// \brief   Thread safe store for concerts.
+/// \details The ConcertLoader moves its loaded concerts into a store.
+class ConcertLoaderStore : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ConcertLoaderStore(QObject* parent = nullptr) : QObject(parent) {}
+    ~ConcertLoaderStore() override = default;
+
+    void addConcerts(const QVector<Concert*>& concerts);
+
+    QVector<Concert*> takeAll(QObject* parent);
+    /// \brief Clear and delete all stored concerts.
+    void clear();
+
+private:
+    QVector<Concert*> m_concerts;
+    QMutex m_lock;
+};
+
+/// \brief   Loads all concerts of the given concert directories.
+/// \details Directories that are reloaded are scanned and their concerts are stored
+///          in the database.  Concerts of all other directories are read from the
+///          database.  The loader is meant to run in its own thread, see
+///          runInLoaderThread().  Loaded concerts are published
+///          in batches using the ConcertLoaderStore.
+class ConcertLoader : public QObject
+{
+    Q_OBJECT
+public:
+    ConcertLoader(QVector<SettingsDir> directories,
+        bool forceReload,
+        ConcertLoaderStore& store,
+        QObject* parent = nullptr);
+    ~ConcertLoader() override;
+
+    /// \brief   Only scan the given directories (not recursively) for new concerts.
+    /// \details Files in \p knownFiles already belong to a concert and are skipped.
+    ///          Used to load concerts of directories that changed on disk.  Requires
+    ///          exactly one concert directory.  Must be set before start() is called.
+    void setDirectoriesToScan(QStringList directories, QSet<QString> knownFiles)
+    {
+        m_directoriesToScan = std::move(directories);
+        m_knownFiles = std::move(knownFiles);
+    }
+    /// \brief Known files of the scanned directories that no longer exist.  Valid once finished.
+    const QStringList& removedFiles() const { return m_removedFiles; }
+
+    void start();
+    /// \brief   Thread-safe way to abort the ConcertLoader.
+    /// \details The finished() signal is still emitted.
+    void abort();
+    /// \brief Thread-safe way to check whether the ConcertLoader was aborted.
+    bool isAborted() const { return m_aborted.load(); }
+
+    /// \brief   Scans the given concert directory for concert files.
+    /// \details Results are in a list which contains a QStringList for every concert.
+    ///          DVD and BluRay structures are detected by their VIDEO_TS and BDMV
+    ///          directories while listing their parent directory.
+    /// \param dir Concert directory to scan. If concerts are in separate folders,
+    ///        only direct subfolders are scanned.
+    /// \param contents List of contents
+    /// \param isAborted Scanning stops as soon as this function returns true.
+    /// \param onDirectory Called for each scanned directory with its path relative to dir.
+    static void scanDirectory(const SettingsDir& dir,
+        QVector<QStringList>& contents,
+        const std::function<bool()>& isAborted,
+        const std::function<void(const QString&)>& onDirectory);
+
+    /// \brief   Group the given files of one directory into concerts.
+    /// \details Multi-part files, e.g. "concert-cd1.mkv" and "concert-cd2.mkv",
+    ///          belong to the same concert.  If concerts are in separate folders,
+    ///          all files are one concert.
+    static void addConcertFiles(const QString& path,
+        QStringList files,
+        QVector<QStringList>& contents,
+        bool separateFolders);
+
+signals:
+    void progress(mediaelch::ConcertLoader* job, int processed, int total);
+    /// \brief   A string representing the current loading state.
+    /// \details For example the currently scanned directory or the loaded concert.
+    void progressText(mediaelch::ConcertLoader* job, QString text);
+    /// \brief All directories were scanned; concerts are loaded now.
+    void directoriesScanned(mediaelch::ConcertLoader* job);
+    /// \brief   New concerts were added to the ConcertLoaderStore.
+    /// \details Concerts are published in batches while the loader is still running.
+    void concertsLoaded(mediaelch::ConcertLoader* job);
+    void finished(mediaelch::ConcertLoader* job);
+
+private:
+    /// \brief   Scan all directories that have to be reloaded from disk.
+    /// \details Concerts of all other directories are read from the database into dbConcerts.
+    QVector<QStringList> readConcertContents(QVector<Concert*>& dbConcerts);
+    /// \brief New concerts of m_directoriesToScan, see setDirectoriesToScan().
+    QVector<QStringList> readChangedConcertContents();
+    void setupConcerts(const QVector<QStringList>& contents);
+    void setupConcertsFromDatabase(QVector<Concert*>& dbConcerts);
+    /// \brief The concert directory that contains the given file or a nullptr.
+    const SettingsDir* concertDirectory(const QString& filePath) const;
+
+    /// \brief Add the concert to the current batch and publish the batch if it is large enough.
+    void addConcert(Concert* concert);
+    /// \brief Move all concerts of the current batch into the store.  Emits concertsLoaded().
+    void publishConcerts();
+
+private:
+    QVector<SettingsDir> m_directories;
+    bool m_forceReload = false;
+    QStringList m_directoriesToScan;
+    QSet<QString> m_knownFiles;
+    QStringList m_removedFiles;
+    ConcertLoaderStore* m_store = nullptr;
+    /// \brief Connection of the loader's thread; only valid while start() runs.
+    Database* m_db = nullptr;
+    std::atomic_bool m_aborted{false};
+
+    int m_processed = 0;
+    int m_total = 0;
+
+    /// \brief Concerts that are not yet published.
+    QVector<Concert*> m_concerts;
+    QElapsedTimer m_batchTimer;
+};
+
+} // namespace mediaelch
@@ -30,6 +30,18 @@ void ConcertModel::addConcert(Concert* concert)
     connect(concert, &Concert::sigChanged, this, &ConcertModel::onConcertChanged, Qt::UniqueConnection);
 }
 
+void ConcertModel::removeConcert(Concert* concert)
+{
+    const int row = qsizetype_to_int(m_concerts.indexOf(concert));
+    if (row < 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    m_concerts.removeAt(row);
+    concert->deleteLater();
+    endRemoveRows();
+}
+
 /**
  * \brief Called when a concerts data has changed
  * Emits dataChanged
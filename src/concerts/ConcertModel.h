@@ -19,6 +19,8 @@ public:
     };
     explicit ConcertModel(QObject* parent = nullptr);
     void addConcert(Concert* concert);
+    /// \brief Remove the concert from the model.  The concert is deleted later.
+    void removeConcert(Concert* concert);
     void clear();
     QVector<Concert*> concerts();
     Concert* concert(int row);
@@ -9,6 +9,7 @@
 #include "media_centers/KodiXml.h"
 #include "media_centers/kodi/EpisodeXmlWriter.h"
 #include "movies/Movie.h"
+#include "movies/MovieMetadataCache.h"
 #include "music/Album.h"
 #include "music/Artist.h"
 #include "settings/Settings.h"
@@ -18,25 +19,151 @@
 #include <QDir>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QSet>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QSqlRecord>
+#include <QThread>
+#include <algorithm>
 
 using namespace mediaelch;
 
-/// \brief This mutex is used for initializing new connections.
+namespace {
+
+/// \brief An open connection that is currently not used by any Database object.
+struct IdleConnection
+{
+    QThread* thread = nullptr;
+    QString databaseFile;
+    QString connectionName;
+};
+
+} // namespace
+
+/// \brief This mutex is used for initializing new connections and guards the connection pool.
 static QMutex s_initializingDatabaseMutex;
 /// \brief Used for creating a new connection name.
 static size_t s_connectionCount = 0;
+/// \brief Database files whose schema was already set up by this process.
+static QSet<QString> s_initializedDatabases;
+/// \brief Connections that can be reused by new Database objects of the same thread.
+static QVector<IdleConnection> s_idleConnections;
+/// \brief Threads whose idle connections are closed when the thread finishes.
+static QSet<QThread*> s_watchedThreads;
+/// \brief Maximum number of idle connections that are kept open per thread.
+static constexpr int MAX_IDLE_CONNECTIONS_PER_THREAD = 2;
+/// \brief Maximum number of host parameters per SQL statement in SQLite versions before 3.32.
+static constexpr int MAX_SQL_VARIABLES = 999;
+/// \brief Maximum number of rows per multi-row INSERT statement.
+static constexpr int MAX_ROWS_PER_INSERT = 64;
+/// \brief Prefix of compressed NFO contents, followed by qCompress()'ed UTF-8.
+/// \details Starts with a null byte so that it can't be mistaken for uncompressed
+///          contents.  The last byte is the format version.
+static const QByteArray COMPRESSED_CONTENT_MARKER("\0MEZ\1", 5);
+
+/// \brief Decode NFO contents that were stored using Database::encodeContent().
+/// \details Uncompressed contents of older versions are returned as they are.
+static QString decodeContent(const QByteArray& data)
+{
+    if (!data.startsWith(COMPRESSED_CONTENT_MARKER)) {
+        return QString::fromUtf8(data);
+    }
+    const QByteArray content = qUncompress(data.mid(COMPRESSED_CONTENT_MARKER.size()));
+    if (content.isEmpty()) {
+        qCWarning(generic) << "[Database] Could not uncompress cached NFO content";
+    }
+    return QString::fromUtf8(content);
+}
+
+Database::Database(QObject* parent) : Database(Settings::instance()->databaseDir(), parent)
+{
+    m_compressContent = Settings::instance()->advanced()->compressDatabaseContent();
+}
+
+/// \brief Close the given connection and remove it from Qt's connection list.
+static void closeConnection(const QString& connectionName)
+{
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+/// \brief Close all idle connections of the given thread.
+/// \note Must be called from the given thread while holding s_initializingDatabaseMutex.
+static void closeIdleConnections(QThread* thread)
+{
+    for (elch_size_t i = s_idleConnections.size() - 1; i >= 0; --i) {
+        if (s_idleConnections.at(i).thread == thread) {
+            closeConnection(s_idleConnections.at(i).connectionName);
+            s_idleConnections.removeAt(i);
+        }
+    }
+    s_watchedThreads.remove(thread);
+}
+
+/// \brief Take an idle connection of the given thread to the given database file.
+/// \returns The connection name or an empty string if there is no idle connection.
+static QString takeIdleConnection(QThread* thread, const QString& databaseFile)
+{
+    for (elch_size_t i = 0; i < s_idleConnections.size(); ++i) {
+        const IdleConnection& connection = s_idleConnections.at(i);
+        if (connection.thread == thread && connection.databaseFile == databaseFile) {
+            const QString connectionName = connection.connectionName;
+            s_idleConnections.removeAt(i);
+            return connectionName;
+        }
+    }
+    return {};
+}
 
-Database::Database(QObject* parent) : QObject(parent)
+/// \brief Keep the connection open so that it can be reused by the given thread.
+/// \details If the thread already has enough idle connections, its oldest one is closed.
+/// \note Must be called from the given thread while holding s_initializingDatabaseMutex.
+static void releaseConnection(QThread* thread, const QString& databaseFile, const QString& connectionName)
+{
+    const auto isIdleInThread = [thread](const IdleConnection& connection) { return connection.thread == thread; };
+    if (std::count_if(s_idleConnections.cbegin(), s_idleConnections.cend(), isIdleInThread)
+        >= MAX_IDLE_CONNECTIONS_PER_THREAD) {
+        const auto oldest = std::find_if(s_idleConnections.begin(), s_idleConnections.end(), isIdleInThread);
+        closeConnection(oldest->connectionName);
+        s_idleConnections.erase(oldest);
+    }
+
+    if (!s_watchedThreads.contains(thread)) {
+        s_watchedThreads.insert(thread);
+        // Connections can only be used and closed by the thread that opened them.
+        // QThread::finished is emitted by the finishing thread itself.
+        QObject::connect(
+            thread,
+            &QThread::finished,
+            thread,
+            [thread]() {
+                QMutexLocker lock(&s_initializingDatabaseMutex);
+                closeIdleConnections(thread);
+            },
+            Qt::DirectConnection);
+    }
+    s_idleConnections.append(IdleConnection{thread, databaseFile, connectionName});
+}
+
+Database::Database(DirectoryPath dataLocation, QObject* parent) :
+    QObject(parent), m_dataLocation(std::move(dataLocation)), m_thread(QThread::currentThread())
 {
     // This lock is required to ensure that multithreaded access only initializes
     // the database once.  Each instance of this class has its own connection name.
     QMutexLocker lock(&s_initializingDatabaseMutex);
+    const QString databaseFile = m_dataLocation.filePath("MediaElch.sqlite");
+
+    const QString idleConnection = takeIdleConnection(m_thread, databaseFile);
+    if (!idleConnection.isEmpty()) {
+        m_db = new QSqlDatabase(QSqlDatabase::database(idleConnection, false));
+        return;
+    }
+
     ++s_connectionCount;
 
-    m_dataLocation = Settings::instance()->databaseDir();
     QDir dir(m_dataLocation.dir());
     if (!dir.exists()) {
         dir.mkpath(m_dataLocation.toString());
@@ -44,21 +171,42 @@ Database::Database(QObject* parent) : QObject(parent)
 
     QString connectionName = QStringLiteral("mediaDb_%1").arg(s_connectionCount);
     m_db = new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", connectionName));
-    m_db->setDatabaseName(m_dataLocation.filePath("MediaElch.sqlite"));
+    m_db->setDatabaseName(databaseFile);
     if (!m_db->open()) {
         qCWarning(generic) << "Could not open cache database";
-    } else {
+        return;
+    }
+
+    if (!s_initializedDatabases.contains(databaseFile)) {
         setupDatabase();
+        s_initializedDatabases.insert(databaseFile);
     }
+    setupConnection();
 }
 
 Database::~Database()
 {
-    if (m_db != nullptr && m_db->isOpen()) {
-        m_db->close();
+    // Prepared statements must be destroyed before the connection is closed or reused.
+    qDeleteAll(m_queries);
+    m_queries.clear();
+    if (m_db == nullptr) {
+        return;
     }
+
+    const QString connectionName = m_db->connectionName();
+    const QString databaseFile = m_db->databaseName();
+    const bool isOpen = m_db->isOpen();
     delete m_db;
     m_db = nullptr;
+
+    QMutexLocker lock(&s_initializingDatabaseMutex);
+    // Connections must not be used by other threads, i.e. only keep them if
+    // this object is destroyed in the thread that created it.
+    if (isOpen && m_thread == QThread::currentThread()) {
+        releaseConnection(m_thread, databaseFile, connectionName);
+    } else {
+        closeConnection(connectionName);
+    }
 }
 
 Database* Database::newConnection(QObject* parent)
@@ -66,6 +214,134 @@ Database* Database::newConnection(QObject* parent)
     return new Database(parent);
 }
 
+QSqlQuery& Database::preparedQuery(const QString& sql)
+{
+    auto it = m_queries.find(sql);
+    if (it == m_queries.end()) {
+        auto* query = new QSqlQuery(db());
+        if (!query->prepare(sql)) {
+            qCWarning(generic) << "[Database] Could not prepare query:" << query->lastError().text();
+        }
+        it = m_queries.insert(sql, query);
+    }
+    return *it.value();
+}
+
+void Database::setCompressContent(bool compress)
+{
+    m_compressContent = compress;
+}
+
+QVariant Database::encodeContent(const QString& content) const
+{
+    if (content.isEmpty()) {
+        return QStringLiteral("");
+    }
+    if (!m_compressContent) {
+        return content.toUtf8();
+    }
+    return QByteArray(COMPRESSED_CONTENT_MARKER + qCompress(content.toUtf8()));
+}
+
+void Database::compact()
+{
+    const QVector<QPair<QString, QString>> tables{
+        {"movies", "idMovie"}, {"episodes", "idEpisode"}, {"shows", "idShow"}, {"concerts", "idConcert"}};
+
+    transaction();
+    for (const auto& table : tables) {
+        QSqlQuery select(db());
+        select.setForwardOnly(true);
+        select.prepare(QStringLiteral("SELECT %1, content FROM %2").arg(table.second, table.first));
+        select.exec();
+        QSqlQuery update(db());
+        update.prepare(QStringLiteral("UPDATE %2 SET content=:content WHERE %1=:id").arg(table.second, table.first));
+
+        int rewritten = 0;
+        while (select.next()) {
+            const QByteArray stored = select.value(1).toByteArray();
+            const QVariant encoded = encodeContent(decodeContent(stored));
+            if (encoded.toByteArray() == stored) {
+                continue;
+            }
+            update.bindValue(":content", encoded);
+            update.bindValue(":id", select.value(0));
+            update.exec();
+            ++rewritten;
+        }
+        qCInfo(generic) << "[Database] Rewrote" << rewritten << "entries of table" << table.first;
+    }
+    commit();
+
+    // VACUUM can't be run inside a transaction.  Afterwards, the write-ahead log
+    // contains the whole database and is truncated as well.
+    QSqlQuery query(db());
+    if (!query.exec("VACUUM;")) {
+        qCWarning(generic) << "[Database] Could not compact the database:" << query.lastError().text();
+    }
+    query.exec("PRAGMA wal_checkpoint(TRUNCATE);");
+}
+
+/// \brief   Number of rows for the next statement of a chunked operation.
+/// \details Only statements for a power of two rows are used, so that only a few
+///          statements per table need to be prepared and cached.
+static int chunkSize(int remaining, int maxRows)
+{
+    int count = 1;
+    while (count * 2 <= qMin(maxRows, remaining)) {
+        count *= 2;
+    }
+    return count;
+}
+
+void Database::insertRows(const QString& table, const QStringList& columns, const QVector<QVariantList>& rows)
+{
+    const int columnCount = qsizetype_to_int(columns.size());
+    const int maxRows = qMin(MAX_ROWS_PER_INSERT, MAX_SQL_VARIABLES / columnCount);
+    const QString rowPlaceholder = QStringLiteral("(?%1)").arg(QStringLiteral(", ?").repeated(columnCount - 1));
+
+    int offset = 0;
+    const int total = qsizetype_to_int(rows.size());
+    while (offset < total) {
+        const int count = chunkSize(total - offset, maxRows);
+        QStringList placeholders;
+        for (int i = 0; i < count; ++i) {
+            placeholders << rowPlaceholder;
+        }
+        QSqlQuery& query = preparedQuery(QStringLiteral("INSERT INTO %1(%2) VALUES %3")
+                                             .arg(table, columns.join(", "), placeholders.join(", ")));
+        int index = 0;
+        for (int row = offset; row < offset + count; ++row) {
+            for (const QVariant& value : rows.at(row)) {
+                query.bindValue(index++, value);
+            }
+        }
+        if (!query.exec()) {
+            qCWarning(generic) << "[Database] Could not insert rows into" << table << query.lastError().text();
+        }
+        offset += count;
+    }
+}
+
+void Database::deleteRows(const QString& table, const QString& column, const QVariantList& values)
+{
+    int offset = 0;
+    const int total = qsizetype_to_int(values.size());
+    while (offset < total) {
+        const int count = chunkSize(total - offset, MAX_SQL_VARIABLES);
+        const QString placeholders = QStringLiteral("?%1").arg(QStringLiteral(", ?").repeated(count - 1));
+        QSqlQuery& query =
+            preparedQuery(QStringLiteral("DELETE FROM %1 WHERE %2 IN (%3)").arg(table, column, placeholders));
+        for (int i = 0; i < count; ++i) {
+            query.bindValue(i, values.at(offset + i));
+        }
+        if (!query.exec()) {
+            qCWarning(generic) << "[Database] Could not delete rows from" << table << query.lastError().text();
+        }
+        offset += count;
+    }
+}
+
 void Database::updateDbVersion(int version)
 {
     QSqlQuery query(*m_db);
@@ -126,6 +402,8 @@ void Database::clearAllMovies()
     query.exec();
     query.prepare("DELETE FROM sqlite_sequence WHERE name='movieSubtitles'");
     query.exec();
+    query.prepare("DELETE FROM movieDirectories");
+    query.exec();
 }
 
 void Database::clearMoviesInDirectory(DirectoryPath path)
@@ -140,106 +418,156 @@ void Database::clearMoviesInDirectory(DirectoryPath path)
     query.prepare("DELETE FROM movies WHERE path=:path");
     query.bindValue(":path", path.toString().toUtf8());
     query.exec();
+    query.prepare("DELETE FROM movieDirectories WHERE path=:path");
+    query.bindValue(":path", path.toString().toUtf8());
+    query.exec();
 }
 
-void Database::addMovie(Movie* movie, DirectoryPath path)
+/// \brief Rows for the movieFiles table.
+static void appendMovieFileRows(QVector<QVariantList>& rows, const Movie& movie, int idMovie)
 {
-    QSqlQuery query(db());
-    query.prepare("INSERT INTO movies(content, lastModified, inSeparateFolder, hasPoster, hasBackdrop, hasLogo, "
-                  "hasClearArt, hasCdArt, hasBanner, hasThumb, hasExtraFanarts, discType, path) "
-                  "VALUES(:content, :lastModified, :inSeparateFolder, :hasPoster, :hasBackdrop, :hasLogo, "
-                  ":hasClearArt, :hasCdArt, :hasBanner, :hasThumb, :hasExtraFanarts, :discType, :path)");
-    query.bindValue(":content", movie->nfoContent().isEmpty() ? "" : movie->nfoContent().toUtf8());
-    query.bindValue(
-        ":lastModified", movie->fileLastModified().isNull() ? QDateTime::currentDateTime() : movie->fileLastModified());
-    query.bindValue(":inSeparateFolder", (movie->inSeparateFolder() ? 1 : 0));
-    query.bindValue(":hasPoster", movie->hasImage(ImageType::MoviePoster) ? 1 : 0);
-    query.bindValue(":hasBackdrop", movie->hasImage(ImageType::MovieBackdrop) ? 1 : 0);
-    query.bindValue(":hasLogo", movie->hasImage(ImageType::MovieLogo) ? 1 : 0);
-    query.bindValue(":hasClearArt", movie->hasImage(ImageType::MovieClearArt) ? 1 : 0);
-    query.bindValue(":hasCdArt", movie->hasImage(ImageType::MovieCdArt) ? 1 : 0);
-    query.bindValue(":hasBanner", movie->hasImage(ImageType::MovieBanner) ? 1 : 0);
-    query.bindValue(":hasThumb", movie->hasImage(ImageType::MovieThumb) ? 1 : 0);
-    query.bindValue(":hasExtraFanarts", movie->images().hasExtraFanarts() ? 1 : 0);
-    query.bindValue(":discType", static_cast<int>(movie->discType()));
-    query.bindValue(":path", path.toString().toUtf8());
-    query.exec();
-    int insertId = query.lastInsertId().toInt();
+    for (const mediaelch::FilePath& file : movie.files()) {
+        rows.append(QVariantList{idMovie, file.toString().toUtf8()});
+    }
+}
 
-    for (const mediaelch::FilePath& file : movie->files()) {
-        query.prepare("INSERT INTO movieFiles(idMovie, file) VALUES(:idMovie, :file)");
-        query.bindValue(":idMovie", insertId);
-        query.bindValue(":file", file.toString().toUtf8());
-        query.exec();
+/// \brief Rows for the movieSubtitles table.
+static void appendMovieSubtitleRows(QVector<QVariantList>& rows, const Movie& movie, int idMovie)
+{
+    for (const Subtitle* subtitle : movie.subtitles()) {
+        rows.append(QVariantList{idMovie,
+            subtitle->files().join("%§%"),
+            subtitle->language().isEmpty() ? "" : subtitle->language(),
+            subtitle->forced() ? 1 : 0});
     }
+}
 
-    for (const Subtitle* subtitle : movie->subtitles()) {
-        query.prepare("INSERT INTO movieSubtitles(idMovie, files, language, forced) VALUES(:idMovie, :files, "
-                      ":language, :forced)");
-        query.bindValue(":idMovie", insertId);
-        query.bindValue(":files", subtitle->files().join("%§%"));
-        query.bindValue(":language", subtitle->language().isEmpty() ? "" : subtitle->language());
-        query.bindValue(":forced", subtitle->forced() ? 1 : 0);
+void Database::addMovie(Movie* movie, DirectoryPath path)
+{
+    addMovies({movie}, std::move(path));
+}
+
+void Database::addMovies(const QVector<Movie*>& movies, DirectoryPath path)
+{
+    QSqlQuery& query =
+        preparedQuery("INSERT INTO movies(content, metadata, lastModified, inSeparateFolder, hasPoster, hasBackdrop, "
+                      "hasLogo, hasClearArt, hasCdArt, hasBanner, hasThumb, hasExtraFanarts, discType, path) "
+                      "VALUES(:content, :metadata, :lastModified, :inSeparateFolder, :hasPoster, :hasBackdrop, "
+                      ":hasLogo, :hasClearArt, :hasCdArt, :hasBanner, :hasThumb, :hasExtraFanarts, :discType, :path)");
+    const QByteArray pathUtf8 = path.toString().toUtf8();
+
+    QVector<QVariantList> fileRows;
+    QVector<QVariantList> subtitleRows;
+    QHash<QString, ColorLabel> labels;
+    for (Movie* movie : movies) {
+        query.bindValue(":content", encodeContent(movie->nfoContent()));
+        query.bindValue(":metadata", MovieMetadataCache::serialize(*movie));
+        query.bindValue(":lastModified",
+            movie->fileLastModified().isNull() ? QDateTime::currentDateTime() : movie->fileLastModified());
+        query.bindValue(":inSeparateFolder", (movie->inSeparateFolder() ? 1 : 0));
+        query.bindValue(":hasPoster", movie->hasImage(ImageType::MoviePoster) ? 1 : 0);
+        query.bindValue(":hasBackdrop", movie->hasImage(ImageType::MovieBackdrop) ? 1 : 0);
+        query.bindValue(":hasLogo", movie->hasImage(ImageType::MovieLogo) ? 1 : 0);
+        query.bindValue(":hasClearArt", movie->hasImage(ImageType::MovieClearArt) ? 1 : 0);
+        query.bindValue(":hasCdArt", movie->hasImage(ImageType::MovieCdArt) ? 1 : 0);
+        query.bindValue(":hasBanner", movie->hasImage(ImageType::MovieBanner) ? 1 : 0);
+        query.bindValue(":hasThumb", movie->hasImage(ImageType::MovieThumb) ? 1 : 0);
+        query.bindValue(":hasExtraFanarts", movie->images().hasExtraFanarts() ? 1 : 0);
+        query.bindValue(":discType", static_cast<int>(movie->discType()));
+        query.bindValue(":path", pathUtf8);
         query.exec();
-    }
+        const int insertId = query.lastInsertId().toInt();
 
-    setLabel(movie->files(), movie->label());
+        appendMovieFileRows(fileRows, *movie, insertId);
+        appendMovieSubtitleRows(subtitleRows, *movie, insertId);
+        for (const mediaelch::FilePath& file : movie->files()) {
+            labels.insert(file.toString(), movie->label());
+        }
+        movie->setDatabaseId(insertId);
+    }
+    setLabels(labels);
 
-    movie->setDatabaseId(insertId);
+    insertRows("movieFiles", {"idMovie", "file"}, fileRows);
+    insertRows("movieSubtitles", {"idMovie", "files", "language", "forced"}, subtitleRows);
 }
 
-void Database::update(Movie* movie)
+void Database::removeMovie(int idMovie)
 {
     QSqlQuery query(db());
-    query.prepare("UPDATE movies SET content=:content WHERE idMovie=:idMovie");
-    query.bindValue(":content", movie->nfoContent().isEmpty() ? "" : movie->nfoContent());
-    query.bindValue(":idMovie", movie->databaseId());
-    query.exec();
-
     query.prepare("DELETE FROM movieFiles WHERE idMovie=:idMovie");
-    query.bindValue(":idMovie", movie->databaseId());
+    query.bindValue(":idMovie", idMovie);
     query.exec();
-    for (const mediaelch::FilePath& file : movie->files()) {
-        query.prepare("INSERT INTO movieFiles(idMovie, file) VALUES(:idMovie, :file)");
-        query.bindValue(":idMovie", movie->databaseId());
-        query.bindValue(":file", file.toString().toUtf8());
-        query.exec();
-    }
-
     query.prepare("DELETE FROM movieSubtitles WHERE idMovie=:idMovie");
+    query.bindValue(":idMovie", idMovie);
+    query.exec();
+    query.prepare("DELETE FROM movies WHERE idMovie=:idMovie");
+    query.bindValue(":idMovie", idMovie);
+    query.exec();
+}
+
+void Database::update(Movie* movie)
+{
+    QSqlQuery& query = preparedQuery("UPDATE movies SET content=:content, metadata=:metadata WHERE idMovie=:idMovie");
+    query.bindValue(":content", encodeContent(movie->nfoContent()));
+    query.bindValue(":metadata", MovieMetadataCache::serialize(*movie));
     query.bindValue(":idMovie", movie->databaseId());
     query.exec();
-    for (const Subtitle* subtitle : movie->subtitles()) {
-        query.prepare("INSERT INTO movieSubtitles(idMovie, files, language, forced) VALUES(:idMovie, :files, "
-                      ":language, :forced)");
-        query.bindValue(":idMovie", movie->databaseId());
-        query.bindValue(":files", subtitle->files().join("%§%"));
-        query.bindValue(":language", subtitle->language().isEmpty() ? "" : subtitle->language());
-        query.bindValue(":forced", subtitle->forced() ? 1 : 0);
-        query.exec();
-    }
+
+    QSqlQuery& deleteFiles = preparedQuery("DELETE FROM movieFiles WHERE idMovie=:idMovie");
+    deleteFiles.bindValue(":idMovie", movie->databaseId());
+    deleteFiles.exec();
+    QVector<QVariantList> fileRows;
+    appendMovieFileRows(fileRows, *movie, movie->databaseId());
+    insertRows("movieFiles", {"idMovie", "file"}, fileRows);
+
+    QSqlQuery& deleteSubtitles = preparedQuery("DELETE FROM movieSubtitles WHERE idMovie=:idMovie");
+    deleteSubtitles.bindValue(":idMovie", movie->databaseId());
+    deleteSubtitles.exec();
+    QVector<QVariantList> subtitleRows;
+    appendMovieSubtitleRows(subtitleRows, *movie, movie->databaseId());
+    insertRows("movieSubtitles", {"idMovie", "files", "language", "forced"}, subtitleRows);
 }
 
 QVector<Movie*> Database::moviesInDirectory(DirectoryPath path, QObject* movieParent)
 {
     transaction();
     QSqlQuery query(db());
-    query.prepare("SELECT M.idMovie, M.content, M.lastModified, M.inSeparateFolder, M.hasPoster, M.hasBackdrop, "
-                  "M.hasLogo, M.hasClearArt, "
-                  "M.hasCdArt, M.hasBanner, M.hasThumb, M.hasExtraFanarts, M.discType, MF.file, L.color "
+    query.prepare("SELECT M.idMovie, M.content, M.metadata, M.lastModified, M.inSeparateFolder, M.hasPoster, "
+                  "M.hasBackdrop, M.hasLogo, M.hasClearArt, "
+                  "M.hasCdArt, M.hasBanner, M.hasThumb, M.hasExtraFanarts, M.discType, MF.file "
                   "FROM movies M "
                   "LEFT JOIN movieFiles MF ON MF.idMovie=M.idMovie "
-                  "LEFT JOIN labels L ON MF.file=L.fileName "
-                  "WHERE path=:path "
+                  "WHERE M.path=:path "
                   "ORDER BY M.idMovie, MF.file");
-    query.bindValue(":path", path.toString().toUtf8());
-    query.exec();
+    const QByteArray pathUtf8 = path.toString().toUtf8();
+    query.bindValue(":path", pathUtf8);
+    query.exec();
+
+    const QSqlRecord record = query.record();
+    const int idMovieIndex = record.indexOf("idMovie");
+    const int contentIndex = record.indexOf("content");
+    const int metadataIndex = record.indexOf("metadata");
+    const int lastModifiedIndex = record.indexOf("lastModified");
+    const int inSeparateFolderIndex = record.indexOf("inSeparateFolder");
+    const int hasPosterIndex = record.indexOf("hasPoster");
+    const int hasBackdropIndex = record.indexOf("hasBackdrop");
+    const int hasLogoIndex = record.indexOf("hasLogo");
+    const int hasClearArtIndex = record.indexOf("hasClearArt");
+    const int hasCdArtIndex = record.indexOf("hasCdArt");
+    const int hasBannerIndex = record.indexOf("hasBanner");
+    const int hasThumbIndex = record.indexOf("hasThumb");
+    const int hasExtraFanartsIndex = record.indexOf("hasExtraFanarts");
+    const int discTypeIndex = record.indexOf("discType");
+    const int fileIndex = record.indexOf("file");
 
     QMap<int, Movie*> movies;
+    // NFO content and cached metadata; restored once all files of a movie are known.
+    QHash<Movie*, QPair<QByteArray, QByteArray>> contents;
     while (query.next()) {
+        const int idMovie = query.value(idMovieIndex).toInt();
         Movie* movie = nullptr;
-        if (movies.contains(query.value(query.record().indexOf("idMovie")).toInt())) {
-            movie = movies.value(query.value(query.record().indexOf("idMovie")).toInt());
+        if (movies.contains(idMovie)) {
+            movie = movies.value(idMovie);
             if (movie == nullptr) {
                 // This *must* not happen because we just inserted it.
                 qCCritical(generic) << "[Database] Movie is undefined but should exist!";
@@ -247,50 +575,76 @@ QVector<Movie*> Database::moviesInDirectory(DirectoryPath path, QObject* moviePa
             }
 
         } else {
-            ColorLabel label = static_cast<ColorLabel>(query.value(query.record().indexOf("color")).toInt());
             movie = new Movie(QStringList(), movieParent);
-            movie->setDatabaseId(query.value(query.record().indexOf("idMovie")).toInt());
-            movie->setFileLastModified(query.value(query.record().indexOf("lastModified")).toDateTime());
-            movie->setInSeparateFolder(query.value(query.record().indexOf("inSeparateFolder")).toInt() == 1);
-            movie->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
-            movie->images().setHasImage(
-                ImageType::MoviePoster, query.value(query.record().indexOf("hasPoster")).toInt() == 1);
-            movie->images().setHasImage(
-                ImageType::MovieBackdrop, query.value(query.record().indexOf("hasBackdrop")).toInt() == 1);
-            movie->images().setHasImage(
-                ImageType::MovieLogo, query.value(query.record().indexOf("hasLogo")).toInt() == 1);
-            movie->images().setHasImage(
-                ImageType::MovieClearArt, query.value(query.record().indexOf("hasClearArt")).toInt() == 1);
-            movie->images().setHasImage(
-                ImageType::MovieCdArt, query.value(query.record().indexOf("hasCdArt")).toInt() == 1);
-            movie->images().setHasImage(
-                ImageType::MovieBanner, query.value(query.record().indexOf("hasBanner")).toInt() == 1);
-            movie->images().setHasImage(
-                ImageType::MovieThumb, query.value(query.record().indexOf("hasThumb")).toInt() == 1);
-            movie->images().setHasExtraFanarts(query.value(query.record().indexOf("hasExtraFanarts")).toInt() == 1);
-            movie->setDiscType(static_cast<DiscType>(query.value(query.record().indexOf("discType")).toInt()));
-            movie->setLabel(label);
+            movie->setDatabaseId(idMovie);
+            movie->setFileLastModified(query.value(lastModifiedIndex).toDateTime());
+            movie->setInSeparateFolder(query.value(inSeparateFolderIndex).toInt() == 1);
+            contents.insert(movie, {query.value(contentIndex).toByteArray(), query.value(metadataIndex).toByteArray()});
+            movie->images().setHasImage(ImageType::MoviePoster, query.value(hasPosterIndex).toInt() == 1);
+            movie->images().setHasImage(ImageType::MovieBackdrop, query.value(hasBackdropIndex).toInt() == 1);
+            movie->images().setHasImage(ImageType::MovieLogo, query.value(hasLogoIndex).toInt() == 1);
+            movie->images().setHasImage(ImageType::MovieClearArt, query.value(hasClearArtIndex).toInt() == 1);
+            movie->images().setHasImage(ImageType::MovieCdArt, query.value(hasCdArtIndex).toInt() == 1);
+            movie->images().setHasImage(ImageType::MovieBanner, query.value(hasBannerIndex).toInt() == 1);
+            movie->images().setHasImage(ImageType::MovieThumb, query.value(hasThumbIndex).toInt() == 1);
+            movie->images().setHasExtraFanarts(query.value(hasExtraFanartsIndex).toInt() == 1);
+            movie->setDiscType(static_cast<DiscType>(query.value(discTypeIndex).toInt()));
             movie->setChanged(false);
-            movies.insert(query.value(query.record().indexOf("idMovie")).toInt(), movie);
+            movies.insert(idMovie, movie);
         }
 
         mediaelch::FileList files = movie->files();
-        files << mediaelch::FilePath(query.value(query.record().indexOf("file")).toByteArray());
+        files << mediaelch::FilePath(query.value(fileIndex).toByteArray());
         movie->setFiles(files);
     }
 
-    query.prepare("SELECT idMovie, files, language, forced FROM movieSubtitles");
+    for (auto it = contents.cbegin(); it != contents.cend(); ++it) {
+        // The NFO content is kept even if the cached metadata is restored: It is used if the
+        // movie is reloaded without reading the NFO file and it is stored again by update().
+        it.key()->setNfoContent(decodeContent(it.value().first));
+        // The NFO content only needs to be parsed if there is no up-to-date cached metadata.
+        // Must happen after setFiles(), which resets the stream details.
+        MovieMetadataCache::deserialize(it.value().second, *it.key());
+    }
+    contents.clear();
+
+    // Labels and subtitles are only loaded for movies in the requested directory.
+    // A movie's label is the label of its first file, see getLabel().
+    query.prepare("SELECT MF.idMovie, MF.file, L.color "
+                  "FROM movies M "
+                  "JOIN movieFiles MF ON MF.idMovie=M.idMovie "
+                  "JOIN labels L ON L.fileName=MF.file "
+                  "WHERE M.path=:path");
+    query.bindValue(":path", pathUtf8);
     query.exec();
     while (query.next()) {
-        int movieId = query.value(query.record().indexOf("idMovie")).toInt();
-        Movie* movie = movies.value(movieId, nullptr);
+        Movie* movie = movies.value(query.value(0).toInt(), nullptr);
+        if (movie != nullptr && !movie->files().isEmpty()
+            && movie->files().first() == mediaelch::FilePath(query.value(1).toByteArray())) {
+            movie->setLabel(static_cast<ColorLabel>(query.value(2).toInt()));
+        }
+    }
+
+    query.prepare("SELECT S.idMovie, S.files, S.language, S.forced "
+                  "FROM movies M "
+                  "JOIN movieSubtitles S ON S.idMovie=M.idMovie "
+                  "WHERE M.path=:path");
+    query.bindValue(":path", pathUtf8);
+    query.exec();
+    const QSqlRecord subtitleRecord = query.record();
+    const int subtitleIdMovieIndex = subtitleRecord.indexOf("idMovie");
+    const int subtitleFilesIndex = subtitleRecord.indexOf("files");
+    const int subtitleLanguageIndex = subtitleRecord.indexOf("language");
+    const int subtitleForcedIndex = subtitleRecord.indexOf("forced");
+    while (query.next()) {
+        Movie* movie = movies.value(query.value(subtitleIdMovieIndex).toInt(), nullptr);
         if (movie == nullptr) {
             continue;
         }
         auto* subtitle = new Subtitle(movie);
-        subtitle->setForced(query.value(query.record().indexOf("forced")).toInt() == 1);
-        subtitle->setLanguage(query.value(query.record().indexOf("language")).toString());
-        subtitle->setFiles(query.value(query.record().indexOf("files")).toString().split("%§%"));
+        subtitle->setForced(query.value(subtitleForcedIndex).toInt() == 1);
+        subtitle->setLanguage(query.value(subtitleLanguageIndex).toString());
+        subtitle->setFiles(query.value(subtitleFilesIndex).toString().split("%§%"));
         subtitle->setChanged(false);
         movie->addSubtitle(subtitle, true);
     }
@@ -300,6 +654,94 @@ QVector<Movie*> Database::moviesInDirectory(DirectoryPath path, QObject* moviePa
     return movies.values().toVector();
 }
 
+QHash<QString, DirectoryFingerprint> Database::movieDirectoryFingerprints(DirectoryPath path)
+{
+    QHash<QString, DirectoryFingerprint> fingerprints;
+    QSqlQuery query(db());
+    query.prepare("SELECT dir, lastModified, entryCount FROM movieDirectories WHERE path=:path");
+    query.bindValue(":path", path.toString().toUtf8());
+    query.exec();
+    while (query.next()) {
+        DirectoryFingerprint fingerprint;
+        fingerprint.lastModified = query.value(1).toLongLong();
+        fingerprint.entryCount = query.value(2).toInt();
+        fingerprints.insert(QString::fromUtf8(query.value(0).toByteArray()), fingerprint);
+    }
+    return fingerprints;
+}
+
+void Database::setMovieDirectoryFingerprints(DirectoryPath path,
+    const QHash<QString, DirectoryFingerprint>& fingerprints)
+{
+    QSqlQuery query(db());
+    query.prepare("DELETE FROM movieDirectories WHERE path=:path");
+    query.bindValue(":path", path.toString().toUtf8());
+    query.exec();
+
+    QVector<QVariantList> rows;
+    rows.reserve(fingerprints.size());
+    for (auto it = fingerprints.cbegin(); it != fingerprints.cend(); ++it) {
+        rows.append({it.key().toUtf8(), it.value().lastModified, it.value().entryCount, path.toString().toUtf8()});
+    }
+    insertRows("movieDirectories", {"dir", "lastModified", "entryCount", "path"}, rows);
+}
+
+QVector<DirectoryPath> Database::movieLibraryPaths()
+{
+    QVector<DirectoryPath> paths;
+    QSqlQuery query(db());
+    query.prepare("SELECT path FROM movies UNION SELECT path FROM movieDirectories");
+    query.exec();
+    while (query.next()) {
+        paths.append(DirectoryPath(QString::fromUtf8(query.value(0).toByteArray())));
+    }
+    return paths;
+}
+
+QHash<QString, DirectoryFingerprint> Database::tvShowDirectoryFingerprints(DirectoryPath path)
+{
+    QHash<QString, DirectoryFingerprint> fingerprints;
+    QSqlQuery query(db());
+    query.prepare("SELECT dir, lastModified, entryCount FROM tvShowDirectories WHERE path=:path");
+    query.bindValue(":path", path.toString().toUtf8());
+    query.exec();
+    while (query.next()) {
+        DirectoryFingerprint fingerprint;
+        fingerprint.lastModified = query.value(1).toLongLong();
+        fingerprint.entryCount = query.value(2).toInt();
+        fingerprints.insert(QString::fromUtf8(query.value(0).toByteArray()), fingerprint);
+    }
+    return fingerprints;
+}
+
+void Database::setTvShowDirectoryFingerprints(DirectoryPath path,
+    const QHash<QString, DirectoryFingerprint>& fingerprints)
+{
+    QSqlQuery query(db());
+    query.prepare("DELETE FROM tvShowDirectories WHERE path=:path");
+    query.bindValue(":path", path.toString().toUtf8());
+    query.exec();
+
+    QVector<QVariantList> rows;
+    rows.reserve(fingerprints.size());
+    for (auto it = fingerprints.cbegin(); it != fingerprints.cend(); ++it) {
+        rows.append({it.key().toUtf8(), it.value().lastModified, it.value().entryCount, path.toString().toUtf8()});
+    }
+    insertRows("tvShowDirectories", {"dir", "lastModified", "entryCount", "path"}, rows);
+}
+
+QVector<DirectoryPath> Database::tvShowLibraryPaths()
+{
+    QVector<DirectoryPath> paths;
+    QSqlQuery query(db());
+    query.prepare("SELECT path FROM shows UNION SELECT path FROM tvShowDirectories");
+    query.exec();
+    while (query.next()) {
+        paths.append(DirectoryPath(QString::fromUtf8(query.value(0).toByteArray())));
+    }
+    return paths;
+}
+
 void Database::clearAllConcerts()
 {
     QSqlQuery query(db());
@@ -324,46 +766,56 @@ void Database::clearConcertsInDirectory(DirectoryPath path)
     query.exec();
 }
 
-void Database::add(Concert* concert, DirectoryPath path)
+void Database::removeConcert(int idConcert)
 {
     QSqlQuery query(db());
-    query.prepare("INSERT INTO concerts(content, inSeparateFolder, path) "
-                  "VALUES(:content, :inSeparateFolder, :path)");
-    query.bindValue(":content", concert->nfoContent().isEmpty() ? "" : concert->nfoContent().toUtf8());
+    query.prepare("DELETE FROM concertFiles WHERE idConcert=:idConcert");
+    query.bindValue(":idConcert", idConcert);
+    query.exec();
+    query.prepare("DELETE FROM concerts WHERE idConcert=:idConcert");
+    query.bindValue(":idConcert", idConcert);
+    query.exec();
+}
+
+/// \brief Rows for a table that maps an item's ID to its files.
+static QVector<QVariantList> fileRows(int id, const mediaelch::FileList& files)
+{
+    QVector<QVariantList> rows;
+    rows.reserve(files.size());
+    for (const FilePath& file : files) {
+        rows.append(QVariantList{id, file.toString().toUtf8()});
+    }
+    return rows;
+}
+
+void Database::add(Concert* concert, DirectoryPath path)
+{
+    QSqlQuery& query = preparedQuery("INSERT INTO concerts(content, inSeparateFolder, path) "
+                                     "VALUES(:content, :inSeparateFolder, :path)");
+    query.bindValue(":content", encodeContent(concert->nfoContent()));
     query.bindValue(":inSeparateFolder", (concert->inSeparateFolder() ? 1 : 0));
     query.bindValue(":path", path.toString().toUtf8());
     query.exec();
     int insertId = query.lastInsertId().toInt();
 
-    for (const FilePath& file : concert->files()) {
-        query.prepare("INSERT INTO concertFiles(idConcert, file) VALUES(:idConcert, :file)");
-        query.bindValue(":idConcert", insertId);
-        query.bindValue(":file", file.toString().toUtf8());
-        query.exec();
-    }
+    insertRows("concertFiles", {"idConcert", "file"}, fileRows(insertId, concert->files()));
     concert->setDatabaseId(insertId);
 }
 
 void Database::update(Concert* concert)
 {
-    QSqlQuery query(db());
-    query.prepare("UPDATE concerts SET content=:content WHERE idConcert=:id");
-    query.bindValue(":content", concert->nfoContent().isEmpty() ? "" : concert->nfoContent());
+    QSqlQuery& query = preparedQuery("UPDATE concerts SET content=:content WHERE idConcert=:id");
+    query.bindValue(":content", encodeContent(concert->nfoContent()));
     query.bindValue(":id", concert->databaseId());
     query.exec();
 
-    query.prepare("DELETE FROM concertFiles WHERE idConcert=:idConcert");
-    query.bindValue(":idConcert", concert->databaseId());
-    query.exec();
-    for (const FilePath& file : concert->files()) {
-        query.prepare("INSERT INTO concertFiles(idConcert, file) VALUES(:idConcert, :file)");
-        query.bindValue(":idConcert", concert->databaseId());
-        query.bindValue(":file", file.toString().toUtf8());
-        query.exec();
-    }
+    QSqlQuery& deleteFiles = preparedQuery("DELETE FROM concertFiles WHERE idConcert=:idConcert");
+    deleteFiles.bindValue(":idConcert", concert->databaseId());
+    deleteFiles.exec();
+    insertRows("concertFiles", {"idConcert", "file"}, fileRows(concert->databaseId(), concert->files()));
 }
 
-QVector<Concert*> Database::concertsInDirectory(DirectoryPath path)
+QVector<Concert*> Database::concertsInDirectory(DirectoryPath path, QObject* concertParent)
 {
     QVector<Concert*> concerts;
     QSqlQuery query(db());
@@ -371,19 +823,25 @@ QVector<Concert*> Database::concertsInDirectory(DirectoryPath path)
     query.prepare("SELECT idConcert, content, inSeparateFolder FROM concerts WHERE path=:path");
     query.bindValue(":path", path.toString().toUtf8());
     query.exec();
+    queryFiles.prepare("SELECT file FROM concertFiles WHERE idConcert=:idConcert");
+
+    const QSqlRecord record = query.record();
+    const int idConcertIndex = record.indexOf("idConcert");
+    const int contentIndex = record.indexOf("content");
+    const int inSeparateFolderIndex = record.indexOf("inSeparateFolder");
     while (query.next()) {
+        const int idConcert = query.value(idConcertIndex).toInt();
         QStringList files;
-        queryFiles.prepare("SELECT file FROM concertFiles WHERE idConcert=:idConcert");
-        queryFiles.bindValue(":idConcert", query.value(query.record().indexOf("idConcert")).toInt());
+        queryFiles.bindValue(":idConcert", idConcert);
         queryFiles.exec();
         while (queryFiles.next()) {
-            files << QString::fromUtf8(queryFiles.value(queryFiles.record().indexOf("file")).toByteArray());
+            files << QString::fromUtf8(queryFiles.value(0).toByteArray());
         }
 
-        auto* concert = new Concert(files, Manager::instance()->concertFileSearcher());
-        concert->setDatabaseId(query.value(query.record().indexOf("idConcert")).toInt());
-        concert->setInSeparateFolder(query.value(query.record().indexOf("inSeparateFolder")).toInt() == 1);
-        concert->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
+        auto* concert = new Concert(files, concertParent);
+        concert->setDatabaseId(idConcert);
+        concert->setInSeparateFolder(query.value(inSeparateFolderIndex).toInt() == 1);
+        concert->setNfoContent(decodeContent(query.value(contentIndex).toByteArray()));
         concerts.append(concert);
     }
     return concerts;
@@ -395,7 +853,7 @@ void Database::add(TvShow* show, DirectoryPath path)
     query.prepare("INSERT INTO shows(dir, content, path) "
                   "VALUES(:dir, :content, :path)");
     query.bindValue(":dir", show->dir().toString().toUtf8());
-    query.bindValue(":content", show->nfoContent().isEmpty() ? "" : show->nfoContent().toUtf8());
+    query.bindValue(":content", encodeContent(show->nfoContent()));
     query.bindValue(":path", path.toString().toUtf8());
     query.exec();
     show->setDatabaseId(query.lastInsertId().toInt());
@@ -472,30 +930,35 @@ void Database::setHideSpecialsInMissingEpisodes(TvShow* show, bool hideSpecials)
 
 void Database::add(TvShowEpisode* episode, DirectoryPath path, int idShow)
 {
-    QSqlQuery query(db());
-    query.prepare("INSERT INTO episodes(content, idShow, path, seasonNumber, episodeNumber) "
-                  "VALUES(:content, :idShow, :path, :seasonNumber, :episodeNumber)");
-    query.bindValue(":content", episode->nfoContent().isEmpty() ? "" : episode->nfoContent().toUtf8());
-    query.bindValue(":idShow", idShow);
-    query.bindValue(":path", path.toString().toUtf8());
-    query.bindValue(":seasonNumber", episode->seasonNumber().toInt());
-    query.bindValue(":episodeNumber", episode->episodeNumber().toInt());
-    query.exec();
-    int insertId = query.lastInsertId().toInt();
-    for (const FilePath& file : episode->files()) {
-        query.prepare("INSERT INTO episodeFiles(idEpisode, file) VALUES(:idEpisode, :file)");
-        query.bindValue(":idEpisode", insertId);
-        query.bindValue(":file", file.toString().toUtf8());
+    add(QVector<TvShowEpisode*>{episode}, std::move(path), idShow);
+}
+
+void Database::add(const QVector<TvShowEpisode*>& episodes, DirectoryPath path, int idShow)
+{
+    QSqlQuery& query = preparedQuery("INSERT INTO episodes(content, idShow, path, seasonNumber, episodeNumber) "
+                                     "VALUES(:content, :idShow, :path, :seasonNumber, :episodeNumber)");
+    const QByteArray pathUtf8 = path.toString().toUtf8();
+
+    QVector<QVariantList> rows;
+    for (TvShowEpisode* episode : episodes) {
+        query.bindValue(":content", encodeContent(episode->nfoContent()));
+        query.bindValue(":idShow", idShow);
+        query.bindValue(":path", pathUtf8);
+        query.bindValue(":seasonNumber", episode->seasonNumber().toInt());
+        query.bindValue(":episodeNumber", episode->episodeNumber().toInt());
         query.exec();
+        const int insertId = query.lastInsertId().toInt();
+        rows << fileRows(insertId, episode->files());
+        episode->setDatabaseId(insertId);
     }
-    episode->setDatabaseId(insertId);
+    insertRows("episodeFiles", {"idEpisode", "file"}, rows);
 }
 
 void Database::update(TvShow* show)
 {
     QSqlQuery query(db());
     query.prepare("UPDATE shows SET content=:content, dir=:dir WHERE idShow=:id");
-    query.bindValue(":content", show->nfoContent().isEmpty() ? "" : show->nfoContent());
+    query.bindValue(":content", encodeContent(show->nfoContent()));
     query.bindValue(":dir", show->dir().toString().toUtf8());
     query.bindValue(":id", show->databaseId());
     query.exec();
@@ -513,22 +976,15 @@ void Database::update(TvShow* show)
 
 void Database::update(TvShowEpisode* episode)
 {
-    QSqlQuery query(db());
-    query.prepare("UPDATE episodes SET content=:content WHERE idEpisode=:id");
-    query.bindValue(":content", episode->nfoContent().isEmpty() ? "" : episode->nfoContent());
+    QSqlQuery& query = preparedQuery("UPDATE episodes SET content=:content WHERE idEpisode=:id");
+    query.bindValue(":content", encodeContent(episode->nfoContent()));
     query.bindValue(":id", episode->databaseId());
     query.exec();
 
-    query.prepare("DELETE FROM episodeFiles WHERE idEpisode=:idEpisode");
-    query.bindValue(":idEpisode", episode->databaseId());
-    query.exec();
-
-    for (const FilePath& file : episode->files()) {
-        query.prepare("INSERT INTO episodeFiles(idEpisode, file) VALUES(:idEpisode, :file)");
-        query.bindValue(":idEpisode", episode->databaseId());
-        query.bindValue(":file", file.toString().toUtf8());
-        query.exec();
-    }
+    QSqlQuery& deleteFiles = preparedQuery("DELETE FROM episodeFiles WHERE idEpisode=:idEpisode");
+    deleteFiles.bindValue(":idEpisode", episode->databaseId());
+    deleteFiles.exec();
+    insertRows("episodeFiles", {"idEpisode", "file"}, fileRows(episode->databaseId(), episode->files()));
 }
 
 int Database::showCount(DirectoryPath path)
@@ -545,30 +1001,32 @@ int Database::showCount(DirectoryPath path)
     return ok ? numberOfShows : 0;
 }
 
-QVector<TvShow*> Database::showsInDirectory(DirectoryPath path)
+QVector<TvShow*> Database::showsInDirectory(DirectoryPath path, QObject* showParent)
 {
     QVector<TvShow*> shows;
     QSqlQuery query(db());
     query.prepare("SELECT idShow, dir, content, path FROM shows WHERE path=:path");
     query.bindValue(":path", path.toString().toUtf8());
     query.exec();
+    const QSqlRecord record = query.record();
+    const int idShowIndex = record.indexOf("idShow");
+    const int dirIndex = record.indexOf("dir");
+    const int contentIndex = record.indexOf("content");
     while (query.next()) {
-        mediaelch::DirectoryPath dir(QString::fromUtf8(query.value(query.record().indexOf("dir")).toByteArray()));
-        auto* show = new TvShow(dir, Manager::instance()->tvShowFileSearcher());
-        show->setDatabaseId(query.value(query.record().indexOf("idShow")).toInt());
-        show->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
+        mediaelch::DirectoryPath dir(QString::fromUtf8(query.value(dirIndex).toByteArray()));
+        auto* show = new TvShow(dir, showParent);
+        show->setDatabaseId(query.value(idShowIndex).toInt());
+        show->setNfoContent(decodeContent(query.value(contentIndex).toByteArray()));
         shows.append(show);
     }
 
+    query.prepare("SELECT showMissingEpisodes, hideSpecialsInMissingEpisodes FROM showsSettings WHERE dir=:dir");
     for (TvShow* show : shows) {
-        query.prepare("SELECT showMissingEpisodes, hideSpecialsInMissingEpisodes FROM showsSettings WHERE dir=:dir");
         query.bindValue(":dir", show->dir().toString().toUtf8());
         query.exec();
         if (query.next()) {
-            show->setShowMissingEpisodes(
-                query.value(query.record().indexOf("showMissingEpisodes")).toInt() == 1, false);
-            show->setHideSpecialsInMissingEpisodes(
-                query.value(query.record().indexOf("hideSpecialsInMissingEpisodes")).toInt() == 1, false);
+            show->setShowMissingEpisodes(query.value(0).toInt() == 1, false);
+            show->setHideSpecialsInMissingEpisodes(query.value(1).toInt() == 1, false);
         }
     }
 
@@ -583,20 +1041,27 @@ QVector<TvShowEpisode*> Database::episodes(int idShow)
     query.prepare("SELECT idEpisode, content, seasonNumber, episodeNumber FROM episodes WHERE idShow=:idShow");
     query.bindValue(":idShow", idShow);
     query.exec();
+    queryFiles.prepare("SELECT file FROM episodeFiles WHERE idEpisode=:idEpisode");
+
+    const QSqlRecord record = query.record();
+    const int idEpisodeIndex = record.indexOf("idEpisode");
+    const int contentIndex = record.indexOf("content");
+    const int seasonNumberIndex = record.indexOf("seasonNumber");
+    const int episodeNumberIndex = record.indexOf("episodeNumber");
     while (query.next()) {
+        const int idEpisode = query.value(idEpisodeIndex).toInt();
         QStringList files;
-        queryFiles.prepare("SELECT file FROM episodeFiles WHERE idEpisode=:idEpisode");
-        queryFiles.bindValue(":idEpisode", query.value(query.record().indexOf("idEpisode")).toInt());
+        queryFiles.bindValue(":idEpisode", idEpisode);
         queryFiles.exec();
         while (queryFiles.next()) {
-            files << QString::fromUtf8(queryFiles.value(queryFiles.record().indexOf("file")).toByteArray());
+            files << QString::fromUtf8(queryFiles.value(0).toByteArray());
         }
 
         auto* episode = new TvShowEpisode(files);
-        episode->setSeason(SeasonNumber(query.value(query.record().indexOf("seasonNumber")).toInt()));
-        episode->setEpisode(EpisodeNumber(query.value(query.record().indexOf("episodeNumber")).toInt()));
-        episode->setDatabaseId(query.value(query.record().indexOf("idEpisode")).toInt());
-        episode->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
+        episode->setSeason(SeasonNumber(query.value(seasonNumberIndex).toInt()));
+        episode->setEpisode(EpisodeNumber(query.value(episodeNumberIndex).toInt()));
+        episode->setDatabaseId(idEpisode);
+        episode->setNfoContent(decodeContent(query.value(contentIndex).toByteArray()));
         episodes.append(episode);
     }
     return episodes;
@@ -698,22 +1163,26 @@ void Database::addEpisodeToShowList(TvShowEpisode* episode, int showsSettingsId,
     kodi::EpisodeXmlWriterGeneric xmlWriter(KodiVersion::latest(), {episode});
     const QByteArray xmlContent = xmlWriter.getEpisodeXml();
 
-    QSqlQuery query(db());
-    query.prepare("SELECT idEpisode FROM showsEpisodes WHERE tmdbid=:tmdbId");
-    query.bindValue(":tmdbId", tmdbId.toString());
-    query.exec();
-    if (query.next()) {
-        const int idEpisode = query.value(0).toInt();
-        query.prepare("UPDATE showsEpisodes SET seasonNumber=:seasonNumber, episodeNumber=:episodeNumber, updated=1, "
-                      "content=:content WHERE idEpisode=:idEpisode");
+    QSqlQuery& select = preparedQuery("SELECT idEpisode FROM showsEpisodes WHERE tmdbid=:tmdbId");
+    select.bindValue(":tmdbId", tmdbId.toString());
+    select.exec();
+    const bool exists = select.next();
+    const int idEpisode = exists ? select.value(0).toInt() : -1;
+    select.finish();
+
+    if (exists) {
+        QSqlQuery& query =
+            preparedQuery("UPDATE showsEpisodes SET seasonNumber=:seasonNumber, episodeNumber=:episodeNumber, "
+                          "updated=1, content=:content WHERE idEpisode=:idEpisode");
         query.bindValue(":content", xmlContent.isEmpty() ? "" : xmlContent);
         query.bindValue(":idEpisode", idEpisode);
         query.bindValue(":seasonNumber", episode->seasonNumber().toInt());
         query.bindValue(":episodeNumber", episode->episodeNumber().toInt());
         query.exec();
     } else {
-        query.prepare("INSERT INTO showsEpisodes(content, idShow, seasonNumber, episodeNumber, tmdbid, updated) "
-                      "VALUES(:content, :idShow, :seasonNumber, :episodeNumber, :tmdbId, 1)");
+        QSqlQuery& query =
+            preparedQuery("INSERT INTO showsEpisodes(content, idShow, seasonNumber, episodeNumber, tmdbid, updated) "
+                          "VALUES(:content, :idShow, :seasonNumber, :episodeNumber, :tmdbId, 1)");
         query.bindValue(":content", xmlContent.isEmpty() ? "" : xmlContent);
         query.bindValue(":idShow", showsSettingsId);
         query.bindValue(":seasonNumber", episode->seasonNumber().toInt());
@@ -731,6 +1200,35 @@ void Database::cleanUpEpisodeList(int showsSettingsId)
     query.exec();
 }
 
+void Database::setEpisodeList(int showsSettingsId, const QVector<TvShowEpisode*>& episodes)
+{
+    transaction();
+    clearEpisodeList(showsSettingsId);
+    for (TvShowEpisode* episode : episodes) {
+        addEpisodeToShowList(episode, showsSettingsId, episode->tmdbId());
+    }
+    cleanUpEpisodeList(showsSettingsId);
+
+    QSqlQuery query(db());
+    query.prepare("UPDATE showsSettings SET episodeListUpdated=:updated WHERE idShow=:idShow");
+    query.bindValue(":updated", QDateTime::currentDateTimeUtc().toSecsSinceEpoch());
+    query.bindValue(":idShow", showsSettingsId);
+    query.exec();
+    commit();
+}
+
+QDateTime Database::episodeListUpdated(int showsSettingsId)
+{
+    QSqlQuery query(db());
+    query.prepare("SELECT episodeListUpdated FROM showsSettings WHERE idShow=:idShow");
+    query.bindValue(":idShow", showsSettingsId);
+    query.exec();
+    if (!query.next() || query.value(0).isNull()) {
+        return {};
+    }
+    return QDateTime::fromSecsSinceEpoch(query.value(0).toLongLong());
+}
+
 QVector<TvShowEpisode*> Database::showsEpisodes(TvShow* show)
 {
     int id = showsSettingsId(show);
@@ -739,11 +1237,15 @@ QVector<TvShowEpisode*> Database::showsEpisodes(TvShow* show)
     query.prepare("SELECT idEpisode, content, seasonNumber, episodeNumber FROM showsEpisodes WHERE idShow=:idShow");
     query.bindValue(":idShow", id);
     query.exec();
+    const QSqlRecord record = query.record();
+    const int contentIndex = record.indexOf("content");
+    const int seasonNumberIndex = record.indexOf("seasonNumber");
+    const int episodeNumberIndex = record.indexOf("episodeNumber");
     while (query.next()) {
         auto* episode = new TvShowEpisode(QStringList(), show);
-        episode->setSeason(SeasonNumber(query.value(query.record().indexOf("seasonNumber")).toInt()));
-        episode->setEpisode(EpisodeNumber(query.value(query.record().indexOf("episodeNumber")).toInt()));
-        episode->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
+        episode->setSeason(SeasonNumber(query.value(seasonNumberIndex).toInt()));
+        episode->setEpisode(EpisodeNumber(query.value(episodeNumberIndex).toInt()));
+        episode->setNfoContent(decodeContent(query.value(contentIndex).toByteArray()));
         episodes.append(episode);
     }
     return episodes;
@@ -751,72 +1253,107 @@ QVector<TvShowEpisode*> Database::showsEpisodes(TvShow* show)
 
 void Database::addImport(QString fileName, QString type, DirectoryPath path)
 {
-    int id = 1;
-    QSqlQuery query(db());
-    query.prepare("SELECT MAX(id) FROM importCache");
-    query.exec();
-    if (query.next()) {
-        id = query.value(0).toInt() + 1;
-    }
-
-    query.prepare("INSERT INTO importCache(id, filename, type, path) VALUES(:id, :filename, :type, :path)");
-    query.bindValue(":id", id);
+    // The id is assigned by SQLite (AUTOINCREMENT).
+    QSqlQuery& query = preparedQuery("INSERT INTO importCache(filename, type, path) VALUES(:filename, :type, :path)");
     query.bindValue(":filename", fileName);
     query.bindValue(":type", type);
     query.bindValue(":path", path.toString());
     query.exec();
+
+    if (m_importsLoaded) {
+        m_importIndex.add(fileName);
+        m_imports.append({fileName, type, path.toString()});
+    }
 }
 
 bool Database::guessImport(QString fileName, QString& type, QString& path)
 {
-    qreal bestMatch = 0;
+    constexpr qreal minSimilarity = 0.7;
 
-    QSqlQuery query(db());
-    query.prepare("SELECT filename, type, path FROM importCache");
-    query.exec();
-    while (query.next()) {
-        qreal p = helper::similarity(fileName, query.value(query.record().indexOf("filename")).toString());
-        if (p > 0.7 && p > bestMatch) {
+    if (!m_importsLoaded) {
+        loadImports();
+    }
+
+    qreal bestMatch = 0;
+    // Candidates are in the same order as the table's rows, i.e. the first best match wins.
+    for (const int id : m_importIndex.candidates(fileName, minSimilarity)) {
+        const ImportEntry& entry = m_imports.at(id);
+        qreal p = helper::similarity(fileName, entry.fileName);
+        if (p > minSimilarity && p > bestMatch) {
             bestMatch = p;
-            type = query.value(query.record().indexOf("type")).toString();
-            path = query.value(query.record().indexOf("path")).toString();
+            type = entry.type;
+            path = entry.path;
         }
     }
 
     return (bestMatch != 0);
 }
 
-void Database::setLabel(const mediaelch::FileList& fileNames, ColorLabel colorLabel)
+void Database::loadImports()
 {
-    // no locker, as this function is called by add()
+    m_importIndex.clear();
+    m_imports.clear();
 
-    int color = static_cast<int>(colorLabel);
     QSqlQuery query(db());
-    int id = 1;
-    query.prepare("SELECT MAX(idLabel) FROM labels");
+    query.prepare("SELECT filename, type, path FROM importCache ORDER BY id");
     query.exec();
-    if (query.next()) {
-        id = query.value(0).toInt() + 1;
+    while (query.next()) {
+        ImportEntry entry{query.value(0).toString(), query.value(1).toString(), query.value(2).toString()};
+        m_importIndex.add(entry.fileName);
+        m_imports.append(std::move(entry));
     }
+    m_importsLoaded = true;
+}
 
+void Database::setLabel(const mediaelch::FileList& fileNames, ColorLabel colorLabel)
+{
+    QHash<QString, ColorLabel> labels;
     for (const mediaelch::FilePath& fileName : fileNames) {
-        query.prepare("SELECT idLabel FROM labels WHERE fileName=:fileName");
-        query.bindValue(":fileName", fileName.toString().toUtf8());
-        query.exec();
-        if (query.next()) {
-            int idLabel = query.value(query.record().indexOf("idLabel")).toInt();
-            query.prepare("UPDATE labels SET color=:color WHERE idLabel=:idLabel");
-            query.bindValue(":idLabel", idLabel);
-            query.bindValue(":color", color);
-            query.exec();
-        } else {
-            query.prepare("INSERT INTO labels(idLabel, color, fileName) VALUES(:idLabel, :color, :fileName)");
-            query.bindValue(":idLabel", id);
-            query.bindValue(":color", color);
-            query.bindValue(":fileName", fileName.toString().toUtf8());
-            query.exec();
+        labels.insert(fileName.toString(), colorLabel);
+    }
+    setLabels(labels);
+}
+
+void Database::setLabels(const QHash<QString, ColorLabel>& labels)
+{
+    // no locker, as this function is called by add()
+
+    // Files without a label don't need a row, see getLabel().
+    QVariantList fileNames;
+    QVector<QVariantList> rows;
+    for (auto it = labels.cbegin(); it != labels.cend(); ++it) {
+        const QByteArray fileName = it.key().toUtf8();
+        fileNames << fileName;
+        if (it.value() != ColorLabel::NoLabel) {
+            rows.append(QVariantList{static_cast<int>(it.value()), fileName});
         }
     }
+    deleteRows("labels", "fileName", fileNames);
+    insertRows("labels", {"color", "fileName"}, rows);
+}
+
+QHash<QString, ColorLabel> Database::labelsInDirectory(DirectoryPath path)
+{
+    // Files below the directory, i.e. all file names in the range ["<path>/", "<path>0"),
+    // because '0' follows '/'.  Unlike LIKE, a range can use the index on labels.fileName.
+    QString prefix = path.toString();
+    if (!prefix.endsWith('/')) {
+        prefix += '/';
+    }
+    QString end = prefix;
+    end[end.size() - 1] = QLatin1Char('0');
+
+    QSqlQuery& query = preparedQuery("SELECT fileName, color FROM labels WHERE fileName >= :begin AND fileName < :end");
+    query.bindValue(":begin", prefix.toUtf8());
+    query.bindValue(":end", end.toUtf8());
+    query.exec();
+
+    QHash<QString, ColorLabel> labels;
+    while (query.next()) {
+        labels.insert(QString::fromUtf8(query.value(0).toByteArray()), static_cast<ColorLabel>(query.value(1).toInt()));
+    }
+    query.finish();
+    return labels;
 }
 
 ColorLabel Database::getLabel(const mediaelch::FileList& fileNames)
@@ -825,15 +1362,15 @@ ColorLabel Database::getLabel(const mediaelch::FileList& fileNames)
         return ColorLabel::NoLabel;
     }
 
-    QSqlQuery query(db());
-    query.prepare("SELECT color FROM labels WHERE fileName=:fileName");
+    QSqlQuery& query = preparedQuery("SELECT color FROM labels WHERE fileName=:fileName");
     query.bindValue(":fileName", fileNames.first().toString().toUtf8());
-    bool success = query.exec();
-    if (success && query.next()) {
-        return static_cast<ColorLabel>(query.value("color").toInt());
+    ColorLabel label = ColorLabel::NoLabel;
+    if (query.exec() && query.next()) {
+        label = static_cast<ColorLabel>(query.value(0).toInt());
     }
-
-    return ColorLabel::NoLabel;
+    // Release the statement's read lock; it is kept for the next call.
+    query.finish();
+    return label;
 }
 
 void Database::setupDatabase()
@@ -968,7 +1505,7 @@ void Database::setupDatabase()
                       "\"color\" integer NOT NULL, "
                       "\"fileName\" text NOT NULL);");
         query.exec();
-        query.prepare("CREATE INDEX id_label_filename_idx ON tags(fileName);");
+        query.prepare("CREATE INDEX IF NOT EXISTS id_label_filename_idx ON labels(fileName);");
         query.exec();
 
 
@@ -1054,10 +1591,102 @@ void Database::setupDatabase()
         query.exec();
 
         myDbVersion = 17;
-        Q_UNUSED(myDbVersion);
         updateDbVersion(17);
     }
 
+    if (myDbVersion < 18) {
+        query.prepare("DROP TABLE IF EXISTS movieDirectories;");
+        query.exec();
+
+        query.prepare(R"sql(CREATE TABLE IF NOT EXISTS movieDirectories (
+                      "idDirectory" integer NOT NULL PRIMARY KEY AUTOINCREMENT,
+                      "dir" text NOT NULL,
+                      "lastModified" integer NOT NULL,
+                      "entryCount" integer NOT NULL,
+                      "path" text NOT NULL);
+        )sql");
+        query.exec();
+        query.prepare("CREATE INDEX id_movie_directories_path_idx ON movieDirectories(path);");
+        query.exec();
+
+        myDbVersion = 18;
+        updateDbVersion(18);
+    }
+
+    if (myDbVersion < 19) {
+        // Parsed metadata, see MovieMetadataCache.  NULL for movies of older versions.
+        query.prepare("ALTER TABLE movies ADD COLUMN \"metadata\" blob;");
+        query.exec();
+
+        myDbVersion = 19;
+        updateDbVersion(19);
+    }
+
+    if (myDbVersion < 20) {
+        // Columns that are used in WHERE clauses.  The labels index of version 14
+        // was created on a non-existing table, i.e. it does not exist in older databases.
+        const QStringList indexes{
+            "CREATE INDEX IF NOT EXISTS id_label_filename_idx ON labels(fileName);",
+            "CREATE INDEX IF NOT EXISTS id_movies_path_idx ON movies(path);",
+            "CREATE INDEX IF NOT EXISTS id_concerts_path_idx ON concerts(path);",
+            "CREATE INDEX IF NOT EXISTS id_shows_path_idx ON shows(path);",
+            "CREATE INDEX IF NOT EXISTS id_episodes_show_idx ON episodes(idShow);",
+            "CREATE INDEX IF NOT EXISTS id_shows_settings_dir_idx ON showsSettings(dir);",
+            "CREATE INDEX IF NOT EXISTS id_shows_episodes_show_idx ON showsEpisodes(idShow);",
+        };
+        for (const QString& index : indexes) {
+            query.prepare(index);
+            if (!query.exec()) {
+                qCWarning(generic) << "[Database] Could not create index:" << query.lastError().text();
+            }
+        }
+
+        myDbVersion = 20;
+        updateDbVersion(20);
+    }
+
+    if (myDbVersion < 21) {
+        // Time of the last episode list update, see EpisodeGuideRefresher.  NULL if never updated.
+        query.prepare("ALTER TABLE showsSettings ADD COLUMN \"episodeListUpdated\" integer;");
+        query.exec();
+        // Episodes of the episode list are looked up by their TMDb ID.
+        query.prepare("CREATE INDEX IF NOT EXISTS id_shows_episodes_tmdbid_idx ON showsEpisodes(tmdbid);");
+        query.exec();
+
+        myDbVersion = 21;
+        updateDbVersion(21);
+    }
+
+    if (myDbVersion < 22) {
+        query.prepare("DROP TABLE IF EXISTS tvShowDirectories;");
+        query.exec();
+
+        query.prepare(R"sql(CREATE TABLE IF NOT EXISTS tvShowDirectories (
+                      "idDirectory" integer NOT NULL PRIMARY KEY AUTOINCREMENT,
+                      "dir" text NOT NULL,
+                      "lastModified" integer NOT NULL,
+                      "entryCount" integer NOT NULL,
+                      "path" text NOT NULL);
+        )sql");
+        query.exec();
+        query.prepare("CREATE INDEX id_tv_show_directories_path_idx ON tvShowDirectories(path);");
+        query.exec();
+
+        myDbVersion = 22;
+        Q_UNUSED(myDbVersion);
+        updateDbVersion(22);
+    }
+
+    // Readers do not block writers and vice versa.  The journal mode is stored in the database file.
+    query.prepare("PRAGMA journal_mode=WAL;");
+    if (!query.exec()) {
+        qCWarning(generic) << "[Database] Could not enable WAL journal mode:" << query.lastError().text();
+    }
+}
+
+void Database::setupConnection()
+{
+    QSqlQuery query(*m_db);
     query.prepare("PRAGMA synchronous=0;");
     query.exec();
 
@@ -1112,11 +1741,15 @@ QVector<Artist*> Database::artistsInDirectory(DirectoryPath path)
     query.prepare("SELECT idArtist, content, dir FROM artists WHERE path=:path");
     query.bindValue(":path", path.toString().toUtf8());
     query.exec();
+    const QSqlRecord record = query.record();
+    const int idArtistIndex = record.indexOf("idArtist");
+    const int contentIndex = record.indexOf("content");
+    const int dirIndex = record.indexOf("dir");
     while (query.next()) {
-        mediaelch::DirectoryPath dir(QString::fromUtf8(query.value(query.record().indexOf("dir")).toByteArray()));
+        mediaelch::DirectoryPath dir(QString::fromUtf8(query.value(dirIndex).toByteArray()));
         auto* artist = new Artist(dir, Manager::instance()->musicFileSearcher());
-        artist->setDatabaseId(query.value(query.record().indexOf("idArtist")).toInt());
-        artist->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
+        artist->setDatabaseId(query.value(idArtistIndex).toInt());
+        artist->setNfoContent(QString::fromUtf8(query.value(contentIndex).toByteArray()));
         artists.append(artist);
     }
     return artists;
@@ -1131,6 +1764,17 @@ void Database::clearAllAlbums()
     query.exec();
 }
 
+void Database::removeArtist(int idArtist)
+{
+    QSqlQuery query(db());
+    query.prepare("DELETE FROM albums WHERE idArtist=:idArtist");
+    query.bindValue(":idArtist", idArtist);
+    query.exec();
+    query.prepare("DELETE FROM artists WHERE idArtist=:idArtist");
+    query.bindValue(":idArtist", idArtist);
+    query.exec();
+}
+
 void Database::clearAlbumsInDirectory(DirectoryPath path)
 {
     QSqlQuery query(db());
@@ -1161,6 +1805,14 @@ void Database::update(Album* album)
     query.exec();
 }
 
+void Database::removeAlbum(int idAlbum)
+{
+    QSqlQuery query(db());
+    query.prepare("DELETE FROM albums WHERE idAlbum=:idAlbum");
+    query.bindValue(":idAlbum", idAlbum);
+    query.exec();
+}
+
 QVector<Album*> Database::albums(Artist* artist)
 {
     QVector<Album*> albums;
@@ -1168,11 +1820,15 @@ QVector<Album*> Database::albums(Artist* artist)
     query.prepare("SELECT idAlbum, content, dir FROM albums WHERE idArtist=:idArtist");
     query.bindValue(":idArtist", artist->databaseId());
     query.exec();
+    const QSqlRecord record = query.record();
+    const int idAlbumIndex = record.indexOf("idAlbum");
+    const int contentIndex = record.indexOf("content");
+    const int dirIndex = record.indexOf("dir");
     while (query.next()) {
-        mediaelch::DirectoryPath dir(QString::fromUtf8(query.value(query.record().indexOf("dir")).toByteArray()));
+        mediaelch::DirectoryPath dir(QString::fromUtf8(query.value(dirIndex).toByteArray()));
         auto* album = new Album(dir, Manager::instance()->musicFileSearcher());
-        album->setDatabaseId(query.value(query.record().indexOf("idAlbum")).toInt());
-        album->setNfoContent(QString::fromUtf8(query.value(query.record().indexOf("content")).toByteArray()));
+        album->setDatabaseId(query.value(idAlbumIndex).toInt());
+        album->setNfoContent(QString::fromUtf8(query.value(contentIndex).toByteArray()));
         album->setArtistObj(artist);
         artist->addAlbum(album);
         albums.append(album);
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "data/TmdbId.h"
+#include "data/TrigramIndex.h"
+#include "file/DirectoryFingerprint.h"
 #include "file/Path.h"
 #include "globals/Globals.h"
 
 #include <QDateTime>
+#include <QHash>
 #include <QSqlDatabase>
+#include <QSqlQuery>
 #include <QString>
 #include <QStringList>
+#include <QVariantList>
 #include <QVector>
 
 class Album;
@@ -16,15 +21,23 @@ class Concert;
 class Movie;
 class TvShow;
 class TvShowEpisode;
+class QThread;
 
 class Database : public QObject
 {
     Q_OBJECT
 public:
     explicit Database(QObject* parent = nullptr);
+    /// \brief Open the database "MediaElch.sqlite" in the given directory.
+    /// \details The default constructor uses the directory from the settings.
+    explicit Database(mediaelch::DirectoryPath dataLocation, QObject* parent = nullptr);
     ~Database() override;
 
-    /// \brief Create a new connection for the calling thread.
+    /// \brief   Create a new connection for the calling thread.
+    /// \details Connections are pooled per thread: Open connections of destroyed
+    ///          Database objects are reused by the same thread.  Loaders run in
+    ///          reused threads of the LoaderThreadPool, i.e. each loader reuses
+    ///          the connection of the previous loader of its thread.
     static Database* newConnection(QObject* parent);
 
     QSqlDatabase db();
@@ -33,24 +46,51 @@ public:
     void clearAllMovies();
     void clearMoviesInDirectory(mediaelch::DirectoryPath path);
     void addMovie(Movie* movie, mediaelch::DirectoryPath path);
+    /// \brief Add all movies at once.  Faster than adding them one by one.
+    void addMovies(const QVector<Movie*>& movies, mediaelch::DirectoryPath path);
+    void removeMovie(int idMovie);
     void update(Movie* movie);
+    /// \brief   Load all movies of the given library directory including their files, labels and subtitles.
+    /// \details All data is read in one transaction using queries that are limited to
+    ///          the directory, i.e. the time does not depend on other library directories.
     QVector<Movie*> moviesInDirectory(mediaelch::DirectoryPath path, QObject* movieParent);
 
+    /// \brief Fingerprints of all directories that were scanned for movies in the given library path.
+    /// \details Key is the absolute directory path as stored by MovieDiskLoader.
+    QHash<QString, mediaelch::DirectoryFingerprint> movieDirectoryFingerprints(mediaelch::DirectoryPath path);
+    /// \brief Replace all stored directory fingerprints of the given library path.
+    void setMovieDirectoryFingerprints(mediaelch::DirectoryPath path,
+        const QHash<QString, mediaelch::DirectoryFingerprint>& fingerprints);
+    /// \brief All library paths that have cached movies or directory fingerprints.
+    QVector<mediaelch::DirectoryPath> movieLibraryPaths();
+
+    /// \brief Fingerprints of the directories of all TV shows in the given library path
+    ///        and their subdirectories.  Key is the absolute directory path.
+    QHash<QString, mediaelch::DirectoryFingerprint> tvShowDirectoryFingerprints(mediaelch::DirectoryPath path);
+    /// \brief Replace all stored TV show directory fingerprints of the given library path.
+    void setTvShowDirectoryFingerprints(mediaelch::DirectoryPath path,
+        const QHash<QString, mediaelch::DirectoryFingerprint>& fingerprints);
+    /// \brief All library paths that have cached TV shows or directory fingerprints.
+    QVector<mediaelch::DirectoryPath> tvShowLibraryPaths();
+
     void clearAllConcerts();
     void clearConcertsInDirectory(mediaelch::DirectoryPath path);
+    void removeConcert(int idConcert);
     void add(Concert* concert, mediaelch::DirectoryPath path);
     void update(Concert* concert);
-    QVector<Concert*> concertsInDirectory(mediaelch::DirectoryPath path);
+    QVector<Concert*> concertsInDirectory(mediaelch::DirectoryPath path, QObject* concertParent);
 
     void add(TvShow* show, mediaelch::DirectoryPath path);
     void add(TvShowEpisode* episode, mediaelch::DirectoryPath path, int idShow);
+    /// \brief Add all episodes of a show at once.  Faster than adding them one by one.
+    void add(const QVector<TvShowEpisode*>& episodes, mediaelch::DirectoryPath path, int idShow);
     void update(TvShow* show);
     void update(TvShowEpisode* episode);
     void clearAllTvShows();
     void clearTvShowsInDirectory(mediaelch::DirectoryPath path);
     void clearTvShowInDirectory(mediaelch::DirectoryPath path);
     int showCount(mediaelch::DirectoryPath path);
-    QVector<TvShow*> showsInDirectory(mediaelch::DirectoryPath path);
+    QVector<TvShow*> showsInDirectory(mediaelch::DirectoryPath path, QObject* showParent);
     QVector<TvShowEpisode*> episodes(int idShow);
     int episodeCount();
 
@@ -60,6 +100,11 @@ public:
     void clearEpisodeList(int showsSettingsId);
     void cleanUpEpisodeList(int showsSettingsId);
     void addEpisodeToShowList(TvShowEpisode* episode, int showsSettingsId, TmdbId tmdbId);
+    /// \brief Replace the episode list of the show in one transaction and store the time of the update.
+    /// \details Same as clearEpisodeList(), addEpisodeToShowList() for each episode and cleanUpEpisodeList().
+    void setEpisodeList(int showsSettingsId, const QVector<TvShowEpisode*>& episodes);
+    /// \brief Time of the last setEpisodeList() call for the show.  Invalid if the list was never set.
+    QDateTime episodeListUpdated(int showsSettingsId);
     QVector<TvShowEpisode*> showsEpisodes(TvShow* show);
 
     void clearAllArtists();
@@ -67,24 +112,73 @@ public:
     void add(Artist* artist, mediaelch::DirectoryPath path);
     void update(Artist* artist);
     QVector<Artist*> artistsInDirectory(mediaelch::DirectoryPath path);
+    /// \brief Remove the artist and all of its albums.
+    void removeArtist(int idArtist);
 
     void clearAllAlbums();
     void clearAlbumsInDirectory(mediaelch::DirectoryPath path);
     void add(Album* album, mediaelch::DirectoryPath path);
     void update(Album* album);
+    void removeAlbum(int idAlbum);
     QVector<Album*> albums(Artist* artist);
 
     void addImport(QString fileName, QString type, mediaelch::DirectoryPath path);
     bool guessImport(QString fileName, QString& type, QString& path);
 
+    /// \brief   Store NFO contents compressed from now on.
+    /// \details Defaults to AdvancedSettings::compressDatabaseContent().  Both
+    ///          compressed and uncompressed contents can always be read.
+    void setCompressContent(bool compress);
+    /// \brief   Rewrite all cached NFO contents in the current format and shrink the database file.
+    /// \details Can take a long time for large databases.
+    void compact();
+
     void setLabel(const mediaelch::FileList& fileNames, ColorLabel color);
+    /// \brief Set the labels of many files at once.  Key is the file path.
+    void setLabels(const QHash<QString, ColorLabel>& labels);
     ColorLabel getLabel(const mediaelch::FileList& fileNames);
+    /// \brief   Labels of all files below the given directory.  Key is the file path.
+    /// \details Files without a label are not part of the result.
+    QHash<QString, ColorLabel> labelsInDirectory(mediaelch::DirectoryPath path);
 
 private:
+    /// \brief Create or migrate the schema.  Only done once per process and database file.
     void setupDatabase();
+    /// \brief Settings that are specific to a connection.
+    void setupConnection();
+    /// \brief   Returns a query for the given SQL statement that is only prepared once per connection.
+    /// \details Bound values of previous executions are overwritten.  SELECT queries
+    ///          must be finished using QSqlQuery::finish() after their results were read.
+    QSqlQuery& preparedQuery(const QString& sql);
+    /// \brief   Insert the given rows into the table using multi-row INSERT statements.
+    /// \details Each row must contain one value per column.
+    void insertRows(const QString& table, const QStringList& columns, const QVector<QVariantList>& rows);
+    /// \brief Load the import cache into m_importIndex.
+    void loadImports();
+    /// \brief NFO content as it is stored in the database, i.e. compressed if enabled.
+    QVariant encodeContent(const QString& content) const;
+    /// \brief Delete all rows of the table whose column has one of the given values.
+    void deleteRows(const QString& table, const QString& column, const QVariantList& values);
 
 private:
     mediaelch::DirectoryPath m_dataLocation;
-    QSqlDatabase* m_db;
+    QSqlDatabase* m_db = nullptr;
+    /// \brief Thread that opened the connection.  Only this thread may use it.
+    QThread* m_thread = nullptr;
+    bool m_compressContent = false;
+
+    struct ImportEntry
+    {
+        QString fileName;
+        QString type;
+        QString path;
+    };
+    /// \brief Rows of the import cache; index is the ID in m_importIndex.
+    /// \details Loaded on first use by guessImport().
+    QVector<ImportEntry> m_imports;
+    mediaelch::TrigramIndex m_importIndex;
+    bool m_importsLoaded = false;
+    /// \brief Prepared statements of this connection, key is the SQL statement.
+    QHash<QString, QSqlQuery*> m_queries;
     void updateDbVersion(int version);
 };
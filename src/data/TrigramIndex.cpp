@@ -0,0 +1,84 @@
+#include "data/TrigramIndex.h"
+
+#include "globals/Meta.h"
+
+#include <QtMath>
+#include <algorithm>
+
+namespace mediaelch {
+
+int TrigramIndex::add(const QString& text)
+{
+    const int id = qsizetype_to_int(m_lengths.size());
+    m_lengths.append(qsizetype_to_int(text.size()));
+
+    const QHash<Trigram, int> textTrigrams = trigrams(text);
+    for (auto it = textTrigrams.cbegin(); it != textTrigrams.cend(); ++it) {
+        m_postings[it.key()].append({id, it.value()});
+    }
+    return id;
+}
+
+void TrigramIndex::clear()
+{
+    m_lengths.clear();
+    m_postings.clear();
+}
+
+int TrigramIndex::size() const
+{
+    return qsizetype_to_int(m_lengths.size());
+}
+
+QVector<int> TrigramIndex::candidates(const QString& text, double minSimilarity) const
+{
+    // Number of trigrams that each text shares with the given one.
+    QVector<int> common(m_lengths.size(), 0);
+    const QHash<Trigram, int> textTrigrams = trigrams(text);
+    for (auto it = textTrigrams.cbegin(); it != textTrigrams.cend(); ++it) {
+        const auto postings = m_postings.constFind(it.key());
+        if (postings == m_postings.cend()) {
+            continue;
+        }
+        for (const auto& posting : postings.value()) {
+            common[posting.first] += qMin(posting.second, it.value());
+        }
+    }
+
+    const int length = qsizetype_to_int(text.size());
+    QVector<int> result;
+    for (int id = 0; id < common.size(); ++id) {
+        // similarity > minSimilarity  <=>  distance < (1 - minSimilarity) * maxLength
+        // The epsilon accounts for rounding errors in helper::similarity(); more
+        // candidates are fine, fewer are not.
+        const int maxLength = qMax(length, m_lengths[id]);
+        const int maxDistance = qFloor((1.0 - minSimilarity) * maxLength + 1e-6);
+        if (qAbs(length - m_lengths[id]) > maxDistance) {
+            continue;
+        }
+        if (common[id] >= maxLength + 2 - 3 * maxDistance) {
+            result.append(id);
+        }
+    }
+    return result;
+}
+
+QHash<TrigramIndex::Trigram, int> TrigramIndex::trigrams(const QString& text)
+{
+    // Padding with null characters, which don't appear in file names.
+    QString padded(2, QChar(0));
+    padded.append(text);
+    padded.append(QChar(0));
+    padded.append(QChar(0));
+
+    QHash<Trigram, int> result;
+    for (int i = 0; i + 2 < padded.size(); ++i) {
+        const Trigram trigram = (static_cast<Trigram>(padded.at(i).unicode()) << 32)
+                                | (static_cast<Trigram>(padded.at(i + 1).unicode()) << 16)
+                                | padded.at(i + 2).unicode();
+        ++result[trigram];
+    }
+    return result;
+}
+
+} // namespace mediaelch
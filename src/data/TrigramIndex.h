@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+namespace mediaelch {
+
+/// \brief Index of strings by their trigrams for fast fuzzy matching.
+///
+/// Comparing a string against many strings using helper::similarity() is
+/// expensive, because the Levenshtein distance has to be computed for each
+/// pair.  This index returns only those strings that can be similar enough.
+/// Strings whose Levenshtein distance is at most k share at least
+/// max(|s1|, |s2|) + 2 - 3k trigrams (both strings are padded by two
+/// characters on each side).  Strings that share fewer trigrams can't reach
+/// the similarity, i.e. no matches are lost.
+///
+/// \par Example
+/// \code{cpp}
+///   TrigramIndex index;
+///   index.add("Movie.2010.1080p");
+///   for (int id : index.candidates("Movie.2010.720p", 0.7)) { ... }
+/// \endcode
+class TrigramIndex
+{
+public:
+    /// \brief Add the given text to the index.
+    /// \returns ID of the text; IDs are assigned in ascending order, starting at 0.
+    int add(const QString& text);
+    void clear();
+    int size() const;
+
+    /// \brief   IDs of all texts whose helper::similarity() to the given text may
+    ///          be greater than \p minSimilarity, in ascending order.
+    /// \details The result may contain texts that are not similar enough, so the
+    ///          similarity must still be computed for each candidate.
+    QVector<int> candidates(const QString& text, double minSimilarity) const;
+
+private:
+    using Trigram = quint64;
+    /// \brief Trigrams of the given text and how often they occur.
+    static QHash<Trigram, int> trigrams(const QString& text);
+
+    /// \brief Length of each text, index is the ID.
+    QVector<int> m_lengths;
+    /// \brief For each trigram: IDs of the texts that contain it and how often.
+    QHash<Trigram, QVector<QPair<int, int>>> m_postings;
+};
+
+} // namespace mediaelch
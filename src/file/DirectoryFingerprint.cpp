@@ -0,0 +1,36 @@
+#include "file/DirectoryFingerprint.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+
+namespace mediaelch {
+
+DirectoryFingerprint DirectoryFingerprint::fromDirectory(const QString& path, int entryCount)
+{
+    DirectoryFingerprint fingerprint;
+    QFileInfo fi(path);
+    if (fi.exists()) {
+        fingerprint.lastModified = fi.lastModified().toMSecsSinceEpoch();
+    }
+    fingerprint.entryCount = entryCount;
+    return fingerprint;
+}
+
+bool operator==(const DirectoryFingerprint& lhs, const DirectoryFingerprint& rhs)
+{
+    return lhs.lastModified == rhs.lastModified && lhs.entryCount == rhs.entryCount;
+}
+
+bool operator!=(const DirectoryFingerprint& lhs, const DirectoryFingerprint& rhs)
+{
+    return !(lhs == rhs);
+}
+
+QDebug operator<<(QDebug debug, const DirectoryFingerprint& fingerprint)
+{
+    QDebugStateSaver saver(debug);
+    debug.nospace() << "DirectoryFingerprint(" << fingerprint.lastModified << ", " << fingerprint.entryCount << ')';
+    return debug;
+}
+
+} // namespace mediaelch
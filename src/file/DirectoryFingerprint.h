@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QDebug>
+#include <QString>
+#include <QtGlobal>
+
+namespace mediaelch {
+
+/// \brief Cheap fingerprint of a directory's state on disk.
+///
+/// A directory's modification time changes whenever an entry is added,
+/// removed or renamed.  Together with the number of entries that were found
+/// by a scan, it is used to decide whether a directory has to be scanned
+/// again or whether cached results can be reused.
+///
+/// \note Files that are modified in-place (e.g. an NFO that is rewritten
+///       without changing its name) do not change the fingerprint.
+struct DirectoryFingerprint
+{
+    /// \brief Modification time of the directory in milliseconds since epoch.
+    qint64 lastModified = 0;
+    /// \brief Number of relevant entries, e.g. media files inside the directory.
+    int entryCount = 0;
+
+    bool isValid() const { return lastModified > 0; }
+
+    /// \brief Create a fingerprint for the given directory by querying its
+    ///        modification time.  Invalid if the directory does not exist.
+    static DirectoryFingerprint fromDirectory(const QString& path, int entryCount);
+};
+
+bool operator==(const DirectoryFingerprint& lhs, const DirectoryFingerprint& rhs);
+bool operator!=(const DirectoryFingerprint& lhs, const DirectoryFingerprint& rhs);
+
+QDebug operator<<(QDebug debug, const DirectoryFingerprint& fingerprint);
+
+} // namespace mediaelch
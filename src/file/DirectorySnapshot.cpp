@@ -0,0 +1,127 @@
+#include "file/DirectorySnapshot.h"
+
+#include "globals/Meta.h"
+
+#include <QDir>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+
+namespace mediaelch {
+
+void DirectorySnapshot::addDirectory(const QString& dirPath, QFileInfoList files)
+{
+    // Same order as QDir::entryInfoList() which is used for unknown directories.
+    std::sort(files.begin(), files.end(), [](const QFileInfo& lhs, const QFileInfo& rhs) {
+        return QString::compare(lhs.fileName(), rhs.fileName(), Qt::CaseInsensitive) < 0;
+    });
+
+    Directory directory;
+    directory.fileNames.reserve(files.size());
+    for (const QFileInfo& file : asConst(files)) {
+        const QString key = fileKey(file.fileName());
+        directory.fileNames.insert(key);
+        const QString folded = key.toLower();
+        if (folded != key) {
+            directory.foldedFileNames.insert(folded);
+        }
+    }
+    directory.files = std::move(files);
+    m_directories.insert(directoryKey(dirPath), std::move(directory));
+}
+
+bool DirectorySnapshot::containsDirectory(const QString& dirPath) const
+{
+    QReadLocker locker(&m_lock);
+    return m_directories.contains(directoryKey(dirPath));
+}
+
+void DirectorySnapshot::clear()
+{
+    m_directories.clear();
+}
+
+void DirectorySnapshot::retain(const QString& dirPath)
+{
+    const auto directory = m_directories.find(directoryKey(dirPath));
+    if (directory != m_directories.end()) {
+        ++directory->users;
+    }
+}
+
+void DirectorySnapshot::removeUnretained()
+{
+    for (auto it = m_directories.begin(); it != m_directories.end();) {
+        if (it->users <= 0) {
+            it = m_directories.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DirectorySnapshot::release(const QString& dirPath)
+{
+    const QString key = directoryKey(dirPath);
+    QWriteLocker locker(&m_lock);
+    const auto directory = m_directories.find(key);
+    if (directory != m_directories.end() && --directory->users <= 0) {
+        m_directories.erase(directory);
+    }
+}
+
+bool DirectorySnapshot::fileExists(const QString& dirPath, const QString& fileName) const
+{
+    {
+        QReadLocker locker(&m_lock);
+        const auto directory = m_directories.constFind(directoryKey(dirPath));
+        if (directory != m_directories.constEnd()) {
+            if (directory->fileNames.contains(fileKey(fileName))) {
+                return true;
+            }
+            // Names are case sensitive on Linux, but network shares may not be, e.g.
+            // "Poster.JPG" may be found as "poster.jpg". Only the file system knows.
+            const QString folded = fileName.toLower();
+            if (!directory->fileNames.contains(folded) && !directory->foldedFileNames.contains(folded)) {
+                return false;
+            }
+        }
+    }
+    return QFileInfo(dirPath + "/" + fileName).isFile();
+}
+
+bool DirectorySnapshot::fileExists(const QString& filePath) const
+{
+    const QFileInfo fi(filePath);
+    return fileExists(fi.path(), fi.fileName());
+}
+
+QFileInfoList DirectorySnapshot::files(const QString& dirPath) const
+{
+    {
+        QReadLocker locker(&m_lock);
+        const auto directory = m_directories.constFind(directoryKey(dirPath));
+        if (directory != m_directories.constEnd()) {
+            return directory->files;
+        }
+    }
+    return QDir(dirPath).entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+}
+
+QString DirectorySnapshot::directoryKey(const QString& dirPath)
+{
+    // Does not access the file system.
+    return QDir::cleanPath(QFileInfo(dirPath).absoluteFilePath());
+}
+
+QString DirectorySnapshot::fileKey(const QString& fileName)
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_MAC)
+    // Default file systems on Windows and macOS are case insensitive.
+    return fileName.toLower();
+#else
+    return fileName;
+#endif
+}
+
+} // namespace mediaelch
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QString>
+
+namespace mediaelch {
+
+/// \brief In-memory snapshot of the files inside one or more directories.
+///
+/// A snapshot is captured once while walking a directory tree.  Afterwards,
+/// existence checks for NFO files, artwork and subtitles can be answered
+/// without a stat() call for each candidate, which is expensive on network
+/// shares (SMB/NFS).  Directories that are not part of the snapshot are
+/// checked on disk.
+///
+/// To keep the memory usage low for large libraries, directories can be
+/// retained by their users and are removed once all users have released them.
+///
+/// \note Adding and retaining directories is not thread safe; reading and
+///       releasing them is.
+class DirectorySnapshot
+{
+public:
+    void addDirectory(const QString& dirPath, QFileInfoList files);
+    bool containsDirectory(const QString& dirPath) const;
+    void clear();
+
+    /// \brief Mark the directory as used by one more user, see release().
+    void retain(const QString& dirPath);
+    /// \brief Remove all directories that were never retained.
+    void removeUnretained();
+    /// \brief   Release a directory that was retained using retain().
+    /// \details The directory is removed from the snapshot once all users released it.
+    void release(const QString& dirPath);
+
+    /// \brief   Whether a file with the given name exists in the given directory.
+    /// \details If the name only matches a file of the snapshot case insensitively, the file
+    ///          system decides, e.g. case insensitive network shares on Linux.
+    bool fileExists(const QString& dirPath, const QString& fileName) const;
+    /// \brief Whether the given file exists; shorthand for fileExists(dir, name).
+    bool fileExists(const QString& filePath) const;
+    /// \brief All files of the given directory, sorted by name (case insensitive).
+    QFileInfoList files(const QString& dirPath) const;
+
+private:
+    static QString directoryKey(const QString& dirPath);
+    static QString fileKey(const QString& fileName);
+
+    struct Directory
+    {
+        QFileInfoList files;
+        QSet<QString> fileNames;
+        /// \brief Lowercase names of files whose name is not lowercase, see fileExists().
+        QSet<QString> foldedFileNames;
+        int users = 0;
+    };
+    QHash<QString, Directory> m_directories;
+    mutable QReadWriteLock m_lock;
+};
+
+} // namespace mediaelch
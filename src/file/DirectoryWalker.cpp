@@ -0,0 +1,65 @@
+#include "file/DirectoryWalker.h"
+
+#include <QDirIterator>
+#include <QSet>
+#include <QVector>
+
+namespace mediaelch {
+
+DirectoryWalker::DirectoryWalker(FileFilter filter, DirectoryPredicate shouldEnter) :
+    m_filter{std::move(filter)}, m_shouldEnter{std::move(shouldEnter)}
+{
+}
+
+bool DirectoryWalker::walk(const QString& rootPath, const DirectoryVisitor& visitor) const
+{
+    // Same as FileFilter::files(): Without filters, there are no files.
+    QDir::Filters entryFilter = QDir::AllDirs | QDir::NoDotAndDotDot;
+    if (m_filter.hasFilter()) {
+        entryFilter |= QDir::Files;
+        if (m_includeSystemFiles) {
+            entryFilter |= QDir::System;
+        }
+    }
+
+    // Canonical targets of symlinked directories that were already entered.
+    // Same approach as QDirIterator::FollowSymlinks to avoid endless loops.
+    QSet<QString> visitedLinks;
+
+    QVector<QFileInfo> stack;
+    stack.append(QFileInfo(rootPath));
+
+    while (!stack.isEmpty()) {
+        const QFileInfo current = stack.takeLast();
+
+        QFileInfoList files;
+        // QDir::AllDirs lists directories regardless of the name filters.
+        QDirIterator it(current.filePath(), m_filter.filters(), entryFilter);
+        while (it.hasNext()) {
+            it.next();
+            const QFileInfo entry = it.fileInfo();
+            if (!entry.isDir()) {
+                files.append(entry);
+                continue;
+            }
+            if (entry.isSymLink()) {
+                const QString target = entry.canonicalFilePath();
+                if (target.isEmpty() || visitedLinks.contains(target)) {
+                    continue;
+                }
+                visitedLinks.insert(target);
+            }
+            if (m_shouldEnter && !m_shouldEnter(entry)) {
+                continue;
+            }
+            stack.append(entry);
+        }
+
+        if (!visitor(current, files)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace mediaelch
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "file/FileFilter.h"
+
+#include <QFileInfo>
+#include <QString>
+#include <functional>
+
+namespace mediaelch {
+
+/// \brief Recursively walks a directory tree and prunes excluded subtrees.
+///
+/// In contrast to QDirIterator::Subdirectories, a directory that is rejected
+/// by the directory predicate is never entered, i.e. none of its entries are
+/// listed.  Each directory is listed exactly once; files are filtered by the
+/// given FileFilter and directories are always listed.  Without any filter,
+/// only directories are walked.
+///
+/// \par Example
+/// \code{cpp}
+///   DirectoryWalker walker(filter, [](const QFileInfo& dir) { return dir.fileName() != "extras"; });
+///   walker.walk(path, [](const QFileInfo& dir, const QFileInfoList& files) {
+///       // ...
+///       return true;
+///   });
+/// \endcode
+class DirectoryWalker
+{
+public:
+    /// \brief Return false to skip the given directory and everything inside it.
+    /// \details Called exactly once for each subdirectory when its parent is listed,
+    ///          so it may also be used to collect directories without entering them.
+    using DirectoryPredicate = std::function<bool(const QFileInfo& directory)>;
+    /// \brief Called once for each entered directory with all of its files that
+    ///        match the file filter.  Return false to stop the walk.
+    using DirectoryVisitor = std::function<bool(const QFileInfo& directory, const QFileInfoList& files)>;
+
+    DirectoryWalker(FileFilter filter, DirectoryPredicate shouldEnter);
+
+    /// \brief Also list "system" files, e.g. broken symlinks. See QDir::System.
+    void setIncludeSystemFiles(bool include) { m_includeSystemFiles = include; }
+
+    /// \brief Walk the tree below rootPath.  The root directory itself is always visited.
+    /// \returns false if the walk was stopped by the visitor.
+    bool walk(const QString& rootPath, const DirectoryVisitor& visitor) const;
+
+private:
+    FileFilter m_filter;
+    DirectoryPredicate m_shouldEnter;
+    bool m_includeSystemFiles = false;
+};
+
+} // namespace mediaelch
@@ -1,7 +1,21 @@
 #include "file/FileFilter.h"
 
+#include "globals/Meta.h"
+
 namespace mediaelch {
 
+FileFilter::FileFilter(QStringList filters) : m_filters(std::move(filters))
+{
+    QStringList patterns;
+    for (const QString& filter : asConst(m_filters)) {
+        patterns << QStringLiteral("(?:%1)").arg(QRegularExpression::wildcardToRegularExpression(filter));
+    }
+    if (!patterns.isEmpty()) {
+        m_regex = QRegularExpression(patterns.join('|'), QRegularExpression::CaseInsensitiveOption);
+        m_regex.optimize();
+    }
+}
+
 QStringList FileFilter::files(QDir directory) const
 {
     if (m_filters.isEmpty() || !directory.exists()) {
@@ -20,4 +34,9 @@ QStringList FileFilter::filters() const
     return m_filters;
 }
 
+bool FileFilter::isFileMatched(const QString& fileName) const
+{
+    return hasFilter() && m_regex.match(fileName).hasMatch();
+}
+
 } // namespace mediaelch
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QDir>
+#include <QRegularExpression>
 #include <QString>
 #include <QStringList>
 
@@ -10,14 +11,19 @@ class FileFilter
 {
 public:
     FileFilter() = default;
-    explicit FileFilter(QStringList filters) : m_filters(std::move(filters)) {}
+    explicit FileFilter(QStringList filters);
 
     QStringList files(QDir directory) const;
     bool hasFilter() const;
     QStringList filters() const;
+    /// \brief Whether the given file name matches any of the filters.
+    /// \details Same semantics as QDir's name filters, i.e. case insensitive wildcards.
+    bool isFileMatched(const QString& fileName) const;
 
 private:
     QStringList m_filters;
+    /// \brief All wildcard filters combined into one regular expression.
+    QRegularExpression m_regex;
 };
 
 } // namespace mediaelch
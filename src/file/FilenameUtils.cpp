@@ -2,6 +2,7 @@
 
 #include "globals/Meta.h"
 
+#include <QHash>
 #include <QRegularExpression>
 #include <QStringList>
 #include <QVector>
@@ -52,6 +53,27 @@ QString stackedBaseName(const QString& fileName)
     return baseName;
 }
 
+QVector<QStringList> groupStackedFiles(const QStringList& files)
+{
+    QHash<QString, QStringList> stacked;
+    stacked.reserve(qsizetype_to_int(files.size()));
+    for (const QString& file : files) {
+        stacked[stackedBaseName(file)].append(file);
+    }
+
+    QStringList baseNames = stacked.keys();
+    baseNames.sort();
+
+    QVector<QStringList> groups;
+    groups.reserve(qsizetype_to_int(baseNames.size()));
+    for (const QString& baseName : asConst(baseNames)) {
+        QStringList group = stacked.take(baseName);
+        group.sort();
+        groups.append(group);
+    }
+    return groups;
+}
+
 QString withoutExtension(const QString& fileName)
 {
     return fileName.left(fileName.lastIndexOf("."));
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
+#include <QVector>
 
 namespace mediaelch {
 namespace file {
@@ -11,6 +13,11 @@ namespace file {
 ///          This function does _NOT_ remove the file path, hence the "stacked".
 QString stackedBaseName(const QString& fileName);
 
+/// \brief   Groups files with the same stackedBaseName(), e.g. "movie-cd1.mkv" and "movie-cd2.mkv".
+/// \details Each file's stacked base name is computed only once.  Groups are ordered
+///          by their stacked base name and files inside each group are sorted.
+QVector<QStringList> groupStackedFiles(const QStringList& files);
+
 /// \brief   Removes the file extension from the filename.
 /// \details Simply removes all text after the last dot. Does not require QFileInfo().
 ///          This is a naive implementation and should only be used for e.g. sorting.
@@ -0,0 +1,440 @@
+#include "file/LibraryWatcher.h"
+
+#include "globals/Meta.h"
+#include "log/Log.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+
+/// \brief If changes keep coming in, they are reported after at most this many debounce intervals.
+constexpr int MAX_DEBOUNCE_FACTOR = 10;
+
+qint64 lastModified(const QFileInfo& dir)
+{
+    return dir.lastModified().toMSecsSinceEpoch();
+}
+
+/// \brief List the given directory and all its subdirectories.
+mediaelch::LibraryWatcher::DirectoryTimes listTree(const QString& root,
+    const mediaelch::DirectoryWalker::DirectoryPredicate& shouldWatch)
+{
+    mediaelch::LibraryWatcher::DirectoryTimes directories;
+    // Without a file filter, only directories are listed.
+    mediaelch::DirectoryWalker walker(mediaelch::FileFilter({}), shouldWatch);
+    walker.walk(root, [&directories](const QFileInfo& dir, const QFileInfoList& /*files*/) {
+        if (!dir.isDir()) {
+            return true; // e.g. removed in the meantime
+        }
+        directories.insert(QDir::cleanPath(dir.absoluteFilePath()), lastModified(dir));
+        return true;
+    });
+    return directories;
+}
+
+/// \brief Direct subdirectories of the given directory.
+QStringList listChildren(const QString& directory, const mediaelch::DirectoryWalker::DirectoryPredicate& shouldWatch)
+{
+    QStringList children;
+    QDirIterator it(directory, QDir::AllDirs | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo entry = it.fileInfo();
+        if (!shouldWatch || shouldWatch(entry)) {
+            children << QDir::cleanPath(entry.absoluteFilePath());
+        }
+    }
+    return children;
+}
+
+bool isBelow(const QString& directory, const QString& parent)
+{
+    return directory.startsWith(parent) && directory.length() > parent.length() && directory.at(parent.length()) == '/';
+}
+
+/// \brief List all library directories and compare them to the known directories.
+mediaelch::LibraryWatcher::ScanResult listAll(const QVector<mediaelch::DirectoryPath>& roots,
+    const mediaelch::LibraryWatcher::DirectoryTimes& known,
+    const mediaelch::DirectoryWalker::DirectoryPredicate& shouldWatch,
+    bool initial)
+{
+    mediaelch::LibraryWatcher::ScanResult result;
+    result.initial = initial;
+    for (const mediaelch::DirectoryPath& root : roots) {
+        const auto tree = listTree(root.toString(), shouldWatch);
+        for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+            result.directories.insert(it.key(), it.value());
+        }
+    }
+    if (initial) {
+        return result;
+    }
+
+    for (auto it = result.directories.cbegin(); it != result.directories.cend(); ++it) {
+        const auto knownDir = known.constFind(it.key());
+        if (knownDir == known.constEnd() || knownDir.value() != it.value()) {
+            result.changed << it.key();
+        }
+    }
+    for (auto it = known.cbegin(); it != known.cend(); ++it) {
+        if (!result.directories.contains(it.key())) {
+            result.removed << it.key();
+        }
+    }
+    return result;
+}
+
+/// \brief List the given changed directories, new subdirectories and detect removed ones.
+mediaelch::LibraryWatcher::ScanResult listChanged(const QSet<QString>& changed,
+    const mediaelch::LibraryWatcher::DirectoryTimes& known,
+    const mediaelch::DirectoryWalker::DirectoryPredicate& shouldWatch)
+{
+    mediaelch::LibraryWatcher::ScanResult result;
+    QSet<QString> changedDirectories;
+    QSet<QString> removedDirectories;
+
+    const auto addRemoved = [&](const QString& removed) {
+        removedDirectories.insert(removed);
+        for (auto it = known.cbegin(); it != known.cend(); ++it) {
+            if (isBelow(it.key(), removed)) {
+                removedDirectories.insert(it.key());
+            }
+        }
+    };
+
+    for (const QString& directory : changed) {
+        const QFileInfo info(directory);
+        if (!info.isDir()) {
+            addRemoved(directory);
+            continue;
+        }
+
+        if (!known.contains(directory)) {
+            // Unknown directories are new, including all their subdirectories.
+            const auto tree = listTree(directory, shouldWatch);
+            for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+                result.directories.insert(it.key(), it.value());
+                changedDirectories.insert(it.key());
+            }
+            continue;
+        }
+
+        result.directories.insert(directory, lastModified(info));
+        changedDirectories.insert(directory);
+
+        const QStringList children = listChildren(directory, shouldWatch);
+        for (const QString& child : children) {
+            if (known.contains(child)) {
+                continue;
+            }
+            const auto tree = listTree(child, shouldWatch);
+            for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+                result.directories.insert(it.key(), it.value());
+                changedDirectories.insert(it.key());
+            }
+        }
+
+        for (auto it = known.cbegin(); it != known.cend(); ++it) {
+            if (QFileInfo(it.key()).path() == directory && !children.contains(it.key())) {
+                addRemoved(it.key());
+            }
+        }
+    }
+
+    for (const QString& removed : asConst(removedDirectories)) {
+        changedDirectories.remove(removed);
+    }
+    result.changed = changedDirectories.values();
+    result.removed = removedDirectories.values();
+    return result;
+}
+
+} // namespace
+
+namespace mediaelch {
+
+LibraryWatcher::LibraryWatcher(QObject* parent) : QObject(parent), m_watcher{new QFileSystemWatcher(this)}
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(2000);
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &LibraryWatcher::onDirectoryChanged);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &LibraryWatcher::onDebounceTimeout);
+    connect(&m_pollTimer, &QTimer::timeout, this, &LibraryWatcher::poll);
+    connect(&m_scan, &QFutureWatcher<ScanResult>::finished, this, &LibraryWatcher::onScanFinished);
+}
+
+void LibraryWatcher::setDebounceInterval(int milliseconds)
+{
+    m_debounceTimer.setInterval(milliseconds);
+}
+
+void LibraryWatcher::setPollInterval(int milliseconds)
+{
+    if (milliseconds <= 0) {
+        m_pollTimer.stop();
+        return;
+    }
+    m_pollTimer.start(milliseconds);
+}
+
+void LibraryWatcher::setNotificationsEnabled(bool enabled)
+{
+    if (enabled == m_notificationsEnabled) {
+        return;
+    }
+    m_notificationsEnabled = enabled;
+    if (enabled && !m_directories.isEmpty()) {
+        m_watcher->addPaths(m_directories.keys());
+        return;
+    }
+    const QStringList watched = m_watcher->directories();
+    if (!enabled && !watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+}
+
+void LibraryWatcher::setDirectoryFilter(DirectoryWalker::DirectoryPredicate shouldWatch)
+{
+    m_shouldWatch = std::move(shouldWatch);
+}
+
+void LibraryWatcher::setDirectories(const QVector<DirectoryPath>& directories)
+{
+    if (directories == m_libraryDirectories) {
+        return;
+    }
+    clear();
+    m_libraryDirectories = directories;
+    if (m_libraryDirectories.isEmpty()) {
+        return;
+    }
+
+    qCInfo(generic) << "[LibraryWatcher] Watching" << m_libraryDirectories.size() << "library directories";
+    const QVector<DirectoryPath> roots = m_libraryDirectories;
+    const auto shouldWatch = m_shouldWatch;
+    startScan([roots, shouldWatch]() { return listAll(roots, {}, shouldWatch, true); });
+}
+
+void LibraryWatcher::clear()
+{
+    // Discard the result of a running scan.  An empty future is canceled.
+    m_scan.setFuture(QFuture<ScanResult>());
+    m_debounceTimer.stop();
+    m_pending.clear();
+    m_pendingSince.invalidate();
+    m_libraryDirectories.clear();
+    m_directories.clear();
+
+    const QStringList watched = m_watcher->directories();
+    if (!watched.isEmpty()) {
+        m_watcher->removePaths(watched);
+    }
+}
+
+void LibraryWatcher::pause()
+{
+    m_paused = true;
+    m_debounceTimer.stop();
+}
+
+void LibraryWatcher::resume()
+{
+    m_paused = false;
+    scheduleFlush();
+}
+
+QStringList LibraryWatcher::removedFiles(const QSet<QString>& files, const QStringList& changedDirectories)
+{
+    QSet<QString> changed;
+    for (const QString& directory : changedDirectories) {
+        changed.insert(QDir::cleanPath(directory));
+    }
+
+    QStringList removed;
+    QHash<QString, bool> existingDirectories;
+    for (const QString& file : files) {
+        const QString directory = QDir::cleanPath(QFileInfo(file).path());
+        if (changed.contains(directory)) {
+            if (!QFileInfo(file).isFile()) {
+                removed << file;
+            }
+            continue;
+        }
+        // Removed directories are not reported, but their parent directory is.
+        // Files of any other directory can only be removed together with their directory.
+        const bool isBelowChanged = std::any_of(changed.cbegin(), changed.cend(), [&directory](const QString& dir) {
+            return isBelow(directory, dir);
+        });
+        if (!isBelowChanged) {
+            continue;
+        }
+        auto exists = existingDirectories.find(directory);
+        if (exists == existingDirectories.end()) {
+            exists = existingDirectories.insert(directory, QFileInfo(directory).isDir());
+        }
+        if (!exists.value()) {
+            removed << file;
+        }
+    }
+    return removed;
+}
+
+void LibraryWatcher::onDirectoryChanged(const QString& directory)
+{
+    m_pending.insert(QDir::cleanPath(directory));
+    if (!m_pendingSince.isValid()) {
+        m_pendingSince.start();
+    }
+    if (m_paused) {
+        return;
+    }
+    // Restart the timer with each notification, so that bursts are reported at once.
+    // Directories that change continuously (e.g. while a file is being downloaded)
+    // are reported after some time nonetheless.
+    if (m_pendingSince.elapsed() < MAX_DEBOUNCE_FACTOR * m_debounceTimer.interval()) {
+        m_debounceTimer.start();
+    } else if (!m_debounceTimer.isActive()) {
+        onDebounceTimeout();
+    }
+}
+
+void LibraryWatcher::onDebounceTimeout()
+{
+    if (m_paused || m_pending.isEmpty()) {
+        return;
+    }
+    if (m_scan.isRunning()) {
+        // Handled as soon as the current scan has finished.
+        return;
+    }
+
+    const QSet<QString> pending = m_pending;
+    const DirectoryTimes known = m_directories;
+    const auto shouldWatch = m_shouldWatch;
+    m_pending.clear();
+    m_pendingSince.invalidate();
+
+    startScan([pending, known, shouldWatch]() { return listChanged(pending, known, shouldWatch); });
+}
+
+void LibraryWatcher::poll()
+{
+    if (m_paused || m_scan.isRunning() || m_libraryDirectories.isEmpty()) {
+        return;
+    }
+    const QVector<DirectoryPath> roots = m_libraryDirectories;
+    const DirectoryTimes known = m_directories;
+    const auto shouldWatch = m_shouldWatch;
+    startScan([roots, known, shouldWatch]() { return listAll(roots, known, shouldWatch, false); });
+}
+
+void LibraryWatcher::onScanFinished()
+{
+    if (m_scan.isCanceled()) {
+        return;
+    }
+    const ScanResult result = m_scan.result();
+    if (m_paused && !result.initial) {
+        // The scan was started before pause().  Its directories are listed
+        // again after resume(), so that changes are not reported while paused.
+        for (const QString& directory : result.changed + result.removed) {
+            m_pending.insert(directory);
+        }
+        if (!m_pending.isEmpty() && !m_pendingSince.isValid()) {
+            m_pendingSince.start();
+        }
+        emit scanFinished();
+        return;
+    }
+    applyScanResult(result);
+    scheduleFlush();
+    emit scanFinished();
+}
+
+void LibraryWatcher::startScan(std::function<ScanResult()> scan)
+{
+    // Setting a new future discards the result of a running scan, e.g. if the
+    // library directories changed in the meantime.
+    m_scan.setFuture(QtConcurrent::run(std::move(scan)));
+}
+
+void LibraryWatcher::scheduleFlush()
+{
+    if (!m_paused && !m_pending.isEmpty() && !m_debounceTimer.isActive()) {
+        m_debounceTimer.start();
+    }
+}
+
+void LibraryWatcher::applyScanResult(const ScanResult& result)
+{
+    for (const QString& removed : result.removed) {
+        m_directories.remove(removed);
+    }
+    if (!result.removed.isEmpty()) {
+        // Removed directories are usually unwatched automatically.
+        const QStringList watched = m_watcher->directories();
+        QStringList unwatch;
+        for (const QString& removed : result.removed) {
+            if (watched.contains(removed)) {
+                unwatch << removed;
+            }
+        }
+        if (!unwatch.isEmpty()) {
+            m_watcher->removePaths(unwatch);
+        }
+    }
+
+    QStringList newDirectories;
+    for (auto it = result.directories.cbegin(); it != result.directories.cend(); ++it) {
+        if (!m_directories.contains(it.key())) {
+            newDirectories << it.key();
+        }
+        m_directories.insert(it.key(), it.value());
+    }
+    if (m_notificationsEnabled && !newDirectories.isEmpty()) {
+        const QStringList failed = m_watcher->addPaths(newDirectories);
+        if (!failed.isEmpty()) {
+            // e.g. if the inotify watch limit is reached; polling still works
+            qCWarning(generic) << "[LibraryWatcher] Could not watch" << failed.size()
+                               << "directories, changes in them are only detected by polling";
+        }
+    }
+
+    if (result.initial || result.changed.isEmpty()) {
+        return;
+    }
+
+    QHash<DirectoryPath, QStringList> changedByLibrary;
+    for (const QString& changed : result.changed) {
+        const DirectoryPath library = libraryDirectoryOf(changed);
+        if (library.isValid()) {
+            changedByLibrary[library].append(changed);
+        }
+    }
+    for (auto it = changedByLibrary.cbegin(); it != changedByLibrary.cend(); ++it) {
+        qCDebug(generic) << "[LibraryWatcher] Changes in" << it.value().size() << "directories of" << it.key();
+        emit directoriesChanged(it.key(), it.value());
+    }
+}
+
+DirectoryPath LibraryWatcher::libraryDirectoryOf(const QString& directory) const
+{
+    // Library directories may be nested.  Use the innermost one.
+    DirectoryPath library;
+    int length = -1;
+    for (const DirectoryPath& root : m_libraryDirectories) {
+        const QString rootPath = QDir::cleanPath(root.toString());
+        if ((directory == rootPath || isBelow(directory, rootPath)) && rootPath.length() > length) {
+            library = root;
+            length = qsizetype_to_int(rootPath.length());
+        }
+    }
+    return library;
+}
+
+} // namespace mediaelch
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "file/DirectoryWalker.h"
+#include "file/Path.h"
+
+#include <QElapsedTimer>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+namespace mediaelch {
+
+/// \brief Watches library directories and reports directories whose contents changed.
+///
+/// All directories below the library directories are watched using
+/// QFileSystemWatcher, i.e. inotify on Linux.  Bursts of change notifications
+/// are debounced and new subdirectories are watched as soon as they appear.
+/// Network shares often do not deliver change notifications, which is why
+/// the directory tree can additionally be polled: The modification times of
+/// all directories are compared to the previous poll.
+///
+/// Directory trees are listed in a worker thread.  Only directories are
+/// listed, never files.
+///
+/// \par Example
+/// \code{cpp}
+///   LibraryWatcher watcher;
+///   watcher.setPollInterval(5 * 60 * 1000);
+///   connect(&watcher, &LibraryWatcher::directoriesChanged, this, &MyClass::onChanged);
+///   watcher.setDirectories(directories);
+/// \endcode
+class LibraryWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// \brief Directories and their modification time in milliseconds since epoch.
+    using DirectoryTimes = QHash<QString, qint64>;
+
+    explicit LibraryWatcher(QObject* parent = nullptr);
+    /// \note Scans only work on copies, i.e. a running scan may outlive the watcher.
+    ~LibraryWatcher() override = default;
+
+    /// \brief Time in milliseconds to wait for further changes before changes are reported.
+    void setDebounceInterval(int milliseconds);
+    /// \brief Poll the directory trees every n milliseconds.  0 disables polling.
+    void setPollInterval(int milliseconds);
+    /// \brief   Use file system notifications to detect changes.  Enabled by default.
+    /// \details If disabled, changes are only detected by polling, see poll().
+    void setNotificationsEnabled(bool enabled);
+    /// \brief Subdirectories for which the predicate returns false are not watched.
+    /// \details Called from a worker thread, i.e. the predicate must be thread-safe.
+    void setDirectoryFilter(DirectoryWalker::DirectoryPredicate shouldWatch);
+
+    /// \brief Watch the given library directories.  Previous directories are no longer watched.
+    /// \details Does nothing if the directories did not change.
+    void setDirectories(const QVector<DirectoryPath>& directories);
+    /// \brief Stop watching all directories.
+    void clear();
+
+    /// \brief Changes are collected but not reported until resume() is called.
+    /// \details Used while the library is reloaded completely.
+    void pause();
+    void resume();
+
+    /// \brief   Files of \p files that no longer exist, given the directories of directoriesChanged().
+    /// \details Only files below the changed directories are checked.  Files of other
+    ///          directories are only checked if their directory still exists, i.e. each
+    ///          directory is accessed once.
+    static QStringList removedFiles(const QSet<QString>& files, const QStringList& changedDirectories);
+
+public slots:
+    /// \brief List all directory trees in a worker thread and report changes.
+    /// \details Called by the poll timer.  Does nothing while paused or while another scan is running.
+    void poll();
+
+signals:
+    /// \brief   Contents of the given directories below a library directory changed.
+    /// \details New directories are reported together with all their subdirectories.
+    ///          Removed directories are not reported, but their parent directory is.
+    void directoriesChanged(mediaelch::DirectoryPath libraryDirectory, QStringList directories);
+    /// \brief A scan of the worker thread finished and its changes, if any, were reported.
+    void scanFinished();
+
+private slots:
+    void onDirectoryChanged(const QString& directory);
+    void onDebounceTimeout();
+    void onScanFinished();
+
+public:
+    /// \brief Result of listing (parts of) the watched directory trees.
+    struct ScanResult
+    {
+        /// \brief Modification times of all directories that were listed.
+        DirectoryTimes directories;
+        /// \brief Directories that are new or whose modification time changed.
+        QStringList changed;
+        /// \brief Directories that no longer exist.
+        QStringList removed;
+        /// \brief If true, this is the initial listing and nothing is reported.
+        bool initial = false;
+    };
+
+private:
+    void startScan(std::function<ScanResult()> scan);
+    void scheduleFlush();
+    void applyScanResult(const ScanResult& result);
+    /// \brief Library directory that the given directory belongs to.
+    DirectoryPath libraryDirectoryOf(const QString& directory) const;
+
+private:
+    QVector<DirectoryPath> m_libraryDirectories;
+    DirectoryWalker::DirectoryPredicate m_shouldWatch;
+    QFileSystemWatcher* m_watcher = nullptr;
+    /// \brief All known directories below the library directories.
+    DirectoryTimes m_directories;
+    /// \brief Directories with change notifications that were not handled, yet.
+    QSet<QString> m_pending;
+    QElapsedTimer m_pendingSince;
+
+    QTimer m_debounceTimer;
+    QTimer m_pollTimer;
+    QFutureWatcher<ScanResult> m_scan;
+    bool m_paused = false;
+    bool m_notificationsEnabled = true;
+};
+
+} // namespace mediaelch
@@ -18,6 +18,7 @@
 #include <QPushButton>
 #include <QRegularExpression>
 #include <QSpinBox>
+#include <QVarLengthArray>
 #include <QWidget>
 
 namespace helper {
@@ -574,6 +575,103 @@ void applyEffect(QWidget* parent)
     }
 }
 
+/// \brief Levenshtein distance using Myers' bit-parallel algorithm (in Hyyrö's
+///        formulation).  The pattern must not be empty and have at most 64 characters.
+static int levenshteinBitParallel(const QString& pattern, const QString& text)
+{
+    // Match masks: bit i is set if pattern[i] equals the character.  Latin-1
+    // characters, i.e. nearly all characters in file names, are looked up
+    // directly, others through a linear search.
+    quint64 latin1Masks[256] = {};
+    ushort otherChars[64];
+    quint64 otherMasks[64];
+    int otherCount = 0;
+
+    const int patternLength = qsizetype_to_int(pattern.length());
+    for (int i = 0; i < patternLength; ++i) {
+        const ushort c = pattern.at(i).unicode();
+        const quint64 bit = quint64(1) << i;
+        if (c < 256) {
+            latin1Masks[c] |= bit;
+            continue;
+        }
+        int k = 0;
+        while (k < otherCount && otherChars[k] != c) {
+            ++k;
+        }
+        if (k == otherCount) {
+            otherChars[k] = c;
+            otherMasks[k] = 0;
+            ++otherCount;
+        }
+        otherMasks[k] |= bit;
+    }
+
+    const quint64 lastBit = quint64(1) << (patternLength - 1);
+    quint64 vp = ~quint64(0); // vertical +1 deltas
+    quint64 vn = 0;           // vertical -1 deltas
+    int distance = patternLength;
+
+    for (const QChar& character : text) {
+        const ushort c = character.unicode();
+        quint64 eq = 0;
+        if (c < 256) {
+            eq = latin1Masks[c];
+        } else {
+            for (int k = 0; k < otherCount; ++k) {
+                if (otherChars[k] == c) {
+                    eq = otherMasks[k];
+                    break;
+                }
+            }
+        }
+
+        const quint64 xv = eq | vn;
+        const quint64 xh = (((eq & vp) + vp) ^ vp) | eq;
+        quint64 hp = vn | ~(xh | vp);
+        quint64 hn = vp & xh;
+        if ((hp & lastBit) != 0) {
+            ++distance;
+        } else if ((hn & lastBit) != 0) {
+            --distance;
+        }
+        // The first row of the distance matrix increases by one in each column.
+        hp = (hp << 1) | 1;
+        hn = hn << 1;
+        vp = hn | ~(xv | hp);
+        vn = hp & xv;
+    }
+    return distance;
+}
+
+/// \brief Levenshtein distance using a single row of the distance matrix.
+///        \p s2 should be the shorter string.
+static int levenshteinSingleRow(const QString& s1, const QString& s2)
+{
+    const int len2 = qsizetype_to_int(s2.length());
+    // Strings up to this length do not need heap allocations.
+    QVarLengthArray<int, 256> row(len2 + 1);
+    for (int j = 0; j <= len2; ++j) {
+        row[j] = j;
+    }
+
+    int i = 0;
+    for (const QChar& c1 : s1) {
+        ++i;
+        int diagonal = row[0]; // d[i - 1][j - 1]
+        row[0] = i;
+        for (int j = 1; j <= len2; ++j) {
+            const int above = row[j]; // d[i - 1][j]
+            row[j] = qMin(qMin(above + 1, row[j - 1] + 1), diagonal + (c1 == s2.at(j - 1) ? 0 : 1));
+            diagonal = above;
+        }
+    }
+    return row[len2];
+}
+
+/// \brief Similarity of two strings based on their Levenshtein distance.
+/// \returns 1 for identical strings, 0 if one of them is empty.  Otherwise
+///          1 - distance / max(|s1|, |s2|).
 qreal similarity(const QString& s1, const QString& s2)
 {
     const elch_size_t len1 = s1.length();
@@ -587,26 +685,14 @@ qreal similarity(const QString& s1, const QString& s2)
         return 0;
     }
 
-    QVector<QVector<int>> d(len1);
-
-    d.insert(0, QVector<int>(len1));
-    d[0].insert(0, 0);
-    for (int i = 1; i <= len1; ++i) {
-        d.insert(i, QVector<int>());
-        d[i].insert(0, i);
-    }
-    for (int i = 1; i <= len2; ++i) {
-        d[0].insert(i, i);
-    }
-
-    for (int i = 1; i <= len1; ++i) {
-        for (int j = 1; j <= len2; ++j) {
-            d[i].insert(j,
-                qMin(qMin(d[i - 1][j] + 1, d[i][j - 1] + 1), d[i - 1][j - 1] + (s1.at(i - 1) == s2.at(j - 1) ? 0 : 1)));
-        }
-    }
+    // The Levenshtein distance is symmetric, so use the shorter string as the
+    // pattern resp. for the row of the distance matrix.
+    const QString& longer = len1 >= len2 ? s1 : s2;
+    const QString& shorter = len1 >= len2 ? s2 : s1;
+    const int distance = shorter.length() <= 64 ? levenshteinBitParallel(shorter, longer)
+                                                : levenshteinSingleRow(longer, shorter);
 
-    qreal dist = d[len1][len2];
+    qreal dist = distance;
     return 1 - (dist / static_cast<qreal>(qMax(len1, len2)));
 }
 
@@ -0,0 +1,111 @@
+#include "globals/LibraryUpdater.h"
+
+#include "globals/Manager.h"
+#include "log/Log.h"
+#include "settings/Settings.h"
+
+#include <memory>
+
+namespace mediaelch {
+
+LibraryUpdater::LibraryUpdater(QObject* parent) :
+    QObject(parent),
+    m_movieWatcher{createWatcher()},
+    m_tvShowWatcher{createWatcher()},
+    m_concertWatcher{createWatcher()},
+    m_musicWatcher{createWatcher()}
+{
+    // clang-format off
+    connect(m_movieWatcher,   &LibraryWatcher::directoriesChanged, this, &LibraryUpdater::onMovieDirectoriesChanged);
+    connect(m_tvShowWatcher,  &LibraryWatcher::directoriesChanged, this, &LibraryUpdater::onTvShowDirectoriesChanged);
+    connect(m_concertWatcher, &LibraryWatcher::directoriesChanged, this, &LibraryUpdater::onConcertDirectoriesChanged);
+    connect(m_musicWatcher,   &LibraryWatcher::directoriesChanged, this, &LibraryUpdater::onMusicDirectoriesChanged);
+    // clang-format on
+}
+
+void LibraryUpdater::pause()
+{
+    m_movieWatcher->pause();
+    m_tvShowWatcher->pause();
+    m_concertWatcher->pause();
+    m_musicWatcher->pause();
+}
+
+void LibraryUpdater::resume()
+{
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
+    if (!advanced->watchLibrary()) {
+        return;
+    }
+
+    const DirectorySettings& directories = Settings::instance()->directorySettings();
+    const DirectoryWalker::DirectoryPredicate shouldWatch = directoryFilter(*advanced);
+    for (LibraryWatcher* watcher : {m_movieWatcher, m_tvShowWatcher, m_concertWatcher, m_musicWatcher}) {
+        watcher->setDirectoryFilter(shouldWatch);
+        watcher->setDebounceInterval(advanced->watchDebounceInterval());
+        watcher->setPollInterval(advanced->watchPollInterval() * 1000);
+    }
+    m_movieWatcher->setDirectories(enabledDirectories(directories.movieDirectories()));
+    m_tvShowWatcher->setDirectories(enabledDirectories(directories.tvShowDirectories()));
+    m_concertWatcher->setDirectories(enabledDirectories(directories.concertDirectories()));
+    m_musicWatcher->setDirectories(enabledDirectories(directories.musicDirectories()));
+
+    m_movieWatcher->resume();
+    m_tvShowWatcher->resume();
+    m_concertWatcher->resume();
+    m_musicWatcher->resume();
+}
+
+void LibraryUpdater::onMovieDirectoriesChanged(DirectoryPath movieDir, QStringList directories)
+{
+    Manager::instance()->movieFileSearcher()->loadNewMovies(movieDir, directories);
+}
+
+void LibraryUpdater::onTvShowDirectoriesChanged(DirectoryPath tvShowDir, QStringList directories)
+{
+    Manager::instance()->tvShowFileSearcher()->updateShows(tvShowDir, directories);
+}
+
+void LibraryUpdater::onConcertDirectoriesChanged(DirectoryPath concertDir, QStringList directories)
+{
+    Manager::instance()->concertFileSearcher()->loadNewConcerts(concertDir, directories);
+}
+
+void LibraryUpdater::onMusicDirectoriesChanged(DirectoryPath musicDir, QStringList directories)
+{
+    Manager::instance()->musicFileSearcher()->updateArtists(musicDir, directories);
+}
+
+LibraryWatcher* LibraryUpdater::createWatcher()
+{
+    auto* watcher = new LibraryWatcher(this);
+    watcher->setDirectoryFilter(directoryFilter(*Settings::instance()->advanced()));
+    return watcher;
+}
+
+DirectoryWalker::DirectoryPredicate LibraryUpdater::directoryFilter(const AdvancedSettings& advanced)
+{
+    // The filter is called from the watcher's worker threads, but Settings is not
+    // thread-safe.  Use a copy of the current exclude patterns instead.
+    const auto settings = std::make_shared<const AdvancedSettings>(advanced);
+
+    // Artwork folders change whenever images are saved, but never contain media files.
+    const QStringList skippedDirectories{".actors", "extrafanart", "extrathumbs"};
+    return [settings, skippedDirectories](const QFileInfo& dir) {
+        const QString dirName = dir.fileName();
+        return !settings->isFolderExcluded(dirName) && !skippedDirectories.contains(dirName, Qt::CaseInsensitive);
+    };
+}
+
+QVector<DirectoryPath> LibraryUpdater::enabledDirectories(const QVector<SettingsDir>& directories)
+{
+    QVector<DirectoryPath> enabled;
+    for (const SettingsDir& dir : directories) {
+        if (!dir.disabled) {
+            enabled << DirectoryPath(dir.path);
+        }
+    }
+    return enabled;
+}
+
+} // namespace mediaelch
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "file/LibraryWatcher.h"
+#include "file/Path.h"
+#include "globals/Globals.h"
+
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+
+class AdvancedSettings;
+
+namespace mediaelch {
+
+/// \brief Loads changes of movie, TV show, concert and music directories automatically.
+///
+/// If enabled in the advanced settings, the library directories are watched
+/// using LibraryWatcher.  Changed directories are passed to the respective
+/// file searcher, which only loads the affected directories.
+/// Updates are paused while the library is reloaded using FileScannerDialog.
+class LibraryUpdater : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LibraryUpdater(QObject* parent = nullptr);
+    ~LibraryUpdater() override = default;
+
+public slots:
+    /// \brief Pause updates, e.g. while the whole library is reloaded.
+    void pause();
+    /// \brief Update the watched directories from the settings and resume updates.
+    void resume();
+
+private slots:
+    void onMovieDirectoriesChanged(mediaelch::DirectoryPath movieDir, QStringList directories);
+    void onTvShowDirectoriesChanged(mediaelch::DirectoryPath tvShowDir, QStringList directories);
+    void onConcertDirectoriesChanged(mediaelch::DirectoryPath concertDir, QStringList directories);
+    void onMusicDirectoriesChanged(mediaelch::DirectoryPath musicDir, QStringList directories);
+
+private:
+    LibraryWatcher* createWatcher();
+    /// \brief Directories that are watched.  Uses a copy of the given settings, i.e. is thread-safe.
+    static DirectoryWalker::DirectoryPredicate directoryFilter(const AdvancedSettings& advanced);
+    static QVector<DirectoryPath> enabledDirectories(const QVector<SettingsDir>& directories);
+
+private:
+    LibraryWatcher* m_movieWatcher = nullptr;
+    LibraryWatcher* m_tvShowWatcher = nullptr;
+    LibraryWatcher* m_concertWatcher = nullptr;
+    LibraryWatcher* m_musicWatcher = nullptr;
+};
+
+} // namespace mediaelch
@@ -0,0 +1,72 @@
+#include "globals/LoaderThreadPool.h"
+
+#include "log/Log.h"
+
+#include <QCoreApplication>
+#include <QMutexLocker>
+
+namespace mediaelch {
+
+LoaderThreadPool* LoaderThreadPool::instance()
+{
+    static LoaderThreadPool* s_instance = new LoaderThreadPool(QCoreApplication::instance());
+    return s_instance;
+}
+
+LoaderThreadPool::LoaderThreadPool(QObject* parent) : QObject(parent)
+{
+}
+
+LoaderThreadPool::~LoaderThreadPool()
+{
+    QMutexLocker lock(&m_mutex);
+    const QVector<QThread*> threads = std::move(m_threads);
+    m_threads.clear();
+    m_idleThreads.clear();
+    lock.unlock();
+
+    for (QThread* thread : threads) {
+        thread->quit();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+QThread* LoaderThreadPool::acquire(QThread::Priority priority)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_idleThreads.isEmpty()) {
+        // The most recently used thread has the most recently used database connection.
+        QThread* thread = m_idleThreads.takeLast();
+        thread->setPriority(priority);
+        return thread;
+    }
+
+    auto* thread = new QThread();
+    thread->setObjectName(QStringLiteral("LoaderThread%1").arg(m_threads.size() + 1));
+    m_threads.append(thread);
+    thread->start(priority);
+    return thread;
+}
+
+void LoaderThreadPool::release(QThread* thread)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_threads.contains(thread) || m_idleThreads.contains(thread)) {
+        return;
+    }
+    m_idleThreads.append(thread);
+    if (m_idleThreads.size() <= MAX_IDLE_THREADS) {
+        return;
+    }
+
+    QThread* oldest = m_idleThreads.takeFirst();
+    m_threads.removeOne(oldest);
+    qCDebug(generic) << "[LoaderThreadPool] Stopping idle thread" << oldest->objectName();
+    QObject::connect(oldest, &QThread::finished, oldest, &QObject::deleteLater);
+    oldest->quit();
+}
+
+} // namespace mediaelch
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QMetaObject>
+#include <QMutex>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+
+namespace mediaelch {
+
+/// \brief Threads that run loaders, e.g. the TvShowLoader.
+///
+/// Loaders use their own database connection, which can only be used by the
+/// thread that opened it.  Threads are therefore kept running once their loader
+/// has finished and are reused by the next loader.  Its database connection is
+/// then taken from the connection pool, see Database::newConnection().
+///
+/// \par Example
+/// \code{cpp}
+///   auto* loader = new TvShowLoader(directories, false, store, nullptr);
+///   connect(loader, &TvShowLoader::finished, this, &MyClass::onFinished);
+///   runInLoaderThread(loader, QThread::HighPriority);
+/// \endcode
+class LoaderThreadPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// \brief The pool of the application.  Its threads are stopped when the application quits.
+    static LoaderThreadPool* instance();
+
+    explicit LoaderThreadPool(QObject* parent = nullptr);
+    /// \brief Stops all threads and waits until their loaders have finished.
+    ~LoaderThreadPool() override;
+
+    /// \brief   Get a running thread without loader.  Idle threads are reused.
+    /// \details Thread-safe.  Must be released once its loader has finished.
+    QThread* acquire(QThread::Priority priority);
+    /// \brief   The thread's loader has finished.  The thread may be used by the next loader.
+    /// \details Thread-safe.  Idle threads exceeding the limit are stopped.
+    void release(QThread* thread);
+
+private:
+    /// \brief Idle threads are kept running, at most this many.
+    static constexpr int MAX_IDLE_THREADS = 4;
+
+    QMutex m_mutex;
+    QVector<QThread*> m_threads;
+    QVector<QThread*> m_idleThreads;
+};
+
+/// \brief   Move the worker to a thread of the LoaderThreadPool and call its start() method there.
+/// \details The thread is released once the worker emits finished().  The worker is
+///          not deleted; use deleteLater() once it has finished.
+template<class Worker>
+void runInLoaderThread(Worker* worker, QThread::Priority priority = QThread::InheritPriority)
+{
+    LoaderThreadPool* pool = LoaderThreadPool::instance();
+    QThread* thread = pool->acquire(priority);
+    worker->moveToThread(thread);
+    // Released by the loader's thread, i.e. before finished() is delivered to other threads.
+    QObject::connect(
+        worker, &Worker::finished, pool, [pool, thread]() { pool->release(thread); }, Qt::DirectConnection);
+    QMetaObject::invokeMethod(worker, &Worker::start, Qt::QueuedConnection);
+}
+
+} // namespace mediaelch
@@ -25,6 +25,7 @@ Manager::Manager(QObject* parent) : QObject(parent)
     m_tvShowFileSearcher = new TvShowFileSearcher(this);
     m_concertFileSearcher = new ConcertFileSearcher(this);
     m_musicFileSearcher = new MusicFileSearcher(this);
+    m_libraryUpdater = new mediaelch::LibraryUpdater(this);
     m_movieModel = new MovieModel(this);
     m_tvShowModel = new TvShowModel(this);
     m_concertModel = new ConcertModel(this);
@@ -117,6 +118,11 @@ MusicFileSearcher* Manager::musicFileSearcher()
     return m_musicFileSearcher;
 }
 
+mediaelch::LibraryUpdater* Manager::libraryUpdater()
+{
+    return m_libraryUpdater;
+}
+
 /**
  * \brief Returns an instance of the MovieModel
  * \return Instance of the MovieModel
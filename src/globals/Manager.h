@@ -3,6 +3,7 @@
 #include "concerts/ConcertFileSearcher.h"
 #include "concerts/ConcertModel.h"
 #include "data/Database.h"
+#include "globals/LibraryUpdater.h"
 #include "globals/ScraperManager.h"
 #include "media_centers/MediaCenterInterface.h"
 #include "movies/MovieModel.h"
@@ -48,6 +49,7 @@ public:
     ELCH_NODISCARD TvShowFileSearcher* tvShowFileSearcher();
     ELCH_NODISCARD ConcertFileSearcher* concertFileSearcher();
     ELCH_NODISCARD MusicFileSearcher* musicFileSearcher();
+    ELCH_NODISCARD mediaelch::LibraryUpdater* libraryUpdater();
     ELCH_NODISCARD Database* database();
     ELCH_NODISCARD MovieModel* movieModel();
     ELCH_NODISCARD TvShowModel* tvShowModel();
@@ -82,5 +84,6 @@ private:
     MusicFilesWidget* m_musicFilesWidget = nullptr;
     FileScannerDialog* m_fileScannerDialog = nullptr;
     MusicFileSearcher* m_musicFileSearcher = nullptr;
+    mediaelch::LibraryUpdater* m_libraryUpdater = nullptr;
     MyIconFont* m_iconFont = nullptr;
 };
@@ -1,5 +1,6 @@
 #include "KodiXml.h"
 
+#include "file/DirectorySnapshot.h"
 #include "globals/Globals.h"
 #include "globals/Helper.h"
 #include "globals/Manager.h"
@@ -194,6 +195,11 @@ bool KodiXml::saveMovie(Movie* movie)
  * \return Path to nfo file, if none found returns an empty string
  */
 QString KodiXml::nfoFilePath(Movie* movie)
+{
+    return nfoFilePath(movie, nullptr);
+}
+
+QString KodiXml::nfoFilePath(Movie* movie, const mediaelch::DirectorySnapshot* snapshot)
 {
     QString nfoFile;
     if (movie->files().isEmpty()) {
@@ -201,15 +207,17 @@ QString KodiXml::nfoFilePath(Movie* movie)
         return nfoFile;
     }
     QFileInfo fi(movie->files().first().toString());
-    if (!fi.isFile()) {
+    const bool isFile = (snapshot != nullptr) ? snapshot->fileExists(fi.absolutePath(), fi.fileName()) : fi.isFile();
+    if (!isFile) {
         qCWarning(generic) << "First file of the movie is not readable" << movie->files().at(0);
         return nfoFile;
     }
 
     for (DataFile dataFile : Settings::instance()->dataFiles(DataFileType::MovieNfo)) {
         QString file = dataFile.saveFileName(fi.fileName(), SeasonNumber::NoSeason, movie->files().count() > 1);
-        QFileInfo nfoFi(fi.absolutePath() + "/" + file);
-        if (nfoFi.exists()) {
+        const bool exists = (snapshot != nullptr) ? snapshot->fileExists(fi.absolutePath(), file)
+                                                  : QFileInfo::exists(fi.absolutePath() + "/" + file);
+        if (exists) {
             nfoFile = fi.absolutePath() + "/" + file;
             break;
         }
@@ -297,14 +305,14 @@ QString KodiXml::nfoFilePath(Concert* concert)
  * \param movie Movie to load
  * \return Loading success
  */
-bool KodiXml::loadMovie(Movie* movie, QString initialNfoContent)
+bool KodiXml::loadMovie(Movie* movie, QString initialNfoContent, const mediaelch::DirectorySnapshot* snapshot)
 {
     movie->clear();
     movie->setChanged(false);
 
     QString nfoContent;
     if (initialNfoContent.isEmpty()) {
-        QString nfoFile = nfoFilePath(movie);
+        QString nfoFile = nfoFilePath(movie, snapshot);
         if (nfoFile.isEmpty()) {
             return false;
         }
@@ -332,7 +340,7 @@ bool KodiXml::loadMovie(Movie* movie, QString initialNfoContent)
     // Existence of images
     if (initialNfoContent.isEmpty()) {
         for (const auto imageType : Movie::imageTypes()) {
-            movie->images().setHasImage(imageType, !imageFileName(movie, imageType).isEmpty());
+            movie->images().setHasImage(imageType, !imageFileName(movie, imageType, {}, false, snapshot).isEmpty());
         }
         movie->images().setHasExtraFanarts(!extraFanartNames(movie).isEmpty());
     }
@@ -1252,6 +1260,15 @@ QString KodiXml::movieSetFileName(QString setName, DataFile* dataFile)
 }
 
 QString KodiXml::imageFileName(const Movie* movie, ImageType type, QVector<DataFile> dataFiles, bool constructName)
+{
+    return imageFileName(movie, type, std::move(dataFiles), constructName, nullptr);
+}
+
+QString KodiXml::imageFileName(const Movie* movie,
+    ImageType type,
+    QVector<DataFile> dataFiles,
+    bool constructName,
+    const mediaelch::DirectorySnapshot* snapshot)
 {
     DataFileType fileType = [type]() {
         switch (type) {
@@ -1291,8 +1308,13 @@ QString KodiXml::imageFileName(const Movie* movie, ImageType type, QVector<DataF
             }
         }
         mediaelch::DirectoryPath path = getPath(movie);
-        QFileInfo pFi(path.filePath(file));
-        if (pFi.isFile() || constructName) {
+        if (constructName) {
+            fileName = path.filePath(file);
+            break;
+        }
+        const bool exists =
+            (snapshot != nullptr) ? snapshot->fileExists(path.toString(), file) : QFileInfo(path.filePath(file)).isFile();
+        if (exists) {
             fileName = path.filePath(file);
             break;
         }
@@ -29,7 +29,9 @@ public:
 
     // movies
     bool saveMovie(Movie* movie) override;
-    bool loadMovie(Movie* movie, QString initialNfoContent = "") override;
+    bool loadMovie(Movie* movie,
+        QString initialNfoContent = "",
+        const mediaelch::DirectorySnapshot* snapshot = nullptr) override;
     // movie images (e.g. posters)
     QImage movieSetPoster(QString setName) override;
     QImage movieSetBackdrop(QString setName) override;
@@ -117,6 +119,12 @@ private:
     void loadStreamDetails(StreamDetails* streamDetails, QDomElement elem);
     bool saveFile(QString filename, QByteArray data);
     mediaelch::DirectoryPath getPath(const Movie* movie);
+    QString nfoFilePath(Movie* movie, const mediaelch::DirectorySnapshot* snapshot);
+    QString imageFileName(const Movie* movie,
+        ImageType type,
+        QVector<DataFile> dataFiles,
+        bool constructName,
+        const mediaelch::DirectorySnapshot* snapshot);
     mediaelch::DirectoryPath getPath(const Concert* concert);
     QString movieSetFileName(QString setName, DataFile* dataFile);
 
@@ -10,6 +10,10 @@
 #include <QStringList>
 #include <QVector>
 
+namespace mediaelch {
+class DirectorySnapshot;
+}
+
 class Album;
 class Artist;
 class Concert;
@@ -25,7 +29,11 @@ class MediaCenterInterface : public QObject
 public:
     // movies
     virtual bool saveMovie(Movie* movie) = 0;
-    virtual bool loadMovie(Movie* movie, QString nfoContent = "") = 0;
+    /// \param snapshot Optional listing of the movie's directory. If given, it is
+    ///        used instead of the file system to check whether NFO and image files exist.
+    virtual bool loadMovie(Movie* movie,
+        QString nfoContent = "",
+        const mediaelch::DirectorySnapshot* snapshot = nullptr) = 0;
     // movie images (e.g. posters)
     virtual QImage movieSetPoster(QString setName) = 0;
     virtual QImage movieSetBackdrop(QString setName) = 0;
@@ -66,21 +66,29 @@ bool MovieController::saveData(MediaCenterInterface* mediaCenterInterface)
     return saved;
 }
 
-bool MovieController::loadData(MediaCenterInterface* mediaCenterInterface, bool force, bool reloadFromNfo)
+bool MovieController::loadData(MediaCenterInterface* mediaCenterInterface,
+    bool force,
+    bool reloadFromNfo,
+    const mediaelch::DirectorySnapshot* snapshot)
 {
     if ((m_infoLoaded || m_movie->hasChanged()) && !force
         && (m_infoFromNfoLoaded || (m_movie->hasChanged() && !m_infoFromNfoLoaded))) {
         return m_infoLoaded;
     }
+    if (m_infoFromCache && !force && !reloadFromNfo) {
+        // Same result as parsing the NFO content stored in the database.
+        return m_infoLoaded;
+    }
+    m_infoFromCache = false;
 
     NameFormatter::setExcludeWords(Settings::instance()->excludeWords());
     m_movie->blockSignals(true);
 
     bool infoLoaded = false;
     if (reloadFromNfo) {
-        infoLoaded = mediaCenterInterface->loadMovie(m_movie);
+        infoLoaded = mediaCenterInterface->loadMovie(m_movie, "", snapshot);
     } else {
-        infoLoaded = mediaCenterInterface->loadMovie(m_movie, m_movie->nfoContent());
+        infoLoaded = mediaCenterInterface->loadMovie(m_movie, m_movie->nfoContent(), snapshot);
     }
 
     if (!infoLoaded) {
@@ -407,6 +415,13 @@ bool MovieController::infoLoaded() const
     return m_infoLoaded;
 }
 
+void MovieController::setInfoLoadedFromCache(bool infoLoaded)
+{
+    m_infoLoaded = infoLoaded;
+    m_infoFromNfoLoaded = false;
+    m_infoFromCache = true;
+}
+
 bool MovieController::downloadsInProgress() const
 {
     return m_downloadsInProgress;
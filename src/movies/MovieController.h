@@ -16,6 +16,7 @@ class MediaCenterInterface;
 class Movie;
 
 namespace mediaelch {
+class DirectorySnapshot;
 namespace scraper {
 class MovieScraper;
 }
@@ -35,8 +36,12 @@ public:
     /// \brief Loads the movies infos with the given MediaCenterInterface
     /// \param mediaCenterInterface MediaCenterInterface to use for loading
     /// \param force Force the loading. If set to false and infos were already loeaded this function just returns
+    /// \param snapshot Optional directory listing, see MediaCenterInterface::loadMovie()
     /// \return Loading was successful or not
-    bool loadData(MediaCenterInterface* mediaCenterInterface, bool force = false, bool reloadFromNfo = true);
+    bool loadData(MediaCenterInterface* mediaCenterInterface,
+        bool force = false,
+        bool reloadFromNfo = true,
+        const mediaelch::DirectorySnapshot* snapshot = nullptr);
 
     /// \brief Loads the movies info from a scraper
     /// \param ids Id of the movie within the given ScraperInterface
@@ -58,6 +63,11 @@ public:
     /// \return Infos were loaded
     bool infoLoaded() const;
 
+    /// \brief   Called if the movie's infos were restored from the database cache.
+    /// \details Subsequent calls to loadData() that don't reload from the NFO file
+    ///          are no-ops, i.e. the cached infos are not parsed again.
+    void setInfoLoadedFromCache(bool infoLoaded);
+
     /// \brief Returns true if a download is in progress
     /// \return Download is in progress
     bool downloadsInProgress() const;
@@ -92,6 +102,7 @@ private:
     Movie* m_movie;
     bool m_infoLoaded;
     bool m_infoFromNfoLoaded;
+    bool m_infoFromCache = false;
     QSet<MovieScraperInfo> m_infosToLoad;
     DownloadManager* m_downloadManager;
     bool m_downloadsInProgress = false;
@@ -0,0 +1,334 @@
+#include "movies/MovieMetadataCache.h"
+
+#include "movies/Movie.h"
+
+#include <QDataStream>
+#include <array>
+
+namespace {
+
+/// \brief Marks a MediaElch movie blob ("MEMV").
+constexpr quint32 MAGIC = 0x4D454D56;
+
+/// \brief Audio details in the order in which KodiXml sets them.
+/// \details StreamDetails' behavior depends on the order, so it is kept.
+constexpr std::array<StreamDetails::AudioDetails, 3> AUDIO_DETAILS{StreamDetails::AudioDetails::Codec,
+    StreamDetails::AudioDetails::Language,
+    StreamDetails::AudioDetails::Channels};
+
+/// \brief All metadata of a movie that is stored in the blob.
+struct MovieMetadata
+{
+    bool infoLoaded = false;
+    QString name;
+    QString originalName;
+    QString sortTitle;
+    QString overview;
+    QString outline;
+    QString tagline;
+    QString writer;
+    QString director;
+    QString setTmdbId;
+    QString setName;
+    QString setOverview;
+    QString imdbId;
+    QString tmdbId;
+    QString certification;
+    QUrl trailer;
+    QDate released;
+    qint64 runtimeMinutes = 0;
+    qint32 playcount = 0;
+    qint32 top250 = 0;
+    double userRating = 0.0;
+    QDateTime lastPlayed;
+    QDateTime dateAdded;
+    double resumePosition = 0.0;
+    double resumeTotal = 0.0;
+    QStringList genres;
+    QStringList countries;
+    QStringList studios;
+    QStringList tags;
+    QVector<Rating> ratings;
+    QVector<Actor> actors;
+    QVector<Poster> posters;
+    QVector<Poster> backdrops;
+    bool streamDetailsLoaded = false;
+    QMap<qint32, QString> videoDetails;
+    QVector<QMap<qint32, QString>> audioDetails;
+    QVector<QMap<qint32, QString>> subtitleDetails;
+};
+
+QDataStream& operator<<(QDataStream& out, const Rating& rating)
+{
+    return out << rating.source << rating.rating << static_cast<qint32>(rating.voteCount) << rating.maxRating
+               << rating.minRating;
+}
+
+QDataStream& operator>>(QDataStream& in, Rating& rating)
+{
+    qint32 voteCount = 0;
+    in >> rating.source >> rating.rating >> voteCount >> rating.maxRating >> rating.minRating;
+    rating.voteCount = voteCount;
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const Actor& actor)
+{
+    return out << actor.name << actor.role << actor.thumb << actor.id << static_cast<qint32>(actor.order);
+}
+
+QDataStream& operator>>(QDataStream& in, Actor& actor)
+{
+    qint32 order = 0;
+    in >> actor.name >> actor.role >> actor.thumb >> actor.id >> order;
+    actor.order = order;
+    actor.imageHasChanged = false;
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const Poster& poster)
+{
+    return out << poster.id << poster.originalUrl << poster.thumbUrl << poster.originalSize << poster.language
+               << poster.hint << poster.aspect;
+}
+
+QDataStream& operator>>(QDataStream& in, Poster& poster)
+{
+    return in >> poster.id >> poster.originalUrl >> poster.thumbUrl >> poster.originalSize >> poster.language
+           >> poster.hint >> poster.aspect;
+}
+
+template<class T>
+QDataStream& writeVector(QDataStream& out, const QVector<T>& values)
+{
+    out << static_cast<quint32>(values.size());
+    for (const T& value : values) {
+        out << value;
+    }
+    return out;
+}
+
+template<class T>
+QDataStream& readVector(QDataStream& in, QVector<T>& values)
+{
+    quint32 size = 0;
+    in >> size;
+    values.clear();
+    // Guard against corrupt blobs; don't reserve more than what can be read.
+    for (quint32 i = 0; i < size && in.status() == QDataStream::Ok; ++i) {
+        T value;
+        in >> value;
+        values.append(value);
+    }
+    return in;
+}
+
+template<class Key>
+QMap<qint32, QString> toIntMap(const QMap<Key, QString>& details)
+{
+    QMap<qint32, QString> map;
+    for (auto it = details.cbegin(); it != details.cend(); ++it) {
+        map.insert(static_cast<qint32>(it.key()), it.value());
+    }
+    return map;
+}
+
+MovieMetadata metadataOf(Movie& movie)
+{
+    MovieMetadata m;
+    m.infoLoaded = movie.controller()->infoLoaded();
+    m.name = movie.name();
+    m.originalName = movie.originalName();
+    m.sortTitle = movie.sortTitle();
+    m.overview = movie.overview();
+    m.outline = movie.outline();
+    m.tagline = movie.tagline();
+    m.writer = movie.writer();
+    m.director = movie.director();
+    const MovieSet set = movie.set();
+    m.setTmdbId = set.tmdbId.toString();
+    m.setName = set.name;
+    m.setOverview = set.overview;
+    m.imdbId = movie.imdbId().toString();
+    m.tmdbId = movie.tmdbId().toString();
+    m.certification = movie.certification().toString();
+    m.trailer = movie.trailer();
+    m.released = movie.released();
+    m.runtimeMinutes = movie.runtime().count();
+    m.playcount = movie.playcount();
+    m.top250 = movie.top250();
+    m.userRating = movie.userRating();
+    m.lastPlayed = movie.lastPlayed();
+    m.dateAdded = movie.dateAdded();
+    m.resumePosition = movie.resumeTime().position;
+    m.resumeTotal = movie.resumeTime().total;
+    m.genres = movie.genres();
+    m.countries = movie.countries();
+    m.studios = movie.studios();
+    m.tags = movie.tags();
+    for (const Rating& rating : movie.ratings()) {
+        m.ratings.append(rating);
+    }
+    for (const Actor* actor : movie.actors().actors()) {
+        m.actors.append(*actor);
+    }
+    m.posters = movie.images().posters();
+    m.backdrops = movie.images().backdrops();
+
+    m.streamDetailsLoaded = movie.streamDetailsLoaded();
+    const StreamDetails* streamDetails = movie.streamDetails();
+    m.videoDetails = toIntMap(streamDetails->videoDetails());
+    for (const auto& audio : streamDetails->audioDetails()) {
+        m.audioDetails.append(toIntMap(audio));
+    }
+    for (const auto& subtitle : streamDetails->subtitleDetails()) {
+        m.subtitleDetails.append(toIntMap(subtitle));
+    }
+    return m;
+}
+
+void applyMetadata(const MovieMetadata& m, Movie& movie)
+{
+    movie.setName(m.name);
+    movie.setOriginalName(m.originalName);
+    movie.setSortTitle(m.sortTitle);
+    movie.setOverview(m.overview);
+    movie.setOutline(m.outline);
+    movie.setTagline(m.tagline);
+    movie.setWriter(m.writer);
+    movie.setDirector(m.director);
+    MovieSet set;
+    set.tmdbId = TmdbId(m.setTmdbId);
+    set.name = m.setName;
+    set.overview = m.setOverview;
+    movie.setSet(set);
+    movie.setImdbId(ImdbId(m.imdbId));
+    movie.setTmdbId(TmdbId(m.tmdbId));
+    movie.setCertification(Certification(m.certification));
+    movie.setTrailer(m.trailer);
+    movie.setReleased(m.released);
+    movie.setRuntime(std::chrono::minutes(m.runtimeMinutes));
+    movie.setPlayCount(m.playcount);
+    movie.setTop250(m.top250);
+    movie.setUserRating(m.userRating);
+    movie.setLastPlayed(m.lastPlayed);
+    movie.setDateAdded(m.dateAdded);
+    mediaelch::ResumeTime resumeTime;
+    resumeTime.position = m.resumePosition;
+    resumeTime.total = m.resumeTotal;
+    movie.setResumeTime(resumeTime);
+    for (const QString& genre : m.genres) {
+        movie.addGenre(genre);
+    }
+    for (const QString& country : m.countries) {
+        movie.addCountry(country);
+    }
+    for (const QString& studio : m.studios) {
+        movie.addStudio(studio);
+    }
+    for (const QString& tag : m.tags) {
+        movie.addTag(tag);
+    }
+    for (const Rating& rating : m.ratings) {
+        movie.ratings().addRating(rating);
+    }
+    for (const Actor& actor : m.actors) {
+        movie.addActor(actor);
+    }
+    for (const Poster& poster : m.posters) {
+        movie.images().addPoster(poster);
+    }
+    for (const Poster& backdrop : m.backdrops) {
+        movie.images().addBackdrop(backdrop);
+    }
+
+    StreamDetails* streamDetails = movie.streamDetails();
+    streamDetails->clear();
+    for (auto it = m.videoDetails.cbegin(); it != m.videoDetails.cend(); ++it) {
+        streamDetails->setVideoDetail(static_cast<StreamDetails::VideoDetails>(it.key()), it.value());
+    }
+    for (int i = 0; i < m.audioDetails.size(); ++i) {
+        for (const auto detail : AUDIO_DETAILS) {
+            const auto value = m.audioDetails.at(i).constFind(static_cast<qint32>(detail));
+            if (value != m.audioDetails.at(i).constEnd()) {
+                streamDetails->setAudioDetail(i, detail, value.value());
+            }
+        }
+    }
+    for (int i = 0; i < m.subtitleDetails.size(); ++i) {
+        const auto& subtitle = m.subtitleDetails.at(i);
+        for (auto it = subtitle.cbegin(); it != subtitle.cend(); ++it) {
+            streamDetails->setSubtitleDetail(i, static_cast<StreamDetails::SubtitleDetails>(it.key()), it.value());
+        }
+    }
+    movie.setStreamDetailsLoaded(m.streamDetailsLoaded);
+}
+
+} // namespace
+
+namespace mediaelch {
+
+QByteArray MovieMetadataCache::serialize(Movie& movie)
+{
+    const MovieMetadata m = metadataOf(movie);
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << MAGIC << FormatVersion;
+    out << m.infoLoaded << m.name << m.originalName << m.sortTitle << m.overview << m.outline << m.tagline
+        << m.writer << m.director << m.setTmdbId << m.setName << m.setOverview << m.imdbId << m.tmdbId
+        << m.certification << m.trailer << m.released << m.runtimeMinutes << m.playcount << m.top250 << m.userRating
+        << m.lastPlayed << m.dateAdded << m.resumePosition << m.resumeTotal << m.genres << m.countries << m.studios
+        << m.tags;
+    writeVector(out, m.ratings);
+    writeVector(out, m.actors);
+    writeVector(out, m.posters);
+    writeVector(out, m.backdrops);
+    out << m.streamDetailsLoaded << m.videoDetails;
+    writeVector(out, m.audioDetails);
+    writeVector(out, m.subtitleDetails);
+    return data;
+}
+
+bool MovieMetadataCache::deserialize(const QByteArray& data, Movie& movie)
+{
+    if (data.isEmpty()) {
+        return false;
+    }
+
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic = 0;
+    quint16 version = 0;
+    in >> magic >> version;
+    if (magic != MAGIC || version != FormatVersion) {
+        return false;
+    }
+
+    MovieMetadata m;
+    in >> m.infoLoaded >> m.name >> m.originalName >> m.sortTitle >> m.overview >> m.outline >> m.tagline
+        >> m.writer >> m.director >> m.setTmdbId >> m.setName >> m.setOverview >> m.imdbId >> m.tmdbId
+        >> m.certification >> m.trailer >> m.released >> m.runtimeMinutes >> m.playcount >> m.top250 >> m.userRating
+        >> m.lastPlayed >> m.dateAdded >> m.resumePosition >> m.resumeTotal >> m.genres >> m.countries >> m.studios
+        >> m.tags;
+    readVector(in, m.ratings);
+    readVector(in, m.actors);
+    readVector(in, m.posters);
+    readVector(in, m.backdrops);
+    in >> m.streamDetailsLoaded >> m.videoDetails;
+    readVector(in, m.audioDetails);
+    readVector(in, m.subtitleDetails);
+    if (in.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    const bool blocked = movie.blockSignals(true);
+    applyMetadata(m, movie);
+    movie.controller()->setInfoLoadedFromCache(m.infoLoaded);
+    movie.setChanged(false);
+    movie.blockSignals(blocked);
+    return true;
+}
+
+} // namespace mediaelch
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QByteArray>
+
+class Movie;
+
+namespace mediaelch {
+
+/// \brief Binary representation of a movie's metadata for the database.
+///
+/// Loading movies from the database used to parse each movie's NFO content
+/// again.  Instead, all metadata that is read from an NFO file (title, IDs,
+/// ratings, actors, stream details, ...) is stored as a compact binary blob
+/// and restored without any XML parsing.
+///
+/// The blob starts with a format version.  Blobs of other versions are
+/// rejected, in which case the NFO content has to be parsed instead.
+class MovieMetadataCache
+{
+public:
+    /// \brief Increase if the format changes.  Old blobs are then ignored.
+    static constexpr quint16 FormatVersion = 1;
+
+    /// \brief Serialize the metadata of the given movie.
+    static QByteArray serialize(Movie& movie);
+
+    /// \brief   Restore the metadata of the given movie.
+    /// \details Files, images, subtitles and other information that is
+    ///          stored in its own columns is not part of the blob.
+    ///          The movie's controller is told that its infos were loaded.
+    /// \returns false if the blob is empty, invalid or has another version.
+    ///          The movie is not changed in this case.
+    static bool deserialize(const QByteArray& data, Movie& movie);
+};
+
+} // namespace mediaelch
@@ -33,6 +33,9 @@ void MovieModel::addMovie(Movie* movie)
 
 void MovieModel::addMovies(const QVector<Movie*>& movies)
 {
+    if (movies.isEmpty()) {
+        return;
+    }
     beginInsertRows(QModelIndex(), rowCount(), rowCount() + qsizetype_to_int(movies.size()) - 1);
     m_movies.append(movies);
     for (Movie* movie : movies) {
@@ -278,6 +281,18 @@ void MovieModel::clear()
     endRemoveRows();
 }
 
+void MovieModel::removeMovie(Movie* movie)
+{
+    const int row = qsizetype_to_int(m_movies.indexOf(movie));
+    if (row < 0) {
+        return;
+    }
+    beginRemoveRows(QModelIndex(), row, row);
+    m_movies.removeAt(row);
+    movie->deleteLater();
+    endRemoveRows();
+}
+
 QVector<Movie*> MovieModel::movies()
 {
     return m_movies;
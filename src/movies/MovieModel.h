@@ -58,6 +58,8 @@ public:
     Movie* movie(int row);
     void addMovie(Movie* movie);
     void addMovies(const QVector<Movie*>& movies);
+    /// \brief Remove the movie from the model.  The movie is deleted later.
+    void removeMovie(Movie* movie);
     void update();
     void clear();
     int countNewMovies();
@@ -1,16 +1,30 @@
 #include "MovieDirectorySearcher.h"
 
 #include "data/Database.h"
+#include "file/DirectoryWalker.h"
 #include "file/FilenameUtils.h"
+#include "file/LibraryWatcher.h"
 #include "globals/Manager.h"
 #include "globals/MessageIds.h"
 
-#include "file/FilenameUtils.h"
-
 #include <QMutexLocker>
 #include <QtConcurrent>
 #include <memory>
 
+namespace {
+
+/// \brief Serializes database writes of MovieDiskLoaders.
+/// \details Loaders of different directories may run concurrently but SQLite
+///          only allows one writer at a time.
+QMutex s_databaseWriteMutex;
+
+/// \brief Loaded movies are published as soon as this many movies are available...
+constexpr int MOVIE_BATCH_SIZE = 250;
+/// \brief ...or after this many milliseconds, whichever comes first.
+constexpr unsigned long MOVIE_BATCH_INTERVAL_MS = 200;
+
+} // namespace
+
 namespace mediaelch {
 
 void MovieLoaderStore::addMovie(Movie* movie)
@@ -64,6 +78,8 @@ MovieDiskLoader::~MovieDiskLoader()
 {
     qDeleteAll(m_movies);
     m_movies.clear();
+    qDeleteAll(m_cachedMovies);
+    m_cachedMovies.clear();
     delete m_db;
 }
 
@@ -87,17 +103,69 @@ void MovieDiskLoader::start()
         return;
     }
 
+    if (!m_directoriesToScan.isEmpty()) {
+        m_removedFiles = LibraryWatcher::removedFiles(m_knownFiles, m_directoriesToScan);
+    }
+
+    if (m_incremental) {
+        reuseUnchangedDirectories();
+        if (isAborted()) {
+            emit finished(this);
+            return;
+        }
+    }
+
     m_processed = 0;
     m_approxTotal = m_dir.separateFolders ? qsizetype_to_int(m_contents.size()) : 0;
     emit progress(this, m_processed, m_approxTotal);
 
     qCDebug(c_movie) << "[Movie] Creating movies for directory:" << QDir::toNativeSeparators(m_dir.path.path());
 
-    // Can be blocking as this class should NOT be run in the GUI thread and
-    // emitting signals is thread safe.
-    QtConcurrent::blockingMap(m_contents, [this](const QStringList& files) { createMovie(files); });
+    removeOutdatedDatabaseEntries();
+
+    // Only keep listings of directories that are needed to create movies.
+    // Each listing is released as soon as its movies are created.
+    for (auto it = m_contents.cbegin(); it != m_contents.cend(); ++it) {
+        const QStringList directories = snapshotDirectories(it.key());
+        for (const QString& dir : directories) {
+            m_snapshot.retain(dir);
+        }
+    }
+    m_snapshot.removeUnretained();
+
+    // Movies are created in parallel.  This thread stores them in the database
+    // and publishes them in batches, so that they appear in the GUI while the
+    // scan is still running.
+    QFuture<void> future = QtConcurrent::map(m_contents, [this](const QStringList& files) {
+        // Remaining directories are skipped if the loader is aborted.
+        if (!isAborted()) {
+            createMovie(files);
+        }
+        // All files of an entry are in the same directory.
+        const QStringList directories = snapshotDirectories(QFileInfo(files.first()).path());
+        for (const QString& dir : directories) {
+            m_snapshot.release(dir);
+        }
+    });
+    while (!future.isFinished()) {
+        if (isAborted()) {
+            future.cancel();
+        }
+        QMutexLocker lock(&m_mutex);
+        if (m_movies.size() < MOVIE_BATCH_SIZE && !future.isFinished()) {
+            m_batchReady.wait(&m_mutex, MOVIE_BATCH_INTERVAL_MS);
+        }
+        lock.unlock();
+        storeAndPublishMovies();
+    }
+    future.waitForFinished();
+    m_snapshot.clear();
 
-    storeAndAddToDatabase();
+    storeAndPublishMovies();
+    if (m_incremental && !isAborted()) {
+        QMutexLocker dbLocker(&s_databaseWriteMutex);
+        m_db->setMovieDirectoryFingerprints(DirectoryPath(m_dir.path), m_fingerprints);
+    }
 
     emit finished(this);
 }
@@ -109,110 +177,215 @@ void MovieDiskLoader::abort()
 
 void MovieDiskLoader::loadMovieContents()
 {
-    QDirIterator it(m_dir.path.path(),
-        m_filter.filters(),
-        QDir::NoDotAndDotDot | QDir::Dirs | QDir::Files,
-        QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
 
-    QString lastDir;
+    // Skip actors, extras, extra fanarts and extra thumbs folders and all files inside them.
+    const QStringList skippedDirectories{".actors", "extras", "extrafanart", "extrathumbs"};
 
-    while (it.hasNext()) {
+    // Changed directories are scanned without their subdirectories.
+    const bool recursive = m_directoriesToScan.isEmpty();
+    const auto shouldEnter = [advanced, &skippedDirectories, recursive](const QFileInfo& dir) {
+        const QString dirName = dir.fileName();
+        return recursive && !advanced->isFolderExcluded(dirName)
+               && !skippedDirectories.contains(dirName, Qt::CaseInsensitive);
+    };
+
+    int visitedDirectories = 0;
+
+    // All files are listed so that a snapshot of each directory can be used
+    // for NFO, artwork and subtitle lookups.  Media files are filtered below.
+    DirectoryWalker walker(FileFilter({"*"}), shouldEnter);
+    const auto visitor = [&](const QFileInfo& dir, const QFileInfoList& files) {
         if (isAborted()) {
-            return;
+            return false;
         }
-        it.next();
 
-        QString dirName = it.fileInfo().dir().dirName();
-        QString fileName = it.fileName(); // may actually be a directory name
+        const QString dirPath = dir.filePath();
+        const QString dirName = dir.fileName();
 
-        const bool isFile = it.fileInfo().isFile();
-        const bool isDir = it.fileInfo().isDir();
-        bool isSpecialDir = false; // set to true for DVD or BluRay Structure
+        // Used for fingerprinting directories in incremental mode.
+        m_directoryModifications.insert(dirPath, dir.lastModified());
+        m_snapshot.addDirectory(dirPath, files);
 
-        if (isFile && Settings::instance()->advanced()->isFileExcluded(fileName)) {
-            continue;
-        }
+        QStringList mediaFiles;
+        for (const QFileInfo& file : files) {
+            const QString fileName = file.fileName();
 
-        // TODO: If there is a BluRay structure then the directory filter may not work
-        // because BDMV's parent directory is not listed.
-        if ((isDir && Settings::instance()->advanced()->isFolderExcluded(fileName))
-            || Settings::instance()->advanced()->isFolderExcluded(dirName)) {
-            continue;
-        }
+            if (!m_filter.isFileMatched(fileName) || advanced->isFileExcluded(fileName)) {
+                continue;
+            }
 
-        // Skips Extras files
-        if (isFile
-            && (fileName.contains("-trailer", Qt::CaseInsensitive)            //
+            // Skips Extras files
+            if (fileName.contains("-trailer", Qt::CaseInsensitive)            //
                 || fileName.contains("-sample", Qt::CaseInsensitive)          //
                 || fileName.contains("-behindthescenes", Qt::CaseInsensitive) //
                 || fileName.contains("-deleted", Qt::CaseInsensitive)         //
                 || fileName.contains("-featurette", Qt::CaseInsensitive)      //
                 || fileName.contains("-interview", Qt::CaseInsensitive)       //
                 || fileName.contains("-scene", Qt::CaseInsensitive)           //
-                || fileName.contains("-short", Qt::CaseInsensitive))) {
-            continue;
-        }
+                || fileName.contains("-short", Qt::CaseInsensitive)) {
+                continue;
+            }
 
-        // Skip actors folder and all files inside it
-        if (QString::compare(".actors", dirName, Qt::CaseInsensitive) == 0) {
-            continue;
+            if (QString::compare("index.bdmv", fileName, Qt::CaseInsensitive) == 0) {
+                // Skip BluRay backup folder
+                if (QString::compare("backup", dirName, Qt::CaseInsensitive) == 0) {
+                    continue;
+                }
+                QDir bluRayDir(dirPath);
+                if (QString::compare(bluRayDir.dirName(), "BDMV", Qt::CaseInsensitive) == 0) {
+                    bluRayDir.cdUp();
+                }
+                m_bluRayDirectories << bluRayDir.path();
+            }
+            if (QString::compare("VIDEO_TS.IFO", fileName, Qt::CaseInsensitive) == 0) {
+                QDir videoDir(dirPath);
+                if (QString::compare(videoDir.dirName(), "VIDEO_TS", Qt::CaseInsensitive) == 0) {
+                    videoDir.cdUp();
+                }
+                m_dvdDirectories << videoDir.path();
+            }
+
+            if (m_knownFiles.contains(file.absoluteFilePath())) {
+                if (m_dir.separateFolders) {
+                    // The directory already belongs to a movie.
+                    mediaFiles.clear();
+                    break;
+                }
+                continue;
+            }
+
+            mediaFiles.append(file.filePath());
+            m_lastModifications.insert(file.filePath(), file.lastModified());
         }
 
-        // Skip extras folder and all files inside it
-        if (QString::compare("extras", dirName, Qt::CaseInsensitive) == 0) {
-            continue;
+        if (!mediaFiles.isEmpty()) {
+            m_contents.insert(dirPath, mediaFiles);
         }
 
-        // Skip extra fanarts folder and all files inside it
-        if (QString::compare("extrafanart", dirName, Qt::CaseInsensitive) == 0) {
-            continue;
+        ++visitedDirectories;
+        // TODO: Use SignalThrottler
+        if (visitedDirectories % 40 == 0) {
+            emit progressText(this, dirName);
         }
+        return true;
+    };
 
-        // Skip extra thumbs folder and all files inside it
-        if (QString::compare("extrathumbs", dirName, Qt::CaseInsensitive) == 0) {
-            continue;
+    if (m_directoriesToScan.isEmpty()) {
+        walker.walk(m_dir.path.path(), visitor);
+        return;
+    }
+
+    for (const QString& directory : asConst(m_directoriesToScan)) {
+        if (!walker.walk(directory, visitor)) {
+            return;
         }
+    }
+}
+
+/// \brief Normalized absolute path of a directory; used as key for fingerprints.
+static QString normalizedDirectory(const QString& dir)
+{
+    return QDir::cleanPath(QFileInfo(dir).absoluteFilePath());
+}
+
+QStringList MovieDiskLoader::snapshotDirectories(const QString& dirPath)
+{
+    // Artwork and NFO files of DVDs and BluRays are stored next to the VIDEO_TS/BDMV folder.
+    const QString dirName = QDir(dirPath).dirName();
+    if (QString::compare(dirName, "BDMV", Qt::CaseInsensitive) == 0
+        || QString::compare(dirName, "VIDEO_TS", Qt::CaseInsensitive) == 0) {
+        return {dirPath, QFileInfo(dirPath).path()};
+    }
+    return {dirPath};
+}
 
-        // Skip BluRay backup folder
-        if (QString::compare("backup", dirName, Qt::CaseInsensitive) == 0
-            && QString::compare("index.bdmv", fileName, Qt::CaseInsensitive) == 0) {
+void MovieDiskLoader::reuseUnchangedDirectories()
+{
+    const DirectoryPath libraryPath(m_dir.path);
+
+    // All visited directories are fingerprinted, not only those with media files:
+    // NFO and artwork files of DVDs and BluRays are stored in the parent directory
+    // of VIDEO_TS/BDMV, see isDirectoryUnchanged().
+    for (auto it = m_directoryModifications.cbegin(); it != m_directoryModifications.cend(); ++it) {
+        DirectoryFingerprint fingerprint;
+        fingerprint.lastModified = it.value().toMSecsSinceEpoch();
+        fingerprint.entryCount = qsizetype_to_int(m_contents.value(it.key()).size());
+        m_fingerprints.insert(normalizedDirectory(it.key()), fingerprint);
+    }
+
+    const QHash<QString, DirectoryFingerprint> storedFingerprints = m_db->movieDirectoryFingerprints(libraryPath);
+    if (storedFingerprints.isEmpty()) {
+        // First incremental scan of this directory: Cached entries (if any) can't
+        // be associated with fingerprints, so the directory is scanned completely.
+        m_clearCachedMovies = true;
+        return;
+    }
+
+    QHash<QString, QVector<Movie*>> cachedByDirectory;
+    const QVector<Movie*> cachedMovies = m_db->moviesInDirectory(libraryPath, nullptr);
+    for (Movie* movie : cachedMovies) {
+        if (movie->files().isEmpty()) {
+            m_staleMovieIds << movie->databaseId();
+            delete movie;
             continue;
         }
+        const QString dir = normalizedDirectory(QFileInfo(movie->files().first().toString()).path());
+        cachedByDirectory[dir].append(movie);
+    }
 
-        if (isFile && QString::compare("index.bdmv", fileName, Qt::CaseInsensitive) == 0) {
-            QDir bluRayDir(it.fileInfo().dir());
-            if (QString::compare(bluRayDir.dirName(), "BDMV", Qt::CaseInsensitive) == 0) {
-                bluRayDir.cdUp();
-            }
-            m_bluRayDirectories << bluRayDir.path();
-            isSpecialDir = true;
+    QMutableMapIterator<QString, QStringList> it(m_contents);
+    while (it.hasNext()) {
+        it.next();
+        if (!isDirectoryUnchanged(it.key(), storedFingerprints)) {
+            continue;
         }
-        if (QString::compare("VIDEO_TS.IFO", fileName, Qt::CaseInsensitive) == 0) {
-            QDir videoDir(it.fileInfo().dir());
-            if (QString::compare(videoDir.dirName(), "VIDEO_TS", Qt::CaseInsensitive) == 0) {
-                videoDir.cdUp();
-            }
-            m_dvdDirectories << videoDir.path();
-            isSpecialDir = true;
+        const QVector<Movie*> movies = cachedByDirectory.take(normalizedDirectory(it.key()));
+        if (movies.isEmpty() && !it.value().isEmpty()) {
+            // Media files but no cached movies, e.g. if the last scan was aborted.
+            continue;
         }
+        m_cachedMovies << movies;
+        it.remove();
+    }
 
-        const QString dirPath = it.fileInfo().path();
-        if (!m_contents.contains(dirPath)) {
-            m_contents.insert(dirPath, {});
-        }
-        if (isFile || isSpecialDir) {
-            m_contents[dirPath].append(it.filePath());
-            m_lastModifications.insert(it.filePath(), it.fileInfo().lastModified());
+    // Everything that is left was either changed or no longer exists.
+    for (const QVector<Movie*>& movies : asConst(cachedByDirectory)) {
+        for (Movie* movie : movies) {
+            m_staleMovieIds << movie->databaseId();
+            delete movie;
         }
+    }
 
-        if (dirName != lastDir) {
-            lastDir = dirName;
-            // TODO: Use SignalThrottler
-            if (m_contents.count() % 40 == 0) {
-                emit progressText(this, dirName);
-            }
-        }
+    qCInfo(c_movie) << "[Movie] Incremental scan: Reusing" << m_cachedMovies.size() << "cached movies,"
+                    << m_contents.size() << "directories have to be scanned";
+
+    QtConcurrent::blockingMap(m_cachedMovies, [](Movie* movie) { //
+        movie->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, false);
+    });
+}
+
+bool MovieDiskLoader::isDirectoryUnchanged(const QString& dirPath,
+    const QHash<QString, DirectoryFingerprint>& storedFingerprints) const
+{
+    const auto isSame = [&](const QString& dir) {
+        const auto stored = storedFingerprints.constFind(dir);
+        return stored != storedFingerprints.constEnd() && stored->isValid() && *stored == m_fingerprints.value(dir);
+    };
+
+    const QString dir = normalizedDirectory(dirPath);
+    if (!isSame(dir)) {
+        return false;
+    }
+
+    // Artwork and NFO files of DVDs and BluRays are stored next to the
+    // VIDEO_TS/BDMV folder, so the parent directory must be unchanged as well.
+    const QString dirName = QDir(dir).dirName();
+    if (QString::compare(dirName, "BDMV", Qt::CaseInsensitive) == 0
+        || QString::compare(dirName, "VIDEO_TS", Qt::CaseInsensitive) == 0) {
+        return isSame(normalizedDirectory(QFileInfo(dir).path()));
     }
+    return true;
 }
 
 void MovieDiskLoader::createMovie(QStringList files)
@@ -261,15 +434,18 @@ void MovieDiskLoader::createMovie(QStringList files)
         movie->setFileLastModified(m_lastModifications.value(files.at(0)));
         movie->setDiscType(discType);
 
-        // Note: "Label" is set in storeAndAddToDatabase()
+        // Note: "Label" is set in storeAndPublishMovies()
 
         movie->setChanged(false);
-        movie->controller()->loadData(Manager::instance()->mediaCenterInterface());
+        movie->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, true, &m_snapshot);
         if (discType == DiscType::Single) {
             QFileInfo mFi(files.first());
-            const QList<QFileInfo> subFiles = mFi.dir().entryInfoList(
-                QStringList{"*.sub", "*.srt", "*.smi", "*.ssa"}, QDir::Files | QDir::NoDotAndDotDot);
-            for (const QFileInfo& subFi : subFiles) {
+            const QStringList subtitleSuffixes{"sub", "srt", "smi", "ssa"};
+            const QFileInfoList dirFiles = m_snapshot.files(mFi.path());
+            for (const QFileInfo& subFi : dirFiles) {
+                if (!subtitleSuffixes.contains(subFi.suffix(), Qt::CaseInsensitive)) {
+                    continue;
+                }
                 QString subFileName = subFi.fileName().mid(mFi.completeBaseName().length() + 1);
                 QStringList parts = subFileName.split(QRegularExpression(R"(\s+|\-+|\.+)"));
                 if (parts.isEmpty()) {
@@ -279,9 +455,9 @@ void MovieDiskLoader::createMovie(QStringList files)
 
                 QStringList subSubFiles = QStringList() << subFi.fileName();
                 if (QString::compare(subFi.suffix(), "sub", Qt::CaseInsensitive) == 0) {
-                    QFileInfo subIdxFi(subFi.absolutePath() + "/" + subFi.completeBaseName() + ".idx");
-                    if (subIdxFi.exists()) {
-                        subSubFiles << subIdxFi.fileName();
+                    const QString subIdxFileName = subFi.completeBaseName() + ".idx";
+                    if (m_snapshot.fileExists(subFi.absolutePath(), subIdxFileName)) {
+                        subSubFiles << subIdxFileName;
                     }
                 }
                 auto* subtitle = new Subtitle(movie);
@@ -303,55 +479,39 @@ void MovieDiskLoader::createMovie(QStringList files)
 
         QMutexLocker lock(&m_mutex);
         m_movies.append(movie);
+        if (m_movies.size() >= MOVIE_BATCH_SIZE) {
+            m_batchReady.wakeOne();
+        }
         lock.unlock();
 
-        emit progress(this, ++m_processed, m_approxTotal);
-        if (m_movies.size() % 40 == 0) {
+        const int processed = ++m_processed;
+        emit progress(this, processed, m_approxTotal);
+        if (processed % 40 == 0) {
             // TODO: Use SignalThrottler
             emit progressText(this, movie->name());
         }
 
     } else {
-        QMap<QString, QStringList> stacked;
-        while (!files.isEmpty()) {
-            QString file = files.takeLast();
-
-            QString stackedBase = mediaelch::file::stackedBaseName(file);
-            stacked.insert(stackedBase, {file});
-
-            for (int fileIndex = 0; fileIndex < files.count();) {
-                const QString& f = files[fileIndex];
-
-                if (mediaelch::file::stackedBaseName(f) == stackedBase) {
-                    stacked[stackedBase].append(f);
-                    files.removeAt(fileIndex);
-                } else {
-                    fileIndex++;
-                }
-            }
-        }
-        QMapIterator<QString, QStringList> it(stacked);
-        while (it.hasNext()) {
-            it.next();
-            if (it.value().isEmpty()) {
-                continue;
-            }
-            QStringList stackedFiles = it.value();
-            stackedFiles.sort();
+        const QVector<QStringList> stacked = mediaelch::file::groupStackedFiles(files);
+        for (const QStringList& stackedFiles : stacked) {
             auto* movie = new Movie(stackedFiles, nullptr);
             movie->setInSeparateFolder(m_dir.separateFolders);
-            movie->setFileLastModified(m_lastModifications.value(it.value().at(0)));
-            movie->controller()->loadData(Manager::instance()->mediaCenterInterface());
+            movie->setFileLastModified(m_lastModifications.value(stackedFiles.at(0)));
+            movie->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, true, &m_snapshot);
 
             // As this method is called in parallel, we may be in another thread.
             movie->moveToThread(thread());
 
             QMutexLocker lock(&m_mutex);
             m_movies.append(movie);
+            if (m_movies.size() >= MOVIE_BATCH_SIZE) {
+                m_batchReady.wakeOne();
+            }
             lock.unlock();
 
-            emit progress(this, ++m_processed, m_approxTotal);
-            if (m_movies.size() % 40 == 0) {
+            const int processed = ++m_processed;
+            emit progress(this, processed, m_approxTotal);
+            if (processed % 40 == 0) {
                 // TODO: Use SignalThrottler
                 emit progressText(this, movie->name());
             }
@@ -359,25 +519,62 @@ void MovieDiskLoader::createMovie(QStringList files)
     }
 }
 
-void MovieDiskLoader::storeAndAddToDatabase()
+void MovieDiskLoader::removeOutdatedDatabaseEntries()
 {
-    if (isAborted()) {
+    if (!m_clearCachedMovies && m_staleMovieIds.isEmpty()) {
         return;
     }
 
-    emit progress(this, 0, 0);
-    emit progressText(this, tr("Storing movies in database..."));
-
+    QMutexLocker dbLocker(&s_databaseWriteMutex);
     m_db->transaction();
-    for (Movie* movie : asConst(m_movies)) {
-        // See also: Use https://stackoverflow.com/a/47473949/1603627
-        // We do this in just one thread.
-        movie->setLabel(m_db->getLabel(movie->files()));
-        m_db->addMovie(movie, DirectoryPath(m_dir.path));
-        m_store->addMovie(movie);
+    if (m_clearCachedMovies) {
+        m_db->clearMoviesInDirectory(DirectoryPath(m_dir.path));
+    }
+    for (int idMovie : asConst(m_staleMovieIds)) {
+        m_db->removeMovie(idMovie);
     }
     m_db->commit();
-    m_movies.clear();
+}
+
+void MovieDiskLoader::storeAndPublishMovies()
+{
+    if (isAborted()) {
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    QVector<Movie*> movies = std::move(m_movies);
+    m_movies = {};
+    lock.unlock();
+
+    if (movies.isEmpty() && m_cachedMovies.isEmpty()) {
+        return;
+    }
+
+    if (!movies.isEmpty()) {
+        QMutexLocker dbLocker(&s_databaseWriteMutex);
+        m_db->transaction();
+        if (!m_labelsLoaded) {
+            // Labels are kept even if the movie is removed from the database; load them once per scan.
+            m_labels = m_db->labelsInDirectory(DirectoryPath(m_dir.path));
+            m_labelsLoaded = true;
+        }
+        for (Movie* movie : asConst(movies)) {
+            // A movie's label is the label of its first file, see Database::getLabel().
+            if (!movie->files().isEmpty()) {
+                movie->setLabel(m_labels.value(movie->files().first().toString(), ColorLabel::NoLabel));
+            }
+        }
+        m_db->addMovies(movies, DirectoryPath(m_dir.path));
+        m_db->commit();
+    }
+
+    // Cached movies are already stored in the database and are part of the first batch.
+    m_store->addMovies(movies);
+    m_store->addMovies(m_cachedMovies);
+    m_cachedMovies.clear();
+
+    emit moviesLoaded(this);
 }
 
 void MovieDatabaseLoader::start()
@@ -399,22 +596,27 @@ void MovieDatabaseLoader::start()
         return;
     }
 
-    // Note, this takes less than a few seconds. No need to check whether we're aborted or not.
-    QtConcurrent::blockingMap(movies,
-        [](Movie* movie) { //
-            movie->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, false);
-        });
+    // Movies are published in batches so that the first ones appear in the GUI
+    // before the whole directory is loaded.
+    const int total = qsizetype_to_int(movies.size());
+    for (int offset = 0; offset < total; offset += MOVIE_BATCH_SIZE) {
+        if (isAborted()) {
+            emit finished(this);
+            return;
+        }
 
-    if (isAborted()) {
-        emit finished(this);
-        return;
+        QVector<Movie*> batch = movies.mid(offset, MOVIE_BATCH_SIZE);
+        QtConcurrent::blockingMap(batch,
+            [](Movie* movie) { //
+                movie->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, false);
+            });
+
+        m_store->addMovies(batch);
+        emit moviesLoaded(this);
+        emit progress(this, offset + qsizetype_to_int(batch.size()), total);
     }
 
-    emit progress(this, 1, 1);
     emit progressText(this, "");
-
-    m_store->addMovies(movies);
-
     emit finished(this);
 }
 
@@ -423,17 +625,4 @@ void MovieDatabaseLoader::abort()
     m_aborted.store(true);
 }
 
-QThread* createAutoDeleteThreadWithMovieLoader(MovieLoader* worker, QObject* threadParent)
-{
-    QThread* thread = new QThread(threadParent);
-    Q_ASSERT(thread != nullptr);
-    worker->moveToThread(thread);
-
-    // Startup & delete setup
-    QObject::connect(thread, &QThread::started, worker, &MovieLoader::start);
-    QObject::connect(worker, &MovieLoader::finished, thread, &QThread::quit);
-    QObject::connect(thread, &QThread::finished, thread, &QThread::deleteLater);
-    return thread;
-}
-
 } // namespace mediaelch
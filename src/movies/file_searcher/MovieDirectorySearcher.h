@@ -1,13 +1,17 @@
 #pragma once
 
+#include "file/DirectoryFingerprint.h"
+#include "file/DirectorySnapshot.h"
 #include "file/FileFilter.h"
 #include "globals/Globals.h"
 
 #include <QMutex>
+#include <QSet>
 #include <QString>
 #include <QThread>
 #include <QTimer>
 #include <QVector>
+#include <QWaitCondition>
 #include <atomic>
 
 class Movie;
@@ -60,16 +64,15 @@ signals:
     /// \brief   A translated string representing the current loading state.
     /// \details For example the currently scanned directory.
     void progressText(mediaelch::MovieLoader* job, QString text);
+    /// \brief   New movies were added to the MovieLoaderStore.
+    /// \details Loaders publish movies in batches while they are still running.
+    void moviesLoaded(mediaelch::MovieLoader* job);
     void finished(mediaelch::MovieLoader* job);
 
 protected:
     MovieLoaderStore* m_store = nullptr;
 };
 
-
-/// \brief Creates a thread and moves the worker to it. Auto deletes thread when worker is finished.
-QThread* createAutoDeleteThreadWithMovieLoader(MovieLoader* worker, QObject* threadParent);
-
 /// \brief Load movies from disk.
 class MovieDiskLoader : public MovieLoader
 {
@@ -83,27 +86,77 @@ public:
     void abort() override;
     bool isAborted() override { return m_aborted.load(); }
 
+    /// \brief   Only rescan directories whose fingerprint changed since the last scan.
+    /// \details Movies of all other directories are taken from the database.
+    ///          Must be set before start() is called.
+    void setIncrementalScan(bool incremental) { m_incremental = incremental; }
+    /// \brief   Only scan the given directories (not recursively) for new movies.
+    /// \details Media files in \p knownFiles already belong to a movie and are
+    ///          skipped.  Used to load movies of directories that changed on disk.
+    ///          Must be set before start() is called.
+    void setDirectoriesToScan(QStringList directories, QSet<QString> knownFiles)
+    {
+        m_directoriesToScan = std::move(directories);
+        m_knownFiles = std::move(knownFiles);
+    }
+    /// \brief Known files of the scanned directories that no longer exist.  Valid once finished.
+    const QStringList& removedFiles() const { return m_removedFiles; }
+
 private:
     void loadMovieContents();
+    /// \brief Compare directory fingerprints with the database and reuse cached
+    ///        movies of unchanged directories. Those directories are removed
+    ///        from m_contents so that they are not scanned again.
+    void reuseUnchangedDirectories();
+    bool isDirectoryUnchanged(const QString& dirPath,
+        const QHash<QString, DirectoryFingerprint>& storedFingerprints) const;
     void createMovie(QStringList files);
-    /// \brief Store all loaded movies into the MovieLoaderStore and database.
-    void storeAndAddToDatabase();
+    /// \brief Directories of the snapshot that are read when creating the movies of the given directory.
+    static QStringList snapshotDirectories(const QString& dirPath);
+    /// \brief Remove database entries of changed or cached directories before
+    ///        new movies are stored.
+    void removeOutdatedDatabaseEntries();
+    /// \brief Store all movies that were loaded since the last call in the
+    ///        database and the MovieLoaderStore.  Emits moviesLoaded().
+    void storeAndPublishMovies();
 
 private:
     SettingsDir m_dir;
     FileFilter m_filter;
     Database* m_db = nullptr;
     QMutex m_mutex;
+    /// \brief Signaled if enough movies for a new batch were created.
+    QWaitCondition m_batchReady;
     QVector<Movie*> m_movies;
     std::atomic_bool m_aborted{false};
     std::atomic_int m_processed{0};
     int m_approxTotal{0};
 
+    bool m_incremental = false;
+    /// \brief Movies of unchanged directories that are already stored in the database.
+    QVector<Movie*> m_cachedMovies;
+    /// \brief Database IDs of movies whose directory has changed or no longer exists.
+    QVector<int> m_staleMovieIds;
+    /// \brief Set if cached movies can't be matched to directories and must be removed.
+    bool m_clearCachedMovies = false;
+    QHash<QString, DirectoryFingerprint> m_fingerprints;
+    /// \brief Labels of all files in the library directory, see Database::labelsInDirectory().
+    QHash<QString, ColorLabel> m_labels;
+    bool m_labelsLoaded = false;
+
+    /// \brief If not empty, only these directories are scanned.
+    QStringList m_directoriesToScan;
+    QSet<QString> m_knownFiles;
+    QStringList m_removedFiles;
+
     // TODO: Streamline, e.g. use one vector of directories with DiscType tags
     QHash<QString, QDateTime> m_lastModifications;
+    QHash<QString, QDateTime> m_directoryModifications;
     QStringList m_bluRayDirectories;
     QStringList m_dvdDirectories;
     QMap<QString, QStringList> m_contents;
+    /// \brief Files of all scanned directories; only valid while movies are created.
+    DirectorySnapshot m_snapshot;
 };
 
 /// \brief Load movies from database
@@ -3,20 +3,22 @@
 #include "MovieDirectorySearcher.h"
 #include "data/Subtitle.h"
 #include "globals/Helper.h"
+#include "globals/LoaderThreadPool.h"
 #include "globals/Manager.h"
 #include "globals/MessageIds.h"
 #include "log/Log.h"
 
 #include <QApplication>
 #include <QDirIterator>
+#include <QSet>
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QtConcurrent>
+#include <algorithm>
 
 namespace mediaelch {
 
-MovieFileSearcher::MovieFileSearcher(QObject* parent) :
-    QObject(parent), m_store{new MovieLoaderStore(this)}, m_aborted{false}
+MovieFileSearcher::MovieFileSearcher(QObject* parent) : QObject(parent), m_aborted{false}
 {
     connect(this, &MovieFileSearcher::started, this, [this]() { m_reloadTimer.start(); });
     connect(this, &MovieFileSearcher::finished, this, [this]() {
@@ -56,6 +58,8 @@ void MovieFileSearcher::reload(bool reloadFromDisk)
 
     m_aborted = false;
     m_running = true;
+    m_finishedProcessed = 0;
+    m_finishedTotal = 0;
 
     emit started();
     emit statusChanged(tr("Searching for Movies..."));
@@ -65,8 +69,21 @@ void MovieFileSearcher::reload(bool reloadFromDisk)
         return;
     }
 
-    if (reloadFromDisk) {
+    // The model is cleared, i.e. results of running updates are outdated.
+    m_updateQueue.clear();
+    if (m_updateJob != nullptr) {
+        discardJob(m_updateJob, m_updateStore);
+        m_updateJob = nullptr;
+        m_updateStore = nullptr;
+    }
+
+    // In incremental mode, each MovieDiskLoader only replaces database
+    // entries of changed directories.  Entries of library directories that
+    // are no longer loaded would be kept forever, so they are removed here.
+    if (reloadFromDisk && !Settings::instance()->advanced()->incrementalMovieScan()) {
         Manager::instance()->database()->clearAllMovies();
+    } else if (reloadFromDisk) {
+        clearRemovedDirectories();
     }
 
     Manager::instance()->movieModel()->clear();
@@ -88,38 +105,87 @@ void MovieFileSearcher::reload(bool reloadFromDisk)
     loadNext();
 }
 
+void MovieFileSearcher::onMoviesLoaded(MovieLoader* job)
+{
+    auto it = m_runningJobs.find(job);
+    if (m_aborted || it == m_runningJobs.end() || job->isAborted()) {
+        return;
+    }
+    // Note: This file searcher is the parent of all movies, but the model
+    //       handles them.
+    Manager::instance()->movieModel()->addMovies(it->store->takeAll(this));
+}
+
 void MovieFileSearcher::onDirectoryLoaded(MovieLoader* job)
 {
-    // There is always only one job. Ensure that we don't mix up anything.
-    Q_ASSERT(job == m_currentJob);
-    m_currentJob = nullptr;
+    // Jobs that were discarded, e.g. by abortDirectory(), are disconnected
+    // and deleted elsewhere.
+    if (!m_runningJobs.contains(job)) {
+        return;
+    }
+    JobState state = m_runningJobs.take(job);
     job->deleteLater();
 
     if (m_aborted || job->isAborted()) {
         // To avoid changes to the model, _after_ the users aborts, don't add any
         // movies to the model.
-        m_store->clear();
+        state.store->clear();
+        state.store->deleteLater();
+        if (!m_aborted) {
+            // Only this directory was aborted; the other ones are still loaded.
+            loadNext();
+        }
+        return;
+    }
 
-    } else {
-        // Note: This file searcher is the parent of all movies, but the model
-        //       handles them.
-        Manager::instance()->movieModel()->addMovies(m_store->takeAll(this));
-        loadNext();
+    // Remaining movies that were not published in a batch, if any.
+    Manager::instance()->movieModel()->addMovies(state.store->takeAll(this));
+    state.store->deleteLater();
+
+    // Keep the progress of finished directories so that the progress bar
+    // does not jump back while other directories are still loading.
+    if (state.total > 0) {
+        m_finishedProcessed += state.processed;
+        m_finishedTotal += state.total;
     }
+    emitCombinedProgress();
+    loadNext();
 }
 
 void MovieFileSearcher::onProgress(MovieLoader* job, int processed, int total)
 {
-    Q_UNUSED(job)
-    emit progress(processed, total, Constants::MovieFileSearcherProgressMessageId);
+    auto it = m_runningJobs.find(job);
+    if (it == m_runningJobs.end()) {
+        return;
+    }
+    it->processed = processed;
+    it->total = total;
+    emitCombinedProgress();
 }
 
 void MovieFileSearcher::onProgressText(MovieLoader* job, QString text)
 {
-    Q_UNUSED(job)
+    if (!m_runningJobs.contains(job)) {
+        return;
+    }
     emit progressText(text);
 }
 
+void MovieFileSearcher::emitCombinedProgress()
+{
+    // Loaders that don't know their total yet report 0/0. Only the loaders
+    // with a known total contribute to the progress bar.
+    int processed = m_finishedProcessed;
+    int total = m_finishedTotal;
+    for (const JobState& state : asConst(m_runningJobs)) {
+        if (state.total > 0) {
+            processed += state.processed;
+            total += state.total;
+        }
+    }
+    emit progress(processed, total, Constants::MovieFileSearcherProgressMessageId);
+}
+
 void MovieFileSearcher::loadNext()
 {
     if (m_aborted) {
@@ -129,39 +195,125 @@ void MovieFileSearcher::loadNext()
 
     Q_ASSERT(m_running);
 
-    if (m_directoryQueue.isEmpty()) {
+    if (m_directoryQueue.isEmpty() && m_runningJobs.isEmpty()) {
+        m_running = false;
         emit finished();
         return;
     }
 
-    Q_ASSERT(m_store != nullptr);
+    const int maxJobs = Settings::instance()->advanced()->concurrentMovieDirectories();
+    while (!m_directoryQueue.isEmpty() && m_runningJobs.size() < maxJobs) {
+        startLoader(m_directoryQueue.dequeue());
+    }
+}
 
-    SettingsDir dir = m_directoryQueue.dequeue();
+void MovieFileSearcher::clearRemovedDirectories()
+{
+    QVector<DirectoryPath> libraryPaths;
+    for (const SettingsDir& dir : asConst(m_directories)) {
+        if (!dir.disabled) {
+            libraryPaths.append(DirectoryPath(dir.path));
+        }
+    }
 
+    Database* database = Manager::instance()->database();
+    const QVector<DirectoryPath> storedPaths = database->movieLibraryPaths();
+    database->transaction();
+    for (const DirectoryPath& path : storedPaths) {
+        if (!libraryPaths.contains(path)) {
+            qCDebug(c_movie) << "[Movies] Removing cached movies of old directory:" << path;
+            database->clearMoviesInDirectory(path);
+        }
+    }
+    database->commit();
+}
+
+void MovieFileSearcher::startLoader(SettingsDir dir)
+{
     QString currentStatus = tr("Searching for movies...");
     const auto active =
         std::count_if(m_directories.cbegin(), m_directories.cend(), [](const SettingsDir& d) { return !d.disabled; });
     if (active > 1) {
-        const auto finished = active - m_directoryQueue.size();
-        currentStatus += QStringLiteral(" (%1/%2)").arg(QString::number(finished), QString::number(active));
+        const auto started = active - m_directoryQueue.size();
+        currentStatus += QStringLiteral(" (%1/%2)").arg(QString::number(started), QString::number(active));
     }
     emit statusChanged(currentStatus);
 
+    JobState state;
+    state.dir = dir;
+    state.store = new MovieLoaderStore(this);
+
     MovieLoader* loader = nullptr;
     if (dir.autoReload) {
-        loader = new MovieDiskLoader(dir, *m_store, Settings::instance()->advanced()->movieFilters(), nullptr);
+        auto* diskLoader =
+            new MovieDiskLoader(dir, *state.store, Settings::instance()->advanced()->movieFilters(), nullptr);
+        diskLoader->setIncrementalScan(Settings::instance()->advanced()->incrementalMovieScan());
+        loader = diskLoader;
     } else {
-        loader = new MovieDatabaseLoader(dir, *m_store, nullptr);
+        loader = new MovieDatabaseLoader(dir, *state.store, nullptr);
     }
 
-    QThread* thread = mediaelch::createAutoDeleteThreadWithMovieLoader(loader, this);
+    connect(loader, &MovieLoader::moviesLoaded, this, &MovieFileSearcher::onMoviesLoaded);
     connect(loader, &MovieLoader::finished, this, &MovieFileSearcher::onDirectoryLoaded);
     connect(loader, &MovieLoader::progress, this, &MovieFileSearcher::onProgress);
     connect(loader, &MovieLoader::progressText, this, &MovieFileSearcher::onProgressText);
 
-    Q_ASSERT(m_currentJob == nullptr);
-    m_currentJob = loader;
-    thread->start(QThread::HighPriority);
+    m_runningJobs.insert(loader, state);
+    mediaelch::runInLoaderThread(loader, QThread::HighPriority);
+}
+
+void MovieFileSearcher::discardJob(MovieLoader* job)
+{
+    discardJob(job, m_runningJobs.take(job).store);
+}
+
+void MovieFileSearcher::discardJob(MovieLoader* job, MovieLoaderStore* store)
+{
+    disconnect(job, nullptr, this, nullptr);
+    // The loader still runs in its own thread. It must not be deleted before
+    // it has finished, because it still writes into its store.  The store must
+    // outlive this searcher as well.
+    store->setParent(nullptr);
+    connect(job, &MovieLoader::finished, store, &MovieLoaderStore::clear);
+    connect(job, &MovieLoader::finished, store, &QObject::deleteLater);
+    connect(job, &MovieLoader::finished, job, &QObject::deleteLater);
+    job->abort();
+}
+
+void MovieFileSearcher::abortDirectory(const mediaelch::DirectoryPath& directory)
+{
+    if (!m_running || m_aborted) {
+        return;
+    }
+
+    const auto isDirectory = [&directory](const SettingsDir& dir) { return DirectoryPath(dir.path) == directory; };
+
+    const auto queued = std::remove_if(m_directoryQueue.begin(), m_directoryQueue.end(), isDirectory);
+    m_directoryQueue.erase(queued, m_directoryQueue.end());
+
+    const QList<MovieLoader*> jobs = m_runningJobs.keys();
+    for (MovieLoader* job : jobs) {
+        if (isDirectory(m_runningJobs.value(job).dir)) {
+            qCInfo(c_movie) << "[Movies] Aborted loading movies of directory:" << directory;
+            discardJob(job);
+        }
+    }
+
+    emitCombinedProgress();
+    // Start queued directories or finish the reload if it was the last one.
+    loadNext();
+}
+
+QVector<DirectoryPath> MovieFileSearcher::loadingDirectories() const
+{
+    QVector<DirectoryPath> directories;
+    for (const JobState& state : asConst(m_runningJobs)) {
+        directories.append(DirectoryPath(state.dir.path));
+    }
+    for (const SettingsDir& dir : asConst(m_directoryQueue)) {
+        directories.append(DirectoryPath(dir.path));
+    }
+    return directories;
 }
 
 void MovieFileSearcher::abort(bool quiet)
@@ -173,10 +325,117 @@ void MovieFileSearcher::abort(bool quiet)
     m_running = false;
     m_directoryQueue.clear();
 
-    if (m_currentJob != nullptr) {
-        m_currentJob->abort();
+    const QList<MovieLoader*> jobs = m_runningJobs.keys();
+    for (MovieLoader* job : jobs) {
+        discardJob(job);
+    }
+
+    m_updateQueue.clear();
+    if (m_updateJob != nullptr) {
+        discardJob(m_updateJob, m_updateStore);
+        m_updateJob = nullptr;
+        m_updateStore = nullptr;
+    }
+}
+
+void MovieFileSearcher::loadNewMovies(const mediaelch::DirectoryPath& libraryDirectory,
+    const QStringList& directories)
+{
+    const auto dir = std::find_if(m_directories.cbegin(), m_directories.cend(), [&](const SettingsDir& d) {
+        return !d.disabled && DirectoryPath(d.path) == libraryDirectory;
+    });
+    if (dir == m_directories.cend() || directories.isEmpty()) {
+        return;
+    }
+    if (m_running) {
+        // A complete reload is in progress which loads all movies anyway.
+        qCDebug(c_movie) << "[Movies] Ignoring changed directories while reloading:" << libraryDirectory;
+        return;
+    }
+
+    m_updateQueue.enqueue({*dir, directories});
+    if (m_updateJob == nullptr) {
+        startNextUpdate();
+    }
+}
+
+void MovieFileSearcher::startNextUpdate()
+{
+    if (m_updateQueue.isEmpty()) {
+        return;
+    }
+    const DirectoryUpdate update = m_updateQueue.dequeue();
+
+    // Files of all movies that are already loaded.  Files of the previous
+    // update are part of the model as well, see onUpdateJobFinished().
+    QSet<QString> knownFiles;
+    const QVector<Movie*> movies = Manager::instance()->movieModel()->movies();
+    for (Movie* movie : movies) {
+        const QStringList files = movie->files().toStringList();
+        for (const QString& file : files) {
+            knownFiles.insert(file);
+        }
+    }
+
+    qCInfo(c_movie) << "[Movies] Scanning" << update.directories.size()
+                    << "changed directories for new movies in:" << update.dir.path.path();
+
+    m_updateStore = new MovieLoaderStore(this);
+    auto* loader = new MovieDiskLoader(
+        update.dir, *m_updateStore, Settings::instance()->advanced()->movieFilters(), nullptr);
+    loader->setDirectoriesToScan(update.directories, knownFiles);
+    m_updateJob = loader;
+
+    connect(loader, &MovieLoader::finished, this, &MovieFileSearcher::onUpdateJobFinished);
+    mediaelch::runInLoaderThread(loader, QThread::LowPriority);
+}
+
+void MovieFileSearcher::onUpdateJobFinished(MovieLoader* job)
+{
+    if (job != m_updateJob) {
+        return;
+    }
+    job->deleteLater();
+
+    // Updates are always run by a MovieDiskLoader, see startNextUpdate().
+    removeMoviesOfFiles(static_cast<MovieDiskLoader*>(job)->removedFiles());
+
+    const QVector<Movie*> movies = m_updateStore->takeAll(this);
+    m_updateStore->deleteLater();
+    m_updateJob = nullptr;
+    m_updateStore = nullptr;
+
+    if (!movies.isEmpty()) {
+        qCInfo(c_movie) << "[Movies] Found" << movies.size() << "new movies";
+        Manager::instance()->movieModel()->addMovies(movies);
+    }
+    startNextUpdate();
+}
+
+void MovieFileSearcher::removeMoviesOfFiles(const QStringList& removedFiles)
+{
+    if (removedFiles.isEmpty()) {
+        return;
+    }
+    QSet<QString> removed;
+    for (const QString& file : removedFiles) {
+        removed.insert(file);
+    }
+
+    const QVector<Movie*> movies = Manager::instance()->movieModel()->movies();
+    for (Movie* movie : movies) {
+        const QStringList files = movie->files().toStringList();
+        // Stacked movies are only removed if all of their files are gone.
+        const bool isRemoved = !files.isEmpty()
+                               && std::all_of(files.cbegin(), files.cend(), [&removed](const QString& file) {
+                                      return removed.contains(file);
+                                  });
+        if (isRemoved) {
+            qCInfo(c_movie) << "[Movies] Removing movie whose files no longer exist:" << movie->name();
+            Manager::instance()->database()->removeMovie(movie->databaseId());
+            Manager::instance()->movieModel()->removeMovie(movie);
+        }
     }
-    m_store->clear();
 }
 
 } // namespace mediaelch
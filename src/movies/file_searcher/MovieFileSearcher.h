@@ -1,5 +1,6 @@
 #pragma once
 
+#include "file/Path.h"
 #include "globals/Meta.h"
 #include "movies/Movie.h"
 
@@ -34,10 +35,21 @@ public:
 
     /// \brief Sets the directories to scan for movies. Not readable directories are skipped.
     void setMovieDirectories(const QVector<SettingsDir>& directories);
+    /// \brief Library directories of the running reload that are loading or queued.
+    QVector<mediaelch::DirectoryPath> loadingDirectories() const;
 
 public slots:
     void reload(bool reloadFromDisk);
     void abort(bool quiet = false);
+    /// \brief Abort loading movies of the given library directory.
+    /// \details Movies of other directories are still loaded.
+    void abortDirectory(const mediaelch::DirectoryPath& directory);
+    /// \brief   Load new movies of the given directories that changed on disk.
+    /// \details Only the given directories of the movie library directory are scanned;
+    ///          files that already belong to a movie in the model are skipped.  Movies
+    ///          are added to the model in the background, i.e. finished() is not emitted.
+    ///          Movies whose files were removed from these directories are removed.
+    void loadNewMovies(const mediaelch::DirectoryPath& libraryDirectory, const QStringList& directories);
 
 signals:
     void started();
@@ -49,21 +61,60 @@ signals:
     void finished();
 
 private slots:
+    void onMoviesLoaded(mediaelch::MovieLoader* job);
     void onDirectoryLoaded(mediaelch::MovieLoader* job);
     void onProgress(mediaelch::MovieLoader* job, int processed, int total);
     void onProgressText(mediaelch::MovieLoader* job, QString text);
+    void onUpdateJobFinished(mediaelch::MovieLoader* job);
 
 private:
+    /// \brief Start loaders for queued directories until the concurrency limit is reached.
     void loadNext();
+    void startLoader(SettingsDir dir);
+    /// \brief Remove cached movies of directories that are no longer (enabled) movie directories.
+    /// \details Only required in incremental mode, otherwise all movies are removed anyway.
+    void clearRemovedDirectories();
+    void emitCombinedProgress();
+    /// \brief Abort the given job and delete it and its store once it has finished.
+    void discardJob(MovieLoader* job);
+    void discardJob(MovieLoader* job, MovieLoaderStore* store);
+    /// \brief Start the next queued update of changed directories, if any.
+    void startNextUpdate();
+    /// \brief Remove movies whose files no longer exist from the model and the database.
+    void removeMoviesOfFiles(const QStringList& removedFiles);
 
 private:
+    /// \brief State of one running MovieLoader, i.e. of one library directory.
+    struct JobState
+    {
+        SettingsDir dir;
+        MovieLoaderStore* store = nullptr;
+        int processed = 0;
+        int total = 0;
+    };
+
     QVector<SettingsDir> m_directories;
     QElapsedTimer m_reloadTimer;
 
     /// \brief Directories that need to be scanned.
     QQueue<SettingsDir> m_directoryQueue;
-    MovieLoaderStore* m_store = nullptr;
-    MovieLoader* m_currentJob = nullptr;
+    /// \brief Currently running loaders. Each one has its own store.
+    QHash<MovieLoader*, JobState> m_runningJobs;
+    /// \brief Progress of all directories that were already loaded.
+    int m_finishedProcessed = 0;
+    int m_finishedTotal = 0;
+
+    /// \brief Changed directories that are scanned for new movies, see loadNewMovies().
+    struct DirectoryUpdate
+    {
+        SettingsDir dir;
+        QStringList directories;
+    };
+    /// \brief Updates run one after another, so that each one knows the movies of
+    ///        all previous ones.
+    QQueue<DirectoryUpdate> m_updateQueue;
+    MovieLoader* m_updateJob = nullptr;
+    MovieLoaderStore* m_updateStore = nullptr;
 
     bool m_running = false;
     bool m_aborted = false;
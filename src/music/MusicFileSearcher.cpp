@@ -1,14 +1,17 @@
 #include "MusicFileSearcher.h"
 
+#include "file/DirectoryWalker.h"
 #include "globals/Manager.h"
 #include "globals/MessageIds.h"
 #include "log/Log.h"
 #include "music/Album.h"
 #include "music/Artist.h"
 
-#include <QDirIterator>
 #include <QFileInfo>
+#include <QHash>
+#include <QSet>
 #include <QtConcurrent>
+#include <algorithm>
 
 MusicFileSearcher::MusicFileSearcher(QObject* parent) :
     QObject(parent), m_progressMessageId{Constants::MusicFileSearcherProgressMessageId}, m_aborted{false}
@@ -54,6 +57,7 @@ void MusicFileSearcher::reload(bool force)
 
     QMap<Artist*, mediaelch::DirectoryPath> artistPaths;
     QMap<Album*, mediaelch::DirectoryPath> albumPaths;
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
     for (const SettingsDir& dir : asConst(m_directories)) {
         if (m_aborted) {
             break;
@@ -67,47 +71,46 @@ void MusicFileSearcher::reload(bool force)
         }
 
         if (dir.autoReload || force) {
-            QDirIterator it(dir.path.path(), QDir::NoDotAndDotDot | QDir::Dirs, QDirIterator::FollowSymlinks);
-            while (it.hasNext()) {
-                if (m_aborted) {
-                    break;
+            const QString rootPath = QDir::cleanPath(dir.path.path());
+            QHash<QString, Artist*> artistsByPath;
+
+            // Artists are direct subfolders of the music directory and albums
+            // are subfolders of artists.  Album folders are never entered.
+            const auto collectArtistsAndAlbums = [&](const QFileInfo& entry) {
+                if (m_aborted || advanced->isFolderExcluded(entry.fileName())) {
+                    return false;
                 }
 
-                it.next();
+                const QString parentPath = QDir::cleanPath(entry.path());
+                if (parentPath == rootPath) {
+                    emit currentDir(entry.baseName());
+                    auto* artist = new Artist(mediaelch::DirectoryPath(entry.filePath()), this);
+                    artist->setName(entry.baseName());
+                    artists.append(artist);
+                    artistPaths.insert(artist, mediaelch::DirectoryPath(dir.path));
+                    artistsByPath.insert(QDir::cleanPath(entry.filePath()), artist);
+                    return true;
+                }
 
-                if (Settings::instance()->advanced()->isFolderExcluded(it.fileInfo().dir().dirName())) {
-                    continue;
+                if (entry.baseName() == "extrafanart" || entry.baseName() == "extrathumbs") {
+                    return false;
                 }
 
-                emit currentDir(it.fileInfo().baseName());
-                auto* artist = new Artist(mediaelch::DirectoryPath(it.filePath()), this);
-                artist->setName(it.fileInfo().baseName());
-                artists.append(artist);
-                artistPaths.insert(artist, mediaelch::DirectoryPath(dir.path));
-
-                QDirIterator itAlbums(it.filePath(), QDir::NoDotAndDotDot | QDir::Dirs, QDirIterator::FollowSymlinks);
-                while (itAlbums.hasNext()) {
-                    itAlbums.next();
-
-                    if (Settings::instance()->advanced()->isFolderExcluded(itAlbums.fileInfo().dir().dirName())) {
-                        continue;
-                    }
-
-                    if (itAlbums.fileInfo().baseName() == "extrafanart") {
-                        continue;
-                    }
-                    if (itAlbums.fileInfo().baseName() == "extrathumbs") {
-                        continue;
-                    }
-
-                    auto* album = new Album(mediaelch::DirectoryPath(itAlbums.filePath()), this);
-                    album->setTitle(itAlbums.fileInfo().baseName());
+                Artist* artist = artistsByPath.value(parentPath);
+                if (artist != nullptr) {
+                    auto* album = new Album(mediaelch::DirectoryPath(entry.filePath()), this);
+                    album->setTitle(entry.baseName());
                     album->setArtistObj(artist);
                     artist->addAlbum(album);
                     albums.append(album);
                     albumPaths.insert(album, mediaelch::DirectoryPath(dir.path));
                 }
-            }
+                return false;
+            };
+
+            // No file filter: Only directories are of interest.
+            mediaelch::DirectoryWalker walker(mediaelch::FileFilter(), collectArtistsAndAlbums);
+            walker.walk(dir.path.path(), [this](const QFileInfo&, const QFileInfoList&) { return !m_aborted; });
         } else {
             QVector<Artist*> artistsInPath =
                 Manager::instance()->database()->artistsInDirectory(mediaelch::DirectoryPath(dir.path));
@@ -185,6 +188,142 @@ void MusicFileSearcher::abort()
     m_aborted = true;
 }
 
+void MusicFileSearcher::updateArtists(const mediaelch::DirectoryPath& musicDir, const QStringList& directories)
+{
+    const auto dir = std::find_if(m_directories.cbegin(), m_directories.cend(), [&](const SettingsDir& d) {
+        return !d.disabled && mediaelch::DirectoryPath(d.path) == musicDir;
+    });
+    if (dir == m_directories.cend() || directories.isEmpty()) {
+        return;
+    }
+
+    const QString rootPath = QDir::cleanPath(dir->path.path());
+    QSet<QString> changed;
+    for (const QString& directory : directories) {
+        changed.insert(QDir::cleanPath(directory));
+    }
+
+    // Artists are direct subfolders of the music directory, see reload().
+    QHash<QString, Artist*> artistsByPath;
+    for (Artist* artist : Manager::instance()->musicModel()->artists()) {
+        const QString artistPath = QDir::cleanPath(artist->path().toString());
+        if (QFileInfo(artistPath).path() == rootPath) {
+            artistsByPath.insert(artistPath, artist);
+        }
+    }
+
+    Database* database = Manager::instance()->database();
+    MusicModel* model = Manager::instance()->musicModel();
+    database->transaction();
+
+    // Removed directories are not reported, but their parent directory is.
+    for (auto it = artistsByPath.begin(); it != artistsByPath.end();) {
+        Artist* artist = it.value();
+        if (changed.contains(rootPath) && !QFileInfo(it.key()).isDir()) {
+            qCInfo(generic) << "[MusicFileSearcher] Removing artist whose directory no longer exists:" << it.key();
+            database->removeArtist(artist->databaseId());
+            model->removeArtist(artist);
+            for (Album* album : artist->albums()) {
+                album->deleteLater();
+            }
+            artist->deleteLater();
+            it = artistsByPath.erase(it);
+            continue;
+        }
+        if (changed.contains(it.key())) {
+            QVector<Album*> albums = artist->albums();
+            const auto removed = std::stable_partition(albums.begin(), albums.end(), [](Album* album) {
+                return QFileInfo(album->path().toString()).isDir();
+            });
+            for (auto album = removed; album != albums.end(); ++album) {
+                qCInfo(generic) << "[MusicFileSearcher] Removing album whose directory no longer exists:"
+                                << (*album)->path();
+                database->removeAlbum((*album)->databaseId());
+                model->removeAlbum(*album);
+                (*album)->deleteLater();
+            }
+            albums.erase(removed, albums.end());
+            artist->setAlbums(albums);
+        }
+        ++it;
+    }
+
+    // New artists, including all of their albums.
+    QSet<QString> artistDirectories;
+    if (changed.contains(rootPath)) {
+        const QFileInfoList entries = QDir(rootPath).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo& entry : entries) {
+            artistDirectories.insert(QDir::cleanPath(entry.filePath()));
+        }
+    }
+    for (const QString& directory : asConst(changed)) {
+        if (QFileInfo(directory).path() == rootPath && QFileInfo(directory).isDir()) {
+            artistDirectories.insert(directory);
+        }
+    }
+    for (const QString& artistPath : asConst(artistDirectories)) {
+        if (artistsByPath.contains(artistPath) || !isMusicDirectory(QFileInfo(artistPath))) {
+            continue;
+        }
+        Artist* artist = addArtist(artistPath, *dir);
+        const QFileInfoList entries = QDir(artistPath).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo& entry : entries) {
+            if (isMusicDirectory(entry)) {
+                addAlbum(QDir::cleanPath(entry.filePath()), artist, *dir);
+            }
+        }
+    }
+
+    // New albums of known artists.
+    for (auto it = artistsByPath.cbegin(); it != artistsByPath.cend(); ++it) {
+        if (!changed.contains(it.key())) {
+            continue;
+        }
+        QSet<QString> albumPaths;
+        for (Album* album : it.value()->albums()) {
+            albumPaths.insert(QDir::cleanPath(album->path().toString()));
+        }
+        const QFileInfoList entries = QDir(it.key()).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QFileInfo& entry : entries) {
+            const QString albumPath = QDir::cleanPath(entry.filePath());
+            if (!albumPaths.contains(albumPath) && isMusicDirectory(entry)) {
+                addAlbum(albumPath, it.value(), *dir);
+            }
+        }
+    }
+
+    database->commit();
+}
+
+bool MusicFileSearcher::isMusicDirectory(const QFileInfo& dir)
+{
+    return !Settings::instance()->advanced()->isFolderExcluded(dir.fileName()) && dir.baseName() != "extrafanart"
+           && dir.baseName() != "extrathumbs";
+}
+
+Artist* MusicFileSearcher::addArtist(const QString& path, const SettingsDir& musicDir)
+{
+    qCInfo(generic) << "[MusicFileSearcher] Adding new artist:" << path;
+    auto* artist = new Artist(mediaelch::DirectoryPath(path), this);
+    artist->setName(QFileInfo(path).baseName());
+    artist->controller()->loadData(Manager::instance()->mediaCenterInterface(), true);
+    Manager::instance()->database()->add(artist, mediaelch::DirectoryPath(musicDir.path));
+    Manager::instance()->musicModel()->appendChild(artist);
+    return artist;
+}
+
+void MusicFileSearcher::addAlbum(const QString& path, Artist* artist, const SettingsDir& musicDir)
+{
+    qCInfo(generic) << "[MusicFileSearcher] Adding new album:" << path;
+    auto* album = new Album(mediaelch::DirectoryPath(path), this);
+    album->setTitle(QFileInfo(path).baseName());
+    album->setArtistObj(artist);
+    artist->addAlbum(album);
+    album->controller()->loadData(Manager::instance()->mediaCenterInterface(), true);
+    Manager::instance()->database()->add(album, mediaelch::DirectoryPath(musicDir.path));
+    Manager::instance()->musicModel()->appendAlbum(artist, album);
+}
+
 Artist* MusicFileSearcher::loadArtistData(Artist* artist)
 {
     artist->controller()->loadData(Manager::instance()->mediaCenterInterface(), false, false);
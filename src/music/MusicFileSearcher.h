@@ -2,7 +2,9 @@
 
 #include "globals/Globals.h"
 
+#include <QFileInfo>
 #include <QObject>
+#include <QStringList>
 
 class Album;
 class Artist;
@@ -21,6 +23,11 @@ public:
 public slots:
     void reload(bool force);
     void abort();
+    /// \brief   Load artists and albums of the given directories that changed on disk.
+    /// \details New artists and albums are added to the model and the database,
+    ///          removed ones are removed.  Only the given directories and the
+    ///          directories of new artists are listed.  musicLoaded() is not emitted.
+    void updateArtists(const mediaelch::DirectoryPath& musicDir, const QStringList& directories);
 
 signals:
     void searchStarted(QString);
@@ -28,6 +35,12 @@ signals:
     void musicLoaded();
     void currentDir(QString);
 
+private:
+    /// \brief Whether albums and artists should be loaded from the given directory.
+    static bool isMusicDirectory(const QFileInfo& dir);
+    Artist* addArtist(const QString& path, const SettingsDir& musicDir);
+    void addAlbum(const QString& path, Artist* artist, const SettingsDir& musicDir);
+
 private:
     QVector<SettingsDir> m_directories;
     int m_progressMessageId;
@@ -126,6 +126,16 @@ MusicModelItem* MusicModel::appendChild(Artist* artist)
     return item;
 }
 
+MusicModelItem* MusicModel::appendAlbum(Artist* artist, Album* album)
+{
+    MusicModelItem* artistItem = artist->modelItem();
+    const QModelIndex artistIndex = index(artistItem->childNumber(), 0);
+    beginInsertRows(artistIndex, artistItem->childCount(), artistItem->childCount());
+    MusicModelItem* item = artistItem->appendChild(album);
+    endInsertRows();
+    return item;
+}
+
 QModelIndex MusicModel::parent(const QModelIndex& index) const
 {
     if (!index.isValid()) {
@@ -197,6 +207,15 @@ void MusicModel::removeArtist(Artist* artist)
     }
 }
 
+void MusicModel::removeAlbum(Album* album)
+{
+    MusicModelItem* albumItem = album->modelItem();
+    if (albumItem == nullptr || albumItem->parent() == nullptr) {
+        return;
+    }
+    removeRow(albumItem->childNumber(), index(albumItem->parent()->childNumber(), 0));
+}
+
 int MusicModel::hasNewArtistsOrAlbums()
 {
     int newItems = 0;
@@ -22,10 +22,13 @@ public:
     bool removeRows(int row, int count, const QModelIndex& parent = QModelIndex()) override;
 
     MusicModelItem* appendChild(Artist* artist);
+    /// \brief Append the album to the given artist, which must be part of the model.
+    MusicModelItem* appendAlbum(Artist* artist, Album* album);
     void clear();
     MusicModelItem* getItem(const QModelIndex& index) const;
     QVector<Artist*> artists();
     void removeArtist(Artist* artist);
+    void removeAlbum(Album* album);
     int hasNewArtistsOrAlbums();
 
 private slots:
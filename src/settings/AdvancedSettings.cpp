@@ -201,7 +201,13 @@ mediaelch::ThumbnailDimensions AdvancedSettings::episodeThumbnailDimensions() co
 
 bool AdvancedSettings::isFileExcluded(QString file) const
 {
-    for (const auto& pattern : m_excludePatterns) {
+    if (m_hasCombinedExcludePatterns && !m_combinedFileExcludes.pattern().isEmpty()
+        && m_combinedFileExcludes.match(file).hasMatch()) {
+        return true;
+    }
+    // Patterns of the combined pattern don't have to be matched again.
+    const auto& patterns = m_hasCombinedExcludePatterns ? m_separateExcludePatterns : m_excludePatterns;
+    for (const auto& pattern : patterns) {
         if (pattern.matchFilename(file)) {
             return true;
         }
@@ -211,7 +217,13 @@ bool AdvancedSettings::isFileExcluded(QString file) const
 
 bool AdvancedSettings::isFolderExcluded(QString dir) const
 {
-    for (const auto& pattern : m_excludePatterns) {
+    if (m_hasCombinedExcludePatterns && !m_combinedFolderExcludes.pattern().isEmpty()
+        && m_combinedFolderExcludes.match(dir).hasMatch()) {
+        return true;
+    }
+    // Patterns of the combined pattern don't have to be matched again.
+    const auto& patterns = m_hasCombinedExcludePatterns ? m_separateExcludePatterns : m_excludePatterns;
+    for (const auto& pattern : patterns) {
         if (pattern.matchFoldername(dir)) {
             return true;
         }
@@ -219,6 +231,98 @@ bool AdvancedSettings::isFolderExcluded(QString dir) const
     return false;
 }
 
+/// \brief Returns true if the pattern refers to its own capture groups, e.g. using "\1".
+/// \details Such patterns can't be part of a combined pattern, because group numbers
+///          change if the pattern is combined with others.  Named references are
+///          treated the same way, because group names must be unique.
+static bool referencesCaptureGroups(const QString& pattern)
+{
+    // Backreferences: \1, \g1, \g{1}, \g{-1}, \g{name}, \k<name>, \k'name', \k{name}, (?P=name)
+    // Subroutine calls and recursion: (?1), (?+1), (?-1), (?R), (?&name), (?P>name)
+    static const QRegularExpression references(
+        R"((?<!\\)(?:\\\\)*(?:\\[1-9]|\\g|\\k[<'{]|\(\?(?:P[=>]|&|R|[+-]?\d)))");
+    return references.match(pattern).hasMatch();
+}
+
+void AdvancedSettings::combineExcludePatterns()
+{
+    QStringList filePatterns;
+    QStringList folderPatterns;
+    m_separateExcludePatterns.clear();
+    for (const auto& pattern : asConst(m_excludePatterns)) {
+        if (referencesCaptureGroups(pattern.pattern())) {
+            m_separateExcludePatterns << pattern;
+            continue;
+        }
+        // Non-capturing groups so that inline options such as "(?i)" only
+        // apply to their own pattern.
+        const QString group = QStringLiteral("(?:%1)").arg(pattern.pattern());
+        if (pattern.isFilePattern()) {
+            filePatterns << group;
+        } else if (pattern.isFolderPattern()) {
+            folderPatterns << group;
+        }
+    }
+
+    m_combinedFileExcludes = QRegularExpression(filePatterns.join('|'));
+    m_combinedFolderExcludes = QRegularExpression(folderPatterns.join('|'));
+
+    // e.g. if two patterns use the same named capture group; fall back to
+    // matching each pattern on its own.
+    m_hasCombinedExcludePatterns = m_combinedFileExcludes.isValid() && m_combinedFolderExcludes.isValid();
+    if (m_hasCombinedExcludePatterns) {
+        m_combinedFileExcludes.optimize();
+        m_combinedFolderExcludes.optimize();
+    } else {
+        qCDebug(generic) << "[AdvancedSettings] Could not combine exclude patterns, matching them one by one";
+    }
+}
+
+bool AdvancedSettings::incrementalMovieScan() const
+{
+    return m_incrementalMovieScan;
+}
+
+bool AdvancedSettings::incrementalTvShowScan() const
+{
+    return m_incrementalTvShowScan;
+}
+
+int AdvancedSettings::concurrentMovieDirectories() const
+{
+    return m_concurrentMovieDirectories;
+}
+
+bool AdvancedSettings::watchLibrary() const
+{
+    return m_watchLibrary;
+}
+
+int AdvancedSettings::watchDebounceInterval() const
+{
+    return m_watchDebounceInterval;
+}
+
+int AdvancedSettings::watchPollInterval() const
+{
+    return m_watchPollInterval;
+}
+
+bool AdvancedSettings::compressDatabaseContent() const
+{
+    return m_compressDatabaseContent;
+}
+
+int AdvancedSettings::episodeGuideRefreshInterval() const
+{
+    return m_episodeGuideRefreshInterval;
+}
+
+int AdvancedSettings::concurrentEpisodeGuideRequests() const
+{
+    return m_concurrentEpisodeGuideRequests;
+}
+
 bool AdvancedSettings::isUserDefined() const
 {
     return m_userDefined;
@@ -287,6 +391,18 @@ QDebug operator<<(QDebug dbg, const AdvancedSettings& settings)
     out << "    useFirstStudioOnly:      " << (settings.m_useFirstStudioOnly ? "true" : "false") << nl;
     out << "    exclude patterns:        " << nl;
     printExcludePatterns(settings.m_excludePatterns);
+    out << "    scanner:                 " << nl;
+    out << "        incrementalMovieScan: " << (settings.m_incrementalMovieScan ? "true" : "false") << nl;
+    out << "        incrementalTvShowScan: " << (settings.m_incrementalTvShowScan ? "true" : "false") << nl;
+    out << "        concurrentMovieDirectories: " << settings.m_concurrentMovieDirectories << nl;
+    out << "        watchLibrary: " << (settings.m_watchLibrary ? "true" : "false") << nl;
+    out << "        watchDebounceInterval: " << settings.m_watchDebounceInterval << nl;
+    out << "        watchPollInterval: " << settings.m_watchPollInterval << nl;
+    out << "    database:                " << nl;
+    out << "        compressContent: " << (settings.m_compressDatabaseContent ? "true" : "false") << nl;
+    out << "    episodeGuides:           " << nl;
+    out << "        refreshInterval: " << settings.m_episodeGuideRefreshInterval << nl;
+    out << "        concurrentRequests: " << settings.m_concurrentEpisodeGuideRequests << nl;
 
     dbg.nospace().noquote() << *out.string();
     return dbg.maybeSpace().maybeQuote();
@@ -44,6 +44,10 @@ public:
         return false;
     }
 
+    bool isFilePattern() const { return m_type == ExcludeType::File; }
+    bool isFolderPattern() const { return m_type == ExcludeType::Folder; }
+    QString pattern() const { return m_regex.pattern(); }
+
     QString toString() const { return excludeTypeToString(m_type) + ": " + m_regex.pattern(); }
 
 private:
@@ -103,6 +107,31 @@ public:
     bool isFileExcluded(QString file) const;
     bool isFolderExcluded(QString dir) const;
 
+    /// \brief If true, movie directories are only rescanned if their
+    ///        modification time or number of entries has changed.
+    bool incrementalMovieScan() const;
+    /// \brief If true, TV show directories are only rescanned if the modification
+    ///        time of the show directory or one of its subdirectories has changed.
+    bool incrementalTvShowScan() const;
+    /// \brief Number of movie library directories that are loaded at the same time.
+    int concurrentMovieDirectories() const;
+    /// \brief If true, library directories are watched for changes and new
+    ///        media files are loaded automatically.
+    bool watchLibrary() const;
+    /// \brief Milliseconds to wait for further changes before changes are loaded.
+    int watchDebounceInterval() const;
+    /// \brief Seconds between two polls of the library directories, 0 if disabled.
+    int watchPollInterval() const;
+
+    /// \brief If true, NFO contents that are cached in the database are stored compressed.
+    bool compressDatabaseContent() const;
+
+    /// \brief Hours after which the episode guide (list of all episodes) of a TV show
+    ///        is loaded again from TMDb, 0 if it is loaded every time.
+    int episodeGuideRefreshInterval() const;
+    /// \brief Number of episode guides that are loaded from TMDb at the same time.
+    int concurrentEpisodeGuideRequests() const;
+
     /// \brief Returns true if the user has provided a custom advancedsettings.xml
     ///        "false" if default values are used.
     bool isUserDefined() const;
@@ -112,6 +141,9 @@ public:
 
 private:
     void setLocale(QString locale);
+    /// \brief Combine all exclude patterns of the same type into one regular
+    ///        expression so that each path only has to be matched once.
+    void combineExcludePatterns();
 
 private:
     bool m_debugLog = false;
@@ -131,11 +163,27 @@ private:
     QHash<QString, QString> m_countryMappings;
     mediaelch::ThumbnailDimensions m_episodeThumbnailDimensions;
     QVector<FileSearchExclude> m_excludePatterns;
+    /// \brief Alternation of all file/folder patterns in m_excludePatterns.
+    /// \details Only used if m_hasCombinedExcludePatterns is true.
+    QRegularExpression m_combinedFileExcludes;
+    QRegularExpression m_combinedFolderExcludes;
+    /// \brief Patterns of m_excludePatterns that can't be combined, e.g. due to backreferences.
+    QVector<FileSearchExclude> m_separateExcludePatterns;
+    bool m_hasCombinedExcludePatterns = false;
     bool m_forceCache = false;
     bool m_portableMode = false;
     int m_bookletCut = 2;
     bool m_writeThumbUrlsToNfo = true;
     bool m_useFirstStudioOnly = false;
+    bool m_incrementalMovieScan = false;
+    bool m_incrementalTvShowScan = false;
+    int m_concurrentMovieDirectories = 1;
+    bool m_watchLibrary = false;
+    int m_watchDebounceInterval = 2000;
+    int m_watchPollInterval = 0;
+    bool m_compressDatabaseContent = false;
+    int m_episodeGuideRefreshInterval = 24;
+    int m_concurrentEpisodeGuideRequests = 4;
     bool m_userDefined = false;
 };
 
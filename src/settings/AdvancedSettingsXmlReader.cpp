@@ -154,6 +154,15 @@ void AdvancedSettingsXmlReader::parseSettings(const QString& xmlSource)
         } else if (m_xml.name() == QLatin1String("exclude")) {
             loadExcludePatterns();
 
+        } else if (m_xml.name() == QLatin1String("scanner")) {
+            loadScanner();
+
+        } else if (m_xml.name() == QLatin1String("database")) {
+            loadDatabase();
+
+        } else if (m_xml.name() == QLatin1String("episodeGuides")) {
+            loadEpisodeGuides();
+
         } else {
             skipUnsupportedTag();
         }
@@ -260,7 +269,7 @@ void AdvancedSettingsXmlReader::loadExcludePatterns()
                 qCCritical(generic) << "[AdvancedSettings] Invalid regular expression! Message:"
                                     << pattern.errorString();
                 addError("pattern", ParseErrorType::InvalidValue);
-                return;
+                break;
             }
             pattern.optimize();
 
@@ -278,6 +287,57 @@ void AdvancedSettingsXmlReader::loadExcludePatterns()
             skipUnsupportedTag();
         }
     }
+    m_settings.combineExcludePatterns();
+}
+
+void AdvancedSettingsXmlReader::loadScanner()
+{
+    while (m_xml.readNextStartElement()) {
+        if (m_xml.name() == QLatin1String("incrementalMovieScan")) {
+            expectBool(m_settings.m_incrementalMovieScan);
+        } else if (m_xml.name() == QLatin1String("incrementalTvShowScan")) {
+            expectBool(m_settings.m_incrementalTvShowScan);
+        } else if (m_xml.name() == QLatin1String("concurrentMovieDirectories")) {
+            const auto inRange = [](int count) { return count >= 1 && count <= 16; };
+            expectIntChecked(m_settings.m_concurrentMovieDirectories, inRange);
+        } else if (m_xml.name() == QLatin1String("watchLibrary")) {
+            expectBool(m_settings.m_watchLibrary);
+        } else if (m_xml.name() == QLatin1String("watchDebounceInterval")) {
+            const auto inRange = [](int ms) { return ms >= 100 && ms <= 60000; };
+            expectIntChecked(m_settings.m_watchDebounceInterval, inRange);
+        } else if (m_xml.name() == QLatin1String("watchPollInterval")) {
+            const auto isValid = [](int seconds) { return seconds == 0 || (seconds >= 10 && seconds <= 86400); };
+            expectIntChecked(m_settings.m_watchPollInterval, isValid);
+        } else {
+            skipUnsupportedTag();
+        }
+    }
+}
+
+void AdvancedSettingsXmlReader::loadDatabase()
+{
+    while (m_xml.readNextStartElement()) {
+        if (m_xml.name() == QLatin1String("compressContent")) {
+            expectBool(m_settings.m_compressDatabaseContent);
+        } else {
+            skipUnsupportedTag();
+        }
+    }
+}
+
+void AdvancedSettingsXmlReader::loadEpisodeGuides()
+{
+    while (m_xml.readNextStartElement()) {
+        if (m_xml.name() == QLatin1String("refreshInterval")) {
+            const auto inRange = [](int hours) { return hours >= 0 && hours <= 8760; };
+            expectIntChecked(m_settings.m_episodeGuideRefreshInterval, inRange);
+        } else if (m_xml.name() == QLatin1String("concurrentRequests")) {
+            const auto inRange = [](int count) { return count >= 1 && count <= 16; };
+            expectIntChecked(m_settings.m_concurrentEpisodeGuideRequests, inRange);
+        } else {
+            skipUnsupportedTag();
+        }
+    }
 }
 
 void AdvancedSettingsXmlReader::addError(QString tag, ParseErrorType type)
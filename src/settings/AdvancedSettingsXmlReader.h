@@ -45,6 +45,9 @@ private:
     void loadFilters();
     void loadMappings(QHash<QString, QString>& map);
     void loadExcludePatterns();
+    void loadScanner();
+    void loadDatabase();
+    void loadEpisodeGuides();
 
     void addError(QString tag, ParseErrorType type);
     void addWarning(QString tag, ParseErrorType type);
@@ -0,0 +1,134 @@
+#include "tv_shows/EpisodeGuideRefresher.h"
+
+#include "data/Database.h"
+#include "globals/Helper.h"
+#include "log/Log.h"
+#include "scrapers/tv_show/tmdb/TmdbTv.h"
+#include "settings/Settings.h"
+#include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
+
+#include <QDateTime>
+#include <QTimer>
+
+namespace mediaelch {
+
+EpisodeGuideRefresher::EpisodeGuideRefresher(scraper::TmdbTv* tmdb,
+    Database* database,
+    Config config,
+    QObject* parent) :
+    QObject(parent), m_tmdb{tmdb}, m_database{database}, m_config{config}
+{
+    m_config.maxConcurrentRequests = qMax(1, m_config.maxConcurrentRequests);
+}
+
+void EpisodeGuideRefresher::refresh(const QVector<TvShow*>& shows)
+{
+    m_total = qsizetype_to_int(shows.size());
+    for (TvShow* show : shows) {
+        if (needsRefresh(show)) {
+            m_queue.enqueue(show);
+        } else {
+            ++m_skipped;
+        }
+    }
+
+    qCInfo(generic) << "[EpisodeGuideRefresher] Loading episode guides of" << m_queue.size() << "TV shows, skipping"
+                    << m_skipped;
+    QTimer::singleShot(0, this, &EpisodeGuideRefresher::startRequests);
+}
+
+void EpisodeGuideRefresher::abort()
+{
+    m_aborted = true;
+    m_skipped += qsizetype_to_int(m_queue.size());
+    m_queue.clear();
+}
+
+bool EpisodeGuideRefresher::needsRefresh(TvShow* show)
+{
+    if (m_tmdb == nullptr || !show->tmdbId().isValid()) {
+        return false;
+    }
+    if (m_config.maxAgeHours <= 0) {
+        return true;
+    }
+    const QDateTime updated = m_database->episodeListUpdated(m_database->showsSettingsId(show));
+    return !updated.isValid()
+           || updated.secsTo(QDateTime::currentDateTimeUtc()) >= static_cast<qint64>(m_config.maxAgeHours) * 3600;
+}
+
+void EpisodeGuideRefresher::startRequests()
+{
+    emitProgress();
+
+    // Scraper settings don't exist if settings were never loaded, e.g. in tests.
+    ScraperSettings* settings = Settings::instance()->scraperSettings(scraper::TmdbTv::ID);
+    const Locale locale = settings != nullptr ? settings->language(m_tmdb->meta().defaultLocale)
+                                              : m_tmdb->meta().defaultLocale;
+
+    while (!m_aborted && m_jobs.size() < m_config.maxConcurrentRequests && !m_queue.isEmpty()) {
+        QPointer<TvShow> show = m_queue.dequeue();
+        if (show.isNull()) {
+            // Deleted while waiting, e.g. because TV shows were reloaded.
+            ++m_skipped;
+            continue;
+        }
+
+        scraper::ShowIdentifier id(show->tmdbId());
+        scraper::SeasonScrapeJob::Config config{
+            id, locale, {}, SeasonOrder::Aired, m_tmdb->meta().supportedEpisodeDetails};
+        auto* job = m_tmdb->loadSeasons(config);
+        m_jobs.insert(job, show);
+        // Queued, so that jobs which finish immediately don't start requests recursively.
+        connect(job,
+            &scraper::SeasonScrapeJob::sigFinished,
+            this,
+            &EpisodeGuideRefresher::onScrapeFinished,
+            Qt::QueuedConnection);
+        job->start();
+    }
+
+    if (m_jobs.isEmpty()) {
+        qCInfo(generic) << "[EpisodeGuideRefresher] Done | refreshed:" << m_refreshed << "| skipped:" << m_skipped
+                        << "| failed:" << m_failed;
+        emit finished();
+    }
+}
+
+void EpisodeGuideRefresher::onScrapeFinished(mediaelch::scraper::SeasonScrapeJob* job)
+{
+    job->deleteLater();
+    QPointer<TvShow> show = m_jobs.take(job);
+
+    if (job->hasError()) {
+        qCWarning(generic) << "[EpisodeGuideRefresher] Could not load episode guide of TV show"
+                           << job->config().identifier << "|" << job->error().message;
+        ++m_failed;
+
+    } else if (show.isNull()) {
+        ++m_skipped;
+
+    } else {
+        QVector<TvShowEpisode*> episodes;
+        for (TvShowEpisode* episode : job->episodes()) {
+            // Map according to advanced settings
+            episode->setNetwork(helper::mapStudio(episode->network()));
+            episode->setCertification(helper::mapCertification(episode->certification()));
+            episodes.append(episode);
+        }
+
+        m_database->setEpisodeList(m_database->showsSettingsId(show), episodes);
+        ++m_refreshed;
+        emit showRefreshed(show);
+    }
+
+    startRequests();
+}
+
+void EpisodeGuideRefresher::emitProgress()
+{
+    emit progress(m_refreshed + m_skipped + m_failed, m_total);
+}
+
+} // namespace mediaelch
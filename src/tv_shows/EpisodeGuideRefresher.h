@@ -0,0 +1,90 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QVector>
+
+class Database;
+class TvShow;
+
+namespace mediaelch {
+
+namespace scraper {
+class SeasonScrapeJob;
+class TmdbTv;
+} // namespace scraper
+
+/// \brief   Loads the episode guides (list of all episodes) of TV shows from TMDb
+///          and stores them in the database.
+/// \details Episode guides are used for missing episodes, see TvShow::fillMissingEpisodes().
+///          At most Config::maxConcurrentRequests guides are loaded at the same time.
+///          Each guide is stored in a single transaction.  Shows without TMDb ID and
+///          shows whose guide is younger than Config::maxAgeHours are skipped.
+///
+/// \par Example
+/// \code{cpp}
+///   auto* refresher = new EpisodeGuideRefresher(tmdb, database, {24, 4}, this);
+///   connect(refresher, &EpisodeGuideRefresher::finished, refresher, &QObject::deleteLater);
+///   refresher->refresh(shows);
+/// \endcode
+class EpisodeGuideRefresher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config
+    {
+        /// \brief Guides that were stored within the last n hours are not loaded again.
+        ///        0 loads all guides.
+        int maxAgeHours = 24;
+        /// \brief Number of guides that are loaded at the same time.
+        int maxConcurrentRequests = 4;
+    };
+
+    EpisodeGuideRefresher(scraper::TmdbTv* tmdb, Database* database, Config config, QObject* parent = nullptr);
+    ~EpisodeGuideRefresher() override = default;
+
+    /// \brief   Load the episode guides of the given shows.
+    /// \details Always asynchronous: finished() is emitted even if all shows are skipped.
+    ///          Must only be called once.
+    void refresh(const QVector<TvShow*>& shows);
+    /// \brief Do not start any further requests.  Running requests are finished.
+    void abort();
+
+    int refreshedCount() const { return m_refreshed; }
+    int skippedCount() const { return m_skipped; }
+    int failedCount() const { return m_failed; }
+
+signals:
+    /// \brief The episode guide of the show was stored in the database.
+    void showRefreshed(TvShow* show);
+    /// \brief Number of processed shows, i.e. refreshed, skipped or failed ones.
+    void progress(int processed, int total);
+    void finished();
+
+private slots:
+    void startRequests();
+    void onScrapeFinished(mediaelch::scraper::SeasonScrapeJob* job);
+
+private:
+    bool needsRefresh(TvShow* show);
+    void emitProgress();
+
+private:
+    scraper::TmdbTv* m_tmdb = nullptr;
+    Database* m_database = nullptr;
+    Config m_config;
+
+    QQueue<QPointer<TvShow>> m_queue;
+    /// \brief Running requests and their shows.  Shows may be deleted meanwhile, e.g. by a reload.
+    QHash<scraper::SeasonScrapeJob*, QPointer<TvShow>> m_jobs;
+    bool m_aborted = false;
+    int m_total = 0;
+    int m_refreshed = 0;
+    int m_skipped = 0;
+    int m_failed = 0;
+};
+
+} // namespace mediaelch
@@ -4,6 +4,7 @@
 #include <QApplication>
 #include <QDir>
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "file/NameFormatter.h"
@@ -24,7 +25,8 @@ using namespace std::chrono_literals;
 TvShow::TvShow(mediaelch::DirectoryPath dir, QObject* parent) : QObject(parent), m_dir{std::move(dir)}, m_runtime{0min}
 {
     clear();
-    static int m_idCounter = 0;
+    // Shows are created by the TvShowLoader's thread as well.
+    static std::atomic_int m_idCounter{0};
     m_showId = ++m_idCounter;
 }
 
@@ -178,6 +180,109 @@ void TvShow::clearSeasonImageType(ImageType imageType)
 void TvShow::addEpisode(TvShowEpisode* episode)
 {
     m_episodes.push_back(episode);
+    indexEpisode(episode);
+}
+
+void TvShow::updateEpisodeNumber(TvShowEpisode* episode, SeasonNumber oldSeason, EpisodeNumber oldEpisode)
+{
+    if (!m_seasonEpisodes.value(oldSeason).contains(episode)) {
+        // Not (yet) part of this show, e.g. the episode's number is set before it is added.
+        return;
+    }
+    unindexEpisode(episode, oldSeason, oldEpisode);
+
+    // Unlike addEpisode(), the episode keeps its position in m_episodes, i.e. it must
+    // not be appended to its new season.  Insert it in front of the season's next episode.
+    const elch_size_t position = m_episodes.indexOf(episode);
+    const SeasonNumber season = episode->seasonNumber();
+    QVector<TvShowEpisode*>& seasonEpisodes = m_seasonEpisodes[season];
+    elch_size_t insertAt = seasonEpisodes.size();
+    for (elch_size_t i = position + 1, n = m_episodes.size(); i < n; ++i) {
+        if (m_episodes.at(i)->seasonNumber() == season) {
+            const elch_size_t next = seasonEpisodes.indexOf(m_episodes.at(i));
+            if (next != -1) {
+                insertAt = next;
+                break;
+            }
+        }
+    }
+    seasonEpisodes.insert(insertAt, episode);
+
+    // The first episode in m_episodes wins for duplicate numbers.
+    const QPair<int, int> key(season.toInt(), episode->episodeNumber().toInt());
+    TvShowEpisode* indexed = m_episodeIndex.value(key, nullptr);
+    if (indexed == nullptr || m_episodes.indexOf(indexed) > position) {
+        m_episodeIndex.insert(key, episode);
+    }
+
+    // Both the old and the new season may now start with another episode.
+    updateSeasonOrder();
+}
+
+void TvShow::updateSeasonOrder()
+{
+    m_seasonOrder.clear();
+    for (const TvShowEpisode* episode : asConst(m_episodes)) {
+        if (m_seasonOrder.size() == m_seasonEpisodes.size()) {
+            break;
+        }
+        const SeasonNumber season = episode->seasonNumber();
+        if (!m_seasonOrder.contains(season)) {
+            m_seasonOrder.append(season);
+        }
+    }
+}
+
+void TvShow::indexEpisode(TvShowEpisode* episode)
+{
+    const SeasonNumber season = episode->seasonNumber();
+    auto seasonIt = m_seasonEpisodes.find(season);
+    if (seasonIt == m_seasonEpisodes.end()) {
+        seasonIt = m_seasonEpisodes.insert(season, {});
+        m_seasonOrder.append(season);
+    }
+    seasonIt->append(episode);
+
+    const QPair<int, int> key(season.toInt(), episode->episodeNumber().toInt());
+    if (!m_episodeIndex.contains(key)) {
+        m_episodeIndex.insert(key, episode);
+    }
+}
+
+void TvShow::unindexEpisode(TvShowEpisode* episode, SeasonNumber season, EpisodeNumber episodeNumber)
+{
+    auto seasonIt = m_seasonEpisodes.find(season);
+    if (seasonIt == m_seasonEpisodes.end()) {
+        return;
+    }
+    seasonIt->removeOne(episode);
+
+    const QPair<int, int> key(season.toInt(), episodeNumber.toInt());
+    if (m_episodeIndex.value(key) == episode) {
+        m_episodeIndex.remove(key);
+        // Another episode may have the same number.
+        for (TvShowEpisode* other : asConst(*seasonIt)) {
+            if (other->episodeNumber() == episodeNumber) {
+                m_episodeIndex.insert(key, other);
+                break;
+            }
+        }
+    }
+
+    if (seasonIt->isEmpty()) {
+        m_seasonEpisodes.erase(seasonIt);
+        m_seasonOrder.removeOne(season);
+    }
+}
+
+void TvShow::rebuildEpisodeIndex()
+{
+    m_seasonEpisodes.clear();
+    m_seasonOrder.clear();
+    m_episodeIndex.clear();
+    for (TvShowEpisode* episode : asConst(m_episodes)) {
+        indexEpisode(episode);
+    }
 }
 
 /**
@@ -675,25 +780,20 @@ const QMap<SeasonNumber, QVector<Poster>>& TvShow::allSeasonThumbs() const
     return m_seasonThumbs;
 }
 
-TvShowEpisode* TvShow::episode(SeasonNumber season, EpisodeNumber episode)
+TvShowEpisode* TvShow::episode(SeasonNumber season, EpisodeNumber episode) const
 {
-    for (elch_size_t i = 0, n = m_episodes.count(); i < n; ++i) {
-        if (m_episodes[i]->seasonNumber() == season && m_episodes[i]->episodeNumber() == episode) {
-            return m_episodes[i];
-        }
-    }
-    return new TvShowEpisode(QStringList(), this);
+    return m_episodeIndex.value(qMakePair(season.toInt(), episode.toInt()), nullptr);
 }
 
 QVector<SeasonNumber> TvShow::seasons(bool includeDummies) const
 {
     QVector<SeasonNumber> seasons;
-    for (TvShowEpisode* episode : m_episodes) {
-        if (episode->isDummy() && !includeDummies) {
+    for (const SeasonNumber& season : m_seasonOrder) {
+        if (season == SeasonNumber::NoSeason) {
             continue;
         }
-        if (!seasons.contains(episode->seasonNumber()) && episode->seasonNumber() != SeasonNumber::NoSeason) {
-            seasons.append(episode->seasonNumber());
+        if (includeDummies || !isDummySeason(season)) {
+            seasons.append(season);
         }
     }
     return seasons;
@@ -706,14 +806,7 @@ const QVector<TvShowEpisode*>& TvShow::episodes() const
 
 QVector<TvShowEpisode*> TvShow::episodes(SeasonNumber season) const
 {
-    QVector<TvShowEpisode*> episodes;
-    for (TvShowEpisode* episode : m_episodes) {
-        if (episode->seasonNumber() == season) {
-            episodes.push_back(episode);
-        }
-    }
-
-    return episodes;
+    return m_seasonEpisodes.value(season);
 }
 
 TvShowModelItem* TvShow::modelItem()
@@ -1363,18 +1456,23 @@ void TvShow::setRuntime(std::chrono::minutes runtime)
 
 bool TvShow::isDummySeason(SeasonNumber season) const
 {
-    for (TvShowEpisode* episode : m_episodes) {
-        if (episode->seasonNumber() == season && !episode->isDummy()) {
-            return false;
-        }
+    const auto seasonIt = m_seasonEpisodes.constFind(season);
+    if (seasonIt == m_seasonEpisodes.cend()) {
+        return true;
     }
-    return true;
+    return std::all_of(seasonIt->cbegin(), seasonIt->cend(), [](const TvShowEpisode* const episode) {
+        return episode->isDummy();
+    });
 }
 
 bool TvShow::hasDummyEpisodes(SeasonNumber season) const
 {
-    return std::any_of(m_episodes.cbegin(), m_episodes.cend(), [season](const TvShowEpisode* const episode) {
-        return episode->seasonNumber() == season && episode->isDummy();
+    const auto seasonIt = m_seasonEpisodes.constFind(season);
+    if (seasonIt == m_seasonEpisodes.cend()) {
+        return false;
+    }
+    return std::any_of(seasonIt->cbegin(), seasonIt->cend(), [](const TvShowEpisode* const episode) {
+        return episode->isDummy();
     });
 }
 
@@ -1419,16 +1517,7 @@ void TvShow::fillMissingEpisodes()
             continue;
         }
 
-        bool found = false;
-        for (elch_size_t i = 0, n = m_episodes.count(); i < n; ++i) {
-            if (m_episodes[i]->seasonNumber() == episode->seasonNumber()
-                && m_episodes[i]->episodeNumber() == episode->episodeNumber()) {
-                found = true;
-                break;
-            }
-        }
-
-        if (found) {
+        if (this->episode(episode->seasonNumber(), episode->episodeNumber()) != nullptr) {
             episode->deleteLater();
             continue;
         }
@@ -1444,17 +1533,18 @@ void TvShow::fillMissingEpisodes()
         addEpisode(episode);
     }
 
+    // Only inserts/removes the changed rows; the view spans new rows itself,
+    // i.e. the view doesn't need to be renewed for each show.
     Manager::instance()->tvShowModel()->updateShow(this);
-    TvShowFilesWidget::instance().renewModel(true);
 }
 
 void TvShow::clearMissingEpisodes()
 {
     const auto isDummyEpisode = [](TvShowEpisode* episode) { return episode->isDummy(); };
     m_episodes.erase(std::remove_if(m_episodes.begin(), m_episodes.end(), isDummyEpisode), m_episodes.end());
+    rebuildEpisodeIndex();
 
     Manager::instance()->tvShowModel()->updateShow(this);
-    TvShowFilesWidget::instance().renewModel(true);
 }
 
 QDebug operator<<(QDebug dbg, const TvShow& show)
@@ -14,8 +14,10 @@
 #include "tv_shows/TvMazeId.h"
 #include "tv_shows/TvShowEpisode.h"
 
+#include <QHash>
 #include <QMetaType>
 #include <QObject>
+#include <QPair>
 #include <QStringList>
 #include <QVector>
 #include <chrono>
@@ -41,6 +43,11 @@ public:
     void clearEpisodes(QSet<EpisodeScraperInfo> infos, bool onlyNew);
     void addEpisode(TvShowEpisode* episode);
     int episodeCount() const;
+    /// \brief   Update the episode index after the season or episode number of one
+    ///          of this show's episodes changed.
+    /// \details Called by TvShowEpisode.  Episodes that were not added to this show
+    ///          using addEpisode() are ignored.
+    void updateEpisodeNumber(TvShowEpisode* episode, SeasonNumber oldSeason, EpisodeNumber oldEpisode);
 
     /// \brief Main title of the show.
     QString title() const;
@@ -89,7 +96,9 @@ public:
     const QMap<SeasonNumber, QVector<Poster>>& allSeasonBanners() const;
     const QMap<SeasonNumber, QVector<Poster>>& allSeasonThumbs() const;
 
-    TvShowEpisode* episode(SeasonNumber season, EpisodeNumber episode);
+    /// \brief Episode with the given season and episode number or nullptr if there is none.
+    /// \details If multiple episodes have the same number, the first one that was added is returned.
+    TvShowEpisode* episode(SeasonNumber season, EpisodeNumber episode) const;
     QVector<SeasonNumber> seasons(bool includeDummies = true) const;
     const QVector<TvShowEpisode*>& episodes() const;
     QVector<TvShowEpisode*> episodes(SeasonNumber season) const;
@@ -217,8 +226,21 @@ signals:
     void sigLoaded(TvShow* show, QSet<ShowScraperInfo> details, mediaelch::Locale locale);
     void sigChanged(TvShow*);
 
+private:
+    void indexEpisode(TvShowEpisode* episode);
+    void unindexEpisode(TvShowEpisode* episode, SeasonNumber season, EpisodeNumber episodeNumber);
+    void rebuildEpisodeIndex();
+    /// \brief Sort m_seasonOrder by the position of each season's first episode in m_episodes.
+    void updateSeasonOrder();
+
 private:
     QVector<TvShowEpisode*> m_episodes;
+    /// \brief Episodes of each season in the same order as in m_episodes.
+    QHash<SeasonNumber, QVector<TvShowEpisode*>> m_seasonEpisodes;
+    /// \brief Seasons in the order of their first episode in m_episodes.
+    QVector<SeasonNumber> m_seasonOrder;
+    /// \brief First episode in m_episodes for a (season, episode) number.
+    QHash<QPair<int, int>, TvShowEpisode*> m_episodeIndex;
     mediaelch::DirectoryPath m_dir;
     QString m_title;
     QString m_showTitle;
@@ -14,6 +14,7 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QTime>
+#include <atomic>
 #include <utility>
 
 TvShowEpisode::TvShowEpisode(const mediaelch::FileList& files, QObject* parent) :
@@ -41,7 +42,8 @@ TvShowEpisode::TvShowEpisode(const mediaelch::FileList& files, TvShow* parentSho
 
 void TvShowEpisode::initCounter()
 {
-    static int m_idCounter = 0;
+    // Episodes are created by the TvShowLoader's thread as well.
+    static std::atomic_int m_idCounter{0};
     m_episodeId = ++m_idCounter;
 }
 
@@ -620,7 +622,11 @@ void TvShowEpisode::setUserRating(double rating)
  */
 void TvShowEpisode::setSeason(SeasonNumber season)
 {
+    const SeasonNumber oldSeason = m_season;
     m_season = season;
+    if (m_show != nullptr && oldSeason != season) {
+        m_show->updateEpisodeNumber(this, oldSeason, m_episode);
+    }
     setChanged(true);
 }
 
@@ -631,7 +637,11 @@ void TvShowEpisode::setSeason(SeasonNumber season)
  */
 void TvShowEpisode::setEpisode(EpisodeNumber episode)
 {
+    const EpisodeNumber oldEpisode = m_episode;
     m_episode = episode;
+    if (m_show != nullptr && oldEpisode != episode) {
+        m_show->updateEpisodeNumber(this, m_season, oldEpisode);
+    }
     setChanged(true);
 }
 
@@ -1,17 +1,22 @@
 #include "TvShowFileSearcher.h"
 
-#include <QApplication>
 #include <QFileInfo>
+#include <QHash>
+#include <QSet>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QSqlRecord>
-#include <QtConcurrent/QtConcurrentMap>
+#include <QThread>
+#include <algorithm>
 
 #include "globals/Helper.h"
+#include "globals/LoaderThreadPool.h"
 #include "globals/Manager.h"
 #include "globals/MessageIds.h"
 #include "tv_shows/TvShow.h"
 #include "tv_shows/TvShowEpisode.h"
+#include "tv_shows/TvShowLoader.h"
+#include "tv_shows/TvShowUtils.h"
 #include "tv_shows/model/EpisodeModelItem.h"
 #include "tv_shows/model/SeasonModelItem.h"
 #include "tv_shows/model/TvShowModelItem.h"
@@ -46,23 +51,71 @@ void TvShowFileSearcher::setTvShowDirectories(QVector<SettingsDir> directories)
 void TvShowFileSearcher::reload(bool force)
 {
     qCInfo(generic) << "[TvShowFileSearcher] Reload TV shows, clear database:" << force;
+    if (m_loader != nullptr) {
+        // Results of the running loader are outdated.
+        discardJob(m_loader, m_loaderStore);
+        m_loader = nullptr;
+        m_loaderStore = nullptr;
+    }
+    // The reload loads all shows anyway.
+    discardUpdates();
     m_aborted = false;
 
     clearOldTvShows(force);
 
     emit searchStarted(tr("Searching for TV Shows..."));
+    emit progress(0, 0, m_progressMessageId);
+
+    m_loaderStore = new mediaelch::TvShowLoaderStore(this);
+    m_loader = new mediaelch::TvShowLoader(m_directories, force, *m_loaderStore, nullptr);
+    m_loader->setIncrementalScan(Settings::instance()->advanced()->incrementalTvShowScan());
+
+    connect(m_loader, &mediaelch::TvShowLoader::showsLoaded, this, &TvShowFileSearcher::onShowsLoaded);
+    connect(m_loader, &mediaelch::TvShowLoader::finished, this, &TvShowFileSearcher::onLoaderFinished);
+    connect(m_loader, &mediaelch::TvShowLoader::directoriesScanned, this, [this]() {
+        emit currentDir("");
+        emit searchStarted(tr("Loading TV Shows..."));
+    });
+    connect(m_loader,
+        &mediaelch::TvShowLoader::progress,
+        this,
+        [this](mediaelch::TvShowLoader*, int processed, int total) {
+            emit progress(processed, total, m_progressMessageId);
+        });
+    connect(m_loader, &mediaelch::TvShowLoader::progressText, this, [this](mediaelch::TvShowLoader*, QString text) {
+        emit currentDir(text);
+    });
+    mediaelch::runInLoaderThread(m_loader, QThread::HighPriority);
+}
 
-    auto files = readTvShowContent(force);
+void TvShowFileSearcher::onShowsLoaded(mediaelch::TvShowLoader* job)
+{
+    if (job != m_loader || m_aborted) {
+        return;
+    }
+    // Note: This file searcher is the parent of all shows, but the model handles them.
+    const QVector<TvShow*> shows = m_loaderStore->takeAll(this);
+    for (TvShow* show : shows) {
+        Manager::instance()->tvShowModel()->appendShow(show);
+    }
+}
 
-    emit currentDir("");
+void TvShowFileSearcher::onLoaderFinished(mediaelch::TvShowLoader* job)
+{
+    if (job != m_loader) {
+        return;
+    }
+    // Remaining shows that were not published in a batch, if any.
+    onShowsLoaded(job);
 
-    emit searchStarted(tr("Loading TV Shows..."));
-    int episodeCounter = 0;
-    const int episodeSum = database().episodeCount();
+    job->deleteLater();
+    m_loaderStore->deleteLater();
+    m_loader = nullptr;
+    m_loaderStore = nullptr;
 
-    QVector<TvShow*> dbShows = getShowsFromDatabase(force);
-    setupShows(files, episodeCounter, episodeSum);
-    setupShowsFromDatabase(dbShows, episodeCounter, episodeSum);
+    if (m_aborted) {
+        return;
+    }
 
     for (TvShow* show : Manager::instance()->tvShowModel()->tvShows()) {
         if (show->showMissingEpisodes()) {
@@ -71,9 +124,20 @@ void TvShowFileSearcher::reload(bool force)
     }
 
     qCDebug(generic) << "[TvShowFileSearcher] Searching for TV shows done";
-    if (!m_aborted) {
-        emit tvShowsLoaded();
-    }
+    emit tvShowsLoaded();
+}
+
+void TvShowFileSearcher::discardJob(mediaelch::TvShowLoader* job, mediaelch::TvShowLoaderStore* store)
+{
+    disconnect(job, nullptr, this, nullptr);
+    // The loader still runs in its own thread. It must not be deleted before
+    // it has finished, because it still writes into its store.  The store must
+    // outlive this searcher as well.
+    store->setParent(nullptr);
+    connect(job, &mediaelch::TvShowLoader::finished, store, &mediaelch::TvShowLoaderStore::clear);
+    connect(job, &mediaelch::TvShowLoader::finished, store, &QObject::deleteLater);
+    connect(job, &mediaelch::TvShowLoader::finished, job, &QObject::deleteLater);
+    job->abort();
 }
 
 TvShowEpisode* TvShowFileSearcher::loadEpisodeData(TvShowEpisode* episode)
@@ -84,354 +148,217 @@ TvShowEpisode* TvShowFileSearcher::loadEpisodeData(TvShowEpisode* episode)
 
 void TvShowFileSearcher::reloadEpisodes(const mediaelch::DirectoryPath& showDir)
 {
-    database().clearTvShowInDirectory(showDir);
-    emit searchStarted(tr("Searching for Episodes..."));
-
-    // remove old show object
-    for (TvShow* s : Manager::instance()->tvShowModel()->tvShows()) {
-        if (m_aborted) {
-            return;
-        }
-
-        if (s->dir() == showDir) {
-            Manager::instance()->tvShowModel()->removeShow(s);
-            break;
-        }
-    }
-
-    // get path
-    mediaelch::DirectoryPath path;
-    elch_size_t index = -1;
-    for (elch_size_t i = 0, n = m_directories.count(); i < n; ++i) {
-        if (m_aborted) {
-            return;
-        }
+    const QString showPath = QDir::cleanPath(showDir.toString());
+    ShowUpdate update;
+    update.update.libraryPath = libraryDirectory(showDir);
+    update.update.showDirs.insert(showPath);
+    update.reloadedShows.insert(showPath);
+    enqueueUpdate(update);
+}
 
-        if (showDir.toString().startsWith(m_directories[i].path.path())) {
-            if (index == -1 || m_directories[index].path.path().length() < m_directories[i].path.path().length()) {
-                index = i;
-            }
-        }
+void TvShowFileSearcher::updateShows(const mediaelch::DirectoryPath& tvShowDir, const QStringList& directories)
+{
+    const bool isTvShowDir = std::any_of(m_directories.cbegin(), m_directories.cend(), [&](const SettingsDir& dir) {
+        return !dir.disabled && mediaelch::DirectoryPath(dir.path) == tvShowDir;
+    });
+    if (!isTvShowDir) {
+        return;
     }
-    if (index != -1) {
-        path = mediaelch::DirectoryPath(m_directories[index].path);
+    if (m_loader != nullptr) {
+        // A complete reload is in progress which loads all shows anyway.
+        qCDebug(generic) << "[TvShowFileSearcher] Ignoring changed directories while reloading:" << tvShowDir;
+        return;
     }
 
-    // search for contents
-    QVector<QStringList> contents;
-    scanTvShowDir(path, showDir, contents);
-    auto* show = new TvShow(showDir, this);
-    show->loadData(Manager::instance()->mediaCenterInterfaceTvShow());
-    database().add(show, path);
+    const QString rootPath = QDir::cleanPath(tvShowDir.toString());
+    ShowUpdate update;
+    update.update.libraryPath = tvShowDir;
 
-    emit searchStarted(tr("Loading Episodes..."));
-    emit currentDir(show->title());
-
-    int episodeCounter = 0;
-    int episodeSum = qsizetype_to_int(contents.count());
-
-    QVector<TvShowEpisode*> episodes;
-    for (const QStringList& files : contents) {
-        if (m_aborted) {
-            return;
-        }
-        SeasonNumber seasonNumber = getSeasonNumber(files);
-        QVector<EpisodeNumber> episodeNumbers = getEpisodeNumbers(files);
-        for (const EpisodeNumber& episodeNumber : episodeNumbers) {
-            auto* episode = new TvShowEpisode(files, show);
-            episode->setSeason(seasonNumber);
-            episode->setEpisode(episodeNumber);
-            episodes.append(episode);
+    // Each direct subdirectory of the TV show directory is a show.
+    for (const QString& directory : directories) {
+        if (!directory.startsWith(rootPath + "/")) {
+            // Shows may have been added or removed.
+            update.update.scanLibrary = update.update.scanLibrary || directory == rootPath;
+            continue;
         }
+        update.update.showDirs.insert(rootPath + "/" + directory.mid(rootPath.length() + 1).section('/', 0, 0));
     }
-
-    QtConcurrent::blockingMapped(episodes, TvShowFileSearcher::reloadEpisodeData);
-
-    for (TvShowEpisode* episode : episodes) {
-        database().add(episode, path, show->databaseId());
-        show->addEpisode(episode);
-        emit progress(++episodeCounter, episodeSum, m_progressMessageId);
-        QApplication::processEvents();
+    if (update.update.showDirs.isEmpty() && !update.update.scanLibrary) {
+        return;
     }
-
-    Manager::instance()->tvShowModel()->appendShow(show);
-
-    emit tvShowsLoaded();
+    enqueueUpdate(update);
 }
 
-TvShowEpisode* TvShowFileSearcher::reloadEpisodeData(TvShowEpisode* episode)
+void TvShowFileSearcher::enqueueUpdate(ShowUpdate update)
 {
-    episode->loadData(Manager::instance()->mediaCenterInterfaceTvShow(), true, true);
-    return episode;
-}
-
-/**
- * \brief Scans a dir for TV show files
- * \param path Directory to scan
- */
-void TvShowFileSearcher::getTvShows(const mediaelch::DirectoryPath& path, QMap<QString, QVector<QStringList>>& contents)
-{
-    QDir dir(path.toString());
-    QStringList tvShows = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QString& cDir : tvShows) {
-        if (m_aborted) {
+    // Merge updates of the same TV show directory that did not start, yet.
+    for (ShowUpdate& queued : m_updateQueue) {
+        if (queued.update.libraryPath == update.update.libraryPath) {
+            queued.update.showDirs.unite(update.update.showDirs);
+            queued.update.scanLibrary = queued.update.scanLibrary || update.update.scanLibrary;
+            queued.reloadedShows.unite(update.reloadedShows);
             return;
         }
-
-        if (Settings::instance()->advanced()->isFolderExcluded(cDir)) {
-            continue;
-        }
-
-        QVector<QStringList> tvShowContents;
-        scanTvShowDir(path, path.subDir(cDir), tvShowContents);
-        contents.insert((dir.path() + '/' + cDir), tvShowContents);
+    }
+    m_updateQueue.enqueue(update);
+    if (m_updateJob == nullptr) {
+        startNextUpdate();
     }
 }
 
-/**
- * \brief Scans the given path for TV show files.
- * Results are in a list which contains a QStringList for every episode.
- * \param startPath Scanning started at this path
- * \param path Path to scan
- * \param contents List of contents
- */
-void TvShowFileSearcher::scanTvShowDir(const mediaelch::DirectoryPath& startPath,
-    const mediaelch::DirectoryPath& path,
-    QVector<QStringList>& contents)
+void TvShowFileSearcher::startNextUpdate()
 {
-    emit currentDir(path.toString().mid(startPath.toString().length()));
-
-    QDir dir(path.toString());
-    for (const QString& cDir : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
-        if (m_aborted) {
-            return;
-        }
-
-        if (Settings::instance()->advanced()->isFolderExcluded(cDir)) {
-            continue;
-        }
-
-        // Skip "Extras" folder
-        if (QString::compare(cDir, "Extras", Qt::CaseInsensitive) == 0
-            || QString::compare(cDir, ".actors", Qt::CaseInsensitive) == 0
-            || QString::compare(cDir, "extrafanarts", Qt::CaseInsensitive) == 0) {
-            continue;
-        }
-
-        // Handle DVD
-        if (helper::isDvd(path.subDir(cDir))) {
-            contents.append(QStringList() << (path.toString() + "/" + cDir + "/VIDEO_TS/VIDEO_TS.IFO"));
-            continue;
-        }
-        if (helper::isDvd(path.subDir(cDir), true)) {
-            contents.append(QStringList() << (path.toString() + "/" + cDir + "/VIDEO_TS.IFO"));
-            continue;
-        }
-
-        // Handle BluRay
-        if (helper::isBluRay(path.subDir(cDir))) {
-            contents.append(QStringList() << (path.toString() + "/" + cDir + "/BDMV/index.bdmv"));
-            continue;
-        }
-        scanTvShowDir(startPath, path.subDir(cDir), contents);
+    if (m_updateQueue.isEmpty()) {
+        return;
     }
+    ShowUpdate update = m_updateQueue.dequeue();
+    m_notifyUpdate = !update.reloadedShows.isEmpty();
 
-    QStringList files;
-    QStringList entries = getFiles(path);
-    for (const QString& file : entries) {
-        if (Settings::instance()->advanced()->isFileExcluded(file)) {
+    // Episode files of all loaded shows of the TV show directory.  Shows of the
+    // previous update are part of the model as well, see onUpdatedShowsLoaded().
+    // Shows of reloadEpisodes() are always reloaded, i.e. their files are not needed.
+    const QString rootPath = QDir::cleanPath(update.update.libraryPath.toString());
+    for (TvShow* show : Manager::instance()->tvShowModel()->tvShows()) {
+        const QString showPath = QDir::cleanPath(show->dir().toString());
+        if (!showPath.startsWith(rootPath + "/") || update.reloadedShows.contains(showPath)) {
             continue;
         }
-        // Skip Trailers and Sample files
-        if (file.contains("-trailer", Qt::CaseInsensitive) || file.contains("-sample", Qt::CaseInsensitive)) {
-            continue;
+        QSet<QString>& loadedFiles = update.update.loadedFiles[showPath];
+        for (const TvShowEpisode* episode : show->episodes()) {
+            if (episode->isDummy()) {
+                continue;
+            }
+            const QStringList files = episode->files().toStringList();
+            for (const QString& file : files) {
+                loadedFiles.insert(file);
+            }
         }
-        files.append(file);
     }
-    files.sort();
 
-    QRegularExpression rx("((?:part|cd)[\\s_]*)(\\d+)", QRegularExpression::CaseInsensitiveOption);
-    for (elch_size_t i = 0, n = files.size(); i < n; i++) {
-        if (m_aborted) {
-            return;
-        }
+    emit searchStarted(tr("Searching for Episodes..."));
 
-        QStringList tvShowFiles;
-        QString file = files.at(i);
-        if (file.isEmpty()) {
-            continue;
-        }
+    m_updateStore = new mediaelch::TvShowLoaderStore(this);
+    m_updateJob = new mediaelch::TvShowLoader(m_directories, true, *m_updateStore, nullptr);
+    m_updateJob->setUpdate(std::move(update.update));
+
+    connect(m_updateJob, &mediaelch::TvShowLoader::showsLoaded, this, &TvShowFileSearcher::onUpdatedShowsLoaded);
+    connect(m_updateJob, &mediaelch::TvShowLoader::finished, this, &TvShowFileSearcher::onUpdateJobFinished);
+    connect(m_updateJob, &mediaelch::TvShowLoader::directoriesScanned, this, [this]() {
+        emit currentDir("");
+        emit searchStarted(tr("Loading Episodes..."));
+    });
+    connect(m_updateJob,
+        &mediaelch::TvShowLoader::progress,
+        this,
+        [this](mediaelch::TvShowLoader*, int processed, int total) {
+            emit progress(processed, total, m_progressMessageId);
+        });
+    connect(m_updateJob,
+        &mediaelch::TvShowLoader::progressText,
+        this,
+        [this](mediaelch::TvShowLoader*, QString text) { emit currentDir(text); });
+    mediaelch::runInLoaderThread(m_updateJob, QThread::LowPriority);
+}
 
-        tvShowFiles << (path.toString() + '/' + file);
-
-        QRegularExpressionMatch match = rx.match(file);
-        elch_size_t pos = match.capturedStart(0);
-        if (pos != -1) {
-            QString left = file.left(pos) + match.captured(1);
-            QString right = file.mid(pos + match.captured(1).size() + match.captured(2).size());
-            for (int x = 0; x < n; x++) {
-                QString subFile = files.at(x);
-                if (subFile != file) {
-                    if (subFile.startsWith(left) && subFile.endsWith(right)) {
-                        tvShowFiles << (path.toString() + '/' + subFile);
-                        files[x] = ""; // set an empty file name, this way we can skip this file in the main loop
-                    }
-                }
+void TvShowFileSearcher::onUpdatedShowsLoaded(mediaelch::TvShowLoader* job)
+{
+    if (job != m_updateJob) {
+        return;
+    }
+    const QVector<TvShow*> shows = m_updateStore->takeAll(this);
+    for (TvShow* show : shows) {
+        // Replace the outdated show, if it was loaded before.
+        for (TvShow* oldShow : Manager::instance()->tvShowModel()->tvShows()) {
+            if (QDir::cleanPath(oldShow->dir().toString()) == QDir::cleanPath(show->dir().toString())) {
+                Manager::instance()->tvShowModel()->removeShow(oldShow);
+                break;
             }
         }
-        if (tvShowFiles.count() > 0) {
-            contents.append(tvShowFiles);
-        }
+        Manager::instance()->tvShowModel()->appendShow(show);
+        m_notifyUpdate = true;
     }
 }
 
-/// Get a list of files in a directory
-QStringList TvShowFileSearcher::getFiles(const mediaelch::DirectoryPath& path)
-{
-    return Settings::instance()->advanced()->tvShowFilters().files(QDir(path.toString()));
-}
-
-void TvShowFileSearcher::abort()
-{
-    m_aborted = true;
-}
-
-SeasonNumber TvShowFileSearcher::getSeasonNumber(QStringList files)
+void TvShowFileSearcher::onUpdateJobFinished(mediaelch::TvShowLoader* job)
 {
-    if (files.isEmpty()) {
-        return SeasonNumber::NoSeason;
+    if (job != m_updateJob) {
+        return;
     }
-
-    QStringList filenameParts = files.at(0).split('/');
-    QString filename = filenameParts.last();
-    if (filename.endsWith("VIDEO_TS.IFO", Qt::CaseInsensitive)) {
-        if (filenameParts.count() > 1 && helper::isDvd(files.at(0))) {
-            filename = filenameParts.at(filenameParts.count() - 3);
-        } else if (filenameParts.count() > 2 && helper::isDvd(files.at(0), true)) {
-            filename = filenameParts.at(filenameParts.count() - 2);
-        }
-    } else if (filename.endsWith("index.bdmv", Qt::CaseInsensitive)) {
-        if (filenameParts.count() > 2) {
-            filename = filenameParts.at(filenameParts.count() - 3);
+    // Remaining shows that were not published in a batch, if any.
+    onUpdatedShowsLoaded(job);
+
+    for (const mediaelch::DirectoryPath& removed : job->removedShows()) {
+        for (TvShow* show : Manager::instance()->tvShowModel()->tvShows()) {
+            if (QDir::cleanPath(show->dir().toString()) == QDir::cleanPath(removed.toString())) {
+                Manager::instance()->tvShowModel()->removeShow(show);
+                m_notifyUpdate = true;
+                break;
+            }
         }
     }
 
-    QRegularExpression rx(R"(S(\d+)[ ._-]?E)", QRegularExpression::CaseInsensitiveOption);
-    QRegularExpressionMatch match;
+    job->deleteLater();
+    m_updateStore->deleteLater();
+    m_updateJob = nullptr;
+    m_updateStore = nullptr;
 
-    match = rx.match(filename);
-    if (match.hasMatch()) {
-        return SeasonNumber(match.captured(1).toInt());
+    if (m_notifyUpdate) {
+        emit tvShowsLoaded();
     }
+    startNextUpdate();
+}
 
-    rx.setPattern("(\\d+)?x(\\d+)");
-    match = rx.match(filename);
-    if (match.hasMatch()) {
-        return SeasonNumber(match.captured(1).toInt());
+void TvShowFileSearcher::discardUpdates()
+{
+    m_updateQueue.clear();
+    if (m_updateJob != nullptr) {
+        discardJob(m_updateJob, m_updateStore);
+        m_updateJob = nullptr;
+        m_updateStore = nullptr;
     }
+}
 
-    rx.setPattern("(\\d+).(\\d){2,4}");
-    match = rx.match(filename);
-    if (match.hasMatch()) {
-        return SeasonNumber(match.captured(1).toInt());
+mediaelch::DirectoryPath TvShowFileSearcher::libraryDirectory(const mediaelch::DirectoryPath& showDir) const
+{
+    elch_size_t index = -1;
+    for (elch_size_t i = 0, n = m_directories.count(); i < n; ++i) {
+        if (showDir.toString().startsWith(m_directories[i].path.path())) {
+            if (index == -1 || m_directories[index].path.path().length() < m_directories[i].path.path().length()) {
+                index = i;
+            }
+        }
     }
-
-    rx.setPattern("Season[ ._]?(\\d+)[ ._]?Episode");
-    match = rx.match(filename);
-    if (match.hasMatch()) {
-        return SeasonNumber(match.captured(1).toInt());
+    if (index == -1) {
+        return {};
     }
-
-    // Default if no valid season could be parsed.
-    return SeasonNumber::SpecialsSeason;
+    return mediaelch::DirectoryPath(m_directories[index].path);
 }
 
-QVector<EpisodeNumber> TvShowFileSearcher::getEpisodeNumbers(QStringList files)
+TvShowEpisode* TvShowFileSearcher::reloadEpisodeData(TvShowEpisode* episode)
 {
-    if (files.isEmpty()) {
-        return {};
-    }
+    episode->loadData(Manager::instance()->mediaCenterInterfaceTvShow(), true, true);
+    return episode;
+}
 
-    QStringList filenameParts = files.at(0).split('/');
-    QString filename = filenameParts.last();
-    if (filename.endsWith("VIDEO_TS.IFO", Qt::CaseInsensitive)) {
-        if (filenameParts.count() > 1 && helper::isDvd(files.at(0))) {
-            filename = filenameParts.at(filenameParts.count() - 3);
-        } else if (filenameParts.count() > 2 && helper::isDvd(files.at(0), true)) {
-            filename = filenameParts.at(filenameParts.count() - 2);
-        }
-    } else if (filename.endsWith("index.bdmv", Qt::CaseInsensitive)) {
-        if (filenameParts.count() > 2) {
-            filename = filenameParts.at(filenameParts.count() - 3);
-        }
+void TvShowFileSearcher::abort()
+{
+    m_aborted = true;
+    if (m_loader != nullptr) {
+        discardJob(m_loader, m_loaderStore);
+        m_loader = nullptr;
+        m_loaderStore = nullptr;
     }
+    discardUpdates();
+}
 
+SeasonNumber TvShowFileSearcher::getSeasonNumber(QStringList files)
+{
+    return mediaelch::parseSeasonAndEpisodeNumbers(files).season;
+}
 
-    QVector<EpisodeNumber> episodes;
-
-    /// Scans a given filename for a given pattern.
-    /// If mayBeAmbiguous is true, we apply a heuristic to avoid matching the video's resolution
-    auto scanWithPattern = [&](const QString& pattern, bool mayBeAmbiguous) -> bool {
-        QRegularExpression rx(pattern, QRegularExpression::CaseInsensitiveOption);
-
-        QRegularExpressionMatchIterator matches = rx.globalMatch(filename);
-
-        elch_size_t lastMatchEnd = -1;
-        while (matches.hasNext()) {
-            QRegularExpressionMatch match = matches.next();
-            // if between the last match and this one are more than five characters: break
-            // this way we can try to filter "false matches" like in "21x04 - Hammond vs. 6x6.mp4"
-            if (mayBeAmbiguous && lastMatchEnd != -1 && lastMatchEnd < match.capturedStart(0) + 5) {
-                return true;
-            }
-            episodes << EpisodeNumber(match.captured(2).toInt());
-            lastMatchEnd = match.capturedEnd(0);
-        }
-
-        // Pattern matched
-        if (episodes.isEmpty()) {
-            return false;
-        }
-
-        // The one episode we found could actually be a multi-episode file.
-        // For example: S01E01E02
-        if (episodes.count() == 1) {
-            rx.setPattern(R"([-_EeXx]+([0-9]+)($|[\-\._\sE]))");
-
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-            matches = rx.globalMatch(
-                filename, lastMatchEnd, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
-#else
-            matches = rx.globalMatch(
-                filename, lastMatchEnd, QRegularExpression::NormalMatch, QRegularExpression::AnchorAtOffsetMatchOption);
-#endif
-
-            while (matches.hasNext()) {
-                episodes << EpisodeNumber(matches.next().captured(1).toInt());
-            }
-        }
-        return true;
-    };
-
-    struct EpisodeNumberPattern
-    {
-        QString regex;
-        bool mayBeAmbiguous = false;
-    };
-
-    QVector<EpisodeNumberPattern> patterns{{R"(S(\d+)[ ._-]?E(\d+))", false},
-        {R"(S(\d+)[ ._-]?EP(\d+))", false},
-        {R"(Season[ ._-]?(\d+)[._ -]?Episode[ ._-]?(\d+))", false},
-        {R"((\d+)x(\d+))", true},
-        {R"((\d+).(\d){2,4})", true}};
-
-    for (const auto& pattern : patterns) {
-        if (scanWithPattern(pattern.regex, pattern.mayBeAmbiguous)) {
-            break;
-        }
-    }
-
-    return episodes;
+QVector<EpisodeNumber> TvShowFileSearcher::getEpisodeNumbers(QStringList files)
+{
+    return mediaelch::parseSeasonAndEpisodeNumbers(files).episodes;
 }
 
 Database& TvShowFileSearcher::database()
@@ -444,162 +371,43 @@ void TvShowFileSearcher::clearOldTvShows(bool forceClear)
     // clear gui
     Manager::instance()->tvShowModel()->clear();
 
-    if (forceClear) {
+    // Incremental scans remove outdated shows themselves, see TvShowLoader.
+    const bool incremental = Settings::instance()->advanced()->incrementalTvShowScan();
+    if (forceClear && !incremental) {
         // Simply delete all shows
         database().clearAllTvShows();
         return;
     }
+    if (forceClear) {
+        // TvShowLoader only knows the current directories.  Entries of library
+        // directories that are no longer loaded would be kept forever.
+        clearRemovedDirectories();
+    }
 
     for (const SettingsDir& dir : asConst(m_directories)) {
-        if (dir.autoReload || dir.disabled) {
+        if ((dir.autoReload && !incremental) || dir.disabled) {
             database().clearTvShowsInDirectory(mediaelch::DirectoryPath(dir.path));
         }
     }
 }
 
-void TvShowFileSearcher::setupShowsFromDatabase(QVector<TvShow*>& dbShows, int episodeCounter, int episodeSum)
+void TvShowFileSearcher::clearRemovedDirectories()
 {
-    for (TvShow* show : dbShows) {
-        if (m_aborted) {
-            return;
-        }
-
-        show->loadData(Manager::instance()->mediaCenterInterfaceTvShow(), false);
-
-        QVector<TvShowEpisode*> episodes = database().episodes(show->databaseId());
-        QtConcurrent::blockingMapped(episodes, TvShowFileSearcher::loadEpisodeData);
-        for (TvShowEpisode* episode : episodes) {
-            if (episode == nullptr) {
-                continue;
-            }
-            episode->setShow(show);
-            show->addEpisode(episode);
-            emit progress(++episodeCounter, episodeSum, m_progressMessageId);
-            if (episodeCounter % 1000 == 0) {
-                emit currentDir("");
-            }
-        }
-
-        Manager::instance()->tvShowModel()->appendShow(show);
-    }
-}
-
-void TvShowFileSearcher::setupShows(QMap<QString, QVector<QStringList>>& contents, int& episodeCounter, int episodeSum)
-{
-    QMapIterator<QString, QVector<QStringList>> it(contents);
-    while (it.hasNext()) {
-        it.next();
-        episodeSum += qsizetype_to_int(it.value().size());
-    }
-    it.toFront();
-
-    // Setup shows
-    while (it.hasNext()) {
-        if (m_aborted) {
-            return;
-        }
-
-        it.next();
-
-        // get path
-        mediaelch::DirectoryPath path;
-        elch_size_t index = -1;
-        for (elch_size_t i = 0, n = m_directories.count(); i < n; ++i) {
-            if (it.key().startsWith(m_directories[i].path.path())) {
-                if (index == -1) {
-                    index = i;
-                } else if (m_directories[index].path.path().length() < m_directories[i].path.path().length()) {
-                    index = i;
-                }
-            }
-        }
-        if (index != -1) {
-            path = mediaelch::DirectoryPath(m_directories[index].path);
-        }
-
-        auto* show = new TvShow(mediaelch::DirectoryPath(it.key()), this);
-        show->loadData(Manager::instance()->mediaCenterInterfaceTvShow());
-        emit currentDir(show->title());
-        database().add(show, path);
-
-        database().transaction();
-        QVector<TvShowEpisode*> episodes;
-
-        // Setup episodes list
-        for (const QStringList& files : it.value()) {
-            SeasonNumber seasonNumber = getSeasonNumber(files);
-            QVector<EpisodeNumber> episodeNumbers = getEpisodeNumbers(files);
-            for (const EpisodeNumber& episodeNumber : episodeNumbers) {
-                auto* episode = new TvShowEpisode(files, show);
-                episode->setSeason(seasonNumber);
-                episode->setEpisode(episodeNumber);
-                episodes.append(episode);
-            }
-        }
-
-        // Load episodes data
-        QtConcurrent::blockingMapped(episodes, TvShowFileSearcher::reloadEpisodeData);
-
-        // Add episodes to model
-        for (TvShowEpisode* episode : asConst(episodes)) {
-            database().add(episode, path, show->databaseId());
-            show->addEpisode(episode);
-            emit progress(++episodeCounter, episodeSum, m_progressMessageId);
-        }
-
-        database().commit();
-        Manager::instance()->tvShowModel()->appendShow(show);
-    }
-
-    emit currentDir("");
-}
-
-QMap<QString, QVector<QStringList>> TvShowFileSearcher::readTvShowContent(bool forceReload)
-{
-    QMap<QString, QVector<QStringList>> contents;
+    QVector<mediaelch::DirectoryPath> libraryPaths;
     for (const SettingsDir& dir : asConst(m_directories)) {
-        if (m_aborted) {
-            break;
-        }
-        if (dir.disabled) {
-            continue;
-        }
-        // Do we need to reload shows from disk?
-        if (dir.autoReload || forceReload) {
-            getTvShows(mediaelch::DirectoryPath(dir.path), contents);
-            continue;
-        }
-        // TODO: Check if necessary?
-        // If there are no shows in the database for the directory, reload
-        // all shows regardless of forceReload.
-        const int showsFromDatabase = database().showCount(mediaelch::DirectoryPath(dir.path));
-        if (showsFromDatabase == 0) {
-            getTvShows(mediaelch::DirectoryPath(dir.path), contents);
-            continue;
+        if (!dir.disabled) {
+            libraryPaths.append(mediaelch::DirectoryPath(dir.path));
         }
     }
-    return contents;
-}
-
 
-QVector<TvShow*> TvShowFileSearcher::getShowsFromDatabase(bool forceReload)
-{
-    if (forceReload) {
-        return {};
-    }
-
-    QVector<TvShow*> dbShows;
-    for (const SettingsDir& dir : asConst(m_directories)) {
-        if (dir.autoReload) { // Those directories are not read from database.
-            continue;
-        }
-        if (dir.disabled) {
-            continue;
-        }
-        QVector<TvShow*> showsFromDatabase = database().showsInDirectory(mediaelch::DirectoryPath(dir.path));
-        if (!showsFromDatabase.isEmpty()) {
-            dbShows.append(showsFromDatabase);
+    const QVector<mediaelch::DirectoryPath> storedPaths = database().tvShowLibraryPaths();
+    database().transaction();
+    for (const mediaelch::DirectoryPath& path : storedPaths) {
+        if (!libraryPaths.contains(path)) {
+            qCDebug(generic) << "[TvShowFileSearcher] Removing cached shows of old directory:" << path;
+            database().clearTvShowsInDirectory(path);
+            database().setTvShowDirectoryFingerprints(path, {});
         }
     }
-    return dbShows;
+    database().commit();
 }
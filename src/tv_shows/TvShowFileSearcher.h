@@ -2,11 +2,15 @@
 
 #include "file/Path.h"
 #include "tv_shows/TvShowEpisode.h"
+#include "tv_shows/TvShowLoader.h"
 
 #include <QDir>
 #include <QObject>
+#include <QQueue>
+#include <QSet>
 
 class Database;
+class TvShow;
 
 class TvShowFileSearcher : public QObject
 {
@@ -20,8 +24,19 @@ public:
     static TvShowEpisode* reloadEpisodeData(TvShowEpisode* episode);
 
 public slots:
+    /// \brief   Reload all TV shows in a background thread.
+    /// \details Shows are added to the TvShowModel while they are loaded.
+    ///          tvShowsLoaded() is emitted once all shows are loaded.
     void reload(bool force);
+    /// \brief   Reload the given show and its episodes from disk in a background thread.
+    /// \details tvShowsLoaded() is emitted once the show is loaded.
     void reloadEpisodes(const mediaelch::DirectoryPath& showDir);
+    /// \brief   Update TV shows after the given directories of a TV show directory changed on disk.
+    /// \details Shows whose episode files changed and new shows are loaded in a background thread.
+    ///          Shows whose directory no longer exists are removed.  Changes to other files,
+    ///          e.g. NFO files or images saved by MediaElch, are ignored.  tvShowsLoaded() is
+    ///          only emitted if shows were loaded or removed.
+    void updateShows(const mediaelch::DirectoryPath& tvShowDir, const QStringList& directories);
     void abort();
 
 signals:
@@ -30,23 +45,51 @@ signals:
     void tvShowsLoaded();
     void currentDir(QString);
 
+private slots:
+    void onShowsLoaded(mediaelch::TvShowLoader* job);
+    void onLoaderFinished(mediaelch::TvShowLoader* job);
+    void onUpdatedShowsLoaded(mediaelch::TvShowLoader* job);
+    void onUpdateJobFinished(mediaelch::TvShowLoader* job);
+
 private:
     QVector<SettingsDir> m_directories;
     int m_progressMessageId;
-    void getTvShows(const mediaelch::DirectoryPath& path, QMap<QString, QVector<QStringList>>& contents);
-    void scanTvShowDir(const mediaelch::DirectoryPath& startPath,
-        const mediaelch::DirectoryPath& path,
-        QVector<QStringList>& contents);
-    QStringList getFiles(const mediaelch::DirectoryPath& path);
     bool m_aborted;
 
+    /// \brief Currently running loader of reload(), if any.
+    mediaelch::TvShowLoader* m_loader = nullptr;
+    mediaelch::TvShowLoaderStore* m_loaderStore = nullptr;
+
+    /// \brief Shows that are updated, see updateShows() and reloadEpisodes().
+    struct ShowUpdate
+    {
+        mediaelch::TvShowUpdate update;
+        /// \brief Shows of reloadEpisodes().  They are reloaded even if their episode files did not change.
+        QSet<QString> reloadedShows;
+    };
+    /// \brief Updates run one after another, so that each one knows the shows of
+    ///        all previous ones.
+    QQueue<ShowUpdate> m_updateQueue;
+    mediaelch::TvShowLoader* m_updateJob = nullptr;
+    mediaelch::TvShowLoaderStore* m_updateStore = nullptr;
+    /// \brief Whether the running update emits tvShowsLoaded() once it has finished.
+    bool m_notifyUpdate = false;
+
 private:
     Database& database();
+    /// \brief The TV show directory that contains the given show directory.
+    mediaelch::DirectoryPath libraryDirectory(const mediaelch::DirectoryPath& showDir) const;
 
     void clearOldTvShows(bool forceClear);
-    /// \brief Get a map of TV show paths and their respective files in the show folder.
-    QMap<QString, QVector<QStringList>> readTvShowContent(bool forceReload);
-    QVector<TvShow*> getShowsFromDatabase(bool forceReload);
-    void setupShows(QMap<QString, QVector<QStringList>>& contents, int& episodeCounter, int episodeSum);
-    void setupShowsFromDatabase(QVector<TvShow*>& dbShows, int episodeCounter, int episodeSum);
+    /// \brief Remove cached shows and fingerprints of directories that are no longer (enabled) TV show directories.
+    /// \details Only required in incremental mode, otherwise all shows are removed anyway.
+    void clearRemovedDirectories();
+    /// \brief Queue the update and start it if no other update is running.
+    void enqueueUpdate(ShowUpdate update);
+    /// \brief Start the next queued update, if any.
+    void startNextUpdate();
+    /// \brief Abort the queued and running updates.
+    void discardUpdates();
+    /// \brief Abort the given loader and delete it and its store once it has finished.
+    void discardJob(mediaelch::TvShowLoader* job, mediaelch::TvShowLoaderStore* store);
 };
@@ -0,0 +1,730 @@
+#include "tv_shows/TvShowLoader.h"
+
+#include "data/Database.h"
+#include "file/DirectoryWalker.h"
+#include "globals/Helper.h"
+#include "globals/Manager.h"
+#include "log/Log.h"
+#include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
+#include "tv_shows/TvShowFileSearcher.h"
+#include "tv_shows/TvShowUtils.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QPair>
+#include <QRegularExpression>
+#include <QtConcurrent/QtConcurrentMap>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// \brief Loaded shows are published as soon as this many shows are available...
+constexpr int SHOW_BATCH_SIZE = 20;
+/// \brief ...or after this many milliseconds, whichever comes first.
+constexpr qint64 SHOW_BATCH_INTERVAL_MS = 200;
+
+/// \brief Normalized absolute path of a directory; used as key for fingerprints.
+QString normalizedDirectory(const QString& dir)
+{
+    return QDir::cleanPath(QFileInfo(dir).absoluteFilePath());
+}
+
+/// \brief Whether the file of a TV show directory belongs to an episode.  Files must match
+///        AdvancedSettings::tvShowFilters() as well.
+bool isEpisodeFile(const QString& fileName, const AdvancedSettings& advanced)
+{
+    if (advanced.isFileExcluded(fileName)) {
+        return false;
+    }
+    // Skip Trailers and Sample files
+    return !fileName.contains("-trailer", Qt::CaseInsensitive) && !fileName.contains("-sample", Qt::CaseInsensitive);
+}
+
+/// \brief Number of episode files directly inside the directory, same as
+///        DirectoryFingerprint::entryCount of TvShowLoader::scanShowDirectory().
+int countEpisodeFiles(const QString& dir, const AdvancedSettings& advanced)
+{
+    const mediaelch::FileFilter& filter = advanced.tvShowFilters();
+    if (!filter.hasFilter()) {
+        return 0;
+    }
+    int count = 0;
+    QDirIterator it(dir, filter.filters(), QDir::Files | QDir::System);
+    while (it.hasNext()) {
+        it.next();
+        if (isEpisodeFile(it.fileName(), advanced)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/// \brief Group the given files of one directory into episodes, e.g. multi-part files.
+void addEpisodeFiles(const QString& path,
+    QStringList files,
+    QVector<QStringList>& contents,
+    const std::function<bool()>& isAborted)
+{
+    files.sort();
+
+    QRegularExpression rx("((?:part|cd)[\\s_]*)(\\d+)", QRegularExpression::CaseInsensitiveOption);
+    for (elch_size_t i = 0, n = files.size(); i < n; i++) {
+        if (isAborted()) {
+            return;
+        }
+
+        QStringList tvShowFiles;
+        QString file = files.at(i);
+        if (file.isEmpty()) {
+            continue;
+        }
+
+        tvShowFiles << (path + '/' + file);
+
+        QRegularExpressionMatch match = rx.match(file);
+        elch_size_t pos = match.capturedStart(0);
+        if (pos != -1) {
+            QString left = file.left(pos) + match.captured(1);
+            QString right = file.mid(pos + match.captured(1).size() + match.captured(2).size());
+            for (int x = 0; x < n; x++) {
+                QString subFile = files.at(x);
+                if (subFile != file) {
+                    if (subFile.startsWith(left) && subFile.endsWith(right)) {
+                        tvShowFiles << (path + '/' + subFile);
+                        files[x] = ""; // set an empty file name, this way we can skip this file in the main loop
+                    }
+                }
+            }
+        }
+        if (tvShowFiles.count() > 0) {
+            contents.append(tvShowFiles);
+        }
+    }
+}
+
+} // namespace
+
+namespace mediaelch {
+
+void TvShowLoaderStore::addShows(const QVector<TvShow*>& shows)
+{
+    for (TvShow* show : shows) {
+        // Episodes are children of their show, i.e. they are moved as well.
+        show->setParent(nullptr);
+        show->moveToThread(thread());
+        show->setParent(this);
+    }
+
+    QMutexLocker locker(&m_lock);
+    m_shows.append(shows);
+}
+
+QVector<TvShow*> TvShowLoaderStore::takeAll(QObject* parent)
+{
+    QMutexLocker locker(&m_lock);
+    QVector<TvShow*> shows = std::move(m_shows);
+    m_shows = {};
+    locker.unlock();
+
+    for (TvShow* show : asConst(shows)) {
+        show->setParent(parent);
+    }
+    return shows;
+}
+
+void TvShowLoaderStore::clear()
+{
+    QMutexLocker locker(&m_lock);
+    qDeleteAll(m_shows);
+    m_shows.clear();
+}
+
+TvShowLoader::TvShowLoader(QVector<SettingsDir> directories,
+    bool forceReload,
+    TvShowLoaderStore& store,
+    QObject* parent) :
+    QObject(parent), m_directories{std::move(directories)}, m_forceReload{forceReload}, m_store{&store}
+{
+}
+
+TvShowLoader::~TvShowLoader()
+{
+    qDeleteAll(m_reusedShows);
+    m_reusedShows.clear();
+    qDeleteAll(m_shows);
+    m_shows.clear();
+}
+
+void TvShowLoader::start()
+{
+    qCInfo(generic) << "[TvShowLoader] Loading TV shows, reload from disk:" << m_forceReload
+                    << "| incremental:" << m_incremental << "| update:" << m_isUpdate;
+
+    // Database connections must be used by the thread that created them.
+    std::unique_ptr<Database> db(Database::newConnection(nullptr));
+    m_db = db.get();
+
+    emit progress(this, 0, 0);
+    emit progressText(this, "");
+
+    QMap<QString, QVector<QStringList>> contents = m_isUpdate ? readUpdatedShowContent() : readTvShowContent();
+    if (isAborted()) {
+        m_db = nullptr;
+        emit finished(this);
+        return;
+    }
+
+    emit progressText(this, "");
+    emit directoriesScanned(this);
+
+    m_processed = 0;
+    // Updates don't load shows from the database.
+    m_total = m_isUpdate ? 0 : m_db->episodeCount();
+    for (const QVector<QStringList>& showContents : asConst(contents)) {
+        m_total += qsizetype_to_int(showContents.size());
+    }
+    emit progress(this, m_processed, m_total);
+
+    m_batchTimer.start();
+    QVector<TvShow*> dbShows = m_isUpdate ? QVector<TvShow*>{} : getShowsFromDatabase();
+    setupShows(contents);
+    setupShowsFromDatabase(dbShows);
+
+    publishShows();
+    m_db = nullptr;
+
+    qCDebug(generic) << "[TvShowLoader] Loading TV shows done";
+    emit progressText(this, "");
+    emit finished(this);
+}
+
+void TvShowLoader::setUpdate(TvShowUpdate update)
+{
+    m_isUpdate = true;
+    m_update = std::move(update);
+}
+
+void TvShowLoader::abort()
+{
+    m_aborted.store(true);
+}
+
+void TvShowLoader::scanShowDirectory(const DirectoryPath& startPath,
+    const DirectoryPath& path,
+    QVector<QStringList>& contents,
+    const std::function<bool()>& isAborted,
+    const std::function<void(const QString&)>& onDirectory,
+    QHash<QString, DirectoryFingerprint>* fingerprints)
+{
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
+
+    const auto shouldEnter = [&](const QFileInfo& dir) {
+        if (isAborted()) {
+            return false;
+        }
+
+        const QString cDir = dir.fileName();
+        if (advanced->isFolderExcluded(cDir)) {
+            return false;
+        }
+
+        // Skip "Extras" folder
+        if (QString::compare(cDir, "Extras", Qt::CaseInsensitive) == 0
+            || QString::compare(cDir, ".actors", Qt::CaseInsensitive) == 0
+            || QString::compare(cDir, "extrafanarts", Qt::CaseInsensitive) == 0) {
+            return false;
+        }
+
+        // Handle DVD
+        if (helper::isDvd(dir.filePath())) {
+            contents.append(QStringList() << (dir.filePath() + "/VIDEO_TS/VIDEO_TS.IFO"));
+            return false;
+        }
+        if (helper::isDvd(dir.filePath(), true)) {
+            contents.append(QStringList() << (dir.filePath() + "/VIDEO_TS.IFO"));
+            return false;
+        }
+
+        // Handle BluRay
+        if (helper::isBluRay(dir.filePath())) {
+            contents.append(QStringList() << (dir.filePath() + "/BDMV/index.bdmv"));
+            return false;
+        }
+        return true;
+    };
+
+    DirectoryWalker walker(advanced->tvShowFilters(), shouldEnter);
+    walker.setIncludeSystemFiles(true);
+    walker.walk(path.toString(), [&](const QFileInfo& dir, const QFileInfoList& entries) {
+        if (isAborted()) {
+            return false;
+        }
+        const QString dirPath = dir.filePath();
+        onDirectory(dirPath.mid(startPath.toString().length()));
+
+        QStringList files;
+        for (const QFileInfo& entry : entries) {
+            if (isEpisodeFile(entry.fileName(), *advanced)) {
+                files.append(entry.fileName());
+            }
+        }
+        if (fingerprints != nullptr) {
+            DirectoryFingerprint fingerprint;
+            fingerprint.lastModified = dir.lastModified().toMSecsSinceEpoch();
+            fingerprint.entryCount = qsizetype_to_int(files.size());
+            fingerprints->insert(normalizedDirectory(dirPath), fingerprint);
+        }
+        addEpisodeFiles(dirPath, files, contents, isAborted);
+        return !isAborted();
+    });
+}
+
+QMap<QString, QVector<QStringList>> TvShowLoader::readTvShowContent()
+{
+    QMap<QString, QVector<QStringList>> contents;
+    for (const SettingsDir& dir : asConst(m_directories)) {
+        if (isAborted()) {
+            break;
+        }
+        if (dir.disabled) {
+            continue;
+        }
+        // Do we need to reload shows from disk?
+        // If there are no shows in the database for the directory, reload
+        // all shows regardless of forceReload.
+        if (dir.autoReload || m_forceReload || m_db->showCount(DirectoryPath(dir.path)) == 0) {
+            if (m_incremental) {
+                getChangedTvShows(DirectoryPath(dir.path), contents);
+            } else {
+                getTvShows(DirectoryPath(dir.path), contents);
+            }
+        }
+    }
+    return contents;
+}
+
+/**
+ * \brief Scans a dir for TV show files
+ * \param path Directory to scan
+ */
+void TvShowLoader::getTvShows(const DirectoryPath& path, QMap<QString, QVector<QStringList>>& contents)
+{
+    QDir dir(path.toString());
+    QStringList tvShows = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& cDir : tvShows) {
+        if (isAborted()) {
+            return;
+        }
+
+        if (Settings::instance()->advanced()->isFolderExcluded(cDir)) {
+            continue;
+        }
+
+        QVector<QStringList> tvShowContents;
+        scanShowDirectory(
+            path,
+            path.subDir(cDir),
+            tvShowContents,
+            [this]() { return isAborted(); },
+            [this](const QString& directory) { emit progressText(this, directory); });
+        contents.insert((dir.path() + '/' + cDir), tvShowContents);
+    }
+}
+
+void TvShowLoader::getChangedTvShows(const DirectoryPath& path, QMap<QString, QVector<QStringList>>& contents)
+{
+    const QHash<QString, DirectoryFingerprint> storedFingerprints = m_db->tvShowDirectoryFingerprints(path);
+    if (storedFingerprints.isEmpty()) {
+        // First incremental scan: Shows in the database can't be checked and are replaced.
+        m_db->clearTvShowsInDirectory(path);
+    }
+
+    QDir dir(path.toString());
+    QString libraryPrefix = normalizedDirectory(path.toString());
+    if (!libraryPrefix.endsWith('/')) {
+        libraryPrefix += '/';
+    }
+
+    // Group the stored fingerprints by show directory, which is the first directory below the library.
+    QHash<QString, QVector<QPair<QString, DirectoryFingerprint>>> storedByShow;
+    for (auto it = storedFingerprints.cbegin(); it != storedFingerprints.cend(); ++it) {
+        if (it.key().startsWith(libraryPrefix)) {
+            const QString showDir = libraryPrefix + it.key().mid(libraryPrefix.length()).section('/', 0, 0);
+            storedByShow[showDir].append(qMakePair(it.key(), it.value()));
+        }
+    }
+
+    QHash<QString, TvShow*> cachedShows;
+    if (!storedFingerprints.isEmpty()) {
+        // Shows are moved to the GUI thread by the store, i.e. they must not have a parent.
+        for (TvShow* show : m_db->showsInDirectory(path, nullptr)) {
+            cachedShows.insert(normalizedDirectory(show->dir().toString()), show);
+        }
+    }
+
+    // A show is unchanged if neither its directory nor one of its subdirectories
+    // was modified.  This only requires a stat() and a listing per directory, but
+    // no episodes and NFO files are loaded.
+    const AdvancedSettings* advanced = Settings::instance()->advanced();
+    const auto isUnchanged = [&storedByShow, advanced](const QString& showDir) {
+        const auto stored = storedByShow.constFind(showDir);
+        if (stored == storedByShow.constEnd()) {
+            return false;
+        }
+        bool hasShowDirectory = false;
+        for (const auto& entry : stored.value()) {
+            if (!entry.second.isValid()
+                || DirectoryFingerprint::fromDirectory(entry.first, entry.second.entryCount) != entry.second) {
+                return false;
+            }
+            // The modification time may be unchanged, e.g. if files were copied including
+            // their timestamps or if the file system's resolution is too coarse.
+            if (countEpisodeFiles(entry.first, *advanced) != entry.second.entryCount) {
+                return false;
+            }
+            hasShowDirectory = hasShowDirectory || entry.first == showDir;
+        }
+        return hasShowDirectory;
+    };
+
+    QHash<QString, DirectoryFingerprint> fingerprints;
+    int reused = 0;
+    int scanned = 0;
+    const QStringList tvShows = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString& cDir : tvShows) {
+        if (isAborted()) {
+            break;
+        }
+
+        if (Settings::instance()->advanced()->isFolderExcluded(cDir)) {
+            continue;
+        }
+
+        const QString showDir = dir.path() + '/' + cDir;
+        const QString showKey = normalizedDirectory(showDir);
+        TvShow* cachedShow = cachedShows.take(showKey);
+        if (cachedShow != nullptr && isUnchanged(showKey)) {
+            for (const auto& entry : storedByShow.value(showKey)) {
+                fingerprints.insert(entry.first, entry.second);
+            }
+            m_reusedShows.append(cachedShow);
+            ++reused;
+            continue;
+        }
+        if (cachedShow != nullptr) {
+            m_db->clearTvShowInDirectory(cachedShow->dir());
+            delete cachedShow;
+        }
+
+        QVector<QStringList> tvShowContents;
+        scanShowDirectory(
+            path,
+            path.subDir(cDir),
+            tvShowContents,
+            [this]() { return isAborted(); },
+            [this](const QString& directory) { emit progressText(this, directory); },
+            &fingerprints);
+        contents.insert(showDir, tvShowContents);
+        ++scanned;
+    }
+
+    // Remaining shows were removed from disk (or the scan was aborted).
+    for (TvShow* show : asConst(cachedShows)) {
+        if (!isAborted()) {
+            m_db->clearTvShowInDirectory(show->dir());
+        }
+        delete show;
+    }
+
+    if (!isAborted()) {
+        m_db->setTvShowDirectoryFingerprints(path, fingerprints);
+        qCInfo(generic) << "[TvShowLoader] Incremental scan of" << path.toString() << "| reused shows:" << reused
+                        << "| scanned shows:" << scanned;
+    }
+}
+
+QMap<QString, QVector<QStringList>> TvShowLoader::readUpdatedShowContent()
+{
+    QMap<QString, QVector<QStringList>> contents;
+    QSet<QString> showDirs = m_update.showDirs;
+
+    if (m_update.scanLibrary) {
+        // Shows may have been added or removed.
+        const QString rootPath = QDir::cleanPath(m_update.libraryPath.toString());
+        const QStringList tvShows = QDir(rootPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString& cDir : tvShows) {
+            if (!Settings::instance()->advanced()->isFolderExcluded(cDir)) {
+                showDirs.insert(rootPath + '/' + cDir);
+            }
+        }
+        for (auto it = m_update.loadedFiles.cbegin(); it != m_update.loadedFiles.cend(); ++it) {
+            if (!QFileInfo(it.key()).isDir()) {
+                qCInfo(generic) << "[TvShowLoader] Removing show whose directory was removed:" << it.key();
+                m_db->clearTvShowInDirectory(DirectoryPath(it.key()));
+                m_removedShows.append(DirectoryPath(it.key()));
+            }
+        }
+    }
+
+    for (const QString& showDir : asConst(showDirs)) {
+        if (isAborted()) {
+            break;
+        }
+        if (!QFileInfo(showDir).isDir()) {
+            continue;
+        }
+
+        QVector<QStringList> tvShowContents;
+        scanShowDirectory(
+            m_update.libraryPath,
+            DirectoryPath(showDir),
+            tvShowContents,
+            [this]() { return isAborted(); },
+            [this](const QString& directory) { emit progressText(this, directory); });
+
+        const auto loaded = m_update.loadedFiles.constFind(showDir);
+        if (loaded != m_update.loadedFiles.constEnd()) {
+            QSet<QString> filesOnDisk;
+            for (const QStringList& files : asConst(tvShowContents)) {
+                for (const QString& file : files) {
+                    filesOnDisk.insert(QFileInfo(file).absoluteFilePath());
+                }
+            }
+            if (filesOnDisk == loaded.value()) {
+                continue;
+            }
+        }
+
+        qCInfo(generic) << "[TvShowLoader] Reloading changed show:" << showDir;
+        m_db->clearTvShowInDirectory(DirectoryPath(showDir));
+        contents.insert(showDir, tvShowContents);
+    }
+    return contents;
+}
+
+QVector<TvShow*> TvShowLoader::getShowsFromDatabase()
+{
+    // Unchanged shows of an incremental scan
+    QVector<TvShow*> dbShows = std::move(m_reusedShows);
+    m_reusedShows = {};
+
+    if (m_forceReload) {
+        return dbShows;
+    }
+
+    for (const SettingsDir& dir : asConst(m_directories)) {
+        if (dir.autoReload) { // Those directories are not read from database.
+            continue;
+        }
+        if (dir.disabled) {
+            continue;
+        }
+        // Shows are moved to the GUI thread by the store, i.e. they must not have a parent.
+        QVector<TvShow*> showsFromDatabase = m_db->showsInDirectory(DirectoryPath(dir.path), nullptr);
+        if (!showsFromDatabase.isEmpty()) {
+            dbShows.append(showsFromDatabase);
+        }
+    }
+    return dbShows;
+}
+
+void TvShowLoader::setupShows(const QMap<QString, QVector<QStringList>>& contents)
+{
+    // Shows and episodes are created in this thread, but their NFO files are parsed
+    // in parallel.  Each show or episode is one task, so that both many small shows
+    // and single large shows use all threads.  As soon as a show and all of its
+    // episodes are loaded, this thread stores it in the database (in batches).
+    std::vector<std::unique_ptr<PendingShow>> pendingShows;
+    QVector<LoadTask> tasks;
+    for (auto it = contents.cbegin(); it != contents.cend(); ++it) {
+        auto pending = std::make_unique<PendingShow>();
+        pending->show = new TvShow(DirectoryPath(it.key()), nullptr);
+        pending->libraryPath = libraryDirectory(it.key());
+        pending->fileCount = qsizetype_to_int(it.value().size());
+
+        for (const QStringList& files : it.value()) {
+            const SeasonAndEpisodeNumbers numbers = parseSeasonAndEpisodeNumbers(files);
+            for (const EpisodeNumber& episodeNumber : numbers.episodes) {
+                auto* episode = new TvShowEpisode(files, pending->show);
+                episode->setSeason(numbers.season);
+                episode->setEpisode(episodeNumber);
+                pending->episodes.append(episode);
+            }
+        }
+
+        pending->remainingTasks.store(qsizetype_to_int(pending->episodes.size()) + 1);
+        tasks.append({pending.get(), nullptr});
+        for (TvShowEpisode* episode : asConst(pending->episodes)) {
+            tasks.append({pending.get(), episode});
+        }
+        pendingShows.push_back(std::move(pending));
+    }
+
+    loadPendingShows(tasks);
+}
+
+void TvShowLoader::loadPendingShows(QVector<LoadTask>& tasks)
+{
+    QFuture<void> future = QtConcurrent::map(tasks, [this](const LoadTask& task) { runLoadTask(task); });
+    while (!future.isFinished()) {
+        QMutexLocker lock(&m_mutex);
+        if (m_loadedShows.size() < SHOW_BATCH_SIZE && !future.isFinished()) {
+            m_showsReady.wait(&m_mutex, SHOW_BATCH_INTERVAL_MS);
+        }
+        lock.unlock();
+        storeLoadedShows();
+    }
+    future.waitForFinished();
+    storeLoadedShows();
+
+    if (isAborted()) {
+        // Shows that were not stored are not used anymore.
+        for (PendingShow* pending : asConst(m_loadedShows)) {
+            delete pending->show;
+        }
+    }
+    m_loadedShows.clear();
+
+    emit progressText(this, "");
+}
+
+void TvShowLoader::runLoadTask(const LoadTask& task)
+{
+    // Note: This method is called in parallel!
+    if (!isAborted()) {
+        if (task.episode == nullptr) {
+            task.show->show->loadData(Manager::instance()->mediaCenterInterfaceTvShow(), !task.show->fromDatabase);
+        } else if (task.show->fromDatabase) {
+            TvShowFileSearcher::loadEpisodeData(task.episode);
+        } else {
+            TvShowFileSearcher::reloadEpisodeData(task.episode);
+        }
+    }
+
+    // The last task of a show hands it over to the database writer, even if aborted.
+    if (task.show->remainingTasks.fetch_sub(1) == 1) {
+        QMutexLocker lock(&m_mutex);
+        m_loadedShows.append(task.show);
+        if (m_loadedShows.size() >= SHOW_BATCH_SIZE) {
+            m_showsReady.wakeOne();
+        }
+    }
+}
+
+void TvShowLoader::storeLoadedShows()
+{
+    if (isAborted()) {
+        return;
+    }
+
+    QMutexLocker lock(&m_mutex);
+    QVector<PendingShow*> loadedShows = std::move(m_loadedShows);
+    m_loadedShows = {};
+    lock.unlock();
+
+    if (loadedShows.isEmpty()) {
+        return;
+    }
+
+    m_db->transaction();
+    for (PendingShow* pending : asConst(loadedShows)) {
+        TvShow* show = pending->show;
+        if (!pending->fromDatabase) {
+            m_db->add(show, pending->libraryPath);
+            m_db->add(pending->episodes, pending->libraryPath, show->databaseId());
+        }
+        // Only now: Loading episodes may change their season/episode number.
+        for (TvShowEpisode* episode : asConst(pending->episodes)) {
+            if (pending->fromDatabase) {
+                episode->setShow(show);
+            }
+            show->addEpisode(episode);
+        }
+        m_processed += pending->fileCount;
+    }
+    m_db->commit();
+
+    emit progressText(this, loadedShows.last()->show->title());
+    emit progress(this, m_processed, m_total);
+    for (PendingShow* pending : asConst(loadedShows)) {
+        addShow(pending->show);
+    }
+}
+
+void TvShowLoader::setupShowsFromDatabase(QVector<TvShow*>& dbShows)
+{
+    // Like setupShows(): Episodes are read from the database in this thread, because
+    // the connection belongs to it, but NFO files of all shows are loaded in parallel.
+    std::vector<std::unique_ptr<PendingShow>> pendingShows;
+    QVector<LoadTask> tasks;
+    for (elch_size_t i = 0; i < dbShows.size(); ++i) {
+        if (isAborted()) {
+            // Shows that are already pending are deleted by loadPendingShows().
+            qDeleteAll(dbShows.mid(i));
+            break;
+        }
+
+        auto pending = std::make_unique<PendingShow>();
+        pending->show = dbShows.at(i);
+        pending->fromDatabase = true;
+        for (TvShowEpisode* episode : m_db->episodes(pending->show->databaseId())) {
+            // Deleted together with the show; assigned to it once loaded, see storeLoadedShows().
+            episode->setParent(pending->show);
+            pending->episodes.append(episode);
+        }
+        pending->fileCount = qsizetype_to_int(pending->episodes.size());
+
+        pending->remainingTasks.store(pending->fileCount + 1);
+        tasks.append({pending.get(), nullptr});
+        for (TvShowEpisode* episode : asConst(pending->episodes)) {
+            tasks.append({pending.get(), episode});
+        }
+        pendingShows.push_back(std::move(pending));
+    }
+    dbShows.clear();
+
+    loadPendingShows(tasks);
+}
+
+DirectoryPath TvShowLoader::libraryDirectory(const QString& showDir) const
+{
+    elch_size_t index = -1;
+    for (elch_size_t i = 0, n = m_directories.count(); i < n; ++i) {
+        if (showDir.startsWith(m_directories[i].path.path())) {
+            if (index == -1) {
+                index = i;
+            } else if (m_directories[index].path.path().length() < m_directories[i].path.path().length()) {
+                index = i;
+            }
+        }
+    }
+    if (index == -1) {
+        return {};
+    }
+    return DirectoryPath(m_directories[index].path);
+}
+
+void TvShowLoader::addShow(TvShow* show)
+{
+    m_shows.append(show);
+    if (m_shows.size() >= SHOW_BATCH_SIZE || m_batchTimer.elapsed() >= SHOW_BATCH_INTERVAL_MS) {
+        publishShows();
+    }
+}
+
+void TvShowLoader::publishShows()
+{
+    m_batchTimer.restart();
+    if (m_shows.isEmpty() || isAborted()) {
+        return;
+    }
+    m_store->addShows(m_shows);
+    m_shows.clear();
+    emit showsLoaded(this);
+}
+
+} // namespace mediaelch
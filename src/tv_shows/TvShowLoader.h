@@ -0,0 +1,197 @@
+#pragma once
+
+#include "file/DirectoryFingerprint.h"
+#include "file/Path.h"
+#include "globals/Globals.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+
+class Database;
+class TvShow;
+class TvShowEpisode;
+
+namespace mediaelch {
+
+/// \brief   Thread safe store for TV shows.
+/// \details The TvShowLoader moves its newly created shows into a store.
+class TvShowLoaderStore : public QObject
+{
+    Q_OBJECT
+public:
+    explicit TvShowLoaderStore(QObject* parent = nullptr) : QObject(parent) {}
+    ~TvShowLoaderStore() override = default;
+
+    void addShows(const QVector<TvShow*>& shows);
+
+    QVector<TvShow*> takeAll(QObject* parent);
+    /// \brief Clear and delete all stored shows.
+    void clear();
+
+private:
+    QVector<TvShow*> m_shows;
+    QMutex m_lock;
+};
+
+/// \brief Shows of a TV show directory that are updated instead of loading all shows.
+/// \see TvShowLoader::setUpdate()
+struct TvShowUpdate
+{
+    /// \brief TV show directory that contains the shows.
+    DirectoryPath libraryPath;
+    /// \brief Show directories that are loaded if their episode files changed.
+    QSet<QString> showDirs;
+    /// \brief   If true, all show directories of the library are checked.
+    /// \details New shows are loaded and shows whose directory no longer exists are removed.
+    bool scanLibrary = false;
+    /// \brief   Episode files of already loaded shows by their directory.
+    /// \details Shows that are not contained are always loaded.
+    QHash<QString, QSet<QString>> loadedFiles;
+};
+
+/// \brief   Loads all TV shows and their episodes of the given TV show directories.
+/// \details Shows of directories that are reloaded are read from disk and stored in
+///          the database.  Shows of all other directories are read from the database.
+///          The loader is meant to run in its own thread, see
+///          runInLoaderThread().  Loaded shows are published in
+///          batches using the TvShowLoaderStore.
+class TvShowLoader : public QObject
+{
+    Q_OBJECT
+public:
+    TvShowLoader(QVector<SettingsDir> directories,
+        bool forceReload,
+        TvShowLoaderStore& store,
+        QObject* parent = nullptr);
+    ~TvShowLoader() override;
+
+    /// \brief   Only rescan shows whose directories were modified since the last scan.
+    /// \details All other shows are loaded from the database.  Must be called before start().
+    void setIncrementalScan(bool incremental) { m_incremental = incremental; }
+    /// \brief   Only load the shows of the given update whose episode files changed.
+    /// \details Changed shows are replaced in the database.  No other shows are loaded.
+    ///          Must be called before start().
+    void setUpdate(TvShowUpdate update);
+    /// \brief Shows of the update that were removed from the database.  Valid once finished.
+    const QVector<DirectoryPath>& removedShows() const { return m_removedShows; }
+
+    void start();
+    /// \brief   Thread-safe way to abort the TvShowLoader.
+    /// \details The finished() signal is still emitted.
+    void abort();
+    /// \brief Thread-safe way to check whether the TvShowLoader was aborted.
+    bool isAborted() const { return m_aborted.load(); }
+
+    /// \brief Scans the given path for TV show files.
+    /// Results are in a list which contains a QStringList for every episode.
+    /// \param startPath Scanning started at this path
+    /// \param path Path to scan
+    /// \param contents List of contents
+    /// \param isAborted Scanning stops as soon as this function returns true.
+    /// \param onDirectory Called for each scanned directory with its path relative to startPath.
+    /// \param fingerprints If set, the fingerprint of each scanned directory is inserted.
+    static void scanShowDirectory(const DirectoryPath& startPath,
+        const DirectoryPath& path,
+        QVector<QStringList>& contents,
+        const std::function<bool()>& isAborted,
+        const std::function<void(const QString&)>& onDirectory,
+        QHash<QString, DirectoryFingerprint>* fingerprints = nullptr);
+
+signals:
+    void progress(mediaelch::TvShowLoader* job, int processed, int total);
+    /// \brief   A string representing the current loading state.
+    /// \details For example the currently scanned directory or the loaded show.
+    void progressText(mediaelch::TvShowLoader* job, QString text);
+    /// \brief All directories were scanned; shows and episodes are loaded now.
+    void directoriesScanned(mediaelch::TvShowLoader* job);
+    /// \brief   New shows were added to the TvShowLoaderStore.
+    /// \details Shows are published in batches while the loader is still running.
+    void showsLoaded(mediaelch::TvShowLoader* job);
+    void finished(mediaelch::TvShowLoader* job);
+
+private:
+    /// \brief A show whose show and episode NFO files are loaded in parallel.
+    struct PendingShow
+    {
+        TvShow* show = nullptr;
+        QVector<TvShowEpisode*> episodes;
+        DirectoryPath libraryPath;
+        /// \brief Whether the show was read from the database, i.e. it is not stored again.
+        bool fromDatabase = false;
+        /// \brief Number of episode file lists (or episodes of database shows), used for the progress.
+        int fileCount = 0;
+        /// \brief Show and episodes that are not loaded, yet.
+        std::atomic_int remainingTasks{0};
+    };
+    /// \brief Load the show's data if episode is a nullptr, otherwise the episode's data.
+    struct LoadTask
+    {
+        PendingShow* show = nullptr;
+        TvShowEpisode* episode = nullptr;
+    };
+
+    /// \brief Get a map of TV show paths and their respective files in the show folder.
+    QMap<QString, QVector<QStringList>> readTvShowContent();
+    void getTvShows(const DirectoryPath& path, QMap<QString, QVector<QStringList>>& contents);
+    /// \brief   Like getTvShows() but only scans shows whose directories have changed.
+    /// \details Unchanged shows are read from the database and moved into m_reusedShows.
+    void getChangedTvShows(const DirectoryPath& path, QMap<QString, QVector<QStringList>>& contents);
+    /// \brief Like readTvShowContent() but only for changed shows of m_update.
+    QMap<QString, QVector<QStringList>> readUpdatedShowContent();
+    QVector<TvShow*> getShowsFromDatabase();
+    void setupShows(const QMap<QString, QVector<QStringList>>& contents);
+    void setupShowsFromDatabase(QVector<TvShow*>& dbShows);
+    /// \brief Run the tasks on the thread pool and store loaded shows in batches until all are done.
+    void loadPendingShows(QVector<LoadTask>& tasks);
+    /// \brief Runs on the thread pool.  Hands the show over to storeLoadedShows() once all of its tasks are done.
+    void runLoadTask(const LoadTask& task);
+    /// \brief Store all completely loaded shows in the database (unless read from it) and publish them.
+    void storeLoadedShows();
+    /// \brief The TV show directory that contains the given show directory.
+    DirectoryPath libraryDirectory(const QString& showDir) const;
+
+    /// \brief Add the show to the current batch and publish the batch if it is large enough.
+    void addShow(TvShow* show);
+    /// \brief Move all shows of the current batch into the store.  Emits showsLoaded().
+    void publishShows();
+
+private:
+    QVector<SettingsDir> m_directories;
+    bool m_forceReload = false;
+    bool m_incremental = false;
+    bool m_isUpdate = false;
+    TvShowUpdate m_update;
+    QVector<DirectoryPath> m_removedShows;
+    TvShowLoaderStore* m_store = nullptr;
+    /// \brief Connection of the loader's thread; only valid while start() runs.
+    Database* m_db = nullptr;
+    std::atomic_bool m_aborted{false};
+
+    int m_processed = 0;
+    int m_total = 0;
+
+    /// \brief Shows of scanned directories that were not changed, see getChangedTvShows().
+    QVector<TvShow*> m_reusedShows;
+    /// \brief Shows that are not yet published.
+    QVector<TvShow*> m_shows;
+
+    QMutex m_mutex;
+    /// \brief Signaled if enough shows for a new batch were loaded.
+    QWaitCondition m_showsReady;
+    /// \brief Shows whose show and episode data is loaded, but that are not stored, yet.
+    QVector<PendingShow*> m_loadedShows;
+    QElapsedTimer m_batchTimer;
+};
+
+} // namespace mediaelch
@@ -1,7 +1,11 @@
 #include "tv_shows/TvShowModel.h"
 
+#include <QHash>
 #include <QPainter>
+#include <QPair>
+#include <QSet>
 #include <QtGui>
+#include <algorithm>
 
 #include "data/MediaStatusColumn.h"
 #include "globals/Globals.h"
@@ -12,6 +16,20 @@
 #include "tv_shows/model/SeasonModelItem.h"
 #include "tv_shows/model/TvShowModelItem.h"
 
+namespace {
+
+/// \brief Whether all and whether any of the season row's episodes are dummies.
+///        Both are shown by season rows, see TvShowModel::data().
+QPair<bool, bool> seasonDummyState(const SeasonModelItem& seasonItem)
+{
+    const QList<EpisodeModelItem*>& episodes = seasonItem.episodes();
+    const auto isDummy = [](const EpisodeModelItem* item) { return item->tvShowEpisode()->isDummy(); };
+    return qMakePair(std::all_of(episodes.cbegin(), episodes.cend(), isDummy),
+        std::any_of(episodes.cbegin(), episodes.cend(), isDummy));
+}
+
+} // namespace
+
 TvShowModel::TvShowModel(QObject* parent) :
     QAbstractItemModel(parent),
     m_newIcon{QIcon(":/img/star_blue.png")},
@@ -267,14 +285,108 @@ bool TvShowModel::removeShow(TvShow* show)
 
 bool TvShowModel::updateShow(TvShow* show)
 {
-    TvShowModelItem* showModel = findModelForShow(show);
-    if (showModel == nullptr) {
+    TvShowModelItem* showItem = findModelForShow(show);
+    if (showItem == nullptr) {
         return false;
     }
 
-    /// \todo Only remove seasons and re-add them. Or better: in-depth merge.
-    removeRow(showModel->indexInParent(), QModelIndex{});
-    appendShow(show);
+    const QModelIndex showIndex = index(showItem->indexInParent(), 0);
+
+    // Seasons and their episodes as they should be shown; same order as in appendShow().
+    QVector<SeasonNumber> seasonOrder;
+    QHash<SeasonNumber, QVector<TvShowEpisode*>> seasonEpisodes;
+    for (TvShowEpisode* episode : show->episodes()) {
+        const SeasonNumber season = episode->seasonNumber();
+        if (!seasonEpisodes.contains(season)) {
+            seasonOrder.append(season);
+        }
+        seasonEpisodes[season].append(episode);
+    }
+
+    // Remove seasons that no longer exist and episodes that are no longer part of their season.
+    // Iterate backwards so that row numbers of not yet visited items stay valid.
+    QHash<SeasonNumber, SeasonModelItem*> seasonItems;
+    QHash<SeasonNumber, QPair<bool, bool>> dummyStates;
+    for (int seasonRow = showItem->childCount() - 1; seasonRow >= 0; --seasonRow) {
+        SeasonModelItem* seasonItem = showItem->seasonAtIndex(seasonRow);
+        const auto wantedEpisodes = seasonEpisodes.constFind(seasonItem->seasonNumber());
+        if (wantedEpisodes == seasonEpisodes.cend() || seasonItems.contains(seasonItem->seasonNumber())) {
+            removeRows(seasonRow, 1, showIndex);
+            continue;
+        }
+        seasonItems.insert(seasonItem->seasonNumber(), seasonItem);
+        dummyStates.insert(seasonItem->seasonNumber(), seasonDummyState(*seasonItem));
+
+        const QModelIndex seasonIndex = index(seasonRow, 0, showIndex);
+        QSet<const TvShowEpisode*> episodes;
+        for (const TvShowEpisode* episode : *wantedEpisodes) {
+            episodes.insert(episode);
+        }
+        // Remove consecutive episodes with a single call.
+        int last = seasonItem->childCount() - 1;
+        while (last >= 0) {
+            if (episodes.contains(seasonItem->episodeAtIndex(last)->tvShowEpisode())) {
+                --last;
+                continue;
+            }
+            int first = last;
+            while (first > 0 && !episodes.contains(seasonItem->episodeAtIndex(first - 1)->tvShowEpisode())) {
+                --first;
+            }
+            removeRows(first, last - first + 1, seasonIndex);
+            last = first - 1;
+        }
+    }
+
+    // Append new seasons and new episodes of existing seasons.
+    for (const SeasonNumber& season : seasonOrder) {
+        const QVector<TvShowEpisode*>& episodes = seasonEpisodes[season];
+        SeasonModelItem* seasonItem = seasonItems.value(season, nullptr);
+
+        if (seasonItem == nullptr) {
+            const int seasonRow = showItem->childCount();
+            beginInsertRows(showIndex, seasonRow, seasonRow);
+            seasonItem = showItem->appendSeason(season, episodes.first()->seasonString(), show);
+            for (TvShowEpisode* episode : episodes) {
+                seasonItem->appendEpisode(episode);
+            }
+            endInsertRows();
+            continue;
+        }
+
+        QSet<const TvShowEpisode*> existingEpisodes;
+        for (const EpisodeModelItem* episodeItem : seasonItem->episodes()) {
+            existingEpisodes.insert(episodeItem->tvShowEpisode());
+        }
+        QVector<TvShowEpisode*> newEpisodes;
+        for (TvShowEpisode* episode : episodes) {
+            if (!existingEpisodes.contains(episode)) {
+                newEpisodes.append(episode);
+            }
+        }
+        if (newEpisodes.isEmpty()) {
+            continue;
+        }
+
+        const int episodeRow = seasonItem->childCount();
+        const QModelIndex seasonIndex = index(seasonItem->indexInParent(), 0, showIndex);
+        beginInsertRows(seasonIndex, episodeRow, episodeRow + qsizetype_to_int(newEpisodes.size()) - 1);
+        for (TvShowEpisode* episode : newEpisodes) {
+            seasonItem->appendEpisode(episode);
+        }
+        endInsertRows();
+    }
+
+    // Existing seasons may have become (or are no longer) dummy seasons.
+    for (auto it = seasonItems.cbegin(); it != seasonItems.cend(); ++it) {
+        if (seasonDummyState(*it.value()) != dummyStates.value(it.key())) {
+            const int seasonRow = it.value()->indexInParent();
+            emit dataChanged(index(seasonRow, 0, showIndex), index(seasonRow, columnCount() - 1, showIndex));
+        }
+    }
+
+    // Episode count and missing episode state of the show may have changed.
+    emit dataChanged(showIndex, index(showIndex.row(), columnCount() - 1));
     return true;
 }
 
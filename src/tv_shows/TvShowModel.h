@@ -35,8 +35,9 @@ public:
     /// Remove a show from the TreeView
     /// \return true if the show was found and removed, false otherwise
     bool removeShow(TvShow* show);
-    /// Update a show, i.e. remove it and add it again.
-    /// \todo Maybe add more specific functions like adding a season, etc.
+    /// Update the seasons and episodes of a show. Only seasons and episodes that were
+    /// added or removed are inserted into or removed from the tree view; the show
+    /// itself and all unchanged rows are kept.
     /// \return true if the show was found and updated, false otherwise
     bool updateShow(TvShow* show);
 
@@ -2,15 +2,16 @@
 
 #include "data/Storage.h"
 #include "globals/Globals.h"
-#include "globals/Helper.h"
 #include "globals/Manager.h"
 #include "globals/MessageIds.h"
 #include "log/Log.h"
 #include "scrapers/tv_show/tmdb/TmdbTv.h"
+#include "settings/Settings.h"
+#include "tv_shows/EpisodeGuideRefresher.h"
 #include "tv_shows/TvShow.h"
 #include "ui/notifications/NotificationBox.h"
 
-#include <QBuffer>
+#include <memory>
 
 using namespace mediaelch;
 
@@ -30,51 +31,73 @@ TvShowUpdater* TvShowUpdater::instance(QObject* parent)
 
 void TvShowUpdater::updateShow(TvShow* show, bool force)
 {
-    using namespace mediaelch;
     if (!show->tmdbId().isValid() || (m_updatedShows.contains(show) && !force)) {
         return;
     }
 
     m_updatedShows.append(show);
+    // Explicitly requested, e.g. because missing episodes were just enabled: ignore the refresh interval.
+    refreshEpisodeGuides({show}, 0);
+}
 
-    auto* box = NotificationBox::instance();
-    const int value = box->value(Constants::TvShowUpdaterProgressMessageId);
-    const int maxValue = box->maxValue(Constants::TvShowUpdaterProgressMessageId);
-    box->progressBarProgress(value, maxValue + 1, Constants::TvShowUpdaterProgressMessageId);
-    box->showProgressBar(tr("Updating TV Shows"), Constants::TvShowUpdaterProgressMessageId, true);
-
-    Locale locale = Settings::instance()->scraperSettings(scraper::TmdbTv::ID)->language(m_tmdb->meta().defaultLocale);
-    scraper::ShowIdentifier id(show->tmdbId());
-    scraper::SeasonScrapeJob::Config config{id, locale, {}, SeasonOrder::Aired, m_tmdb->meta().supportedEpisodeDetails};
-    auto* scrapeJob = m_tmdb->loadSeasons(config);
+void TvShowUpdater::updateShows(const QVector<TvShow*>& shows)
+{
+    QVector<TvShow*> showsToUpdate;
+    for (TvShow* show : shows) {
+        if (show->tmdbId().isValid() && !m_updatedShows.contains(show)) {
+            showsToUpdate.append(show);
+            m_updatedShows.append(show);
+        }
+    }
+    if (!showsToUpdate.isEmpty()) {
+        refreshEpisodeGuides(showsToUpdate, Settings::instance()->advanced()->episodeGuideRefreshInterval());
+    }
+}
 
-    // Fill database with missing episodes.
-    connect(scrapeJob, &scraper::SeasonScrapeJob::sigFinished, this, [show, box](scraper::SeasonScrapeJob* job) {
-        job->deleteLater();
-        box->hideProgressBar(Constants::TvShowUpdaterProgressMessageId);
-        show->clearMissingEpisodes();
+void TvShowUpdater::refreshEpisodeGuides(const QVector<TvShow*>& shows, int maxAgeHours)
+{
+    if (m_tmdb == nullptr) {
+        return;
+    }
 
-        const auto& scrapedEpisodes = job->episodes();
+    EpisodeGuideRefresher::Config config;
+    config.maxAgeHours = maxAgeHours;
+    config.maxConcurrentRequests = Settings::instance()->advanced()->concurrentEpisodeGuideRequests();
+    auto* refresher = new EpisodeGuideRefresher(m_tmdb, Manager::instance()->database(), config, this);
 
-        for (TvShowEpisode* episode : scrapedEpisodes) {
-            // Map according to advanced settings
-            const QString network = helper::mapStudio(episode->network());
-            const Certification certification = helper::mapCertification(episode->certification());
+    // All running refreshers share one progress bar.
+    ++m_runningRefreshers;
+    m_progressMax += qsizetype_to_int(shows.size());
+    updateProgressBar();
 
-            episode->setNetwork(network);
-            episode->setCertification(certification);
+    auto lastProcessed = std::make_shared<int>(0);
+    connect(refresher, &EpisodeGuideRefresher::progress, this, [this, lastProcessed](int processed, int /*total*/) {
+        m_progressValue += processed - *lastProcessed;
+        *lastProcessed = processed;
+        updateProgressBar();
+    });
+    connect(refresher, &EpisodeGuideRefresher::showRefreshed, this, [](TvShow* show) {
+        if (show->showMissingEpisodes()) {
+            show->clearMissingEpisodes();
+            show->fillMissingEpisodes();
         }
-
-        // Store in database
-        Database* const database = Manager::instance()->database();
-        const int showsSettingsId = database->showsSettingsId(show);
-        database->clearEpisodeList(showsSettingsId);
-        for (auto* episode : scrapedEpisodes) {
-            database->addEpisodeToShowList(episode, showsSettingsId, episode->tmdbId());
+    });
+    connect(refresher, &EpisodeGuideRefresher::finished, this, [this, refresher]() {
+        refresher->deleteLater();
+        --m_runningRefreshers;
+        if (m_runningRefreshers == 0) {
+            m_progressValue = 0;
+            m_progressMax = 0;
+            NotificationBox::instance()->hideProgressBar(Constants::TvShowUpdaterProgressMessageId);
         }
-        database->cleanUpEpisodeList(showsSettingsId);
-
-        show->fillMissingEpisodes();
     });
-    scrapeJob->start();
+
+    refresher->refresh(shows);
+}
+
+void TvShowUpdater::updateProgressBar()
+{
+    auto* box = NotificationBox::instance();
+    box->showProgressBar(tr("Updating TV Shows"), Constants::TvShowUpdaterProgressMessageId, true);
+    box->progressBarProgress(m_progressValue, m_progressMax, Constants::TvShowUpdaterProgressMessageId);
 }
@@ -12,7 +12,7 @@ class TmdbTv;
 } // namespace mediaelch
 
 /// \brief   Updates all TvShows, e.g. downloads missing episodes.
-/// \details The TVShowUpdater uses TMDb to load missing episodes.
+/// \details The TVShowUpdater uses TMDb to load missing episodes, see EpisodeGuideRefresher.
 ///          The TvShowUpdate requires TvShows to have a valid TMDb ID.
 class TvShowUpdater : public QObject
 {
@@ -21,8 +21,18 @@ public:
     explicit TvShowUpdater(QObject* parent = nullptr);
     static TvShowUpdater* instance(QObject* parent = nullptr);
     void updateShow(TvShow* show, bool force = false);
+    /// \brief Update all given shows that were not updated, yet.  Shows whose episodes were
+    ///        loaded within AdvancedSettings::episodeGuideRefreshInterval() are skipped.
+    void updateShows(const QVector<TvShow*>& shows);
+
+private:
+    void refreshEpisodeGuides(const QVector<TvShow*>& shows, int maxAgeHours);
+    void updateProgressBar();
 
 private:
     mediaelch::scraper::TmdbTv* m_tmdb;
     QVector<TvShow*> m_updatedShows;
+    int m_runningRefreshers = 0;
+    int m_progressValue = 0;
+    int m_progressMax = 0;
 };
@@ -2,6 +2,142 @@
 
 #include "globals/Helper.h"
 
+#include <QRegularExpression>
+
+namespace {
+
+/// \brief The name that contains season and episode numbers, i.e. the file name
+///        or the directory name for DVDs and BluRays.
+QString episodeFileName(const QStringList& files)
+{
+    QStringList filenameParts = files.at(0).split('/');
+    QString filename = filenameParts.last();
+    if (filename.endsWith("VIDEO_TS.IFO", Qt::CaseInsensitive)) {
+        if (filenameParts.count() > 1 && helper::isDvd(files.at(0))) {
+            filename = filenameParts.at(filenameParts.count() - 3);
+        } else if (filenameParts.count() > 2 && helper::isDvd(files.at(0), true)) {
+            filename = filenameParts.at(filenameParts.count() - 2);
+        }
+    } else if (filename.endsWith("index.bdmv", Qt::CaseInsensitive)) {
+        if (filenameParts.count() > 2) {
+            filename = filenameParts.at(filenameParts.count() - 3);
+        }
+    }
+    return filename;
+}
+
+QRegularExpression compilePattern(const QString& pattern)
+{
+    QRegularExpression rx(pattern, QRegularExpression::CaseInsensitiveOption);
+    rx.optimize();
+    return rx;
+}
+
+struct EpisodeNumberPattern
+{
+    QRegularExpression regex;
+    /// \brief If true, we apply a heuristic to avoid matching the video's resolution.
+    bool mayBeAmbiguous = false;
+};
+
+/// \brief Season patterns in the order they are tried.  Compiled once.
+const QVector<QRegularExpression>& seasonPatterns()
+{
+    static const QVector<QRegularExpression> patterns{
+        compilePattern(R"(S(\d+)[ ._-]?E)"),
+        compilePattern(R"((\d+)?x(\d+))"),
+        compilePattern(R"((\d+).(\d){2,4})"),
+        compilePattern(R"(Season[ ._]?(\d+)[ ._]?Episode)"),
+    };
+    return patterns;
+}
+
+/// \brief Episode patterns in the order they are tried.  Compiled once.
+const QVector<EpisodeNumberPattern>& episodePatterns()
+{
+    static const QVector<EpisodeNumberPattern> patterns{
+        {compilePattern(R"(S(\d+)[ ._-]?E(\d+))"), false},
+        {compilePattern(R"(S(\d+)[ ._-]?EP(\d+))"), false},
+        {compilePattern(R"(Season[ ._-]?(\d+)[._ -]?Episode[ ._-]?(\d+))"), false},
+        {compilePattern(R"((\d+)x(\d+))"), true},
+        {compilePattern(R"((\d+).(\d){2,4})"), true},
+    };
+    return patterns;
+}
+
+/// \brief Additional episodes of a multi-episode file, e.g. "E02" in "S01E01E02".
+const QRegularExpression& multiEpisodePattern()
+{
+    static const QRegularExpression pattern = compilePattern(R"([-_EeXx]+([0-9]+)($|[\-\._\sE]))");
+    return pattern;
+}
+
+SeasonNumber parseSeasonNumber(const QString& filename)
+{
+    for (const QRegularExpression& rx : seasonPatterns()) {
+        QRegularExpressionMatch match = rx.match(filename);
+        if (match.hasMatch()) {
+            return SeasonNumber(match.captured(1).toInt());
+        }
+    }
+    // Default if no valid season could be parsed.
+    return SeasonNumber::SpecialsSeason;
+}
+
+/// Scans a given filename for a given pattern.
+/// \returns true if the pattern matched; episodes are appended to \p episodes.
+bool scanWithPattern(const QString& filename, const EpisodeNumberPattern& pattern, QVector<EpisodeNumber>& episodes)
+{
+    QRegularExpressionMatchIterator matches = pattern.regex.globalMatch(filename);
+
+    elch_size_t lastMatchEnd = -1;
+    while (matches.hasNext()) {
+        QRegularExpressionMatch match = matches.next();
+        // if between the last match and this one are more than five characters: break
+        // this way we can try to filter "false matches" like in "21x04 - Hammond vs. 6x6.mp4"
+        if (pattern.mayBeAmbiguous && lastMatchEnd != -1 && lastMatchEnd < match.capturedStart(0) + 5) {
+            return true;
+        }
+        episodes << EpisodeNumber(match.captured(2).toInt());
+        lastMatchEnd = match.capturedEnd(0);
+    }
+
+    // Pattern matched
+    if (episodes.isEmpty()) {
+        return false;
+    }
+
+    // The one episode we found could actually be a multi-episode file.
+    // For example: S01E01E02
+    if (episodes.count() == 1) {
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+        matches = multiEpisodePattern().globalMatch(
+            filename, lastMatchEnd, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+#else
+        matches = multiEpisodePattern().globalMatch(
+            filename, lastMatchEnd, QRegularExpression::NormalMatch, QRegularExpression::AnchorAtOffsetMatchOption);
+#endif
+
+        while (matches.hasNext()) {
+            episodes << EpisodeNumber(matches.next().captured(1).toInt());
+        }
+    }
+    return true;
+}
+
+QVector<EpisodeNumber> parseEpisodeNumbers(const QString& filename)
+{
+    QVector<EpisodeNumber> episodes;
+    for (const EpisodeNumberPattern& pattern : episodePatterns()) {
+        if (scanWithPattern(filename, pattern, episodes)) {
+            break;
+        }
+    }
+    return episodes;
+}
+
+} // namespace
+
 namespace mediaelch {
 
 QString guessTvShowTitleFromFiles(const FileList& files)
@@ -30,4 +166,17 @@ QString guessTvShowTitleFromFiles(const FileList& files)
     return filename.trimmed();
 }
 
+SeasonAndEpisodeNumbers parseSeasonAndEpisodeNumbers(const QStringList& files)
+{
+    SeasonAndEpisodeNumbers numbers;
+    if (files.isEmpty()) {
+        return numbers;
+    }
+
+    const QString filename = episodeFileName(files);
+    numbers.season = parseSeasonNumber(filename);
+    numbers.episodes = parseEpisodeNumbers(filename);
+    return numbers;
+}
+
 } // namespace mediaelch
@@ -1,11 +1,31 @@
 #pragma once
 
 #include "file/Path.h"
+#include "tv_shows/EpisodeNumber.h"
+#include "tv_shows/SeasonNumber.h"
 
 #include <QString>
+#include <QStringList>
+#include <QVector>
 
 namespace mediaelch {
 
 QString guessTvShowTitleFromFiles(const FileList& files);
 
-}
+/// \brief Season and episode numbers of an episode file, see parseSeasonAndEpisodeNumbers().
+struct SeasonAndEpisodeNumbers
+{
+    SeasonNumber season = SeasonNumber::NoSeason;
+    /// \brief Episode numbers, may contain multiple episodes, e.g. for "S01E01E02".
+    QVector<EpisodeNumber> episodes;
+};
+
+/// \brief   Parse the season and episode numbers of the given episode files.
+/// \details Only the first file is used.  For DVDs and BluRays, the directory name
+///          is parsed instead.  If no season can be parsed, the specials season is
+///          returned.  If the list of files is empty, NoSeason and no episodes are
+///          returned.  All patterns are compiled only once, i.e. this function is
+///          cheap enough to be called for each episode of a library.
+SeasonAndEpisodeNumbers parseSeasonAndEpisodeNumbers(const QStringList& files);
+
+} // namespace mediaelch
@@ -8,7 +8,7 @@
 #include "renamer/RenamerDialog.h"
 #include "scrapers/movie/custom/CustomMovieScraper.h"
 #include "settings/Settings.h"
-#include "tv_shows/TvShowFileSearcher.h"
+#include "tv_shows/TvShowUtils.h"
 #include "tv_shows/model/SeasonModelItem.h"
 #include "tv_shows/model/TvShowModelItem.h"
 #include "ui/notifications/Notificator.h"
@@ -324,10 +324,10 @@ void ImportDialog::onTvShowChosen()
     ui->formLayout->setEnabled(false);
 
     m_episode = new TvShowEpisode(files(), m_show);
-    m_episode->setSeason(TvShowFileSearcher::getSeasonNumber(files()));
-    QVector<EpisodeNumber> episodes = TvShowFileSearcher::getEpisodeNumbers(files());
-    if (!episodes.isEmpty()) {
-        m_episode->setEpisode(episodes.first());
+    const mediaelch::SeasonAndEpisodeNumbers numbers = mediaelch::parseSeasonAndEpisodeNumbers(files());
+    m_episode->setSeason(numbers.season);
+    if (!numbers.episodes.isEmpty()) {
+        m_episode->setEpisode(numbers.episodes.first());
     }
 
     connect(m_episode.data(), &TvShowEpisode::sigLoaded, this, &ImportDialog::onEpisodeLoadDone, Qt::UniqueConnection);
@@ -689,7 +689,6 @@ void ImportDialog::onMovingFilesFinished()
             // We now always refresh the show unless there are missing episode
             // in which case the fillMissingEpisodes() updates the model.
             Manager::instance()->tvShowModel()->updateShow(m_show);
-            TvShowFilesWidget::instance().renewModel(true);
         }
 
         m_episode = nullptr;
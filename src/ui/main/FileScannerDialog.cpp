@@ -2,6 +2,7 @@
 #include "globals/Manager.h"
 #include "ui_FileScannerDialog.h"
 
+#include <QMenu>
 #include <QTimer>
 
 #include "data/ImageCache.h"
@@ -50,7 +51,11 @@ FileScannerDialog::FileScannerDialog(QWidget* parent) : QDialog(parent), ui(new
     connect(manager->musicFileSearcher(),   &MusicFileSearcher::searchStarted,   ui->status, &QLabel::setText);
     // clang-format on
 
+    // Signals of background updates (see LibraryUpdater) must not affect this dialog.
     connect(manager->movieFileSearcher(), &MovieFileSearcher::finished, this, [this]() {
+        if (!isVisible()) {
+            return;
+        }
         if (m_reloadType != ReloadType::All) {
             accept();
         } else {
@@ -58,6 +63,9 @@ FileScannerDialog::FileScannerDialog(QWidget* parent) : QDialog(parent), ui(new
         }
     });
     connect(manager->tvShowFileSearcher(), &TvShowFileSearcher::tvShowsLoaded, this, [this]() {
+        if (!isVisible()) {
+            return;
+        }
         if (m_reloadType != ReloadType::All) {
             accept();
         } else {
@@ -65,6 +73,9 @@ FileScannerDialog::FileScannerDialog(QWidget* parent) : QDialog(parent), ui(new
         }
     });
     connect(manager->concertFileSearcher(), &ConcertFileSearcher::concertsLoaded, this, [this]() {
+        if (!isVisible()) {
+            return;
+        }
         if (m_reloadType != ReloadType::All) {
             accept();
         } else {
@@ -72,6 +83,25 @@ FileScannerDialog::FileScannerDialog(QWidget* parent) : QDialog(parent), ui(new
         }
     });
     connect(manager->musicFileSearcher(), &MusicFileSearcher::musicLoaded, this, &FileScannerDialog::accept);
+
+    connect(this, &QDialog::finished, manager->libraryUpdater(), &mediaelch::LibraryUpdater::resume);
+
+    // Movie directories are loaded concurrently; each one can be skipped, e.g. a slow network share.
+    auto* skipMenu = new QMenu(ui->skipDirectory);
+    ui->skipDirectory->setMenu(skipMenu);
+    ui->skipDirectory->setVisible(false);
+    connect(skipMenu, &QMenu::aboutToShow, this, [skipMenu]() {
+        skipMenu->clear();
+        const QVector<DirectoryPath> directories = Manager::instance()->movieFileSearcher()->loadingDirectories();
+        for (const DirectoryPath& directory : directories) {
+            skipMenu->addAction(directory.toNativePathString(), [directory]() {
+                Manager::instance()->movieFileSearcher()->abortDirectory(directory);
+            });
+        }
+    });
+    connect(manager->movieFileSearcher(), &MovieFileSearcher::finished, this, [this]() {
+        ui->skipDirectory->setVisible(false);
+    });
 }
 
 /**
@@ -88,6 +118,8 @@ int FileScannerDialog::exec()
     auto* manager = Manager::instance();
     const auto& dirSettings = Settings::instance()->directorySettings();
 
+    manager->libraryUpdater()->pause();
+
     if (m_reloadType == ReloadType::All || m_reloadType == ReloadType::Movies) {
         manager->movieFileSearcher()->setMovieDirectories(dirSettings.movieDirectories());
     }
@@ -104,6 +136,7 @@ int FileScannerDialog::exec()
     ui->status->setText("");
     ui->progressBar->setValue(0);
     ui->currentDir->setText("");
+    ui->skipDirectory->setVisible(false);
     QDialog::show();
     adjustSize();
 
@@ -171,6 +204,7 @@ void FileScannerDialog::reject()
 void FileScannerDialog::onStartMovieScanner()
 {
     ui->progressBar->setValue(0);
+    ui->skipDirectory->setVisible(Settings::instance()->directorySettings().movieDirectories().size() > 1);
     if (m_forceReload) {
         QTimer::singleShot(0, this, &FileScannerDialog::onStartMovieScannerForce);
     } else {
@@ -221,6 +221,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), ui(new Ui::MainWi
     connect(m_renamer, &RenamerDialog::sigFilesRenamed, this, &MainWindow::onFilesRenamed);
 
     connect(m_settingsWindow, &SettingsWindow::sigSaved, this, &MainWindow::onRenewModels, Qt::QueuedConnection);
+    connect(m_settingsWindow, &SettingsWindow::sigSaved, Manager::instance()->libraryUpdater(), &mediaelch::LibraryUpdater::resume, Qt::QueuedConnection);
 
     connect(ui->setsWidget,            &SetsWidget::sigJumpToMovie,          this, &MainWindow::onJumpToMovie);
     connect(ui->certificationWidget,   &CertificationWidget::sigJumpToMovie, this, &MainWindow::onJumpToMovie);
@@ -728,12 +729,13 @@ void MainWindow::onJumpToMovie(Movie* movie)
 
 void MainWindow::updateTvShows()
 {
-    const QVector<TvShow*> shows = Manager::instance()->tvShowModel()->tvShows();
-    for (TvShow* show : shows) {
+    QVector<TvShow*> shows;
+    for (TvShow* show : Manager::instance()->tvShowModel()->tvShows()) {
         if (show->showMissingEpisodes()) {
-            TvShowUpdater::instance()->updateShow(show);
+            shows.append(show);
         }
     }
+    TvShowUpdater::instance()->updateShows(shows);
 }
 
 void MainWindow::onCommandBarOpen()
@@ -57,6 +57,7 @@ TvShowFilesWidget::TvShowFilesWidget(QWidget* parent) :
 
     Manager::instance()->setTvShowFilesWidget(this);
 
+    connect(m_tvShowProxyModel, &QAbstractItemModel::rowsInserted, this, &TvShowFilesWidget::spanRows);
     connect(m_tvShowProxyModel, &QAbstractItemModel::rowsInserted, this, &TvShowFilesWidget::updateStatusLabel);
     connect(m_tvShowProxyModel, &QAbstractItemModel::rowsRemoved,  this, &TvShowFilesWidget::updateStatusLabel);
     // clang-format on
@@ -510,23 +511,28 @@ void TvShowFilesWidget::renewModel(bool force)
         return;
     }
 
-    /// \todo Check whether this code is really necessary after #883
+    // Rows that are inserted later on are spanned in spanRows().
+    spanRows(QModelIndex{}, 0, ui->files->model()->rowCount() - 1);
 
-    const int rowCount = ui->files->model()->rowCount();
-    for (int row = 0; row < rowCount; ++row) {
-        QModelIndex showIndex = ui->files->model()->index(row, 0);
-
-        for (int seasonRow = 0, x = ui->files->model()->rowCount(showIndex); seasonRow < x; ++seasonRow) {
-            QModelIndex seasonIndex = ui->files->model()->index(seasonRow, 0, showIndex);
-            ui->files->setFirstColumnSpanned(seasonRow, showIndex, true);
+    updateStatusLabel();
+}
 
-            for (int episodeRow = 0, y = ui->files->model()->rowCount(seasonIndex); episodeRow < y; ++episodeRow) {
-                ui->files->setFirstColumnSpanned(episodeRow, seasonIndex, true);
-            }
+/// \brief Span the first column of the given seasons/episodes and of all their children.
+/// \details Only shows have multiple columns. Called for all inserted rows, so that
+///          seasons and episodes that are added to an existing show are spanned as well.
+void TvShowFilesWidget::spanRows(const QModelIndex& parent, int first, int last)
+{
+    const QAbstractItemModel* model = ui->files->model();
+    for (int row = first; row <= last; ++row) {
+        if (parent.isValid()) {
+            ui->files->setFirstColumnSpanned(row, parent, true);
+        }
+        const QModelIndex index = model->index(row, 0, parent);
+        const int childCount = model->rowCount(index);
+        if (childCount > 0) {
+            spanRows(index, 0, childCount - 1);
         }
     }
-
-    updateStatusLabel();
 }
 
 /// \brief Emits sigTvShowSelected, sigSeasonSelected or sigEpisodeSelected based
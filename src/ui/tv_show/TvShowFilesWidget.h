@@ -63,6 +63,7 @@ private slots:
     void showMissingEpisodes();
     void hideSpecialsInMissingEpisodes();
     void updateStatusLabel();
+    void spanRows(const QModelIndex& parent, int first, int last);
     void playEpisode(QModelIndex idx);
 
 private:
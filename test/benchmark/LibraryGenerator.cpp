@@ -0,0 +1,247 @@
+#include "test/benchmark/LibraryGenerator.h"
+
+#include <QDir>
+#include <QFile>
+
+namespace {
+
+QByteArray movieNfo(const QString& title, int year)
+{
+    return QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+                          "<movie>\n"
+                          "  <title>%1</title>\n"
+                          "  <year>%2</year>\n"
+                          "  <plot>A synthetic movie that is used for benchmarks.</plot>\n"
+                          "  <genre>Drama</genre>\n"
+                          "  <actor><name>Jane Doe</name><role>Herself</role></actor>\n"
+                          "</movie>\n")
+        .arg(title.toHtmlEscaped(), QString::number(year))
+        .toUtf8();
+}
+
+QByteArray showNfo(const QString& title)
+{
+    return QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+                          "<tvshow>\n"
+                          "  <title>%1</title>\n"
+                          "  <plot>A synthetic TV show that is used for benchmarks.</plot>\n"
+                          "</tvshow>\n")
+        .arg(title.toHtmlEscaped())
+        .toUtf8();
+}
+
+QByteArray episodeNfo(const QString& title, int season, int episode)
+{
+    return QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+                          "<episodedetails>\n"
+                          "  <title>%1</title>\n"
+                          "  <season>%2</season>\n"
+                          "  <episode>%3</episode>\n"
+                          "</episodedetails>\n")
+        .arg(title.toHtmlEscaped(), QString::number(season), QString::number(episode))
+        .toUtf8();
+}
+
+QByteArray concertNfo(const QString& title)
+{
+    return QStringLiteral("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+                          "<musicvideo>\n"
+                          "  <title>%1</title>\n"
+                          "  <artist>Synthetic Band</artist>\n"
+                          "</musicvideo>\n")
+        .arg(title.toHtmlEscaped())
+        .toUtf8();
+}
+
+/// \brief Deterministic year for the n-th movie.
+int yearOf(int n)
+{
+    return 1950 + (n % 70);
+}
+
+} // namespace
+
+namespace mediaelch {
+namespace benchmark {
+
+LibraryGenerator::LibraryGenerator(DirectoryPath root, LibraryConfig config) :
+    m_root{std::move(root)}, m_config{config}
+{
+}
+
+bool LibraryGenerator::generate()
+{
+    m_fileCount = 0;
+    return generateMovies() && generateTvShows() && generateConcerts();
+}
+
+bool LibraryGenerator::generateMovies()
+{
+    const QString movieDir = this->movieDir().toString();
+    if (!makeDir(movieDir)) {
+        return false;
+    }
+
+    int n = 0;
+    for (int i = 0; i < m_config.movies; ++i, ++n) {
+        const QString title = QStringLiteral("Movie %1").arg(n);
+        const QString baseName = QStringLiteral("%1 (%2)").arg(title).arg(yearOf(n));
+        const QString dir = movieDir + "/" + baseName;
+        if (!makeDir(dir) || !writeFile(dir + "/" + baseName + ".mkv")
+            || !writeMovie(dir, baseName, title, yearOf(n))) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < m_config.stackedMovies; ++i, ++n) {
+        const QString title = QStringLiteral("Stacked Movie %1").arg(n);
+        const QString baseName = QStringLiteral("%1 (%2)").arg(title).arg(yearOf(n));
+        const QString dir = movieDir + "/" + baseName;
+        if (!makeDir(dir) || !writeFile(dir + "/" + baseName + " - cd1.avi")
+            || !writeFile(dir + "/" + baseName + " - cd2.avi") || !writeMovie(dir, baseName, title, yearOf(n))) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < m_config.bluRays; ++i, ++n) {
+        const QString title = QStringLiteral("BluRay Movie %1").arg(n);
+        const QString dir = movieDir + "/" + QStringLiteral("%1 (%2)").arg(title).arg(yearOf(n));
+        const QString bdmv = dir + "/BDMV";
+        if (!makeDir(bdmv + "/STREAM") || !makeDir(bdmv + "/PLAYLIST") || !makeDir(bdmv + "/BACKUP")
+            || !writeFile(bdmv + "/index.bdmv") || !writeFile(bdmv + "/MovieObject.bdmv")
+            || !writeFile(bdmv + "/BACKUP/index.bdmv") || !writeFile(bdmv + "/STREAM/00001.m2ts")
+            || !writeFile(bdmv + "/PLAYLIST/00001.mpls") || !writeMovie(dir, "index", title, yearOf(n))) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < m_config.dvds; ++i, ++n) {
+        const QString title = QStringLiteral("DVD Movie %1").arg(n);
+        const QString dir = movieDir + "/" + QStringLiteral("%1 (%2)").arg(title).arg(yearOf(n));
+        const QString videoTs = dir + "/VIDEO_TS";
+        if (!makeDir(videoTs) || !writeFile(videoTs + "/VIDEO_TS.IFO") || !writeFile(videoTs + "/VIDEO_TS.BUP")
+            || !writeFile(videoTs + "/VTS_01_1.VOB") || !writeMovie(dir, "VIDEO_TS", title, yearOf(n))) {
+            return false;
+        }
+    }
+
+    const QString flatDir = flatMovieDir().toString();
+    if (!makeDir(flatDir)) {
+        return false;
+    }
+    for (int i = 0; i < m_config.flatMovies; ++i, ++n) {
+        const QString title = QStringLiteral("Flat Movie %1").arg(n);
+        const QString baseName = QStringLiteral("%1 (%2)").arg(title).arg(yearOf(n));
+        // Every tenth movie has two parts.
+        const bool ok = (i % 10 == 0) ? writeFile(flatDir + "/" + baseName + ".part1.mkv")
+                                            && writeFile(flatDir + "/" + baseName + ".part2.mkv")
+                                      : writeFile(flatDir + "/" + baseName + ".mkv");
+        if (!ok || !writeMovie(flatDir, baseName, title, yearOf(n))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LibraryGenerator::writeMovie(const QString& dir, const QString& baseName, const QString& title, int year)
+{
+    if (m_config.nfoFiles && !writeFile(dir + "/" + baseName + ".nfo", movieNfo(title, year))) {
+        return false;
+    }
+    if (m_config.artwork
+        && (!writeFile(dir + "/" + baseName + "-poster.jpg") || !writeFile(dir + "/" + baseName + "-fanart.jpg"))) {
+        return false;
+    }
+    if (m_config.subtitles
+        && (!writeFile(dir + "/" + baseName + ".en.srt") || !writeFile(dir + "/" + baseName + ".de.forced.srt"))) {
+        return false;
+    }
+    return true;
+}
+
+bool LibraryGenerator::generateTvShows()
+{
+    const QString showDir = tvShowDir().toString();
+    if (!makeDir(showDir)) {
+        return false;
+    }
+
+    for (int show = 0; show < m_config.tvShows; ++show) {
+        const QString title = QStringLiteral("Show %1").arg(show);
+        const QString dir = showDir + "/" + title;
+        if (!makeDir(dir)) {
+            return false;
+        }
+        if (m_config.nfoFiles && !writeFile(dir + "/tvshow.nfo", showNfo(title))) {
+            return false;
+        }
+        if (m_config.artwork && (!writeFile(dir + "/poster.jpg") || !writeFile(dir + "/fanart.jpg"))) {
+            return false;
+        }
+
+        for (int season = 1; season <= m_config.seasonsPerShow; ++season) {
+            const QString seasonDir = dir + QStringLiteral("/Season %1").arg(season);
+            if (!makeDir(seasonDir)) {
+                return false;
+            }
+            for (int episode = 1; episode <= m_config.episodesPerSeason; ++episode) {
+                const QString baseName = QStringLiteral("%1 - S%2E%3")
+                                             .arg(title)
+                                             .arg(season, 2, 10, QChar('0'))
+                                             .arg(episode, 2, 10, QChar('0'));
+                const QString path = seasonDir + "/" + baseName;
+                if (!writeFile(path + ".mkv")) {
+                    return false;
+                }
+                if (m_config.nfoFiles && !writeFile(path + ".nfo", episodeNfo(baseName, season, episode))) {
+                    return false;
+                }
+                if (m_config.artwork && !writeFile(path + "-thumb.jpg")) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool LibraryGenerator::generateConcerts()
+{
+    const QString concertDir = this->concertDir().toString();
+    if (!makeDir(concertDir)) {
+        return false;
+    }
+
+    for (int i = 0; i < m_config.concerts; ++i) {
+        const QString title = QStringLiteral("Concert %1").arg(i);
+        const QString dir = concertDir + "/" + title;
+        if (!makeDir(dir) || !writeFile(dir + "/" + title + ".mkv")) {
+            return false;
+        }
+        if (m_config.nfoFiles && !writeFile(dir + "/" + title + ".nfo", concertNfo(title))) {
+            return false;
+        }
+        if (m_config.artwork && !writeFile(dir + "/" + title + "-poster.jpg")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LibraryGenerator::writeFile(const QString& path, const QByteArray& content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    ++m_fileCount;
+    return file.write(content) == content.size();
+}
+
+bool LibraryGenerator::makeDir(const QString& path)
+{
+    return QDir().mkpath(path);
+}
+
+} // namespace benchmark
+} // namespace mediaelch
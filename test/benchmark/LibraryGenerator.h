@@ -0,0 +1,78 @@
+#pragma once
+
+#include "file/Path.h"
+
+#include <QString>
+
+namespace mediaelch {
+namespace benchmark {
+
+/// \brief Size and contents of a synthetic library, see LibraryGenerator.
+struct LibraryConfig
+{
+    /// \brief Movies with a single file, each in its own folder.
+    int movies = 1000;
+    /// \brief Movies with two parts (cd1/cd2), each in its own folder.
+    int stackedMovies = 100;
+    /// \brief Movies in a BluRay folder structure.
+    int bluRays = 20;
+    /// \brief Movies in a DVD folder structure.
+    int dvds = 20;
+    /// \brief Additional movies without their own folder, i.e. in one flat folder.
+    int flatMovies = 500;
+
+    int tvShows = 50;
+    int seasonsPerShow = 4;
+    int episodesPerSeason = 10;
+
+    int concerts = 100;
+
+    /// \brief Write an NFO file next to each media file.
+    bool nfoFiles = true;
+    /// \brief Write poster and fanart images next to each media file.
+    bool artwork = true;
+    /// \brief Write two subtitle files for each movie.
+    bool subtitles = true;
+};
+
+/// \brief Generates a synthetic media library with empty media files.
+///
+/// Directory layout below the root directory:
+///   - movies/         one folder per movie, including BluRay and DVD structures
+///   - movies_flat/    movies without their own folder
+///   - tvshows/        one folder per show with season folders
+///   - concerts/       one folder per concert
+class LibraryGenerator
+{
+public:
+    LibraryGenerator(DirectoryPath root, LibraryConfig config);
+
+    /// \brief Create all files.  Existing files are overwritten.
+    /// \returns false if any file could not be written.
+    bool generate();
+
+    /// \brief Number of files that were written by generate().
+    int fileCount() const { return m_fileCount; }
+
+    DirectoryPath movieDir() const { return m_root.subDir("movies"); }
+    DirectoryPath flatMovieDir() const { return m_root.subDir("movies_flat"); }
+    DirectoryPath tvShowDir() const { return m_root.subDir("tvshows"); }
+    DirectoryPath concertDir() const { return m_root.subDir("concerts"); }
+
+private:
+    bool generateMovies();
+    bool generateTvShows();
+    bool generateConcerts();
+
+    bool writeMovie(const QString& dir, const QString& baseName, const QString& title, int year);
+    bool writeFile(const QString& path, const QByteArray& content = {});
+    bool makeDir(const QString& path);
+
+private:
+    DirectoryPath m_root;
+    LibraryConfig m_config;
+    int m_fileCount = 0;
+};
+
+} // namespace benchmark
+} // namespace mediaelch
@@ -0,0 +1,382 @@
+/// \file
+/// Benchmark for scanning large libraries.
+///
+/// Generates a synthetic library in a temporary directory and measures how
+/// long the movie, TV show and concert loaders take for each scan phase.
+/// Results are written as JSON so that they can be compared across commits.
+///
+/// The benchmark uses its own database in QStandardPaths' test location,
+/// i.e. the user's MediaElch database is never touched.
+
+#include "Version.h"
+#include "globals/Manager.h"
+#include "globals/Meta.h"
+#include "movies/Movie.h"
+#include "movies/file_searcher/MovieDirectorySearcher.h"
+#include "settings/Settings.h"
+#include "test/benchmark/LibraryGenerator.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QPair>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <atomic>
+#include <functional>
+#include <iostream>
+
+using namespace mediaelch;
+using namespace mediaelch::benchmark;
+
+namespace {
+
+class BenchmarkResults
+{
+public:
+    void add(const QString& phase, qint64 milliseconds, int items)
+    {
+        QJsonObject result;
+        result.insert("phase", phase);
+        result.insert("ms", milliseconds);
+        result.insert("items", items);
+        m_results.append(result);
+        std::cerr << qPrintable(QStringLiteral("%1 %2 ms (%3 items)").arg(phase, -40).arg(milliseconds, 8).arg(items))
+                  << std::endl;
+    }
+
+    QJsonArray toJson() const { return m_results; }
+
+private:
+    QJsonArray m_results;
+};
+
+SettingsDir settingsDir(const DirectoryPath& path, bool separateFolders)
+{
+    SettingsDir dir;
+    dir.path = path.dir();
+    dir.separateFolders = separateFolders;
+    dir.autoReload = false;
+    return dir;
+}
+
+int takeMovieCount(MovieLoaderStore& store)
+{
+    const QVector<Movie*> movies = store.takeAll(nullptr);
+    const int count = qsizetype_to_int(movies.size());
+    qDeleteAll(movies);
+    return count;
+}
+
+/// \brief Run a MovieDiskLoader synchronously.
+/// \details The first progress signal is emitted before the directory is listed,
+///          the second one after it has been listed.
+void benchmarkMovieDiskLoader(BenchmarkResults& results,
+    const QString& phase,
+    const SettingsDir& dir,
+    bool incremental)
+{
+    MovieLoaderStore store;
+    MovieDiskLoader loader(dir, store, Settings::instance()->advanced()->movieFilters());
+    loader.setIncrementalScan(incremental);
+
+    QElapsedTimer timer;
+    std::atomic_int progressCount{0};
+    std::atomic<qint64> listed{-1};
+    qint64 firstBatch = -1;
+
+    // Progress is also emitted by worker threads, hence direct connections.
+    QObject::connect(
+        &loader,
+        &MovieLoader::progress,
+        [&](MovieLoader* /*job*/, int /*processed*/, int /*total*/) {
+            if (++progressCount == 2) {
+                listed = timer.elapsed();
+            }
+        },
+        Qt::DirectConnection);
+    QObject::connect(
+        &loader,
+        &MovieLoader::moviesLoaded,
+        [&](MovieLoader* /*job*/) {
+            if (firstBatch < 0) {
+                firstBatch = timer.elapsed();
+            }
+        },
+        Qt::DirectConnection);
+
+    timer.start();
+    loader.start();
+    const qint64 total = timer.elapsed();
+
+    const int movieCount = takeMovieCount(store);
+    results.add(phase + ".list", listed.load(), movieCount);
+    results.add(phase + ".first_batch", firstBatch, movieCount);
+    results.add(phase + ".total", total, movieCount);
+}
+
+void benchmarkMovieDatabaseLoader(BenchmarkResults& results, const QString& phase, const SettingsDir& dir)
+{
+    MovieLoaderStore store;
+    MovieDatabaseLoader loader(dir, store);
+
+    QElapsedTimer timer;
+    qint64 firstBatch = -1;
+    QObject::connect(
+        &loader,
+        &MovieLoader::moviesLoaded,
+        [&](MovieLoader* /*job*/) {
+            if (firstBatch < 0) {
+                firstBatch = timer.elapsed();
+            }
+        },
+        Qt::DirectConnection);
+
+    timer.start();
+    loader.start();
+    const qint64 total = timer.elapsed();
+
+    const int movieCount = takeMovieCount(store);
+    results.add(phase + ".first_batch", firstBatch, movieCount);
+    results.add(phase + ".total", total, movieCount);
+}
+
+void benchmarkMovies(BenchmarkResults& results, const LibraryGenerator& library)
+{
+    const QVector<QPair<QString, SettingsDir>> directories{
+        {"movies", settingsDir(library.movieDir(), true)},
+        {"movies_flat", settingsDir(library.flatMovieDir(), false)},
+    };
+    for (const auto& directory : directories) {
+        const QString prefix = directory.first;
+        benchmarkMovieDiskLoader(results, prefix + ".disk.cold", directory.second, false);
+        // The first incremental scan stores the directory fingerprints...
+        benchmarkMovieDiskLoader(results, prefix + ".disk.incremental_initial", directory.second, true);
+        // ...so that the second one can reuse all cached movies.
+        benchmarkMovieDiskLoader(results, prefix + ".disk.incremental_unchanged", directory.second, true);
+        benchmarkMovieDatabaseLoader(results, prefix + ".database", directory.second);
+    }
+}
+
+/// \brief Measure a file searcher's reload().
+/// \details Both searchers emit searchStarted() twice: Once before the library is
+///          searched on disk and once before shows or concerts are loaded from
+///          the database and added to the model.  Searchers may load in a
+///          background thread, i.e. the measurement ends with the \p loaded signal.
+template<class Searcher>
+void benchmarkReload(BenchmarkResults& results,
+    const QString& phase,
+    Searcher& searcher,
+    void (Searcher::*loaded)(),
+    bool force,
+    const std::function<int()>& itemCount)
+{
+    QElapsedTimer timer;
+    QVector<qint64> searchStarted;
+    const auto connection = QObject::connect(&searcher, &Searcher::searchStarted, [&](QString /*text*/) {
+        searchStarted << timer.elapsed();
+    });
+
+    QEventLoop loop;
+    bool isLoaded = false;
+    const auto loadedConnection = QObject::connect(&searcher, loaded, &loop, [&]() {
+        isLoaded = true;
+        loop.quit();
+    });
+
+    timer.start();
+    searcher.reload(force);
+    if (!isLoaded) {
+        loop.exec();
+    }
+    const qint64 total = timer.elapsed();
+    QObject::disconnect(connection);
+    QObject::disconnect(loadedConnection);
+
+    const int items = itemCount();
+    if (searchStarted.size() == 2) {
+        results.add(phase + ".disk", searchStarted.at(1) - searchStarted.at(0), items);
+        results.add(phase + ".load", total - searchStarted.at(1), items);
+    }
+    results.add(phase + ".total", total, items);
+}
+
+void benchmarkTvShows(BenchmarkResults& results, const LibraryGenerator& library)
+{
+    TvShowFileSearcher* searcher = Manager::instance()->tvShowFileSearcher();
+    searcher->setTvShowDirectories({settingsDir(library.tvShowDir(), false)});
+    const auto showCount = []() { return qsizetype_to_int(Manager::instance()->tvShowModel()->tvShows().size()); };
+
+    benchmarkReload(results, "tvshows.cold", *searcher, &TvShowFileSearcher::tvShowsLoaded, true, showCount);
+    benchmarkReload(results, "tvshows.cached", *searcher, &TvShowFileSearcher::tvShowsLoaded, false, showCount);
+}
+
+void benchmarkConcerts(BenchmarkResults& results, const LibraryGenerator& library)
+{
+    ConcertFileSearcher* searcher = Manager::instance()->concertFileSearcher();
+    searcher->setConcertDirectories({settingsDir(library.concertDir(), false)});
+    const auto concertCount = []() {
+        return qsizetype_to_int(Manager::instance()->concertModel()->concerts().size());
+    };
+
+    benchmarkReload(results, "concerts.cold", *searcher, &ConcertFileSearcher::concertsLoaded, true, concertCount);
+    benchmarkReload(results, "concerts.cached", *searcher, &ConcertFileSearcher::concertsLoaded, false, concertCount);
+}
+
+QJsonObject configToJson(const LibraryConfig& config, int fileCount)
+{
+    QJsonObject json;
+    json.insert("movies", config.movies);
+    json.insert("stacked_movies", config.stackedMovies);
+    json.insert("bluray_movies", config.bluRays);
+    json.insert("dvd_movies", config.dvds);
+    json.insert("flat_movies", config.flatMovies);
+    json.insert("tvshows", config.tvShows);
+    json.insert("seasons_per_show", config.seasonsPerShow);
+    json.insert("episodes_per_season", config.episodesPerSeason);
+    json.insert("concerts", config.concerts);
+    json.insert("nfo_files", config.nfoFiles);
+    json.insert("artwork", config.artwork);
+    json.insert("subtitles", config.subtitles);
+    json.insert("files", fileCount);
+    return json;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("MediaElchBenchmark");
+    QApplication::setApplicationVersion(mediaelch::constants::AppVersionFullStr);
+    // Use a separate database, cache and settings location.
+    QStandardPaths::setTestModeEnabled(true);
+    registerAllMetaTypes();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Scans a synthetic library and reports how long each phase takes.");
+    parser.addHelpOption();
+
+    const LibraryConfig defaults;
+    const auto countOption = [](const QString& name, const QString& description, int defaultValue) {
+        return QCommandLineOption(name, description + QStringLiteral(" (default: %1)").arg(defaultValue), "count");
+    };
+    const QCommandLineOption moviesOption = countOption("movies", "Movies in their own folder", defaults.movies);
+    const QCommandLineOption stackedOption = countOption("stacked", "Movies with two parts", defaults.stackedMovies);
+    const QCommandLineOption bluRayOption = countOption("bluray", "BluRay movies", defaults.bluRays);
+    const QCommandLineOption dvdOption = countOption("dvd", "DVD movies", defaults.dvds);
+    const QCommandLineOption flatOption = countOption("flat", "Movies in one flat folder", defaults.flatMovies);
+    const QCommandLineOption showsOption = countOption("shows", "TV shows", defaults.tvShows);
+    const QCommandLineOption seasonsOption = countOption("seasons", "Seasons per TV show", defaults.seasonsPerShow);
+    const QCommandLineOption episodesOption =
+        countOption("episodes", "Episodes per season", defaults.episodesPerSeason);
+    const QCommandLineOption concertsOption = countOption("concerts", "Concerts", defaults.concerts);
+    const QCommandLineOption noNfoOption("no-nfo", "Do not write NFO files.");
+    const QCommandLineOption noArtworkOption("no-artwork", "Do not write artwork files.");
+    const QCommandLineOption noSubtitlesOption("no-subtitles", "Do not write subtitle files.");
+    const QCommandLineOption outputOption(
+        {"o", "output"}, "Write the JSON results to <file> instead of stdout.", "file");
+    const QCommandLineOption keepOption("keep", "Do not remove the generated library.");
+
+    parser.addOptions({moviesOption,
+        stackedOption,
+        bluRayOption,
+        dvdOption,
+        flatOption,
+        showsOption,
+        seasonsOption,
+        episodesOption,
+        concertsOption,
+        noNfoOption,
+        noArtworkOption,
+        noSubtitlesOption,
+        outputOption,
+        keepOption});
+    parser.process(app);
+
+    bool valid = true;
+    const auto count = [&](const QCommandLineOption& option, int defaultValue) {
+        if (!parser.isSet(option)) {
+            return defaultValue;
+        }
+        bool ok = false;
+        const int value = parser.value(option).toInt(&ok);
+        if (!ok || value < 0) {
+            std::cerr << "Invalid value for --" << qPrintable(option.names().last()) << std::endl;
+            valid = false;
+        }
+        return value;
+    };
+
+    LibraryConfig config;
+    config.movies = count(moviesOption, defaults.movies);
+    config.stackedMovies = count(stackedOption, defaults.stackedMovies);
+    config.bluRays = count(bluRayOption, defaults.bluRays);
+    config.dvds = count(dvdOption, defaults.dvds);
+    config.flatMovies = count(flatOption, defaults.flatMovies);
+    config.tvShows = count(showsOption, defaults.tvShows);
+    config.seasonsPerShow = count(seasonsOption, defaults.seasonsPerShow);
+    config.episodesPerSeason = count(episodesOption, defaults.episodesPerSeason);
+    config.concerts = count(concertsOption, defaults.concerts);
+    config.nfoFiles = !parser.isSet(noNfoOption);
+    config.artwork = !parser.isSet(noArtworkOption);
+    config.subtitles = !parser.isSet(noSubtitlesOption);
+    if (!valid) {
+        return 1;
+    }
+
+    // Loaders log each file; that would distort the results.
+    QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+
+    // Start with an empty database.  Must happen before the Manager opens it.
+    // The write-ahead log and its index belong to the database file.
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        QFile::remove(Settings::instance()->databaseDir().filePath(QStringLiteral("MediaElch.sqlite") + suffix));
+    }
+
+    QTemporaryDir tempDir;
+    if (!tempDir.isValid()) {
+        std::cerr << "Could not create a temporary directory" << std::endl;
+        return 1;
+    }
+    tempDir.setAutoRemove(!parser.isSet(keepOption));
+
+    LibraryGenerator library(DirectoryPath(tempDir.path()), config);
+    QElapsedTimer generateTimer;
+    generateTimer.start();
+    if (!library.generate()) {
+        std::cerr << "Could not generate the library in " << qPrintable(tempDir.path()) << std::endl;
+        return 1;
+    }
+    std::cerr << "Generated " << library.fileCount() << " files in " << generateTimer.elapsed() << " ms: "
+              << qPrintable(tempDir.path()) << std::endl;
+
+    BenchmarkResults results;
+    benchmarkMovies(results, library);
+    benchmarkTvShows(results, library);
+    benchmarkConcerts(results, library);
+
+    QJsonObject json;
+    json.insert("version", QApplication::applicationVersion());
+    json.insert("config", configToJson(config, library.fileCount()));
+    json.insert("results", results.toJson());
+    const QByteArray output = QJsonDocument(json).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(output) != output.size()) {
+            std::cerr << "Could not write results to " << qPrintable(file.fileName()) << std::endl;
+            return 1;
+        }
+    } else {
+        QTextStream(stdout) << output;
+    }
+    return 0;
+}
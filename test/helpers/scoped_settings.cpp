@@ -0,0 +1,14 @@
+#include "test/helpers/scoped_settings.h"
+
+#include "settings/AdvancedSettingsXmlReader.h"
+#include "settings/Settings.h"
+
+ScopedAdvancedSettings::ScopedAdvancedSettings(const QString& xml) : m_previous{*Settings::instance()->advanced()}
+{
+    *Settings::instance()->advanced() = AdvancedSettingsXmlReader::loadFromXml(xml).first;
+}
+
+ScopedAdvancedSettings::~ScopedAdvancedSettings()
+{
+    *Settings::instance()->advanced() = m_previous;
+}
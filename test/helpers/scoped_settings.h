@@ -0,0 +1,25 @@
+#pragma once
+
+#include "settings/AdvancedSettings.h"
+
+#include <QString>
+
+/// \brief Replaces the global advanced settings with the given XML and restores
+///        the previous settings when it goes out of scope, even if a test fails.
+///
+/// \par Example
+/// \code{cpp}
+///   ScopedAdvancedSettings settings(R"xml(<advancedsettings>...</advancedsettings>)xml");
+/// \endcode
+class ScopedAdvancedSettings
+{
+public:
+    explicit ScopedAdvancedSettings(const QString& xml);
+    ~ScopedAdvancedSettings();
+
+    ScopedAdvancedSettings(const ScopedAdvancedSettings&) = delete;
+    ScopedAdvancedSettings& operator=(const ScopedAdvancedSettings&) = delete;
+
+private:
+    AdvancedSettings m_previous;
+};
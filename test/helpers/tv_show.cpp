@@ -0,0 +1,13 @@
+#include "test/helpers/tv_show.h"
+
+#include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
+
+TvShowEpisode* addEpisodeToShow(TvShow& show, int season, int episodeNumber)
+{
+    auto* episode = new TvShowEpisode(QStringList{}, &show);
+    episode->setSeason(SeasonNumber(season));
+    episode->setEpisode(EpisodeNumber(episodeNumber));
+    show.addEpisode(episode);
+    return episode;
+}
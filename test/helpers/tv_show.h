@@ -0,0 +1,8 @@
+#pragma once
+
+class TvShow;
+class TvShowEpisode;
+
+/// \brief Create an episode with the given numbers and add it to the show.
+/// \returns The new episode; it is owned by the show.
+TvShowEpisode* addEpisodeToShow(TvShow& show, int season, int episodeNumber);
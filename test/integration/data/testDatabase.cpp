@@ -0,0 +1,450 @@
+#include "test/test_helpers.h"
+
+#include "concerts/ConcertLoader.h"
+#include "data/Database.h"
+#include "data/Subtitle.h"
+#include "globals/LoaderThreadPool.h"
+#include "globals/Meta.h"
+#include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
+
+#include <QEventLoop>
+#include <QObject>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTemporaryDir>
+#include <QThread>
+
+using namespace mediaelch;
+
+/// \brief Returns the query plan of the given SELECT statement, one step per line.
+static QStringList queryPlan(Database& database, const QString& sql)
+{
+    QSqlQuery query(database.db());
+    REQUIRE(query.prepare("EXPLAIN QUERY PLAN " + sql));
+    // Values do not matter for the query plan, but all placeholders must be bound.
+    const int placeholders = qsizetype_to_int(sql.count('?'));
+    for (int i = 0; i < placeholders; ++i) {
+        query.bindValue(i, "value");
+    }
+    REQUIRE(query.exec());
+
+    QStringList plan;
+    const int detailIndex = query.record().indexOf("detail");
+    while (query.next()) {
+        plan << query.value(detailIndex).toString();
+    }
+    return plan;
+}
+
+TEST_CASE("Database uses indexes for frequent queries", "[database]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+
+    const auto sql = GENERATE(as<QString>{},
+        "SELECT idMovie FROM movies WHERE path=?",
+        "SELECT M.idMovie, MF.file, L.color FROM movies M "
+        "LEFT JOIN movieFiles MF ON MF.idMovie=M.idMovie "
+        "LEFT JOIN labels L ON MF.file=L.fileName "
+        "WHERE path=?",
+        "SELECT color FROM labels WHERE fileName=?",
+        "SELECT idLabel FROM labels WHERE fileName=?",
+        "SELECT fileName, color FROM labels WHERE fileName >= ? AND fileName < ?",
+        "SELECT idConcert FROM concerts WHERE path=?",
+        "SELECT idShow FROM shows WHERE path=?",
+        "SELECT idEpisode FROM episodes WHERE idShow=?",
+        "SELECT showMissingEpisodes FROM showsSettings WHERE dir=?",
+        "SELECT idEpisode FROM showsEpisodes WHERE idShow=?",
+        "SELECT idEpisode FROM showsEpisodes WHERE tmdbid=?",
+        "SELECT dir, lastModified, entryCount FROM tvShowDirectories WHERE path=?",
+        // Labels and subtitles of a movie library directory
+        "SELECT MF.idMovie, MF.file, L.color FROM movies M "
+        "JOIN movieFiles MF ON MF.idMovie=M.idMovie "
+        "JOIN labels L ON L.fileName=MF.file "
+        "WHERE M.path=?",
+        "SELECT S.idMovie, S.files, S.language, S.forced FROM movies M "
+        "JOIN movieSubtitles S ON S.idMovie=M.idMovie "
+        "WHERE M.path=?");
+    CAPTURE(sql);
+
+    const QStringList plan = queryPlan(database, sql);
+    const QString planDetails = plan.join(" | ");
+    CAPTURE(planDetails);
+    REQUIRE_FALSE(plan.isEmpty());
+    for (const QString& step : plan) {
+        // Full table scans are reported as "SCAN <table>" or "SCAN TABLE <table>" depending on the SQLite version.
+        CHECK_FALSE(step.startsWith("SCAN"));
+    }
+}
+
+TEST_CASE("Database loads movies of one library directory", "[database][movie]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+
+    constexpr int rootCount = 50;
+    constexpr int moviesPerRoot = 4;
+
+    QObject parent;
+    database.transaction();
+    for (int root = 0; root < rootCount; ++root) {
+        QVector<Movie*> movies;
+        for (int i = 0; i < moviesPerRoot; ++i) {
+            const QString base = QStringLiteral("/library/%1/Movie %2/movie").arg(root).arg(i);
+            auto* movie = new Movie({base + ".cd1.mkv", base + ".cd2.mkv"}, &parent);
+            movie->setName(QStringLiteral("Movie %1/%2").arg(root).arg(i));
+            movie->setLabel(i == 0 ? ColorLabel::Green : ColorLabel::NoLabel);
+            auto* subtitle = new Subtitle(movie);
+            subtitle->setFiles({base + ".en.srt"});
+            subtitle->setLanguage("en");
+            movie->addSubtitle(subtitle, true);
+            movies.append(movie);
+        }
+        database.addMovies(movies, DirectoryPath(QStringLiteral("/library/%1").arg(root)));
+    }
+    database.commit();
+
+    for (const int root : {0, rootCount / 2, rootCount - 1}) {
+        CAPTURE(root);
+        QObject movieParent;
+        const QVector<Movie*> movies =
+            database.moviesInDirectory(DirectoryPath(QStringLiteral("/library/%1").arg(root)), &movieParent);
+        REQUIRE(movies.size() == moviesPerRoot);
+
+        int subtitleCount = 0;
+        int labelCount = 0;
+        for (Movie* movie : movies) {
+            CHECK(movie->files().size() == 2);
+            CHECK(movie->name().startsWith(QStringLiteral("Movie %1/").arg(root)));
+            for (const Subtitle* subtitle : movie->subtitles()) {
+                CHECK(subtitle->files().first().startsWith(QStringLiteral("/library/%1/").arg(root)));
+                ++subtitleCount;
+            }
+            if (movie->label() == ColorLabel::Green) {
+                ++labelCount;
+            }
+        }
+        // Only subtitles and labels of this directory are loaded.
+        CHECK(subtitleCount == moviesPerRoot);
+        CHECK(labelCount == 1);
+    }
+
+    // Rows read per call must not grow with the number of library directories: All queries
+    // of moviesInDirectory() find the directory's movies using the path index.
+    const QStringList queries{
+        "SELECT M.idMovie, M.content, M.metadata, M.lastModified, M.inSeparateFolder, M.hasPoster, "
+        "M.hasBackdrop, M.hasLogo, M.hasClearArt, "
+        "M.hasCdArt, M.hasBanner, M.hasThumb, M.hasExtraFanarts, M.discType, MF.file "
+        "FROM movies M "
+        "LEFT JOIN movieFiles MF ON MF.idMovie=M.idMovie "
+        "WHERE M.path=? "
+        "ORDER BY M.idMovie, MF.file",
+        "SELECT MF.idMovie, MF.file, L.color "
+        "FROM movies M "
+        "JOIN movieFiles MF ON MF.idMovie=M.idMovie "
+        "JOIN labels L ON L.fileName=MF.file "
+        "WHERE M.path=?",
+        "SELECT S.idMovie, S.files, S.language, S.forced "
+        "FROM movies M "
+        "JOIN movieSubtitles S ON S.idMovie=M.idMovie "
+        "WHERE M.path=?"};
+    for (const QString& sql : queries) {
+        CAPTURE(sql);
+        const QStringList plan = queryPlan(database, sql);
+        const QString planDetails = plan.join(" | ");
+        CAPTURE(planDetails);
+        CHECK(planDetails.contains("id_movies_path_idx"));
+        for (const QString& step : plan) {
+            CHECK_FALSE(step.startsWith("SCAN"));
+        }
+    }
+}
+
+TEST_CASE("Database keeps the NFO content of movies with cached metadata", "[database][movie]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+    const DirectoryPath path("/library");
+    const QString content = "<movie><title>Movie</title></movie>";
+
+    QObject parent;
+    auto* movie = new Movie({"/library/Movie/movie.mkv"}, &parent);
+    movie->setName("Movie");
+    movie->setNfoContent(content);
+    database.addMovies({movie}, path);
+
+    QObject movieParent;
+    QVector<Movie*> movies = database.moviesInDirectory(path, &movieParent);
+    REQUIRE(movies.size() == 1);
+    CHECK(movies.first()->name() == "Movie");
+    CHECK(movies.first()->nfoContent() == content);
+
+    // Storing the restored movie again must not lose its NFO content.
+    database.update(movies.first());
+    movies = database.moviesInDirectory(path, &movieParent);
+    REQUIRE(movies.size() == 1);
+    CHECK(movies.first()->nfoContent() == content);
+}
+
+TEST_CASE("Database connections", "[database]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    const DirectoryPath path(dir.path());
+
+    QString connectionName;
+    {
+        Database database(path);
+        connectionName = database.db().connectionName();
+
+        QSqlQuery query(database.db());
+        REQUIRE(query.exec("PRAGMA journal_mode;"));
+        REQUIRE(query.next());
+        CHECK(query.value(0).toString() == "wal");
+    }
+
+    SECTION("are reused by the same thread")
+    {
+        Database database(path);
+        CHECK(database.db().connectionName() == connectionName);
+
+        Database other(path);
+        CHECK(other.db().connectionName() != connectionName);
+    }
+
+    SECTION("are not shared between threads")
+    {
+        QString otherConnectionName;
+        QThread* thread = QThread::create([&]() {
+            Database database(path);
+            otherConnectionName = database.db().connectionName();
+        });
+        thread->start();
+        REQUIRE(thread->wait(10000));
+        delete thread;
+        CHECK_FALSE(otherConnectionName.isEmpty());
+        CHECK(otherConnectionName != connectionName);
+    }
+
+    SECTION("can read while another connection writes")
+    {
+        Database writer(path);
+        Database reader(path);
+        writer.transaction();
+        writer.addMovie(new Movie({"/library/movie.mkv"}, &writer), DirectoryPath("/library"));
+
+        QObject parent;
+        // Uncommitted changes are not visible, but reading is possible.
+        CHECK(reader.moviesInDirectory(DirectoryPath("/library"), &parent).isEmpty());
+        writer.commit();
+        CHECK(reader.moviesInDirectory(DirectoryPath("/library"), &parent).size() == 1);
+    }
+}
+
+TEST_CASE("Database connections are reused by the next loader", "[database]")
+{
+    // Runs a loader without directories, which only opens its database connection.
+    const auto runLoader = []() {
+        ConcertLoaderStore store;
+        auto* loader = new ConcertLoader({}, false, store, nullptr);
+        QThread* loaderThread = nullptr;
+        QObject::connect(
+            loader,
+            &ConcertLoader::progress,
+            [&loaderThread]() { loaderThread = QThread::currentThread(); },
+            Qt::DirectConnection);
+        // The loader is deleted by its thread once start() has returned, i.e. once
+        // the thread was released.
+        QEventLoop loop;
+        QObject::connect(loader, &ConcertLoader::finished, loader, &QObject::deleteLater);
+        QObject::connect(loader, &QObject::destroyed, &loop, &QEventLoop::quit);
+        runInLoaderThread(loader);
+        loop.exec();
+        return loaderThread;
+    };
+
+    QThread* firstThread = runLoader();
+    const elch_size_t connectionCount = QSqlDatabase::connectionNames().size();
+    QThread* secondThread = runLoader();
+
+    REQUIRE(firstThread != nullptr);
+    CHECK(firstThread != QThread::currentThread());
+    CHECK(secondThread == firstThread);
+    // The second loader did not open a new connection.
+    CHECK(QSqlDatabase::connectionNames().size() == connectionCount);
+}
+
+TEST_CASE("Database stores labels of many files at once", "[database]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+
+    database.setLabels({
+        {"/library/a/movie.mkv", ColorLabel::Red},
+        {"/library/a/sub/movie.mkv", ColorLabel::Blue},
+        {"/library/a/none.mkv", ColorLabel::NoLabel},
+        {"/library/ab/movie.mkv", ColorLabel::Green},
+    });
+
+    QHash<QString, ColorLabel> labels = database.labelsInDirectory(DirectoryPath("/library/a"));
+    CHECK(labels.size() == 2);
+    CHECK(labels.value("/library/a/movie.mkv") == ColorLabel::Red);
+    CHECK(labels.value("/library/a/sub/movie.mkv") == ColorLabel::Blue);
+    CHECK(database.getLabel(QStringList{"/library/ab/movie.mkv"}) == ColorLabel::Green);
+
+    // Overwrite and remove existing labels
+    database.setLabels({
+        {"/library/a/movie.mkv", ColorLabel::Yellow},
+        {"/library/a/sub/movie.mkv", ColorLabel::NoLabel},
+    });
+    labels = database.labelsInDirectory(DirectoryPath("/library/a"));
+    CHECK(labels.size() == 1);
+    CHECK(labels.value("/library/a/movie.mkv") == ColorLabel::Yellow);
+    CHECK(database.getLabel(QStringList{"/library/a/sub/movie.mkv"}) == ColorLabel::NoLabel);
+}
+
+/// \brief Size of the content column of all episodes as stored in the database.
+static qint64 storedEpisodeContentSize(Database& database)
+{
+    QSqlQuery query(database.db());
+    REQUIRE(query.exec("SELECT SUM(LENGTH(CAST(content AS BLOB))) FROM episodes"));
+    REQUIRE(query.next());
+    return query.value(0).toLongLong();
+}
+
+TEST_CASE("Database stores imports", "[database]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+
+    database.addImport("Movie.2000.mkv", "movie", DirectoryPath("/library/movies"));
+    database.addImport("Show.S01E01.mkv", "tvshow", DirectoryPath("/library/shows"));
+
+    QSqlQuery query(database.db());
+    REQUIRE(query.exec("SELECT id FROM importCache ORDER BY id"));
+    QVector<int> ids;
+    while (query.next()) {
+        ids << query.value(0).toInt();
+    }
+    REQUIRE(ids.size() == 2);
+    CHECK(ids.at(0) < ids.at(1));
+
+    QString type;
+    QString path;
+    REQUIRE(database.guessImport("Show.S01E02.mkv", type, path));
+    CHECK(type == "tvshow");
+    CHECK(path == "/library/shows");
+}
+
+TEST_CASE("Database stores NFO contents compressed", "[database]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+    const DirectoryPath path("/library");
+    constexpr int idShow = 1;
+
+    QString actors;
+    for (int i = 0; i < 50; ++i) {
+        actors += QStringLiteral("<actor><name>Actor %1</name><role>Role</role></actor>").arg(i);
+    }
+    const QString content = QStringLiteral("<episodedetails><title>Pilot</title>%1</episodedetails>").arg(actors);
+
+    QObject parent;
+    auto* episode = new TvShowEpisode(QStringList{"/library/Show/S01E01.mkv"}, &parent);
+    episode->setNfoContent(content);
+    auto* emptyEpisode = new TvShowEpisode(QStringList{"/library/Show/S01E02.mkv"}, &parent);
+
+    SECTION("new entries")
+    {
+        database.setCompressContent(true);
+        database.add(QVector<TvShowEpisode*>{episode, emptyEpisode}, path, idShow);
+        CHECK(storedEpisodeContentSize(database) < content.size() / 2);
+    }
+
+    SECTION("existing entries are rewritten when the database is compacted")
+    {
+        database.add(QVector<TvShowEpisode*>{episode, emptyEpisode}, path, idShow);
+        CHECK(storedEpisodeContentSize(database) == content.toUtf8().size());
+
+        database.setCompressContent(true);
+        database.compact();
+        CHECK(storedEpisodeContentSize(database) < content.size() / 2);
+
+        // and back again
+        database.setCompressContent(false);
+        database.compact();
+        CHECK(storedEpisodeContentSize(database) == content.toUtf8().size());
+    }
+
+    const QVector<TvShowEpisode*> episodes = database.episodes(idShow);
+    REQUIRE(episodes.size() == 2);
+    QStringList contents{episodes.at(0)->nfoContent(), episodes.at(1)->nfoContent()};
+    contents.sort();
+    CHECK(contents.at(0).isEmpty());
+    CHECK(contents.at(1) == content);
+    qDeleteAll(episodes);
+}
+
+TEST_CASE("Database stores episode lists of TV shows", "[database][tvshow]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+
+    TvShow show(DirectoryPath(dir.path() + "/show"));
+    const int showsSettingsId = database.showsSettingsId(&show);
+    CHECK_FALSE(database.episodeListUpdated(showsSettingsId).isValid());
+
+    const auto createEpisode = [&show](int season, int episodeNumber, int tmdbId) {
+        auto* episode = new TvShowEpisode(QStringList{}, &show);
+        episode->setSeason(SeasonNumber(season));
+        episode->setEpisode(EpisodeNumber(episodeNumber));
+        episode->setTmdbId(TmdbId(tmdbId));
+        return episode;
+    };
+
+    const QDateTime before = QDateTime::currentDateTimeUtc().addSecs(-1);
+    database.setEpisodeList(showsSettingsId, {createEpisode(1, 1, 101), createEpisode(1, 2, 102)});
+    CHECK(database.episodeListUpdated(showsSettingsId) >= before);
+    CHECK(database.showsEpisodes(&show).size() == 2);
+
+    // Episodes that are no longer part of the list are removed, existing ones are updated.
+    database.setEpisodeList(showsSettingsId, {createEpisode(2, 1, 102), createEpisode(2, 2, 103)});
+    const QVector<TvShowEpisode*> episodes = database.showsEpisodes(&show);
+    REQUIRE(episodes.size() == 2);
+    for (const TvShowEpisode* episode : episodes) {
+        CHECK(episode->seasonNumber() == SeasonNumber(2));
+    }
+}
+
+TEST_CASE("Database stores fingerprints of TV show directories", "[database][tvshow]")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    Database database(DirectoryPath(dir.path()));
+
+    const DirectoryPath library(dir.path() + "/shows");
+    const DirectoryPath otherLibrary(dir.path() + "/other");
+    CHECK(database.tvShowDirectoryFingerprints(library).isEmpty());
+
+    QHash<QString, DirectoryFingerprint> fingerprints;
+    fingerprints.insert(library.toString() + "/Show", DirectoryFingerprint{1600000000000, 3});
+    fingerprints.insert(library.toString() + "/Show/Season 1", DirectoryFingerprint{1600000001000, 10});
+    database.setTvShowDirectoryFingerprints(library, fingerprints);
+    database.setTvShowDirectoryFingerprints(otherLibrary, {{otherLibrary.toString() + "/Show", {1, 1}}});
+
+    CHECK(database.tvShowDirectoryFingerprints(library) == fingerprints);
+
+    // Fingerprints are replaced per library directory.
+    fingerprints.remove(library.toString() + "/Show/Season 1");
+    database.setTvShowDirectoryFingerprints(library, fingerprints);
+    CHECK(database.tvShowDirectoryFingerprints(library) == fingerprints);
+    CHECK(database.tvShowDirectoryFingerprints(otherLibrary).size() == 1);
+}
@@ -6,6 +6,7 @@
 
 #include <QApplication>
 #include <QDir>
+#include <QStandardPaths>
 #include <QtGlobal>
 
 int main(int argc, char** argv)
@@ -17,6 +18,10 @@ int main(int argc, char** argv)
     qSetGlobalQHashSeed(0);
 
     QApplication app(argc, argv);
+    // Loaders open their own database connections: Use a separate database,
+    // cache and settings location that does not contain results of older runs.
+    QStandardPaths::setTestModeEnabled(true);
+    QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).removeRecursively();
     registerAllMetaTypes();
     Catch::Session session; // NOLINT(clang-analyzer-core.uninitialized.UndefReturn)
 
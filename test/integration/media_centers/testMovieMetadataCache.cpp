@@ -0,0 +1,83 @@
+#include "test/test_helpers.h"
+
+#include "media_centers/KodiXml.h"
+#include "media_centers/kodi/MovieXmlWriter.h"
+#include "movies/MovieMetadataCache.h"
+#include "test/integration/resource_dir.h"
+
+#include <QDataStream>
+
+using namespace mediaelch;
+
+static QString movieXml(Movie& movie)
+{
+    kodi::MovieXmlWriterGeneric writer(KodiVersion(18), movie);
+    return writer.getMovieXml(true).trimmed();
+}
+
+TEST_CASE("MovieMetadataCache restores movies without parsing the NFO", "[movie][database][nfo]")
+{
+    const FileList files({"/movies/Movie (2000)/Movie (2000).mkv"});
+    KodiXml kodi;
+
+    const auto filename = GENERATE(as<QString>{},
+        "movie/kodi_v18_movie_all.nfo",
+        "movie/kodi_v18_movie_empty.nfo",
+        "movie/kodi_v18_Alien_1979.nfo",
+        "movie/kodi_v18_Toy_Story_3_2010.nfo");
+    CAPTURE(filename);
+
+    // Same as loading a movie from the database using its NFO content.
+    Movie original;
+    original.setFiles(files);
+    REQUIRE(kodi.loadMovie(&original, getFileContent(filename)));
+    const QByteArray blob = MovieMetadataCache::serialize(original);
+
+    Movie restored;
+    restored.setFiles(files);
+    REQUIRE(MovieMetadataCache::deserialize(blob, restored));
+
+    CHECK(movieXml(restored) == movieXml(original));
+    CHECK(restored.streamDetailsLoaded() == original.streamDetailsLoaded());
+    CHECK(restored.streamDetails()->audioDetails() == original.streamDetails()->audioDetails());
+    CHECK(restored.streamDetails()->subtitleDetails() == original.streamDetails()->subtitleDetails());
+    CHECK_FALSE(restored.hasChanged());
+
+    SECTION("loading the restored movie from the database does not parse it again")
+    {
+        const QString name = restored.name();
+        restored.controller()->loadData(&kodi, false, false);
+        CHECK(restored.name() == name);
+        CHECK(movieXml(restored) == movieXml(original));
+    }
+}
+
+TEST_CASE("MovieMetadataCache rejects invalid blobs", "[movie][database]")
+{
+    Movie source;
+    source.setName("Movie");
+    const QByteArray blob = MovieMetadataCache::serialize(source);
+
+    Movie movie;
+    movie.setName("Unchanged");
+
+    SECTION("empty blob, e.g. stored by an older version")
+    {
+        CHECK_FALSE(MovieMetadataCache::deserialize(QByteArray(), movie));
+    }
+    SECTION("truncated blob")
+    {
+        CHECK_FALSE(MovieMetadataCache::deserialize(blob.left(blob.size() / 2), movie));
+    }
+    SECTION("other format version")
+    {
+        QByteArray otherVersion = blob;
+        QDataStream out(&otherVersion, QIODevice::ReadWrite);
+        out.setVersion(QDataStream::Qt_5_12);
+        out.device()->seek(sizeof(quint32));
+        out << static_cast<quint16>(MovieMetadataCache::FormatVersion + 1);
+        CHECK_FALSE(MovieMetadataCache::deserialize(otherVersion, movie));
+    }
+
+    CHECK(movie.name() == "Unchanged");
+}
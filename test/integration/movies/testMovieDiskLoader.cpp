@@ -0,0 +1,201 @@
+#include "test/test_helpers.h"
+#include "test/helpers/scoped_settings.h"
+
+#include "globals/Manager.h"
+#include "movies/file_searcher/MovieDirectorySearcher.h"
+#include "movies/file_searcher/MovieFileSearcher.h"
+#include "settings/Settings.h"
+
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QMap>
+#include <QTemporaryDir>
+#include <QThreadPool>
+#include <atomic>
+
+using namespace mediaelch;
+
+static void createFile(const QString& path)
+{
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+}
+
+static SettingsDir movieDirectory(const QString& path)
+{
+    SettingsDir dir;
+    dir.path = QDir(path);
+    dir.separateFolders = true;
+    dir.autoReload = true;
+    return dir;
+}
+
+/// \brief Scan the given directory incrementally.
+/// \returns Database IDs of all loaded movies by their first file, relative to the directory.
+static QMap<QString, int> loadMovieIds(const SettingsDir& dir)
+{
+    MovieLoaderStore store;
+    MovieDiskLoader loader(dir, store, Settings::instance()->advanced()->movieFilters());
+    loader.setIncrementalScan(true);
+    loader.start();
+
+    QMap<QString, int> ids;
+    const QVector<Movie*> movies = store.takeAll(nullptr);
+    for (Movie* movie : movies) {
+        REQUIRE_FALSE(movie->files().isEmpty());
+        const QString file = movie->files().first().toString().mid(dir.path.path().length() + 1);
+        ids.insert(file, movie->databaseId());
+    }
+    qDeleteAll(movies);
+    return ids;
+}
+
+TEST_CASE("MovieDiskLoader only rescans changed directories", "[movie][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    createFile(root.filePath("Movie/Movie.mkv"));
+    createFile(root.filePath("BluRay Movie/BDMV/index.bdmv"));
+    createFile(root.filePath("DVD Movie/VIDEO_TS/VIDEO_TS.IFO"));
+
+    const SettingsDir dir = movieDirectory(root.path());
+    const QMap<QString, int> initial = loadMovieIds(dir);
+    REQUIRE(initial.keys()
+            == QStringList{"BluRay Movie/BDMV/index.bdmv", "DVD Movie/VIDEO_TS/VIDEO_TS.IFO", "Movie/Movie.mkv"});
+
+    SECTION("movies of unchanged directories are reused, including DVDs and BluRays")
+    {
+        CHECK(loadMovieIds(dir) == initial);
+    }
+
+    SECTION("DVDs are rescanned if the directory next to VIDEO_TS changed")
+    {
+        // Simulate a new NFO file next to VIDEO_TS: Only the parent directory's modification time changes.
+        Database* database = Manager::instance()->database();
+        const DirectoryPath libraryPath(dir.path);
+        QHash<QString, DirectoryFingerprint> fingerprints = database->movieDirectoryFingerprints(libraryPath);
+        const QString dvdDir = QDir::cleanPath(QFileInfo(root.filePath("DVD Movie")).absoluteFilePath());
+        REQUIRE(fingerprints.contains(dvdDir));
+        fingerprints[dvdDir].lastModified -= 1000;
+        database->setMovieDirectoryFingerprints(libraryPath, fingerprints);
+
+        const QMap<QString, int> ids = loadMovieIds(dir);
+        REQUIRE(ids.keys() == initial.keys());
+        CHECK(ids.value("Movie/Movie.mkv") == initial.value("Movie/Movie.mkv"));
+        CHECK(ids.value("BluRay Movie/BDMV/index.bdmv") == initial.value("BluRay Movie/BDMV/index.bdmv"));
+        CHECK(ids.value("DVD Movie/VIDEO_TS/VIDEO_TS.IFO") != initial.value("DVD Movie/VIDEO_TS/VIDEO_TS.IFO"));
+    }
+
+    SECTION("new directories are scanned and removed ones are removed from the database")
+    {
+        REQUIRE(QDir(root.filePath("Movie")).removeRecursively());
+        createFile(root.filePath("New Movie/New Movie.mkv"));
+
+        const QMap<QString, int> ids = loadMovieIds(dir);
+        CHECK(ids.keys()
+              == QStringList{
+                  "BluRay Movie/BDMV/index.bdmv", "DVD Movie/VIDEO_TS/VIDEO_TS.IFO", "New Movie/New Movie.mkv"});
+        CHECK(ids.value("DVD Movie/VIDEO_TS/VIDEO_TS.IFO") == initial.value("DVD Movie/VIDEO_TS/VIDEO_TS.IFO"));
+
+        const QVector<Movie*> cached =
+            Manager::instance()->database()->moviesInDirectory(DirectoryPath(dir.path), nullptr);
+        CHECK(cached.size() == 3);
+        qDeleteAll(cached);
+    }
+}
+
+TEST_CASE("MovieFileSearcher removes movies of old directories in incremental mode", "[movie][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    createFile(root.filePath("old/Movie/Movie.mkv"));
+    createFile(root.filePath("current/Movie/Movie.mkv"));
+
+    const SettingsDir oldDir = movieDirectory(root.filePath("old"));
+    const SettingsDir currentDir = movieDirectory(root.filePath("current"));
+    loadMovieIds(oldDir);
+    loadMovieIds(currentDir);
+
+    Database* database = Manager::instance()->database();
+    REQUIRE(database->movieLibraryPaths().contains(DirectoryPath(oldDir.path)));
+
+    const ScopedAdvancedSettings settings(R"xml(<advancedsettings>
+        <scanner><incrementalMovieScan>true</incrementalMovieScan></scanner>
+    </advancedsettings>)xml");
+
+    MovieFileSearcher searcher;
+    searcher.setMovieDirectories({currentDir});
+
+    QEventLoop loop;
+    bool finished = false;
+    QObject::connect(&searcher, &MovieFileSearcher::finished, &loop, [&]() {
+        finished = true;
+        loop.quit();
+    });
+    searcher.reload(true);
+    if (!finished) {
+        loop.exec();
+    }
+    Manager::instance()->movieModel()->clear();
+
+    const QVector<DirectoryPath> paths = database->movieLibraryPaths();
+    CHECK(paths.contains(DirectoryPath(currentDir.path)));
+    CHECK_FALSE(paths.contains(DirectoryPath(oldDir.path)));
+}
+
+TEST_CASE("MovieDiskLoader stops creating movies when aborted", "[movie]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    const int movieCount = 1000;
+    for (int i = 0; i < movieCount; ++i) {
+        createFile(root.filePath(QStringLiteral("Movie %1/Movie %1.mkv").arg(i)));
+    }
+
+    MovieLoaderStore store;
+    MovieDiskLoader loader(movieDirectory(root.path()), store, Settings::instance()->advanced()->movieFilters());
+
+    // Movies are created in parallel: Progress is reported by the worker threads.
+    const int abortAfter = 10;
+    std::atomic_int created{0};
+    std::atomic_int batchesAfterAbort{0};
+    QObject::connect(
+        &loader,
+        &MovieLoader::progress,
+        [&](MovieLoader* /*job*/, int processed, int /*total*/) {
+            if (processed > 0) {
+                ++created;
+            }
+            if (processed == abortAfter) {
+                loader.abort();
+            }
+        },
+        Qt::DirectConnection);
+    QObject::connect(
+        &loader,
+        &MovieLoader::moviesLoaded,
+        [&](MovieLoader* /*job*/) {
+            if (loader.isAborted()) {
+                ++batchesAfterAbort;
+            }
+        },
+        Qt::DirectConnection);
+    int finishedCount = 0;
+    QObject::connect(
+        &loader, &MovieLoader::finished, [&](MovieLoader* /*job*/) { ++finishedCount; }, Qt::DirectConnection);
+
+    loader.start();
+
+    CHECK(finishedCount == 1);
+    CHECK(batchesAfterAbort == 0);
+    // Only movies that were already being created when the loader was aborted are finished.
+    CHECK(created.load() <= abortAfter + QThreadPool::globalInstance()->maxThreadCount());
+    const QVector<Movie*> movies = store.takeAll(nullptr);
+    CHECK(movies.size() < movieCount);
+    qDeleteAll(movies);
+}
@@ -0,0 +1,206 @@
+#include "test/test_helpers.h"
+#include "test/helpers/scoped_settings.h"
+
+#include "globals/Manager.h"
+#include "movies/file_searcher/MovieFileSearcher.h"
+#include "settings/Settings.h"
+
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QPair>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+
+using namespace mediaelch;
+
+static void createFile(const QString& path)
+{
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+}
+
+TEST_CASE("MovieFileSearcher loads several directories concurrently", "[movie]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    // Directories with 5, 10 and 15 movies in separate folders.
+    QVector<SettingsDir> directories;
+    for (int i = 1; i <= 3; ++i) {
+        const QString path = root.filePath(QStringLiteral("movies%1").arg(i));
+        for (int movie = 0; movie < i * 5; ++movie) {
+            createFile(QStringLiteral("%1/Movie %2/Movie %2.mkv").arg(path).arg(movie));
+        }
+        SettingsDir dir;
+        dir.path = QDir(path);
+        dir.separateFolders = true;
+        directories << dir;
+    }
+
+    const ScopedAdvancedSettings settings(R"xml(<advancedsettings>
+        <scanner><concurrentMovieDirectories>3</concurrentMovieDirectories></scanner>
+    </advancedsettings>)xml");
+
+    MovieFileSearcher searcher;
+    searcher.setMovieDirectories(directories);
+
+    QStringList statusTexts;
+    QVector<QPair<int, int>> progress;
+    QObject::connect(&searcher, &MovieFileSearcher::statusChanged, [&](QString text) { statusTexts << text; });
+    QObject::connect(&searcher, &MovieFileSearcher::progress, [&](int current, int max, int /*messageBarId*/) {
+        progress << qMakePair(current, max);
+    });
+
+    QEventLoop loop;
+    bool finished = false;
+    QObject::connect(&searcher, &MovieFileSearcher::finished, &loop, [&]() {
+        finished = true;
+        loop.quit();
+    });
+
+    searcher.reload(true);
+    // All loaders are started right away, i.e. before any of them has finished.
+    CHECK(statusTexts.filter(QRegularExpression(R"(\(\d/3\))")).size() == 3);
+
+    if (!finished) {
+        loop.exec();
+    }
+
+    CHECK(Manager::instance()->movieModel()->movies().size() == 30);
+    Manager::instance()->movieModel()->clear();
+
+    REQUIRE_FALSE(progress.isEmpty());
+    for (const auto& value : asConst(progress)) {
+        CHECK(value.first <= value.second);
+        CHECK(value.second <= 30);
+    }
+    // Finished directories are still part of the combined progress.
+    CHECK(progress.last() == qMakePair(30, 30));
+}
+
+TEST_CASE("MovieFileSearcher aborts single directories", "[movie]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    // Directories with 5, 10 and 15 movies in separate folders.
+    QVector<SettingsDir> directories;
+    for (int i = 1; i <= 3; ++i) {
+        const QString path = root.filePath(QStringLiteral("movies%1").arg(i));
+        for (int movie = 0; movie < i * 5; ++movie) {
+            createFile(QStringLiteral("%1/Movie %2/Movie %2.mkv").arg(path).arg(movie));
+        }
+        SettingsDir dir;
+        dir.path = QDir(path);
+        dir.separateFolders = true;
+        directories << dir;
+    }
+    const DirectoryPath first(directories.at(0).path);
+    const DirectoryPath second(directories.at(1).path);
+    const DirectoryPath third(directories.at(2).path);
+
+    // Two directories are loaded at the same time, i.e. the third one is queued.
+    const ScopedAdvancedSettings settings(R"xml(<advancedsettings>
+        <scanner><concurrentMovieDirectories>2</concurrentMovieDirectories></scanner>
+    </advancedsettings>)xml");
+
+    MovieFileSearcher searcher;
+    searcher.setMovieDirectories(directories);
+
+    QEventLoop loop;
+    int finishedCount = 0;
+    QObject::connect(&searcher, &MovieFileSearcher::finished, &loop, [&]() {
+        ++finishedCount;
+        loop.quit();
+    });
+
+    searcher.reload(true);
+    REQUIRE(searcher.loadingDirectories().size() == 3);
+
+    SECTION("other directories are still loaded")
+    {
+        searcher.abortDirectory(second);
+        searcher.abortDirectory(third);
+        CHECK(searcher.loadingDirectories() == QVector<DirectoryPath>{first});
+        if (finishedCount == 0) {
+            loop.exec();
+        }
+
+        CHECK(finishedCount == 1);
+        CHECK(Manager::instance()->movieModel()->movies().size() == 5);
+    }
+
+    SECTION("queued directories are started if a running one is aborted")
+    {
+        searcher.abortDirectory(first);
+        if (finishedCount == 0) {
+            loop.exec();
+        }
+
+        CHECK(finishedCount == 1);
+        CHECK(Manager::instance()->movieModel()->movies().size() == 25);
+    }
+
+    SECTION("the search finishes if all directories are aborted")
+    {
+        searcher.abortDirectory(first);
+        searcher.abortDirectory(second);
+        searcher.abortDirectory(third);
+        if (finishedCount == 0) {
+            loop.exec();
+        }
+
+        CHECK(finishedCount == 1);
+        CHECK(Manager::instance()->movieModel()->movies().isEmpty());
+    }
+
+    CHECK(searcher.loadingDirectories().isEmpty());
+    Manager::instance()->movieModel()->clear();
+}
+
+TEST_CASE("MovieFileSearcher loads changed directories", "[movie]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString path = QDir::cleanPath(root.filePath("movies"));
+    for (int movie = 0; movie < 3; ++movie) {
+        createFile(QStringLiteral("%1/Movie %2/Movie %2.mkv").arg(path).arg(movie));
+    }
+    SettingsDir dir;
+    dir.path = QDir(path);
+    dir.separateFolders = true;
+
+    MovieFileSearcher searcher;
+    searcher.setMovieDirectories({dir});
+
+    MovieModel* model = Manager::instance()->movieModel();
+    {
+        QEventLoop loop;
+        QObject::connect(&searcher, &MovieFileSearcher::finished, &loop, &QEventLoop::quit);
+        searcher.reload(true);
+        loop.exec();
+    }
+    REQUIRE(model->movies().size() == 3);
+
+    // Same as reported by LibraryWatcher: The removed directory is not reported, but its parent is.
+    REQUIRE(QDir(path + "/Movie 1").removeRecursively());
+    createFile(path + "/Movie 3/Movie 3.mkv");
+    {
+        // New movies are added after removed ones are removed.
+        QEventLoop loop;
+        QObject::connect(model, &MovieModel::rowsInserted, &loop, &QEventLoop::quit);
+        searcher.loadNewMovies(DirectoryPath(path), {path, path + "/Movie 3"});
+        loop.exec();
+    }
+
+    QStringList files;
+    for (Movie* movie : model->movies()) {
+        files << movie->files().toStringList();
+    }
+    files.sort();
+    CHECK(files
+          == QStringList{path + "/Movie 0/Movie 0.mkv", path + "/Movie 2/Movie 2.mkv", path + "/Movie 3/Movie 3.mkv"});
+    model->clear();
+}
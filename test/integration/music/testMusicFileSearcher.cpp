@@ -0,0 +1,79 @@
+#include "test/test_helpers.h"
+
+#include "data/Database.h"
+#include "globals/Manager.h"
+#include "music/Album.h"
+#include "music/Artist.h"
+#include "music/MusicFileSearcher.h"
+
+#include <QDir>
+#include <QTemporaryDir>
+
+using namespace mediaelch;
+
+static QStringList albumTitles(const Artist& artist)
+{
+    QStringList titles;
+    for (const Album* album : artist.albums()) {
+        titles << album->title();
+    }
+    titles.sort();
+    return titles;
+}
+
+TEST_CASE("MusicFileSearcher updates changed directories", "[music]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = QDir::cleanPath(root.path());
+    REQUIRE(QDir().mkpath(rootPath + "/Artist A/Album 1"));
+    REQUIRE(QDir().mkpath(rootPath + "/Artist A/Album 2"));
+    REQUIRE(QDir().mkpath(rootPath + "/Artist B/Album 3"));
+
+    SettingsDir dir;
+    dir.path = QDir(rootPath);
+    MusicFileSearcher searcher;
+    searcher.setMusicDirectories({dir});
+    searcher.reload(true);
+
+    MusicModel* model = Manager::instance()->musicModel();
+    REQUIRE(model->artists().size() == 2);
+
+    // Same as reported by LibraryWatcher: Removed directories are not reported, but their parents are.
+    REQUIRE(QDir(rootPath + "/Artist A/Album 1").removeRecursively());
+    REQUIRE(QDir(rootPath + "/Artist B").removeRecursively());
+    REQUIRE(QDir().mkpath(rootPath + "/Artist A/Album 4"));
+    REQUIRE(QDir().mkpath(rootPath + "/Artist C/Album 5"));
+    searcher.updateArtists(DirectoryPath(rootPath),
+        {rootPath,
+            rootPath + "/Artist A",
+            rootPath + "/Artist A/Album 4",
+            rootPath + "/Artist C",
+            rootPath + "/Artist C/Album 5"});
+
+    QHash<QString, Artist*> artists;
+    for (Artist* artist : model->artists()) {
+        artists.insert(artist->name(), artist);
+    }
+    REQUIRE(artists.keys().size() == 2);
+    REQUIRE(artists.contains("Artist A"));
+    REQUIRE(artists.contains("Artist C"));
+    CHECK(albumTitles(*artists.value("Artist A")) == QStringList{"Album 2", "Album 4"});
+    CHECK(albumTitles(*artists.value("Artist C")) == QStringList{"Album 5"});
+    CHECK(artists.value("Artist C")->modelItem()->childCount() == 1);
+
+    // The database is updated as well, i.e. the next start shows the same artists.
+    Database* database = Manager::instance()->database();
+    const QVector<Artist*> stored = database->artistsInDirectory(DirectoryPath(rootPath));
+    CHECK(stored.size() == 2);
+    int storedAlbums = 0;
+    for (Artist* artist : stored) {
+        const QVector<Album*> albums = database->albums(artist);
+        storedAlbums += qsizetype_to_int(albums.size());
+        qDeleteAll(albums);
+    }
+    CHECK(storedAlbums == 3);
+    qDeleteAll(stored);
+
+    model->clear();
+}
@@ -0,0 +1,162 @@
+#include "test/test_helpers.h"
+
+#include "data/Database.h"
+#include "globals/Manager.h"
+#include "scrapers/tv_show/tmdb/TmdbTv.h"
+#include "tv_shows/EpisodeGuideRefresher.h"
+#include "tv_shows/TvShow.h"
+
+#include <QEventLoop>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace mediaelch;
+
+namespace {
+
+/// \brief Season scrape job without any episodes that finishes as soon as the event loop runs.
+class FakeSeasonScrapeJob : public scraper::SeasonScrapeJob
+{
+public:
+    FakeSeasonScrapeJob(Config config, std::function<void()> onFinished, QObject* parent) :
+        scraper::SeasonScrapeJob(std::move(config), parent), m_onFinished{std::move(onFinished)}
+    {
+    }
+
+    void start() override
+    {
+        QTimer::singleShot(0, this, [this]() {
+            m_onFinished();
+            emit sigFinished(this);
+        });
+    }
+
+private:
+    std::function<void()> m_onFinished;
+};
+
+/// \brief TMDb scraper that does not send any requests, but counts them.
+class FakeTmdbTv : public scraper::TmdbTv
+{
+public:
+    scraper::SeasonScrapeJob* loadSeasons(scraper::SeasonScrapeJob::Config config) override
+    {
+        ++requestCount;
+        ++runningRequests;
+        maxRunningRequests = qMax(maxRunningRequests, runningRequests);
+        if (onRequest) {
+            onRequest(requestCount);
+        }
+        return new FakeSeasonScrapeJob(config, [this]() { --runningRequests; }, this);
+    }
+
+    /// \brief Called with the number of requests so far for each new request.
+    std::function<void(int)> onRequest;
+    int requestCount = 0;
+    int runningRequests = 0;
+    int maxRunningRequests = 0;
+};
+
+} // namespace
+
+static std::unique_ptr<TvShow> createShow(const QString& name, int tmdbId)
+{
+    auto show = std::make_unique<TvShow>(DirectoryPath("/refresher/" + name));
+    if (tmdbId > 0) {
+        show->setTmdbId(TmdbId(tmdbId));
+    }
+    return show;
+}
+
+static void runRefresher(EpisodeGuideRefresher& refresher, const QVector<TvShow*>& shows)
+{
+    QEventLoop loop;
+    QObject::connect(&refresher, &EpisodeGuideRefresher::finished, &loop, &QEventLoop::quit);
+    refresher.refresh(shows);
+    loop.exec();
+}
+
+TEST_CASE("EpisodeGuideRefresher skips up-to-date episode guides", "[tvshow][database]")
+{
+    Database* database = Manager::instance()->database();
+    FakeTmdbTv tmdb;
+
+    auto upToDate = createShow("Up To Date", 1);
+    auto outdated = createShow("Outdated", 2);
+    auto withoutId = createShow("Without ID", 0);
+    database->setEpisodeList(database->showsSettingsId(upToDate.get()), {});
+    const QVector<TvShow*> shows{upToDate.get(), outdated.get(), withoutId.get()};
+
+    SECTION("guides younger than maxAgeHours are skipped")
+    {
+        EpisodeGuideRefresher refresher(&tmdb, database, {24, 4});
+        runRefresher(refresher, shows);
+
+        CHECK(tmdb.requestCount == 1);
+        CHECK(refresher.refreshedCount() == 1);
+        CHECK(refresher.skippedCount() == 2);
+        CHECK(refresher.failedCount() == 0);
+        CHECK(database->episodeListUpdated(database->showsSettingsId(outdated.get())).isValid());
+    }
+
+    SECTION("a maximum age of 0 refreshes all guides")
+    {
+        EpisodeGuideRefresher refresher(&tmdb, database, {0, 4});
+        runRefresher(refresher, shows);
+
+        CHECK(tmdb.requestCount == 2);
+        CHECK(refresher.refreshedCount() == 2);
+        // Shows without TMDb ID can't be refreshed.
+        CHECK(refresher.skippedCount() == 1);
+    }
+}
+
+TEST_CASE("EpisodeGuideRefresher limits the number of concurrent requests", "[tvshow][database]")
+{
+    FakeTmdbTv tmdb;
+    std::vector<std::unique_ptr<TvShow>> showStorage;
+    QVector<TvShow*> shows;
+    for (int i = 1; i <= 10; ++i) {
+        showStorage.push_back(createShow(QStringLiteral("Concurrent %1").arg(i), i));
+        shows.append(showStorage.back().get());
+    }
+
+    EpisodeGuideRefresher refresher(&tmdb, Manager::instance()->database(), {0, 3});
+    runRefresher(refresher, shows);
+
+    CHECK(tmdb.requestCount == 10);
+    CHECK(tmdb.maxRunningRequests == 3);
+    CHECK(tmdb.runningRequests == 0);
+    CHECK(refresher.refreshedCount() == 10);
+}
+
+TEST_CASE("EpisodeGuideRefresher skips shows that are deleted while refreshing", "[tvshow][database]")
+{
+    Database* database = Manager::instance()->database();
+    FakeTmdbTv tmdb;
+    auto first = createShow("Deleted First", 1);
+    auto running = createShow("Deleted Running", 2);
+    auto queued = createShow("Deleted Queued", 3);
+    const QVector<TvShow*> shows{first.get(), running.get(), queued.get()};
+
+    tmdb.onRequest = [&](int request) {
+        if (request == 1) {
+            // Shows may be deleted while they are waiting, e.g. by a reload...
+            queued.reset();
+        } else if (request == 2) {
+            // ...or while their guide is loaded.
+            running.reset();
+        }
+    };
+
+    // One request at a time, so that the last show is still queued during the first request.
+    EpisodeGuideRefresher refresher(&tmdb, database, {0, 1});
+    runRefresher(refresher, shows);
+
+    CHECK(tmdb.requestCount == 2);
+    CHECK(refresher.refreshedCount() == 1);
+    CHECK(refresher.skippedCount() == 2);
+    CHECK(database->episodeListUpdated(database->showsSettingsId(first.get())).isValid());
+}
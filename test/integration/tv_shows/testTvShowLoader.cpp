@@ -0,0 +1,457 @@
+#include "test/test_helpers.h"
+#include "test/helpers/scoped_settings.h"
+
+#include "data/Database.h"
+#include "globals/Manager.h"
+#include "settings/Settings.h"
+#include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
+#include "tv_shows/TvShowFileSearcher.h"
+#include "tv_shows/TvShowLoader.h"
+
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QMap>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <numeric>
+
+using namespace mediaelch;
+
+static void createFile(const QString& path)
+{
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+}
+
+static SettingsDir tvShowDirectory(const QString& path)
+{
+    SettingsDir dir;
+    dir.path = QDir(path);
+    dir.autoReload = true;
+    return dir;
+}
+
+/// \brief Normalized absolute path as used for show directories.
+static QString cleanPath(const QString& path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+/// \brief Names of the given shows' directories.
+static QStringList showNames(const QVector<TvShow*>& shows)
+{
+    QStringList names;
+    for (TvShow* show : shows) {
+        names << show->dir().dirName();
+    }
+    names.sort();
+    return names;
+}
+
+/// \brief Number of episodes of the show with the given directory name.
+static int episodeCount(const QVector<TvShow*>& shows, const QString& name)
+{
+    for (TvShow* show : shows) {
+        if (show->dir().dirName() == name) {
+            return qsizetype_to_int(show->episodes().size());
+        }
+    }
+    return -1;
+}
+
+TEST_CASE("TvShowLoader loads all shows", "[tvshow][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+
+    createFile(rootPath + "/Show A/S01E01.mkv");
+    createFile(rootPath + "/Show A/S01E02.mkv");
+    createFile(rootPath + "/Show A/Season 2/S02E01.mkv");
+    createFile(rootPath + "/Show B/S01E01E02.mkv");
+    createFile(rootPath + "/Show B/S01E01-trailer.mkv");
+
+    SettingsDir dir = tvShowDirectory(rootPath);
+    dir.autoReload = false;
+
+    {
+        // Shows of directories without shows in the database are always read from disk.
+        TvShowLoaderStore store;
+        TvShowLoader loader({dir}, false, store);
+        loader.start();
+
+        const QVector<TvShow*> shows = store.takeAll(nullptr);
+        CHECK(showNames(shows) == QStringList{"Show A", "Show B"});
+        CHECK(episodeCount(shows, "Show A") == 3);
+        // One file with two episodes; trailers are ignored.
+        CHECK(episodeCount(shows, "Show B") == 2);
+        qDeleteAll(shows);
+    }
+
+    // All shows are stored in the database...
+    CHECK(Manager::instance()->database()->showCount(DirectoryPath(rootPath)) == 2);
+
+    {
+        // ...and read from it next time.
+        createFile(rootPath + "/Show C/S01E01.mkv");
+        TvShowLoaderStore store;
+        TvShowLoader loader({dir}, false, store);
+        loader.start();
+
+        const QVector<TvShow*> shows = store.takeAll(nullptr);
+        CHECK(showNames(shows) == QStringList{"Show A", "Show B"});
+        CHECK(episodeCount(shows, "Show A") == 3);
+        CHECK(episodeCount(shows, "Show B") == 2);
+        qDeleteAll(shows);
+    }
+
+    Manager::instance()->database()->clearTvShowsInDirectory(DirectoryPath(rootPath));
+}
+
+TEST_CASE("TvShowLoader loads shows of the database in parallel", "[tvshow][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+
+    const int showCount = 45;
+    for (int i = 0; i < showCount; ++i) {
+        createFile(rootPath + QStringLiteral("/Show %1/S01E01.mkv").arg(i));
+        createFile(rootPath + QStringLiteral("/Show %1/S01E02.mkv").arg(i));
+        createFile(rootPath + QStringLiteral("/Show %1/S02E01.mkv").arg(i));
+    }
+
+    SettingsDir dir = tvShowDirectory(rootPath);
+    dir.autoReload = false;
+    {
+        // Initial load from disk
+        TvShowLoaderStore store;
+        TvShowLoader loader({dir}, false, store);
+        loader.start();
+        qDeleteAll(store.takeAll(nullptr));
+    }
+    REQUIRE(Manager::instance()->database()->showCount(DirectoryPath(rootPath)) == showCount);
+
+    TvShowLoaderStore store;
+    TvShowLoader loader({dir}, false, store);
+
+    SECTION("all shows and episodes are loaded")
+    {
+        int processed = 0;
+        int total = 0;
+        QObject::connect(
+            &loader,
+            &TvShowLoader::progress,
+            [&](TvShowLoader* /*job*/, int p, int t) {
+                processed = p;
+                total = t;
+            },
+            Qt::DirectConnection);
+        loader.start();
+
+        const QVector<TvShow*> shows = store.takeAll(nullptr);
+        CHECK(shows.size() == showCount);
+        for (TvShow* show : shows) {
+            REQUIRE(show->episodes().size() == 3);
+            CHECK(show->seasons() == QVector<SeasonNumber>{SeasonNumber(1), SeasonNumber(2)});
+            for (TvShowEpisode* episode : show->episodes()) {
+                CHECK(episode->tvShow() == show);
+            }
+        }
+        CHECK(processed == total);
+        qDeleteAll(shows);
+    }
+
+    SECTION("shows that were not published are discarded if aborted")
+    {
+        QObject::connect(
+            &loader, &TvShowLoader::showsLoaded, [&](TvShowLoader* /*job*/) { loader.abort(); }, Qt::DirectConnection);
+        int finishedCount = 0;
+        QObject::connect(
+            &loader, &TvShowLoader::finished, [&](TvShowLoader* /*job*/) { ++finishedCount; }, Qt::DirectConnection);
+        loader.start();
+
+        CHECK(finishedCount == 1);
+        const QVector<TvShow*> shows = store.takeAll(nullptr);
+        CHECK(shows.size() < showCount);
+        qDeleteAll(shows);
+    }
+
+    Manager::instance()->database()->clearTvShowsInDirectory(DirectoryPath(rootPath));
+}
+
+TEST_CASE("TvShowLoader publishes shows in batches", "[tvshow]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+
+    const int showCount = 45;
+    for (int i = 0; i < showCount; ++i) {
+        createFile(rootPath + QStringLiteral("/Show %1/S01E01.mkv").arg(i));
+    }
+
+    TvShowLoaderStore store;
+    TvShowLoader loader({tvShowDirectory(rootPath)}, true, store);
+    QVector<int> batches;
+    QObject::connect(
+        &loader,
+        &TvShowLoader::showsLoaded,
+        [&](TvShowLoader* /*job*/) {
+            const QVector<TvShow*> shows = store.takeAll(nullptr);
+            batches << qsizetype_to_int(shows.size());
+            qDeleteAll(shows);
+        },
+        Qt::DirectConnection);
+    int finishedCount = 0;
+    QObject::connect(
+        &loader, &TvShowLoader::finished, [&](TvShowLoader* /*job*/) { ++finishedCount; }, Qt::DirectConnection);
+    loader.start();
+
+    CHECK(finishedCount == 1);
+    // Batches are published if they are large enough or after some time.
+    CHECK(batches.size() >= 3);
+    CHECK(std::accumulate(batches.cbegin(), batches.cend(), 0) == showCount);
+    CHECK(std::all_of(batches.cbegin(), batches.cend(), [](int size) { return size > 0 && size <= 20; }));
+    CHECK(store.takeAll(nullptr).isEmpty());
+}
+
+/// \brief Load the given directory incrementally.
+/// \returns Database IDs of all loaded shows by their directory name.
+static QMap<QString, int> loadShowIds(const SettingsDir& dir)
+{
+    TvShowLoaderStore store;
+    TvShowLoader loader({dir}, false, store);
+    loader.setIncrementalScan(true);
+    loader.start();
+
+    QMap<QString, int> ids;
+    const QVector<TvShow*> shows = store.takeAll(nullptr);
+    for (TvShow* show : shows) {
+        ids.insert(show->dir().dirName(), show->databaseId());
+    }
+    qDeleteAll(shows);
+    return ids;
+}
+
+TEST_CASE("TvShowLoader only rescans changed shows", "[tvshow][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+
+    createFile(rootPath + "/Show A/S01E01.mkv");
+    createFile(rootPath + "/Show A/Season 2/S02E01.mkv");
+    createFile(rootPath + "/Show B/S01E01.mkv");
+
+    const SettingsDir dir = tvShowDirectory(rootPath);
+    const DirectoryPath libraryPath(rootPath);
+    Database* database = Manager::instance()->database();
+    const QMap<QString, int> initial = loadShowIds(dir);
+    REQUIRE(initial.keys() == QStringList{"Show A", "Show B"});
+
+    SECTION("unchanged shows are reused")
+    {
+        CHECK(loadShowIds(dir) == initial);
+    }
+
+    SECTION("shows are rescanned if a directory was modified")
+    {
+        QHash<QString, DirectoryFingerprint> fingerprints = database->tvShowDirectoryFingerprints(libraryPath);
+        const QString seasonDir = rootPath + "/Show A/Season 2";
+        REQUIRE(fingerprints.contains(seasonDir));
+        fingerprints[seasonDir].lastModified -= 1000;
+        database->setTvShowDirectoryFingerprints(libraryPath, fingerprints);
+
+        const QMap<QString, int> ids = loadShowIds(dir);
+        REQUIRE(ids.keys() == initial.keys());
+        CHECK(ids.value("Show A") != initial.value("Show A"));
+        CHECK(ids.value("Show B") == initial.value("Show B"));
+    }
+
+    SECTION("shows are rescanned if the number of episode files changed")
+    {
+        // Simulate a directory whose modification time did not change, e.g. a copy with
+        // preserved timestamps: Only the stored number of files differs from the disk.
+        QHash<QString, DirectoryFingerprint> fingerprints = database->tvShowDirectoryFingerprints(libraryPath);
+        const QString showDir = rootPath + "/Show B";
+        REQUIRE(fingerprints.contains(showDir));
+        CHECK(fingerprints.value(showDir).entryCount == 1);
+        fingerprints[showDir].entryCount = 2;
+        database->setTvShowDirectoryFingerprints(libraryPath, fingerprints);
+
+        const QMap<QString, int> ids = loadShowIds(dir);
+        REQUIRE(ids.keys() == initial.keys());
+        CHECK(ids.value("Show A") == initial.value("Show A"));
+        CHECK(ids.value("Show B") != initial.value("Show B"));
+    }
+
+    SECTION("new shows are scanned and removed ones are removed from the database")
+    {
+        REQUIRE(QDir(rootPath + "/Show B").removeRecursively());
+        createFile(rootPath + "/Show C/S01E01.mkv");
+
+        const QMap<QString, int> ids = loadShowIds(dir);
+        CHECK(ids.keys() == QStringList{"Show A", "Show C"});
+        CHECK(ids.value("Show A") == initial.value("Show A"));
+        CHECK(database->showCount(libraryPath) == 2);
+        CHECK_FALSE(database->tvShowDirectoryFingerprints(libraryPath).contains(rootPath + "/Show B"));
+    }
+
+    database->clearTvShowsInDirectory(libraryPath);
+    database->setTvShowDirectoryFingerprints(libraryPath, {});
+}
+
+TEST_CASE("TvShowFileSearcher removes cached shows of old directories", "[tvshow][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString keptPath = cleanPath(root.path()) + "/kept";
+    const QString removedPath = cleanPath(root.path()) + "/removed";
+    createFile(keptPath + "/Show A/S01E01.mkv");
+    createFile(removedPath + "/Show B/S01E01.mkv");
+
+    const DirectoryPath keptLibrary(keptPath);
+    const DirectoryPath removedLibrary(removedPath);
+    Database* database = Manager::instance()->database();
+    loadShowIds(tvShowDirectory(keptPath));
+    loadShowIds(tvShowDirectory(removedPath));
+    REQUIRE(database->showCount(removedLibrary) == 1);
+    REQUIRE_FALSE(database->tvShowDirectoryFingerprints(removedLibrary).isEmpty());
+
+    const ScopedAdvancedSettings settings(R"xml(<advancedsettings>
+        <scanner><incrementalTvShowScan>true</incrementalTvShowScan></scanner>
+    </advancedsettings>)xml");
+
+    // The second directory was removed from the settings.
+    TvShowFileSearcher searcher;
+    searcher.setTvShowDirectories({tvShowDirectory(keptPath)});
+    QEventLoop loop;
+    QObject::connect(&searcher, &TvShowFileSearcher::tvShowsLoaded, &loop, &QEventLoop::quit);
+    searcher.reload(true);
+    loop.exec();
+
+    CHECK(Manager::instance()->tvShowModel()->tvShows().size() == 1);
+    CHECK(database->showCount(keptLibrary) == 1);
+    CHECK(database->showCount(removedLibrary) == 0);
+    CHECK(database->tvShowDirectoryFingerprints(removedLibrary).isEmpty());
+    CHECK_FALSE(database->tvShowLibraryPaths().contains(removedLibrary));
+
+    Manager::instance()->tvShowModel()->clear();
+    database->clearTvShowsInDirectory(keptLibrary);
+    database->setTvShowDirectoryFingerprints(keptLibrary, {});
+}
+
+TEST_CASE("TvShowLoader only loads changed shows of an update", "[tvshow][database]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+
+    createFile(rootPath + "/Show A/S01E01.mkv");
+    createFile(rootPath + "/Show B/S01E01.mkv");
+    createFile(rootPath + "/Show C/S01E01.mkv");
+
+    TvShowUpdate update;
+    update.libraryPath = DirectoryPath(rootPath);
+    update.showDirs = {rootPath + "/Show A", rootPath + "/Show B"};
+    update.scanLibrary = true;
+    // Show A is unchanged, Show B has a new episode, Show C is new and "Removed" no longer exists.
+    update.loadedFiles.insert(rootPath + "/Show A", {rootPath + "/Show A/S01E01.mkv"});
+    update.loadedFiles.insert(rootPath + "/Show B", {});
+    update.loadedFiles.insert(rootPath + "/Removed", {rootPath + "/Removed/S01E01.mkv"});
+
+    TvShowLoaderStore store;
+    TvShowLoader loader({tvShowDirectory(rootPath)}, true, store);
+    loader.setUpdate(update);
+    loader.start();
+
+    const QVector<TvShow*> shows = store.takeAll(nullptr);
+    CHECK(showNames(shows) == QStringList{"Show B", "Show C"});
+    REQUIRE(loader.removedShows().size() == 1);
+    CHECK(loader.removedShows().first() == DirectoryPath(rootPath + "/Removed"));
+    qDeleteAll(shows);
+}
+
+TEST_CASE("TvShowFileSearcher updates shows in a background thread", "[tvshow]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+    createFile(rootPath + "/Show/S01E01.mkv");
+    createFile(rootPath + "/Show/S01E02.mkv");
+
+    TvShowFileSearcher searcher;
+    searcher.setTvShowDirectories({tvShowDirectory(rootPath)});
+
+    QEventLoop loop;
+    bool finished = false;
+    QObject::connect(&searcher, &TvShowFileSearcher::tvShowsLoaded, &loop, [&]() {
+        finished = true;
+        loop.quit();
+    });
+
+    searcher.updateShows(DirectoryPath(rootPath), {rootPath, rootPath + "/Show"});
+    // The show is loaded by a worker thread, i.e. not before the event loop runs.
+    CHECK_FALSE(finished);
+    CHECK(Manager::instance()->tvShowModel()->tvShows().isEmpty());
+    if (!finished) {
+        loop.exec();
+    }
+
+    const QVector<TvShow*> shows = Manager::instance()->tvShowModel()->tvShows();
+    REQUIRE(shows.size() == 1);
+    CHECK(shows.first()->episodes().size() == 2);
+    Manager::instance()->tvShowModel()->clear();
+}
+
+TEST_CASE("TvShowFileSearcher discards the results of outdated loaders", "[tvshow]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = cleanPath(root.path());
+
+    const int showCount = 30;
+    for (int i = 0; i < showCount; ++i) {
+        createFile(rootPath + QStringLiteral("/Show %1/S01E01.mkv").arg(i));
+    }
+
+    TvShowFileSearcher searcher;
+    searcher.setTvShowDirectories({tvShowDirectory(rootPath)});
+
+    QEventLoop loop;
+    int loadedCount = 0;
+    QObject::connect(&searcher, &TvShowFileSearcher::tvShowsLoaded, &loop, [&]() {
+        ++loadedCount;
+        loop.quit();
+    });
+
+    SECTION("reload")
+    {
+        // The first loader is aborted; none of its shows end up in the model.
+        searcher.reload(true);
+        searcher.reload(true);
+        loop.exec();
+
+        CHECK(loadedCount == 1);
+        CHECK(Manager::instance()->tvShowModel()->tvShows().size() == showCount);
+    }
+
+    SECTION("update")
+    {
+        searcher.updateShows(DirectoryPath(rootPath), {rootPath});
+        searcher.abort();
+        // The aborted update must not publish its shows.
+        searcher.reload(true);
+        loop.exec();
+
+        CHECK(loadedCount == 1);
+        CHECK(Manager::instance()->tvShowModel()->tvShows().size() == showCount);
+    }
+
+    Manager::instance()->tvShowModel()->clear();
+    Manager::instance()->database()->clearTvShowsInDirectory(DirectoryPath(rootPath));
+}
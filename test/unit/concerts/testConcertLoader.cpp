@@ -0,0 +1,45 @@
+#include "test/test_helpers.h"
+
+#include "concerts/ConcertLoader.h"
+
+using namespace mediaelch;
+
+TEST_CASE("ConcertLoader groups concert files", "[concert]")
+{
+    QVector<QStringList> contents;
+
+    SECTION("multi-part files belong to one concert")
+    {
+        const QStringList files{"Live-cd2.mkv",
+            "Live-cd1.mkv",
+            "Other Live.mkv",
+            "Tour part_1.avi",
+            "Tour part_2.avi",
+            "Tour part_1.mkv"};
+        ConcertLoader::addConcertFiles("/concerts", files, contents, false);
+
+        const QVector<QStringList> expected{
+            {"/concerts/Live-cd1.mkv", "/concerts/Live-cd2.mkv"},
+            {"/concerts/Other Live.mkv"},
+            {"/concerts/Tour part_1.avi", "/concerts/Tour part_2.avi"},
+            {"/concerts/Tour part_1.mkv"},
+        };
+        CHECK(contents == expected);
+    }
+
+    SECTION("all files of separate folders are one concert")
+    {
+        ConcertLoader::addConcertFiles("/concerts/Live", {"b.mkv", "a.mkv"}, contents, true);
+        CHECK(contents == QVector<QStringList>{{"/concerts/Live/a.mkv", "/concerts/Live/b.mkv"}});
+    }
+
+    SECTION("many multi-part files")
+    {
+        QStringList files;
+        for (int i = 0; i < 20000; ++i) {
+            files << QStringLiteral("Concert %1 - CD%2.mkv").arg(i / 2).arg(i % 2 + 1);
+        }
+        ConcertLoader::addConcertFiles("/concerts", files, contents, false);
+        CHECK(contents.size() == 10000);
+    }
+}
@@ -0,0 +1,82 @@
+#include "test/test_helpers.h"
+
+#include "data/TrigramIndex.h"
+#include "globals/Helper.h"
+
+#include <random>
+
+using namespace mediaelch;
+
+/// \brief Random variation of the given text with up to \p edits random edits.
+static QString mutate(QString text, int edits, std::mt19937& random)
+{
+    const QString alphabet = "abcde.-_ 0123";
+    std::uniform_int_distribution<int> operation(0, 2);
+    std::uniform_int_distribution<int> character(0, static_cast<int>(alphabet.size()) - 1);
+    for (int i = 0; i < edits; ++i) {
+        const int position = std::uniform_int_distribution<int>(0, static_cast<int>(text.size()))(random);
+        const QChar c = alphabet.at(character(random));
+        switch (operation(random)) {
+        case 0: text.insert(position, c); break;
+        case 1:
+            if (position < text.size()) {
+                text.remove(position, 1);
+            }
+            break;
+        default:
+            if (position < text.size()) {
+                text[position] = c;
+            }
+            break;
+        }
+    }
+    return text;
+}
+
+TEST_CASE("TrigramIndex", "[data]")
+{
+    SECTION("finds identical and similar texts")
+    {
+        TrigramIndex index;
+        CHECK(index.add("The.Movie.2010.1080p.BluRay") == 0);
+        CHECK(index.add("Another.Show.S01E01.720p") == 1);
+        CHECK(index.add("The.Movie.2010.720p.BluRay") == 2);
+        CHECK(index.size() == 3);
+
+        CHECK(index.candidates("The.Movie.2010.1080p.BluRay", 0.7) == QVector<int>{0, 2});
+        CHECK(index.candidates("Another.Show.S01E02.720p", 0.7) == QVector<int>{1});
+        CHECK(index.candidates("Something completely different", 0.7).isEmpty());
+
+        index.clear();
+        CHECK(index.size() == 0);
+        CHECK(index.candidates("The.Movie.2010.1080p.BluRay", 0.7).isEmpty());
+    }
+
+    SECTION("does not lose matches compared to helper::similarity()")
+    {
+        std::mt19937 random(42); // NOLINT(cert-msc32-c,cert-msc51-cpp): deterministic on purpose
+        const QStringList bases{"Movie.2010.1080p", "abc", "Some Show - S01E01", "a", "The_Concert_Live_2019.mkv"};
+
+        TrigramIndex index;
+        QStringList texts;
+        for (int i = 0; i < 500; ++i) {
+            const QString& base = bases.at(i % bases.size());
+            const QString text = mutate(base, i % 6, random);
+            texts << text;
+            index.add(text);
+        }
+
+        for (const double minSimilarity : {0.7, 0.5, 0.2}) {
+            for (int i = 0; i < 100; ++i) {
+                const QString query = mutate(bases.at(i % bases.size()), i % 4, random);
+                const QVector<int> candidates = index.candidates(query, minSimilarity);
+                for (int id = 0; id < texts.size(); ++id) {
+                    if (helper::similarity(query, texts.at(id)) > minSimilarity) {
+                        CAPTURE(query, texts.at(id), minSimilarity);
+                        CHECK(candidates.contains(id));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,114 @@
+#include "test/test_helpers.h"
+
+#include "file/DirectorySnapshot.h"
+#include "file/FileFilter.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+
+using namespace mediaelch;
+
+TEST_CASE("DirectorySnapshot", "[file]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    const auto createFile = [&root](const QString& name) {
+        QFile file(root.filePath(name));
+        REQUIRE(file.open(QIODevice::WriteOnly));
+    };
+    createFile("movie.mkv");
+    createFile("movie.nfo");
+
+    SECTION("answers from the snapshot for captured directories")
+    {
+        DirectorySnapshot snapshot;
+        snapshot.addDirectory(root.path(), QDir(root.path()).entryInfoList(QDir::Files));
+
+        // Files created after the snapshot was taken are not known.
+        createFile("poster.jpg");
+
+        CHECK(snapshot.containsDirectory(root.path()));
+        CHECK(snapshot.containsDirectory(root.path() + "/"));
+        CHECK(snapshot.fileExists(root.path(), "movie.nfo"));
+        CHECK(snapshot.fileExists(root.filePath("movie.mkv")));
+        CHECK_FALSE(snapshot.fileExists(root.path(), "poster.jpg"));
+        CHECK(snapshot.files(root.path()).size() == 2);
+    }
+
+    SECTION("files are sorted by name")
+    {
+        createFile("B.srt");
+        createFile("a.srt");
+
+        QFileInfoList files = QDir(root.path()).entryInfoList(QDir::Files);
+        std::reverse(files.begin(), files.end());
+        DirectorySnapshot snapshot;
+        snapshot.addDirectory(root.path(), files);
+
+        QStringList fileNames;
+        for (const QFileInfo& file : snapshot.files(root.path())) {
+            fileNames << file.fileName();
+        }
+        CHECK(fileNames == QStringList{"a.srt", "B.srt", "movie.mkv", "movie.nfo"});
+    }
+
+    SECTION("directories are removed once all users released them")
+    {
+        QDir(root.path()).mkdir("unused");
+        DirectorySnapshot snapshot;
+        snapshot.addDirectory(root.path(), QDir(root.path()).entryInfoList(QDir::Files));
+        snapshot.addDirectory(root.filePath("unused"), {});
+
+        snapshot.retain(root.path());
+        snapshot.retain(root.path());
+        snapshot.removeUnretained();
+        CHECK_FALSE(snapshot.containsDirectory(root.filePath("unused")));
+        CHECK(snapshot.containsDirectory(root.path()));
+
+        snapshot.release(root.path());
+        CHECK(snapshot.containsDirectory(root.path()));
+        snapshot.release(root.path());
+        CHECK_FALSE(snapshot.containsDirectory(root.path()));
+        // Released directories are checked on disk.
+        CHECK(snapshot.fileExists(root.path(), "movie.nfo"));
+    }
+
+    SECTION("file names that only differ in case are checked on disk")
+    {
+        createFile("Poster.JPG");
+        DirectorySnapshot snapshot;
+        snapshot.addDirectory(root.path(), QDir(root.path()).entryInfoList(QDir::Files));
+
+        CHECK(snapshot.fileExists(root.path(), "Poster.JPG"));
+        CHECK(snapshot.fileExists(root.path(), "movie.nfo"));
+        // Same result as the file system, which may be case insensitive, e.g. SMB shares.
+        CHECK(snapshot.fileExists(root.path(), "poster.jpg") == QFileInfo(root.filePath("poster.jpg")).isFile());
+        CHECK(snapshot.fileExists(root.path(), "MOVIE.NFO") == QFileInfo(root.filePath("MOVIE.NFO")).isFile());
+        CHECK_FALSE(snapshot.fileExists(root.path(), "Fanart.JPG"));
+    }
+
+    SECTION("falls back to the file system for unknown directories")
+    {
+        DirectorySnapshot snapshot;
+        CHECK_FALSE(snapshot.containsDirectory(root.path()));
+        CHECK(snapshot.fileExists(root.path(), "movie.nfo"));
+        CHECK_FALSE(snapshot.fileExists(root.path(), "fanart.jpg"));
+        CHECK(snapshot.files(root.path()).size() == 2);
+    }
+}
+
+TEST_CASE("FileFilter matches file names", "[file]")
+{
+    const FileFilter filter({"*.mkv", "VIDEO_TS.IFO", "*.m?v"});
+
+    CHECK(filter.isFileMatched("movie.mkv"));
+    CHECK(filter.isFileMatched("MOVIE.MKV"));
+    CHECK(filter.isFileMatched("video_ts.ifo"));
+    CHECK(filter.isFileMatched("movie.m4v"));
+    CHECK_FALSE(filter.isFileMatched("movie.mkv.nfo"));
+    CHECK_FALSE(filter.isFileMatched("movie.avi"));
+    CHECK_FALSE(FileFilter().isFileMatched("movie.mkv"));
+}
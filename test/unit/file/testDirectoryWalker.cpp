@@ -0,0 +1,89 @@
+#include "test/test_helpers.h"
+
+#include "file/DirectoryWalker.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+
+using namespace mediaelch;
+
+static void createFile(const QString& path)
+{
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+}
+
+TEST_CASE("DirectoryWalker", "[file]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+
+    createFile(root.filePath("movie.mkv"));
+    createFile(root.filePath("movie.nfo"));
+    createFile(root.filePath("A/a.mkv"));
+    createFile(root.filePath("A/extras/trailer.mkv"));
+    createFile(root.filePath("A/extras/nested/deep.mkv"));
+    createFile(root.filePath("B/C/c.avi"));
+
+    const FileFilter filter({"*.mkv", "*.avi"});
+
+    SECTION("visits all directories and filters files")
+    {
+        QStringList files;
+        int directories = 0;
+        DirectoryWalker walker(filter, nullptr);
+        const bool completed = walker.walk(root.path(), [&](const QFileInfo&, const QFileInfoList& entries) {
+            ++directories;
+            for (const QFileInfo& entry : entries) {
+                files << entry.filePath().mid(root.path().length());
+            }
+            return true;
+        });
+        files.sort();
+
+        CHECK(completed);
+        CHECK(directories == 6);
+        CHECK(files
+              == QStringList{
+                  "/A/a.mkv", "/A/extras/nested/deep.mkv", "/A/extras/trailer.mkv", "/B/C/c.avi", "/movie.mkv"});
+    }
+
+    SECTION("never enters excluded directories")
+    {
+        QStringList visited;
+        DirectoryWalker walker(filter, [&](const QFileInfo& dir) { return dir.fileName() != "extras"; });
+        walker.walk(root.path(), [&](const QFileInfo& dir, const QFileInfoList&) {
+            visited << dir.filePath().mid(root.path().length());
+            return true;
+        });
+        visited.sort();
+
+        CHECK(visited == QStringList{"", "/A", "/B", "/B/C"});
+    }
+
+    SECTION("without file filter only directories are walked")
+    {
+        bool hasFiles = false;
+        DirectoryWalker walker(FileFilter(), nullptr);
+        walker.walk(root.path(), [&](const QFileInfo&, const QFileInfoList& entries) {
+            hasFiles = hasFiles || !entries.isEmpty();
+            return true;
+        });
+        CHECK_FALSE(hasFiles);
+    }
+
+    SECTION("visitor can stop the walk")
+    {
+        int directories = 0;
+        DirectoryWalker walker(filter, nullptr);
+        const bool completed = walker.walk(root.path(), [&](const QFileInfo&, const QFileInfoList&) {
+            ++directories;
+            return false;
+        });
+        CHECK_FALSE(completed);
+        CHECK(directories == 1);
+    }
+}
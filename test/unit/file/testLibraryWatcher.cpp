@@ -0,0 +1,114 @@
+#include "test/test_helpers.h"
+
+#include "file/LibraryWatcher.h"
+
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+
+using namespace mediaelch;
+
+/// \brief Run the event loop until the watcher's current scan has finished.
+/// \returns All directories that were reported as changed in the meantime.
+static QStringList waitForScan(LibraryWatcher& watcher)
+{
+    QStringList changed;
+    QEventLoop loop;
+    QObject::connect(&watcher, &LibraryWatcher::directoriesChanged, &loop, [&](DirectoryPath, QStringList dirs) {
+        changed << dirs;
+    });
+    QObject::connect(&watcher, &LibraryWatcher::scanFinished, &loop, &QEventLoop::quit);
+    loop.exec();
+    return changed;
+}
+
+TEST_CASE("LibraryWatcher", "[file]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = QDir::cleanPath(QFileInfo(root.path()).absoluteFilePath());
+    REQUIRE(QDir().mkpath(rootPath + "/Movie A"));
+    REQUIRE(QDir().mkpath(rootPath + "/Movie A/extrafanart"));
+
+    // Scans are only started by poll() (and resume()), so that each change is
+    // reported by exactly one scan.
+    LibraryWatcher watcher;
+    watcher.setNotificationsEnabled(false);
+    watcher.setDebounceInterval(0);
+    watcher.setPollInterval(0);
+    watcher.setDirectoryFilter([](const QFileInfo& dir) { return dir.fileName() != "extrafanart"; });
+    watcher.setDirectories({DirectoryPath(rootPath)});
+
+    // Initial listing; nothing is reported.
+    CHECK(waitForScan(watcher).isEmpty());
+
+    SECTION("reports new directories and their subdirectories")
+    {
+        REQUIRE(QDir().mkpath(rootPath + "/Movie B/Sub"));
+        watcher.poll();
+        const QStringList changed = waitForScan(watcher);
+        CHECK(changed.contains(rootPath + "/Movie B"));
+        CHECK(changed.contains(rootPath + "/Movie B/Sub"));
+    }
+
+    SECTION("reports directories with new files")
+    {
+        QFile file(rootPath + "/Movie A/movie.mkv");
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.close();
+        watcher.poll();
+        CHECK(waitForScan(watcher).contains(rootPath + "/Movie A"));
+    }
+
+    SECTION("ignores filtered directories")
+    {
+        QFile file(rootPath + "/Movie A/extrafanart/fanart1.jpg");
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.close();
+        watcher.poll();
+        CHECK(waitForScan(watcher).isEmpty());
+    }
+
+    SECTION("does not report changes of a scan that finishes while paused")
+    {
+        REQUIRE(QDir().mkpath(rootPath + "/Movie C"));
+        watcher.poll();
+        watcher.pause();
+        CHECK(waitForScan(watcher).isEmpty());
+
+        // Changes are reported by a new scan after resuming.
+        watcher.resume();
+        CHECK(waitForScan(watcher).contains(rootPath + "/Movie C"));
+    }
+}
+
+TEST_CASE("LibraryWatcher finds removed files of changed directories", "[file]")
+{
+    QTemporaryDir root;
+    REQUIRE(root.isValid());
+    const QString rootPath = QDir::cleanPath(QFileInfo(root.path()).absoluteFilePath());
+    REQUIRE(QDir().mkpath(rootPath + "/Movie A"));
+    REQUIRE(QDir().mkpath(rootPath + "/Movie B"));
+    QFile file(rootPath + "/Movie A/movie.mkv");
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    const QSet<QString> files{rootPath + "/Movie A/movie.mkv",
+        rootPath + "/Movie A/removed.mkv",
+        rootPath + "/Movie B/unchanged.mkv",
+        rootPath + "/Removed/Sub/movie.mkv"};
+
+    SECTION("files of changed directories are checked")
+    {
+        const QStringList removed = LibraryWatcher::removedFiles(files, {rootPath + "/Movie A"});
+        CHECK(removed == QStringList{rootPath + "/Movie A/removed.mkv"});
+    }
+
+    SECTION("files of removed directories are reported via their changed parent directory")
+    {
+        const QStringList removed = LibraryWatcher::removedFiles(files, {rootPath});
+        CHECK(removed == QStringList{rootPath + "/Removed/Sub/movie.mkv"});
+    }
+}
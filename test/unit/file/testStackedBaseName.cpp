@@ -37,3 +37,60 @@ TEST_CASE("stackedBasedName", "[filename]")
               == "C:\\path\\to\\movie.mkv\\captain.america");
     }
 }
+
+/// \brief Files of a flat movie directory: Every third movie consists of two parts.
+static QStringList flatMovieDirectory(int fileCount)
+{
+    QStringList files;
+    files.reserve(fileCount);
+    int movie = 0;
+    while (files.size() < fileCount) {
+        const QString name = QStringLiteral("/movies/Some Movie Title %1 (2020)").arg(movie);
+        if (movie % 3 == 0) {
+            files << name + " - cd1.mkv" << name + " - cd2.mkv";
+        } else {
+            files << name + ".mkv";
+        }
+        ++movie;
+    }
+    return files;
+}
+
+TEST_CASE("groupStackedFiles", "[filename]")
+{
+    using namespace mediaelch::file;
+
+    SECTION("Groups parts of the same movie")
+    {
+        const QStringList files{"/movies/b.part2.mkv", "/movies/a.mkv", "/movies/b.part1.mkv", "/movies/c-cd1.avi"};
+        const QVector<QStringList> groups = groupStackedFiles(files);
+        REQUIRE(groups.size() == 3);
+        CHECK(groups[0] == QStringList{"/movies/a.mkv"});
+        CHECK(groups[1] == QStringList({"/movies/b.part1.mkv", "/movies/b.part2.mkv"}));
+        CHECK(groups[2] == QStringList{"/movies/c-cd1.avi"});
+    }
+
+    SECTION("Handles large directories")
+    {
+        const QStringList files = flatMovieDirectory(10000);
+        const QVector<QStringList> groups = groupStackedFiles(files);
+        // 2 parts every 3 movies => 4 files per 3 movies
+        CHECK(groups.size() == 7500);
+        int fileCount = 0;
+        for (const QStringList& group : groups) {
+            fileCount += qsizetype_to_int(group.size());
+        }
+        CHECK(fileCount == 10000);
+    }
+}
+
+TEST_CASE("groupStackedFiles benchmark", "[filename][.benchmark]")
+{
+    using namespace mediaelch::file;
+
+    const QStringList files1k = flatMovieDirectory(1000);
+    const QStringList files10k = flatMovieDirectory(10000);
+
+    BENCHMARK("1k files") { return groupStackedFiles(files1k); };
+    BENCHMARK("10k files") { return groupStackedFiles(files10k); };
+}
@@ -0,0 +1,95 @@
+#include "test/test_helpers.h"
+
+#include "globals/Helper.h"
+
+#include <random>
+
+/// \brief Straightforward implementation of helper::similarity() using the full
+///        Levenshtein distance matrix.  Used as reference.
+static qreal referenceSimilarity(const QString& s1, const QString& s2)
+{
+    const int len1 = qsizetype_to_int(s1.length());
+    const int len2 = qsizetype_to_int(s2.length());
+
+    if (s1 == s2) {
+        return 1;
+    }
+    if (len1 == 0 || len2 == 0) {
+        return 0;
+    }
+
+    QVector<QVector<int>> d(len1 + 1, QVector<int>(len2 + 1, 0));
+    for (int i = 0; i <= len1; ++i) {
+        d[i][0] = i;
+    }
+    for (int j = 0; j <= len2; ++j) {
+        d[0][j] = j;
+    }
+    for (int i = 1; i <= len1; ++i) {
+        for (int j = 1; j <= len2; ++j) {
+            d[i][j] = qMin(
+                qMin(d[i - 1][j] + 1, d[i][j - 1] + 1), d[i - 1][j - 1] + (s1.at(i - 1) == s2.at(j - 1) ? 0 : 1));
+        }
+    }
+
+    qreal dist = d[len1][len2];
+    return 1 - (dist / static_cast<qreal>(qMax(len1, len2)));
+}
+
+static QString randomText(int length, const QString& alphabet, std::mt19937& random)
+{
+    std::uniform_int_distribution<int> character(0, qsizetype_to_int(alphabet.size()) - 1);
+    QString text;
+    for (int i = 0; i < length; ++i) {
+        text.append(alphabet.at(character(random)));
+    }
+    return text;
+}
+
+TEST_CASE("helper::similarity", "[helper]")
+{
+    SECTION("simple cases")
+    {
+        CHECK(helper::similarity("", "") == 1);
+        CHECK(helper::similarity("abc", "abc") == 1);
+        CHECK(helper::similarity("abc", "") == 0);
+        CHECK(helper::similarity("", "abc") == 0);
+        CHECK(helper::similarity("abc", "xyz") == 0);
+        CHECK(helper::similarity("kitten", "sitting") == Approx(1 - 3.0 / 7.0));
+        CHECK(helper::similarity("sitting", "kitten") == Approx(1 - 3.0 / 7.0));
+    }
+
+    SECTION("is identical to the reference implementation")
+    {
+        std::mt19937 random(42); // NOLINT(cert-msc32-c,cert-msc51-cpp): deterministic on purpose
+        // Non-Latin-1 characters are handled differently by the implementation.
+        const QString alphabet = QString::fromUtf8("abc.-_ 01äé€字");
+        // Pattern lengths around 64 characters switch the implementation.
+        const int lengths[] = {0, 1, 2, 5, 20, 63, 64, 65, 100, 300};
+
+        for (const int length1 : lengths) {
+            for (const int length2 : lengths) {
+                for (int i = 0; i < 5; ++i) {
+                    const QString s1 = randomText(length1, alphabet, random);
+                    const QString s2 = randomText(length2, alphabet, random);
+                    CAPTURE(s1, s2);
+                    // Both implementations must return the same floating point value.
+                    CHECK(helper::similarity(s1, s2) == referenceSimilarity(s1, s2));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("helper::similarity benchmark", "[helper][.benchmark]")
+{
+    const QString file1 = "The.Movie.Name.2010.1080p.BluRay.x264-GROUP.mkv";
+    const QString file2 = "The.Other.Movie.2012.720p.WEB-DL.x264-OTHERGROUP.mkv";
+    const QString long1 = file1.repeated(4);
+    const QString long2 = file2.repeated(4);
+
+    BENCHMARK("file names") { return helper::similarity(file1, file2); };
+    BENCHMARK("file names (reference)") { return referenceSimilarity(file1, file2); };
+    BENCHMARK("long texts") { return helper::similarity(long1, long2); };
+    BENCHMARK("long texts (reference)") { return referenceSimilarity(long1, long2); };
+}
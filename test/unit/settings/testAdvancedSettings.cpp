@@ -138,6 +138,56 @@ TEST_CASE("Advanced Settings XML", "[settings]")
             CHECK(messages[0].tag == "pattern");
             CHECK(messages[0].type == AdvancedSettingsXmlReader::ParseErrorType::InvalidAttributeValue);
         }
+
+        SECTION("multiple patterns of each type are matched")
+        {
+            QString xml = addBaseXml(R"xml(
+                <exclude>
+                    <pattern applyTo="filename">^\.</pattern>
+                    <pattern applyTo="filename">(?i)-proof\.mkv$</pattern>
+                    <pattern applyTo="folders">^extras$</pattern>
+                    <pattern applyTo="folders">^@eaDir$</pattern>
+                </exclude>
+            )xml");
+
+            const auto pair = AdvancedSettingsXmlReader::loadFromXml(xml);
+            const auto settings = pair.first;
+            REQUIRE(pair.second.isEmpty());
+
+            CHECK(settings.isFileExcluded(".hidden.mkv"));
+            CHECK(settings.isFileExcluded("Movie-PROOF.mkv"));
+            CHECK_FALSE(settings.isFileExcluded("Movie.mkv"));
+            // Inline options must only apply to their own pattern.
+            CHECK_FALSE(settings.isFolderExcluded("EXTRAS"));
+            CHECK(settings.isFolderExcluded("extras"));
+            CHECK(settings.isFolderExcluded("@eaDir"));
+            // File patterns don't apply to folders and vice versa.
+            CHECK_FALSE(settings.isFolderExcluded(".hidden"));
+            CHECK_FALSE(settings.isFileExcluded("extras"));
+        }
+
+        SECTION("backreferences refer to the pattern's own groups")
+        {
+            QString xml = addBaseXml(R"xml(
+                <exclude>
+                    <pattern applyTo="filename">^(sample)-</pattern>
+                    <pattern applyTo="filename">^(\w+)\.\1\.mkv$</pattern>
+                    <pattern applyTo="folders">^(old)$</pattern>
+                    <pattern applyTo="folders">^(?&lt;name&gt;\w)\k&lt;name&gt;$</pattern>
+                </exclude>
+            )xml");
+
+            const auto pair = AdvancedSettingsXmlReader::loadFromXml(xml);
+            const auto settings = pair.first;
+            REQUIRE(pair.second.isEmpty());
+
+            CHECK(settings.isFileExcluded("sample-movie.mkv"));
+            CHECK(settings.isFileExcluded("movie.movie.mkv"));
+            CHECK_FALSE(settings.isFileExcluded("movie.other.mkv"));
+            CHECK(settings.isFolderExcluded("old"));
+            CHECK(settings.isFolderExcluded("xx"));
+            CHECK_FALSE(settings.isFolderExcluded("xy"));
+        }
     }
 
     SECTION("read attributes correctly")
@@ -10,6 +10,7 @@
 #include "music/Artist.h"
 #include "music/MusicModel.h"
 #include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
 #include "tv_shows/TvShowModel.h"
 
 #include <QAbstractItemModelTester>
@@ -112,3 +113,87 @@ TEST_CASE("Models pass Qt's builtin model checker", "[movie][model]")
             model.get(), QAbstractItemModelTester::FailureReportingMode::Fatal);
     }
 }
+
+TEST_CASE("TvShowModel updates shows incrementally", "[show][model]")
+{
+    auto model = std::make_unique<TvShowModel>();
+    auto show = std::make_unique<TvShow>();
+    addEpisodeToShow(*show, 1, 1);
+    addEpisodeToShow(*show, 1, 2);
+    model->appendShow(show.get());
+
+    // Checks that all row insertions and removals are consistent.
+    auto tester = std::make_unique<QAbstractItemModelTester>(
+        model.get(), QAbstractItemModelTester::FailureReportingMode::Fatal);
+
+    const QModelIndex showIndex = model->index(0, 0);
+    const QPersistentModelIndex seasonIndex = model->index(0, 0, showIndex);
+    REQUIRE(model->rowCount(showIndex) == 1);
+    REQUIRE(model->rowCount(seasonIndex) == 2);
+
+    int removedRows = 0;
+    QObject::connect(model.get(),
+        &QAbstractItemModel::rowsRemoved,
+        [&removedRows](const QModelIndex& /*parent*/, int first, int last) { removedRows += last - first + 1; });
+
+    SECTION("new episodes and seasons are appended without removing existing rows")
+    {
+        addEpisodeToShow(*show, 1, 3)->setIsDummy(true);
+        TvShowEpisode* dummy = addEpisodeToShow(*show, 2, 1);
+        dummy->setIsDummy(true);
+
+        CHECK(model->updateShow(show.get()));
+        CHECK(removedRows == 0);
+        CHECK(seasonIndex.isValid());
+        CHECK(model->rowCount(showIndex) == 2);
+        CHECK(model->rowCount(seasonIndex) == 3);
+
+        // Season 2 is empty afterwards and is removed.
+        dummy->setSeason(SeasonNumber(1));
+        dummy->setEpisode(EpisodeNumber(4));
+        CHECK(model->updateShow(show.get()));
+        CHECK(removedRows == 1);
+        CHECK(seasonIndex.isValid());
+        CHECK(model->rowCount(showIndex) == 1);
+        CHECK(model->rowCount(seasonIndex) == 4);
+    }
+
+    SECTION("season rows are updated if their dummy state changed")
+    {
+        TvShowEpisode* dummy = addEpisodeToShow(*show, 2, 1);
+        dummy->setIsDummy(true);
+        CHECK(model->updateShow(show.get()));
+        const QPersistentModelIndex dummySeasonIndex = model->index(1, 0, showIndex);
+        REQUIRE(model->data(dummySeasonIndex, TvShowRoles::HasDummyEpisodes).toBool());
+
+        QVector<QPersistentModelIndex> changed;
+        QObject::connect(model.get(),
+            &QAbstractItemModel::dataChanged,
+            [&changed](const QModelIndex& topLeft, const QModelIndex& /*bottomRight*/) { changed << topLeft; });
+
+        // Season 1 gets a missing episode; season 2 gets a real one.
+        addEpisodeToShow(*show, 1, 3)->setIsDummy(true);
+        addEpisodeToShow(*show, 2, 2);
+        CHECK(model->updateShow(show.get()));
+        CHECK(changed.contains(seasonIndex));
+        CHECK(changed.contains(dummySeasonIndex));
+        CHECK(model->data(seasonIndex, TvShowRoles::HasDummyEpisodes).toBool());
+
+        // Nothing changed for the seasons.
+        changed.clear();
+        CHECK(model->updateShow(show.get()));
+        CHECK_FALSE(changed.contains(seasonIndex));
+        CHECK_FALSE(changed.contains(dummySeasonIndex));
+    }
+
+    SECTION("renumbered episodes are moved to their new season")
+    {
+        show->episodes().first()->setSeason(SeasonNumber(2));
+
+        CHECK(model->updateShow(show.get()));
+        CHECK(removedRows == 1);
+        CHECK(model->rowCount(showIndex) == 2);
+        CHECK(model->rowCount(seasonIndex) == 1);
+        CHECK(model->rowCount(model->index(1, 0, showIndex)) == 1);
+    }
+}
@@ -0,0 +1,102 @@
+#include "test/test_helpers.h"
+
+#include "tv_shows/TvShow.h"
+#include "tv_shows/TvShowEpisode.h"
+
+TEST_CASE("TvShow episode index", "[show]")
+{
+    TvShow show;
+    TvShowEpisode* s1e1 = addEpisodeToShow(show, 1, 1);
+    TvShowEpisode* s1e2 = addEpisodeToShow(show, 1, 2);
+    TvShowEpisode* s0e1 = addEpisodeToShow(show, 0, 1);
+    TvShowEpisode* s2e1 = addEpisodeToShow(show, 2, 1);
+
+    SECTION("finds episodes by season and episode number")
+    {
+        CHECK(show.episode(SeasonNumber(1), EpisodeNumber(1)) == s1e1);
+        CHECK(show.episode(SeasonNumber(1), EpisodeNumber(2)) == s1e2);
+        CHECK(show.episode(SeasonNumber(0), EpisodeNumber(1)) == s0e1);
+        CHECK(show.episode(SeasonNumber(2), EpisodeNumber(1)) == s2e1);
+        CHECK(show.episode(SeasonNumber(3), EpisodeNumber(1)) == nullptr);
+
+        CHECK(show.episodes(SeasonNumber(1)) == QVector<TvShowEpisode*>{s1e1, s1e2});
+        CHECK(show.episodes(SeasonNumber(3)).isEmpty());
+        // Order of the first episode of each season
+        CHECK(show.seasons() == QVector<SeasonNumber>{SeasonNumber(1), SeasonNumber(0), SeasonNumber(2)});
+    }
+
+    SECTION("the first added episode wins for duplicate numbers")
+    {
+        TvShowEpisode* duplicate = addEpisodeToShow(show, 1, 1);
+        CHECK(show.episode(SeasonNumber(1), EpisodeNumber(1)) == s1e1);
+        s1e1->setEpisode(EpisodeNumber(3));
+        CHECK(show.episode(SeasonNumber(1), EpisodeNumber(1)) == duplicate);
+        CHECK(show.episode(SeasonNumber(1), EpisodeNumber(3)) == s1e1);
+        s1e1->setEpisode(EpisodeNumber(1));
+        CHECK(show.episode(SeasonNumber(1), EpisodeNumber(1)) == s1e1);
+    }
+
+    SECTION("is updated if episodes are renumbered")
+    {
+        s2e1->setSeason(SeasonNumber(3));
+        CHECK(show.episode(SeasonNumber(2), EpisodeNumber(1)) == nullptr);
+        CHECK(show.episode(SeasonNumber(3), EpisodeNumber(1)) == s2e1);
+        CHECK(show.seasons() == QVector<SeasonNumber>{SeasonNumber(1), SeasonNumber(0), SeasonNumber(3)});
+        CHECK(show.episodes(SeasonNumber(2)).isEmpty());
+    }
+
+    SECTION("keeps the order of episodes if they are renumbered")
+    {
+        // Seasons: 1, 1, 0, 2
+        s1e1->setSeason(SeasonNumber(2));
+        CHECK(show.seasons() == QVector<SeasonNumber>{SeasonNumber(2), SeasonNumber(1), SeasonNumber(0)});
+        CHECK(show.episodes(SeasonNumber(2)) == QVector<TvShowEpisode*>{s1e1, s2e1});
+
+        s2e1->setSeason(SeasonNumber(1));
+        s1e1->setSeason(SeasonNumber(1));
+        CHECK(show.seasons() == QVector<SeasonNumber>{SeasonNumber(1), SeasonNumber(0)});
+        CHECK(show.episodes(SeasonNumber(1)) == QVector<TvShowEpisode*>{s1e1, s1e2, s2e1});
+    }
+
+    SECTION("dummy episodes")
+    {
+        TvShowEpisode* dummy = addEpisodeToShow(show, 4, 1);
+        dummy->setIsDummy(true);
+        CHECK(show.isDummySeason(SeasonNumber(4)));
+        CHECK(show.hasDummyEpisodes(SeasonNumber(4)));
+        CHECK_FALSE(show.isDummySeason(SeasonNumber(1)));
+        CHECK_FALSE(show.hasDummyEpisodes(SeasonNumber(1)));
+        CHECK(show.seasons(true).contains(SeasonNumber(4)));
+        CHECK_FALSE(show.seasons(false).contains(SeasonNumber(4)));
+    }
+}
+
+TEST_CASE("TvShow keeps the season order if episodes are renumbered", "[show]")
+{
+    TvShow show;
+    TvShowEpisode* a = addEpisodeToShow(show, 1, 1);
+    addEpisodeToShow(show, 2, 1);
+    TvShowEpisode* c = addEpisodeToShow(show, 1, 2);
+
+    a->setSeason(SeasonNumber(3));
+    CHECK(show.seasons() == QVector<SeasonNumber>{SeasonNumber(3), SeasonNumber(2), SeasonNumber(1)});
+    CHECK(show.episodes(SeasonNumber(1)) == QVector<TvShowEpisode*>{c});
+}
+
+TEST_CASE("TvShow episode index benchmark", "[show][.benchmark]")
+{
+    TvShow show;
+    for (int i = 1; i <= 5000; ++i) {
+        addEpisodeToShow(show, 1 + i / 100, i % 100);
+    }
+
+    BENCHMARK("episode() for 5000 episodes")
+    {
+        int found = 0;
+        for (int i = 1; i <= 5000; ++i) {
+            found += show.episode(SeasonNumber(1 + i / 100), EpisodeNumber(i % 100)) != nullptr ? 1 : 0;
+        }
+        return found;
+    };
+    BENCHMARK("seasons() for 5000 episodes") { return show.seasons(false); };
+}
@@ -1,6 +1,9 @@
 #include "test/test_helpers.h"
 
 #include "tv_shows/TvShowFileSearcher.h"
+#include "tv_shows/TvShowUtils.h"
+
+#include <QRegularExpression>
 
 static EpisodeNumber getEpisodeNumber(QString filename)
 {
@@ -75,3 +78,169 @@ TEST_CASE("TvShowFileSearcher parses season and episode data", "[show][utils]")
         CHECK(getEpisodeNumbers("Oz/Oz.S01E01E02.Emerald City (720p)") == episodeList({1, 2}));
     }
 }
+
+/// \brief Implementation of getSeasonNumber() before patterns were compiled only once.
+///        Used as reference.  Assumes that the file is neither a DVD nor a BluRay.
+static SeasonNumber referenceSeasonNumber(const QString& filename)
+{
+    QRegularExpression rx(R"(S(\d+)[ ._-]?E)", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch match = rx.match(filename);
+    if (match.hasMatch()) {
+        return SeasonNumber(match.captured(1).toInt());
+    }
+    rx.setPattern("(\\d+)?x(\\d+)");
+    match = rx.match(filename);
+    if (match.hasMatch()) {
+        return SeasonNumber(match.captured(1).toInt());
+    }
+    rx.setPattern("(\\d+).(\\d){2,4}");
+    match = rx.match(filename);
+    if (match.hasMatch()) {
+        return SeasonNumber(match.captured(1).toInt());
+    }
+    rx.setPattern("Season[ ._]?(\\d+)[ ._]?Episode");
+    match = rx.match(filename);
+    if (match.hasMatch()) {
+        return SeasonNumber(match.captured(1).toInt());
+    }
+    return SeasonNumber::SpecialsSeason;
+}
+
+/// \brief Implementation of getEpisodeNumbers() before patterns were compiled only once.
+///        Used as reference.  Assumes that the file is neither a DVD nor a BluRay.
+static QVector<EpisodeNumber> referenceEpisodeNumbers(const QString& filename)
+{
+    QVector<EpisodeNumber> episodes;
+    auto scanWithPattern = [&](const QString& pattern, bool mayBeAmbiguous) -> bool {
+        QRegularExpression rx(pattern, QRegularExpression::CaseInsensitiveOption);
+        QRegularExpressionMatchIterator matches = rx.globalMatch(filename);
+        elch_size_t lastMatchEnd = -1;
+        while (matches.hasNext()) {
+            QRegularExpressionMatch match = matches.next();
+            if (mayBeAmbiguous && lastMatchEnd != -1 && lastMatchEnd < match.capturedStart(0) + 5) {
+                return true;
+            }
+            episodes << EpisodeNumber(match.captured(2).toInt());
+            lastMatchEnd = match.capturedEnd(0);
+        }
+        if (episodes.isEmpty()) {
+            return false;
+        }
+        if (episodes.count() == 1) {
+            rx.setPattern(R"([-_EeXx]+([0-9]+)($|[\-\._\sE]))");
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+            matches = rx.globalMatch(
+                filename, lastMatchEnd, QRegularExpression::NormalMatch, QRegularExpression::AnchoredMatchOption);
+#else
+            matches = rx.globalMatch(
+                filename, lastMatchEnd, QRegularExpression::NormalMatch, QRegularExpression::AnchorAtOffsetMatchOption);
+#endif
+            while (matches.hasNext()) {
+                episodes << EpisodeNumber(matches.next().captured(1).toInt());
+            }
+        }
+        return true;
+    };
+
+    const QVector<QPair<QString, bool>> patterns{{R"(S(\d+)[ ._-]?E(\d+))", false},
+        {R"(S(\d+)[ ._-]?EP(\d+))", false},
+        {R"(Season[ ._-]?(\d+)[._ -]?Episode[ ._-]?(\d+))", false},
+        {R"((\d+)x(\d+))", true},
+        {R"((\d+).(\d){2,4})", true}};
+    for (const auto& pattern : patterns) {
+        if (scanWithPattern(pattern.first, pattern.second)) {
+            break;
+        }
+    }
+    return episodes;
+}
+
+/// \brief File names as they can be found in real-world TV show libraries.
+static QStringList episodeFileNameCorpus()
+{
+    return QStringList{
+        "/tv/Oz/Season 1/Oz.S01E01.Emerald City (720p).mkv",
+        "/tv/Oz/Season 1/Oz.S01E01E02.Emerald City (720p).mkv",
+        "/tv/Breaking Bad/Season 05/Breaking.Bad.S05E14.Ozymandias.1080p.BluRay.x264-ROVERS.mkv",
+        "/tv/Breaking Bad/Season 05/breaking.bad.s05e16.720p.hdtv.x264.mkv",
+        "/tv/Top Gear/Series 21/21x04 - Hammond vs. 6x6.mp4",
+        "/tv/Top Gear/Series 21/Top Gear - 21x05 - Episode 5.avi",
+        "/tv/Friends/Season 3/Friends - 3x01 - The One with the Princess Leia Fantasy.avi",
+        "/tv/Friends/Season 3/Friends.301.The.One.Where.No.Ones.Ready.avi",
+        "/tv/Friends/Season 10/friends.1017.1018.the.last.one.avi",
+        "/tv/The Office/Season 2/The Office [2x01] The Dundies.mkv",
+        "/tv/The Office/Season 2/The.Office.US.S02E01-E02.720p.WEB-DL.mkv",
+        "/tv/Doctor Who/Season 1/Doctor Who (2005) - S01E01 - Rose.mkv",
+        "/tv/Doctor Who/Specials/Doctor Who (2005) - S00E01 - The Christmas Invasion.mkv",
+        "/tv/Doctor Who/Specials/Doctor Who - The Day of the Doctor.mkv",
+        "/tv/Game of Thrones/Season 8/Game.of.Thrones.S08E06.The.Iron.Throne.2160p.UHD.BluRay.x265.mkv",
+        "/tv/Game of Thrones/Season 8/Game of Thrones - S08 E06 - The Iron Throne.mkv",
+        "/tv/Game of Thrones/Season 8/Game_of_Thrones_S08_E06.mkv",
+        "/tv/Sherlock/Season 1/Sherlock.S01EP01.A.Study.in.Pink.mkv",
+        "/tv/Sherlock/Season 1/Sherlock Season 1 Episode 2 - The Blind Banker.mkv",
+        "/tv/Sherlock/Season 1/Sherlock.Season.01.Episode.03.mkv",
+        "/tv/The Daily Show/Season 2019/The.Daily.Show.2019.10.15.Guest.Name.720p.WEB.x264.mkv",
+        "/tv/One Piece/Season 1/One Piece - S01E1005 - Title.mkv",
+        "/tv/One Piece/Season 1/[Group] One Piece - 1005 [1080p].mkv",
+        "/tv/Naruto/Naruto Shippuden - 500 [720p].mkv",
+        "/tv/The Simpsons/Season 30/The Simpsons S30E01-E02 Bart's Not Dead.mkv",
+        "/tv/The Simpsons/Season 30/the.simpsons.s30e03.cd1.avi",
+        "/tv/The Simpsons/Season 30/the.simpsons.s30e03.part2.avi",
+        "/tv/Lost/Season 1/Lost - 1x01-1x02 - Pilot.avi",
+        "/tv/Lost/Season 1/lost.s01e01e02e03.avi",
+        "/tv/24/Season 1/24.S01E01.12.00.A.M.-1.00.A.M.avi",
+        "/tv/Sample Show/Season 1/Sample Show S1E1.mp4",
+        "/tv/Sample Show/Season 1/Sample Show s1 e1.mp4",
+        "/tv/Sample Show/Season 1/Sample.Show.S1.E1.mp4",
+        "/tv/Sample Show/Season 1/Sample Show - 1080p.mp4",
+        "/tv/Sample Show/Season 1/Sample Show - Extras.mp4",
+        "/tv/Sample Show/Season 1/Ep01.mp4",
+        "/tv/Sample Show/Season 1/01.mp4",
+        "/tv/Sample Show/Season 1/1x1.mp4",
+    };
+}
+
+TEST_CASE("parseSeasonAndEpisodeNumbers returns the same results as before", "[show][utils]")
+{
+    const QStringList corpus = episodeFileNameCorpus();
+    for (const QString& file : corpus) {
+        CAPTURE(file);
+        const QString filename = file.split('/').last();
+        const mediaelch::SeasonAndEpisodeNumbers numbers = mediaelch::parseSeasonAndEpisodeNumbers({file});
+        CHECK(numbers.season == referenceSeasonNumber(filename));
+        CHECK(numbers.episodes == referenceEpisodeNumbers(filename));
+        CHECK(TvShowFileSearcher::getSeasonNumber({file}) == numbers.season);
+        CHECK(TvShowFileSearcher::getEpisodeNumbers({file}) == numbers.episodes);
+    }
+
+    const mediaelch::SeasonAndEpisodeNumbers none = mediaelch::parseSeasonAndEpisodeNumbers({});
+    CHECK(none.season == SeasonNumber::NoSeason);
+    CHECK(none.episodes.isEmpty());
+}
+
+TEST_CASE("parseSeasonAndEpisodeNumbers benchmark", "[show][utils][.benchmark]")
+{
+    const QStringList corpus = episodeFileNameCorpus();
+    QStringList filenames;
+    for (const QString& file : corpus) {
+        filenames << file.split('/').last();
+    }
+
+    BENCHMARK("parseSeasonAndEpisodeNumbers")
+    {
+        int count = 0;
+        for (const QString& file : corpus) {
+            count += qsizetype_to_int(mediaelch::parseSeasonAndEpisodeNumbers({file}).episodes.size());
+        }
+        return count;
+    };
+    BENCHMARK("reference")
+    {
+        int count = 0;
+        for (const QString& filename : filenames) {
+            referenceSeasonNumber(filename);
+            count += qsizetype_to_int(referenceEpisodeNumbers(filename).size());
+        }
+        return count;
+    };
+}